@@ -0,0 +1,10 @@
+#ifndef CONFIGURED_H
+#define CONFIGURED_H
+
+#ifdef USE_WIDE_CHARS
+typedef wchar_t Char;
+#else
+typedef char Char;
+#endif
+
+#endif
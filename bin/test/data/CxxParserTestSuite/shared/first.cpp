@@ -0,0 +1,7 @@
+#define USE_WIDE_CHARS
+#include "configured.h"
+#include "guarded.h"
+#include "templated.h"
+#include "unguarded.h"
+
+Char first;
@@ -0,0 +1,8 @@
+#pragma once
+
+#define GUARDED_SIZE 4
+
+struct Guarded
+{
+	char data[GUARDED_SIZE];
+};
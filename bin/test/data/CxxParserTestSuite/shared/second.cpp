@@ -0,0 +1,4 @@
+#include "configured.h"
+#include "guarded.h"
+
+Char second;
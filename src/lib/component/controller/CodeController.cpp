@@ -65,17 +65,47 @@ void CodeController::handleMessage(MessageActivateFullTextSearch* message)
 
 	saveOrRestoreViewMode(message);
 
-	m_collection = m_storageAccess->getFullTextSearchLocations(
-		message->searchTerm, message->caseSensitive);
+	m_fullTextSearchQuery = FullTextSearchQuery(message->searchTerm, message->caseSensitive);
+	m_fullTextSearchQuery.maxHitCount = static_cast<size_t>(
+		std::max(ApplicationSettings::getInstance()->getCodeFullTextSearchMaxHitCount(), 0));
+	{
+		std::lock_guard<std::mutex> lock(m_fullTextSearchCanceledMutex);
+		m_fullTextSearchCanceled = m_fullTextSearchQuery.canceled;
+	}
+
+	m_collection = std::make_shared<SourceLocationCollection>();
+	m_fullTextSearchCollection = m_collection;
+	m_files.clear();
 
 	CodeView::CodeParams params;
 	params.clearSnippets = true;
 	params.useSingleFileCache = false;
 
-	m_files = getFilesForCollection(m_collection);
-	createReferences();
-	expandVisibleFiles(params.useSingleFileCache);
-	showFiles(params, firstReferenceScrollParams(), !message->isReplayed());
+	const bool updateView = !message->isReplayed();
+	bool filesShown = false;
+
+	// show the files of each batch as soon as they are found
+	continueFullTextSearch([&]() {
+		if (!filesShown)
+		{
+			expandVisibleFiles(params.useSingleFileCache);
+			showFiles(params, firstReferenceScrollParams(), updateView);
+			filesShown = true;
+		}
+		else if (
+			updateView && getView()->isInListMode() && m_currentFileMax < SNIPPETS_INCREASE_STEP)
+		{
+			std::vector<CodeFileParams>::const_iterator begin;
+			std::vector<CodeFileParams>::const_iterator end;
+			getMoreFilesRange(begin, end);
+			getView()->showSnippets(begin, end);
+		}
+	});
+
+	if (!filesShown)
+	{
+		showFiles(params, firstReferenceScrollParams(), updateView);
+	}
 }
 
 void CodeController::handleMessage(MessageActivateLegend* message)
@@ -454,6 +484,15 @@ void CodeController::handleMessage(MessageFocusOut* message)
 	getView()->deCoFocusTokenIds();
 }
 
+void CodeController::handleMessage(MessageFullTextSearchInterrupted* message)
+{
+	std::lock_guard<std::mutex> lock(m_fullTextSearchCanceledMutex);
+	if (m_fullTextSearchCanceled)
+	{
+		*m_fullTextSearchCanceled = true;
+	}
+}
+
 void CodeController::handleMessage(MessageScrollToLine* message)
 {
 	getView()->scrollTo(
@@ -683,6 +722,14 @@ void CodeController::handleMessage(MessageCodeRequestMoreSnippets* message)
 
 	getMoreFilesRange(begin, end);
 
+	// load more hits of a fulltext search that stopped at the hit limit
+	if (begin == end && m_fullTextSearchQuery.firstCandidateIndex &&
+		m_collection == m_fullTextSearchCollection)
+	{
+		continueFullTextSearch();
+		getMoreFilesRange(begin, end);
+	}
+
 	getView()->showSnippets(begin, end);
 }
 
@@ -696,6 +743,7 @@ void CodeController::clear()
 	getView()->clear();
 
 	m_collection = std::make_shared<SourceLocationCollection>();
+	m_fullTextSearchCollection.reset();
 	m_currentFilePath = FilePath();
 	clearReferences();
 }
@@ -1697,6 +1745,30 @@ void CodeController::showFirstActiveReference(Id tokenId, bool updateView)
 	showFiles(m_codeParams, scrollParams, updateView);
 }
 
+void CodeController::continueFullTextSearch(std::function<void()> onFilesAdded)
+{
+	TRACE();
+
+	m_fullTextSearchQuery.firstCandidateIndex = m_storageAccess->getFullTextSearchLocations(
+		m_fullTextSearchQuery, [&](std::shared_ptr<SourceLocationCollection> collection) {
+			collection->forEachSourceLocationFile([this](std::shared_ptr<SourceLocationFile> file) {
+				m_collection->addSourceLocationFile(file);
+
+				CodeFileParams params;
+				params.locationFile = file;
+				m_files.push_back(params);
+			});
+			m_fullTextSearchQuery.reportedHitCount += collection->getSourceLocationCount();
+
+			createReferences();
+
+			if (onFilesAdded)
+			{
+				onFilesAdded();
+			}
+		});
+}
+
 void CodeController::showFiles(CodeView::CodeParams params, CodeScrollParams scrollParams, bool updateView)
 {
 	if (updateView)
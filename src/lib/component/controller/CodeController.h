@@ -1,10 +1,13 @@
 #ifndef CODE_CONTROLLER_H
 #define CODE_CONTROLLER_H
 
+#include <functional>
 #include <map>
+#include <mutex>
 #include <string>
 
 #include "FilePath.h"
+#include "FullTextSearchQuery.h"
 #include "LocationType.h"
 #include "MessageActivateErrors.h"
 #include "MessageActivateFullTextSearch.h"
@@ -23,6 +26,7 @@
 #include "MessageFocusChanged.h"
 #include "MessageFocusIn.h"
 #include "MessageFocusOut.h"
+#include "MessageFullTextSearchInterrupted.h"
 #include "MessageListener.h"
 #include "MessageScrollCode.h"
 #include "MessageScrollToLine.h"
@@ -62,6 +66,7 @@ class CodeController
 	, public MessageListener<MessageFlushUpdates>
 	, public MessageListener<MessageFocusIn>
 	, public MessageListener<MessageFocusOut>
+	, public MessageListener<MessageFullTextSearchInterrupted>
 	, public MessageListener<MessageScrollCode>
 	, public MessageListener<MessageScrollToLine>
 	, public MessageListener<MessageShowError>
@@ -106,6 +111,7 @@ private:
 	void handleMessage(MessageFlushUpdates* message) override;
 	void handleMessage(MessageFocusIn* message) override;
 	void handleMessage(MessageFocusOut* message) override;
+	void handleMessage(MessageFullTextSearchInterrupted* message) override;
 	void handleMessage(MessageScrollCode* message) override;
 	void handleMessage(MessageScrollToLine* message) override;
 	void handleMessage(MessageShowError* message) override;
@@ -175,6 +181,10 @@ private:
 	void showFirstActiveReference(Id tokenId, bool updateView);
 	void showFiles(CodeView::CodeParams params, CodeScrollParams scrollParams, bool updateView);
 
+	// continues the current fulltext search up to the hit limit, onFilesAdded gets called after each
+	// batch of files has been added to m_files
+	void continueFullTextSearch(std::function<void()> onFilesAdded = std::function<void()>());
+
 	void CodeController::getMoreFilesRange(
 		std::vector<CodeFileParams>::const_iterator& begin,
 		std::vector<CodeFileParams>::const_iterator& end);
@@ -199,6 +209,11 @@ private:
 	int m_localReferenceIndex = -1;
 
 	const int SNIPPETS_INCREASE_STEP = 50;
+
+	FullTextSearchQuery m_fullTextSearchQuery;
+	std::shared_ptr<SourceLocationCollection> m_fullTextSearchCollection;
+	std::shared_ptr<std::atomic<bool>> m_fullTextSearchCanceled;
+	std::mutex m_fullTextSearchCanceledMutex;
 };
 
 #endif	  // CODE_CONTROLLER_H
@@ -1,7 +1,10 @@
 #ifndef GRAPH_CONTROLLER_H
 #define GRAPH_CONTROLLER_H
 
-#include <list>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "MessageActivateErrors.h"
@@ -26,16 +29,14 @@
 #include "MessageSaveAsDot.h"
 
 #include "Controller.h"
-#include "DummyEdge.h"
-#include "DummyNode.h"
+#include "GraphState.h"
 #include "GraphView.h"
-#include "Node.h"
 
-class Graph;
 class StorageAccess;
 
 class GraphController
 	: public Controller
+	, private GraphState
 	, public MessageListener<MessageActivateErrors>
 	, public MessageListener<MessageActivateFullTextSearch>
 	, public MessageListener<MessageActivateLegend>
@@ -58,7 +59,7 @@ class GraphController
 {
 public:
 	GraphController(StorageAccess* storageAccess);
-	~GraphController() = default;
+	~GraphController();
 
 	Id getSchedulerId() const override;
 
@@ -83,70 +84,33 @@ private:
 	void handleMessage(MessageShowReference* message) override;
 	void handleMessage(MessageSaveAsDot* message) override;
 
+	// asks about graphs that are too large to show, before they get layouted
+	void activateTrail(
+		std::shared_ptr<GraphState> state, std::shared_ptr<MessageActivateTrail> message);
+
 	GraphView* getView() const;
 
+	// Graphs of activations are built into a separate GraphState on a thread, so a newer activation
+	// can cancel them while the scheduler keeps handling messages. The build function checks
+	// isCancelled between its stages and returns false when it stopped early. Once a build is
+	// complete, show runs as task on the scheduler to take the new state over.
+	void startGraphThread(
+		std::function<bool(std::function<bool()>)> build, std::function<void()> show);
+	void joinGraphThread();
+	void cancelGraphThread();
+	bool isGraphOutdated(size_t generation) const;
+	bool isGraphBuilding() const;
+
+	// messages that change the shown graph wait until the graph that is being built is shown
+	template <typename MessageType>
+	bool deferWhileGraphBuilding(MessageType* message);
+	void handleDeferredMessages();
+
+	// cancels the graph thread first, so it can be called from any thread
 	void clear() override;
+	void clearGraph();
 
-	void createDummyGraph(const std::shared_ptr<Graph> graph);
-	void createDummyGraphAndSetActiveAndVisibility(
-		const std::vector<Id>& tokenIds,
-		const std::shared_ptr<Graph> graph,
-		bool keepExpandedNodesExpanded);
-	std::vector<std::shared_ptr<DummyNode>> createDummyNodeTopDown(Node* node, Id ancestorId);
-
-	void updateDummyNodeNamesAndAddQualifiers(const std::vector<std::shared_ptr<DummyNode>>& dummyNodes);
-
-	std::vector<Id> getExpandedNodeIds() const;
-	void setExpandedNodeIds(const std::vector<Id>& nodeIds);
-	void autoExpandActiveNode(const std::vector<Id>& activeTokenIds);
-
-	bool setActive(const std::vector<Id>& activeTokenIds, bool showAllEdges);
-	void setVisibility(bool noActive);
-	void setActiveAndVisibility(const std::vector<Id>& activeTokenIds);
-	bool setNodeActiveRecursive(DummyNode* node, const std::vector<Id>& activeTokenIds) const;
-	bool setNodeVisibilityRecursiveBottomUp(DummyNode* node, bool noActive) const;
-	void setNodeVisibilityRecursiveTopDown(DummyNode* node, bool parentExpanded) const;
-
-	void hideBuiltinTypes();
-
-	void bundleNodes();
-	void bundleNodesAndEdgesMatching(
-		std::function<bool(const DummyNode::BundleInfo&, const Node*)> matcher,
-		size_t count,
-		bool countConnectedNodes,
-		const std::wstring& name);
-	std::shared_ptr<DummyNode> bundleNodesMatching(
-		std::list<std::shared_ptr<DummyNode>>& nodes,
-		std::function<bool(const DummyNode*)> matcher,
-		const std::wstring& name);
-	std::shared_ptr<DummyNode> bundleByType(
-		std::list<std::shared_ptr<DummyNode>>& nodes,
-		const NodeType& type,
-		const Tree<NodeType::BundleInfo>& bundleInfoTree,
-		const bool considerInvisibleNodes);
-	void bundleNodesByType();
-
-	void addCharacterIndex();
-	bool hasCharacterIndex() const;
-
-	void groupNodesByParents(GroupType groupType);
-	DummyNode* groupAllNodes(GroupType groupType, Id groupNodeId);
-	void groupTrailNodes(GroupType groupType);
-
-	void layoutNesting();
-	void extendEqualFunctionNames(const std::vector<std::shared_ptr<DummyNode>>& nodes) const;
-	Vec4i layoutNestingRecursive(DummyNode* node, int relayoutAccessMaxWidth = -1) const;
-	void addExpandToggleNode(DummyNode* node) const;
-	void layoutToGrid(DummyNode* node) const;
-
-	void layoutGraph(bool getSortedNodes = false);
-	void layoutList();
-	void layoutTrail(bool horizontal, bool hasOrigin);
-
-	void assignBundleIds();
-
-	std::shared_ptr<DummyNode> getDummyGraphNodeById(Id tokenId) const;
-	DummyEdge* getDummyGraphEdgeById(Id tokenId) const;
+	void updateViewSize();
 
 	void relayoutGraph(
 		MessageBase* message,
@@ -155,28 +119,23 @@ private:
 		const std::wstring& groupName);
 	void buildGraph(MessageBase* message, GraphView::GraphParams params);
 
-	void forEachDummyNodeRecursive(std::function<void(DummyNode*)> func);
-	void forEachDummyEdge(std::function<void(DummyEdge*)> func);
-
-	void createLegendGraph();
-
-	StorageAccess* m_storageAccess;
-
-	std::vector<std::shared_ptr<DummyNode>> m_dummyNodes;
-	std::vector<std::shared_ptr<DummyEdge>> m_dummyEdges;
-
-	std::map<Id, std::shared_ptr<DummyNode>> m_dummyGraphNodes;
-
-	std::vector<Id> m_activeNodeIds;
-	std::vector<Id> m_activeEdgeIds;
-
-	std::shared_ptr<Graph> m_graph;
-
-	std::map<Id, Id> m_topLevelAncestorIds;
-
-	bool m_useBezierEdges = false;
-	bool m_showsLegend = false;
 	Id m_tokenIdToFocus = 0;
+
+	std::atomic<size_t> m_graphGeneration;
+	std::atomic<size_t> m_shownGeneration;
+	std::shared_ptr<std::thread> m_graphThread;
+	std::mutex m_graphThreadMutex;
+
+	// shared with the show tasks, which may still be queued on the scheduler after destruction
+	struct ShowLifetime
+	{
+		std::mutex mutex;
+		bool alive = true;
+	};
+	std::shared_ptr<ShowLifetime> m_showLifetime;
+
+	std::vector<std::function<void()>> m_deferredMessages;
+	std::mutex m_deferredMessagesMutex;
 };
 
 #endif	  // GRAPH_CONTROLLER_H
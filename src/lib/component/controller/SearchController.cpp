@@ -60,8 +60,16 @@ void SearchController::handleMessage(MessageSearchAutocomplete* message)
 	}
 
 	LOG_INFO(L"autocomplete string: \"" + message->query + L"\"");
-	view->setAutocompletionList(m_storageAccess->getAutocompletionMatches(
-		message->query, message->acceptedNodeTypes, true));
+	const std::vector<SearchMatch> matches = m_storageAccess->getAutocompletionMatches(
+		message->query, message->acceptedNodeTypes, true);
+
+	// Newer keystrokes arrived while searching, their request shows the up-to-date list
+	if (message->query != view->getQuery())
+	{
+		return;
+	}
+
+	view->setAutocompletionList(matches);
 }
 
 SearchView* SearchController::getView()
@@ -0,0 +1,137 @@
+#ifndef GRAPH_STATE_H
+#define GRAPH_STATE_H
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "DummyEdge.h"
+#include "DummyNode.h"
+#include "GroupType.h"
+#include "Node.h"
+#include "Vector2.h"
+#include "Vector4.h"
+#include "types.h"
+
+class Graph;
+class MessageActivateTokens;
+class MessageActivateTrail;
+class StorageAccess;
+
+// The dummy graph that the GraphController shows, together with the steps that build and layout
+// it. Graphs of activations are built into a separate GraphState off the scheduler thread, which
+// therefore must not use the view. The GraphController takes the state over once it is complete.
+class GraphState
+{
+public:
+	GraphState(StorageAccess* storageAccess);
+
+	std::shared_ptr<Graph> getGraph() const;
+
+	void setViewSize(const Vec2i& viewSize);
+
+	// the builds stop early and return false once isCancelled returns true
+	bool createTokenGraph(
+		const MessageActivateTokens& message,
+		const std::vector<Id>& expandedNodeIds,
+		GroupType grouping,
+		std::function<bool()> isCancelled,
+		bool* isNamespace);
+	void fetchTrailGraph(const MessageActivateTrail& message);
+	bool createTrailGraph(const MessageActivateTrail& message, std::function<bool()> isCancelled);
+
+protected:
+	void createDummyGraph(const std::shared_ptr<Graph> graph);
+	void createDummyGraphAndSetActiveAndVisibility(
+		const std::vector<Id>& tokenIds,
+		const std::shared_ptr<Graph> graph,
+		const std::vector<Id>& expandedNodeIds);
+	std::vector<std::shared_ptr<DummyNode>> createDummyNodeTopDown(Node* node, Id ancestorId);
+
+	void updateDummyNodeNamesAndAddQualifiers(const std::vector<std::shared_ptr<DummyNode>>& dummyNodes);
+
+	std::vector<Id> getExpandedNodeIds() const;
+	void setExpandedNodeIds(const std::vector<Id>& nodeIds);
+	void autoExpandActiveNode(const std::vector<Id>& activeTokenIds);
+
+	bool setActive(const std::vector<Id>& activeTokenIds, bool showAllEdges);
+	void setVisibility(bool noActive);
+	void setActiveAndVisibility(const std::vector<Id>& activeTokenIds);
+	bool setNodeActiveRecursive(DummyNode* node, const std::vector<Id>& activeTokenIds) const;
+	bool setNodeVisibilityRecursiveBottomUp(DummyNode* node, bool noActive) const;
+	void setNodeVisibilityRecursiveTopDown(DummyNode* node, bool parentExpanded) const;
+
+	void hideBuiltinTypes();
+
+	void bundleNodes();
+	void bundleNodesAndEdgesMatching(
+		std::function<bool(const DummyNode::BundleInfo&, const Node*)> matcher,
+		size_t count,
+		bool countConnectedNodes,
+		const std::wstring& name);
+	std::shared_ptr<DummyNode> bundleNodesMatching(
+		std::list<std::shared_ptr<DummyNode>>& nodes,
+		std::function<bool(const DummyNode*)> matcher,
+		const std::wstring& name);
+	std::shared_ptr<DummyNode> bundleByType(
+		std::list<std::shared_ptr<DummyNode>>& nodes,
+		const NodeType& type,
+		const Tree<NodeType::BundleInfo>& bundleInfoTree,
+		const bool considerInvisibleNodes);
+	void bundleNodesByType();
+
+	void addCharacterIndex();
+	bool hasCharacterIndex() const;
+
+	void groupNodesByParents(GroupType groupType);
+	DummyNode* groupAllNodes(GroupType groupType, Id groupNodeId);
+	void groupTrailNodes(GroupType groupType);
+
+	void layoutNesting();
+	void extendEqualFunctionNames(const std::vector<std::shared_ptr<DummyNode>>& nodes) const;
+	Vec4i layoutNestingRecursive(DummyNode* node, int relayoutAccessMaxWidth = -1) const;
+	void addExpandToggleNode(DummyNode* node) const;
+	void layoutToGrid(DummyNode* node) const;
+
+	// the layouts stop early once isCancelled returns true
+	void layoutGraph(
+		bool getSortedNodes = false, std::function<bool()> isCancelled = std::function<bool()>());
+	void layoutList();
+	void layoutTrail(
+		bool horizontal,
+		bool hasOrigin,
+		std::function<bool()> isCancelled = std::function<bool()>());
+
+	void assignBundleIds();
+
+	std::shared_ptr<DummyNode> getDummyGraphNodeById(Id tokenId) const;
+	DummyEdge* getDummyGraphEdgeById(Id tokenId) const;
+
+	void forEachDummyNodeRecursive(std::function<void(DummyNode*)> func);
+	void forEachDummyEdge(std::function<void(DummyEdge*)> func);
+
+	void createLegendGraph();
+
+	StorageAccess* m_storageAccess;
+
+	std::vector<std::shared_ptr<DummyNode>> m_dummyNodes;
+	std::vector<std::shared_ptr<DummyEdge>> m_dummyEdges;
+
+	std::map<Id, std::shared_ptr<DummyNode>> m_dummyGraphNodes;
+
+	std::vector<Id> m_activeNodeIds;
+	std::vector<Id> m_activeEdgeIds;
+
+	std::shared_ptr<Graph> m_graph;
+
+	std::map<Id, Id> m_topLevelAncestorIds;
+
+	bool m_useBezierEdges = false;
+	bool m_showsLegend = false;
+
+	Vec2i m_viewSize;
+};
+
+#endif	  // GRAPH_STATE_H
@@ -1,32 +1,57 @@
 #include "TrailLayouter.h"
 
+#include <algorithm>
+#include <deque>
 #include <iostream>
 
-TrailLayouter::TrailLayouter(LayoutDirection dir): m_direction(dir), m_rootNode(nullptr) {}
+namespace
+{
+const size_t s_noNode = ~size_t(0);
+
+// number of alternating upward and downward sweeps after the initial ordering of the columns
+const size_t s_crossingReductionSweepCount = 4;
+}	 // namespace
+
+TrailLayouter::TrailLayouter(LayoutDirection dir): m_direction(dir), m_rootNode(s_noNode) {}
 
 void TrailLayouter::layoutGraph(
 	std::vector<std::shared_ptr<DummyNode>>& dummyNodes,
 	const std::vector<std::shared_ptr<DummyEdge>>& dummyEdges,
-	const std::map<Id, Id>& topLevelAncestorIds)
+	const std::map<Id, Id>& topLevelAncestorIds,
+	std::function<bool()> isCancelled)
 {
+	auto cancelled = [&isCancelled]() { return isCancelled && isCancelled(); };
+
 	buildGraph(dummyNodes, dummyEdges, topLevelAncestorIds);
 
-	if (!m_rootNode)
+	if (m_rootNode == s_noNode || cancelled())
 	{
 		return;
 	}
 
 	removeDeadEnds();
-	makeAcyclicRecursive(m_rootNode, std::set<TrailNode*>());
+	makeAcyclic();
 
 	assignLongestPathLevels();
-	assignRemainingLevels();
 
 	addVirtualNodes();
+	if (cancelled())
+	{
+		return;
+	}
 
 	buildColumns();
 	reduceEdgeCrossings();
+	if (cancelled())
+	{
+		return;
+	}
+
 	layout();
+	if (cancelled())
+	{
+		return;
+	}
 
 	retrievePositions(topLevelAncestorIds);
 
@@ -59,78 +84,85 @@ void TrailLayouter::buildGraph(
 
 void TrailLayouter::removeDeadEnds()
 {
-	std::set<TrailNode*> predecessors;
+	std::vector<char> visited(m_nodes.size(), 0);
+	size_t visitedCount = 0;
 
-	std::set<TrailNode*> deadEnds;
-	std::set<TrailNode*> loseEnds;
+	std::set<size_t> deadEnds;
+	std::set<size_t> loseEnds;
 
-	std::deque<TrailNode*> nodes;
+	std::deque<size_t> nodes;
 	nodes.push_back(m_rootNode);
 
 	while (nodes.size())
 	{
-		TrailNode* node = nodes.front();
+		const size_t nodeIndex = nodes.front();
 		nodes.pop_front();
 
-		if (predecessors.find(node) == predecessors.end())
+		if (!visited[nodeIndex])
 		{
-			predecessors.insert(node);
+			visited[nodeIndex] = 1;
+			visitedCount++;
 
-			for (TrailEdge* edge: node->outgoingEdges)
+			const TrailNode& node = m_nodes[nodeIndex];
+			for (size_t edgeIndex: node.outgoingEdges)
 			{
-				if (predecessors.find(edge->target) == predecessors.end())
+				if (!visited[m_edges[edgeIndex].target])
 				{
-					nodes.push_back(edge->target);
+					nodes.push_back(m_edges[edgeIndex].target);
 				}
 			}
 
-			for (TrailEdge* edge: node->incomingEdges)
+			for (size_t edgeIndex: node.incomingEdges)
 			{
-				if (predecessors.find(edge->origin) == predecessors.end())
+				if (!visited[m_edges[edgeIndex].origin])
 				{
-					loseEnds.insert(edge->origin);
+					loseEnds.insert(m_edges[edgeIndex].origin);
 				}
 			}
 
-			if (!node->outgoingEdges.size())
+			if (!node.outgoingEdges.size())
 			{
-				deadEnds.insert(node);
+				deadEnds.insert(nodeIndex);
 			}
 		}
 
 		while (!nodes.size() && (deadEnds.size() || loseEnds.size()) &&
-			   predecessors.size() < m_allNodes.size())
+			   visitedCount < m_nodes.size())
 		{
 			if (deadEnds.size())
 			{
-				TrailNode* deadEnd = *deadEnds.begin();
+				const size_t deadEnd = *deadEnds.begin();
 				deadEnds.erase(deadEnds.begin());
 
-				for (TrailEdge* edge: deadEnd->incomingEdges)
+				const std::vector<size_t>& edges = m_nodes[deadEnd].incomingEdges;
+				auto it = std::find_if(edges.begin(), edges.end(), [&](size_t edgeIndex) {
+					return !visited[m_edges[edgeIndex].origin];
+				});
+
+				if (it != edges.end())
 				{
-					if (predecessors.find(edge->origin) == predecessors.end())
-					{
-						nodes.push_back(edge->origin);
-						switchEdge(edge);
-						break;
-					}
+					const size_t edgeIndex = *it;
+					nodes.push_back(m_edges[edgeIndex].origin);
+					switchEdge(edgeIndex);
 				}
 			}
 			else
 			{
-				TrailNode* loseEnd = *loseEnds.begin();
+				const size_t loseEnd = *loseEnds.begin();
 				loseEnds.erase(loseEnds.begin());
 
-				if (predecessors.find(loseEnd) == predecessors.end())
+				if (!visited[loseEnd])
 				{
-					for (TrailEdge* edge: loseEnd->outgoingEdges)
+					const std::vector<size_t>& edges = m_nodes[loseEnd].outgoingEdges;
+					auto it = std::find_if(edges.begin(), edges.end(), [&](size_t edgeIndex) {
+						return visited[m_edges[edgeIndex].target];
+					});
+
+					if (it != edges.end())
 					{
-						if (predecessors.find(edge->target) != predecessors.end())
-						{
-							nodes.push_back(loseEnd);
-							switchEdge(edge);
-							break;
-						}
+						const size_t edgeIndex = *it;
+						nodes.push_back(loseEnd);
+						switchEdge(edgeIndex);
 					}
 				}
 			}
@@ -138,184 +170,183 @@ void TrailLayouter::removeDeadEnds()
 	}
 }
 
-void TrailLayouter::makeAcyclicRecursive(TrailNode* node, std::set<TrailNode*> predecessors)
+void TrailLayouter::makeAcyclic()
 {
-	predecessors.insert(node);
+	// depth first search from the root, edges pointing back to a node on the stack close a cycle
+	enum NodeState : char
+	{
+		STATE_UNVISITED,
+		STATE_ON_STACK,
+		STATE_DONE
+	};
+
+	std::vector<char> states(m_nodes.size(), STATE_UNVISITED);
+	std::vector<size_t> edgesToSwitch;
+
+	// node index and position of the next outgoing edge to follow
+	std::vector<std::pair<size_t, size_t>> stack;
+	stack.emplace_back(m_rootNode, 0);
+	states[m_rootNode] = STATE_ON_STACK;
 
-	std::set<TrailEdge*> edgesToSwitch;
-	for (TrailEdge* edge: node->outgoingEdges)
+	while (stack.size())
 	{
-		if (predecessors.find(edge->target) != predecessors.end())
+		const size_t nodeIndex = stack.back().first;
+		const std::vector<size_t>& edges = m_nodes[nodeIndex].outgoingEdges;
+
+		if (stack.back().second == edges.size())
 		{
-			edgesToSwitch.insert(edge);
+			states[nodeIndex] = STATE_DONE;
+			stack.pop_back();
+			continue;
 		}
-		else
+
+		const size_t edgeIndex = edges[stack.back().second++];
+		const size_t target = m_edges[edgeIndex].target;
+
+		if (states[target] == STATE_ON_STACK)
+		{
+			edgesToSwitch.push_back(edgeIndex);
+		}
+		else if (states[target] == STATE_UNVISITED)
 		{
-			makeAcyclicRecursive(edge->target, predecessors);
+			states[target] = STATE_ON_STACK;
+			stack.emplace_back(target, 0);
 		}
 	}
 
-	for (TrailEdge* edge: edgesToSwitch)
+	for (size_t edgeIndex: edgesToSwitch)
 	{
-		switchEdge(edge);
+		switchEdge(edgeIndex);
 	}
 }
 
 void TrailLayouter::assignLongestPathLevels()
 {
-	std::set<TrailNode*> nodes;
-	nodes.insert(m_rootNode);
-
-	std::map<TrailNode*, TrailNode*> predecessorNodes;
+	// the nodes reachable from the root form an acyclic graph, so visiting them in topological
+	// order assigns each node the length of the longest path from the root
+	std::vector<size_t> incomingEdgeCounts(m_nodes.size(), 0);
+	std::vector<char> reachable(m_nodes.size(), 0);
 
-	int level = 0;
+	std::vector<size_t> nodes;
+	nodes.push_back(m_rootNode);
+	reachable[m_rootNode] = 1;
 
-	while (nodes.size())
+	for (size_t i = 0; i < nodes.size(); i++)
 	{
-		std::set<TrailNode*> newNodes;
-
-		for (TrailNode* node: nodes)
+		for (size_t edgeIndex: m_nodes[nodes[i]].outgoingEdges)
 		{
-			for (TrailEdge* edge: node->outgoingEdges)
+			const size_t target = m_edges[edgeIndex].target;
+			incomingEdgeCounts[target]++;
+
+			if (!reachable[target])
 			{
-				newNodes.insert(edge->target);
-				predecessorNodes[edge->target] = node;
+				reachable[target] = 1;
+				nodes.push_back(target);
 			}
 		}
-
-		if (!newNodes.size())
-		{
-			break;
-		}
-
-		nodes = newNodes;
-		level++;
 	}
 
-	while (nodes.size())
+	nodes.clear();
+	nodes.push_back(m_rootNode);
+	m_nodes[m_rootNode].level = 0;
+
+	for (size_t i = 0; i < nodes.size(); i++)
 	{
-		std::set<TrailNode*> newNodes;
+		const int level = m_nodes[nodes[i]].level;
 
-		for (TrailNode* node: nodes)
+		for (size_t edgeIndex: m_nodes[nodes[i]].outgoingEdges)
 		{
-			node->level = level;
+			const size_t target = m_edges[edgeIndex].target;
+			m_nodes[target].level = std::max(m_nodes[target].level, level + 1);
 
-			if (level > 0)
+			if (--incomingEdgeCounts[target] == 0)
 			{
-				newNodes.insert(predecessorNodes[node]);
+				nodes.push_back(target);
 			}
 		}
-
-		nodes = newNodes;
-		level--;
 	}
 }
 
-void TrailLayouter::assignRemainingLevels()
+void TrailLayouter::addVirtualNodes()
 {
-	std::multimap<int, TrailNode*> nodes;
-	nodes.emplace(m_rootNode->level, m_rootNode);
-
-	std::set<TrailNode*> allNodes;
-	allNodes.insert(m_rootNode);
+	const size_t edgeCount = m_edges.size();
 
-	while (nodes.size())
+	size_t virtualNodeCount = 0;
+	for (const TrailEdge& edge: m_edges)
 	{
-		std::multimap<int, TrailNode*> newNodes;
-
-		for (std::pair<int, TrailNode*> p: nodes)
-		{
-			TrailNode* node = p.second;
-
-			for (TrailEdge* edge: node->outgoingEdges)
-			{
-				if (allNodes.insert(edge->target).second)
-				{
-					newNodes.emplace(edge->target->level, edge->target);
-				}
-			}
+		virtualNodeCount += std::max(
+			m_nodes[edge.target].level - m_nodes[edge.origin].level - 1, 0);
+	}
 
-			if (node->level < 0)
-			{
-				int level = -1;
+	m_nodes.reserve(m_nodes.size() + virtualNodeCount);
+	m_edges.reserve(m_edges.size() + virtualNodeCount);
 
-				for (TrailEdge* edge: node->incomingEdges)
-				{
-					if (edge->origin->level == -1)
-					{
-						if (allNodes.insert(edge->origin).second)
-						{
-							newNodes.emplace(edge->origin->level, edge->origin);
-						}
-
-						level = node->level;
-						newNodes.emplace(level, node);
-						break;
-					}
-					else
-					{
-						level = std::max(level, edge->origin->level + 1);
-					}
-				}
+	for (size_t edgeIndex = 0; edgeIndex < edgeCount; edgeIndex++)
+	{
+		const int originLevel = m_nodes[m_edges[edgeIndex].origin].level;
+		const int targetLevel = m_nodes[m_edges[edgeIndex].target].level;
 
-				node->level = level;
-			}
-		}
+		for (int i = originLevel + 1; i < targetLevel; i++)
+		{
+			const size_t virtualNodeIndex = m_nodes.size();
+			const size_t virtualEdgeIndex = m_edges.size();
 
-		nodes = newNodes;
-	}
-}
+			TrailNode virtualNode;
+			virtualNode.id = 0;
+			virtualNode.name = L"<virtual>";
+			virtualNode.dummyNode = nullptr;
+			virtualNode.level = i;
 
-void TrailLayouter::addVirtualNodes()
-{
-	std::vector<std::shared_ptr<TrailEdge>> newEdges;
+			virtualNode.size = Vec2i(50, 20);
 
-	for (const std::shared_ptr<TrailEdge>& edge: m_allEdges)
-	{
-		for (int i = edge->origin->level + 1; i < edge->target->level; i++)
-		{
-			std::shared_ptr<TrailNode> virtualNode = std::make_shared<TrailNode>();
-			virtualNode->id = 0;
-			virtualNode->name = L"<virtual>";
-			virtualNode->dummyNode = nullptr;
-			virtualNode->level = i;
+			virtualNode.incomingEdges.push_back(virtualEdgeIndex);
+			virtualNode.outgoingEdges.push_back(edgeIndex);
 
-			virtualNode->size = Vec2i(50, 20);
+			m_nodes.push_back(std::move(virtualNode));
 
-			m_allNodes.push_back(virtualNode);
-			edge->virtualNodes.push_back(virtualNode.get());
 
+			TrailEdge virtualEdge;
+			virtualEdge.id = 0;
 
-			std::shared_ptr<TrailEdge> virtualEdge = std::make_shared<TrailEdge>();
-			virtualEdge->id = 0;
+			virtualEdge.origin = m_edges[edgeIndex].origin;
+			std::vector<size_t>& originEdges = m_nodes[virtualEdge.origin].outgoingEdges;
+			std::replace(originEdges.begin(), originEdges.end(), edgeIndex, virtualEdgeIndex);
 
-			virtualEdge->origin = edge->origin;
-			virtualEdge->origin->outgoingEdges.erase(edge.get());
-			virtualEdge->origin->outgoingEdges.insert(virtualEdge.get());
+			virtualEdge.target = virtualNodeIndex;
 
-			virtualEdge->target = virtualNode.get();
-			virtualEdge->target->incomingEdges.insert(virtualEdge.get());
-			virtualEdge->target->outgoingEdges.insert(edge.get());
+			m_edges.push_back(std::move(virtualEdge));
 
-			edge->origin = virtualNode.get();
-			newEdges.push_back(virtualEdge);
+			m_edges[edgeIndex].origin = virtualNodeIndex;
+			m_edges[edgeIndex].virtualNodes.push_back(virtualNodeIndex);
 		}
 	}
-
-	m_allEdges.insert(m_allEdges.end(), newEdges.begin(), newEdges.end());
 }
 
 void TrailLayouter::buildColumns()
 {
-	for (const std::shared_ptr<TrailNode>& node: m_allNodes)
+	for (size_t nodeIndex = 0; nodeIndex < m_nodes.size(); nodeIndex++)
 	{
-		const int level = node->level + 1;
+		const int level = m_nodes[nodeIndex].level + 1;
 		for (int i = static_cast<int>(m_nodesPerCol.size()); i <= level; i++)
 		{
-			m_nodesPerCol.push_back(std::vector<TrailNode*>());
+			m_nodesPerCol.push_back(std::vector<size_t>());
 		}
 
-		m_nodesPerCol[level].push_back(node.get());
+		m_nodesPerCol[level].push_back(nodeIndex);
+	}
+
+	updateNodePositionsInCol();
+}
+
+void TrailLayouter::updateNodePositionsInCol()
+{
+	m_nodePositionsInCol.resize(m_nodes.size());
+	for (const std::vector<size_t>& nodes: m_nodesPerCol)
+	{
+		for (size_t j = 0; j < nodes.size(); j++)
+		{
+			m_nodePositionsInCol[nodes[j]] = j;
+		}
 	}
 }
 
@@ -323,63 +354,145 @@ void TrailLayouter::reduceEdgeCrossings()
 {
 	for (size_t i = 1; i < m_nodesPerCol.size(); i++)
 	{
-		std::vector<TrailNode*> nodes = m_nodesPerCol[i];
+		const bool usePredecessors = m_nodesPerCol[i - 1].size() != 1 ||
+			i + 1 == m_nodesPerCol.size() || m_nodesPerCol[i + 1].empty();
+
+		orderColumnByNeighbors(i, usePredecessors);
+	}
+
+	size_t edgeCrossingCount = getEdgeCrossingCount();
+	std::vector<std::vector<size_t>> bestNodesPerCol = m_nodesPerCol;
 
-		bool usePredecessors = true;
-		std::vector<TrailNode*> neighbors = m_nodesPerCol[i - 1];
-		if (neighbors.size() == 1 && i + 1 < m_nodesPerCol.size() && m_nodesPerCol[i + 1].size() > 0)
+	// Each sweep orders the columns by the positions of their neighbors in the previous column,
+	// alternating between upward and downward direction. The order with fewest crossings is kept.
+	for (size_t sweep = 0; sweep < s_crossingReductionSweepCount && edgeCrossingCount; sweep++)
+	{
+		if (sweep % 2 == 0)
 		{
-			neighbors = m_nodesPerCol[i + 1];
-			usePredecessors = false;
+			for (size_t i = m_nodesPerCol.size() - 1; i > 0; i--)
+			{
+				orderColumnByNeighbors(i - 1, false);
+			}
+		}
+		else
+		{
+			for (size_t i = 1; i < m_nodesPerCol.size(); i++)
+			{
+				orderColumnByNeighbors(i, true);
+			}
 		}
 
-		std::map<TrailNode*, size_t> neighborIndices;
-		for (size_t j = 0; j < neighbors.size(); j++)
+		const size_t count = getEdgeCrossingCount();
+		if (count < edgeCrossingCount)
 		{
-			neighborIndices.emplace(neighbors[j], j);
+			edgeCrossingCount = count;
+			bestNodesPerCol = m_nodesPerCol;
 		}
+	}
 
-		std::multimap<float, TrailNode*> newOrder;
+	m_nodesPerCol = bestNodesPerCol;
+	updateNodePositionsInCol();
+}
 
-		for (size_t j = 0; j < nodes.size(); j++)
-		{
-			TrailNode* node = nodes[j];
+void TrailLayouter::orderColumnByNeighbors(size_t col, bool usePredecessors)
+{
+	std::vector<size_t>& nodes = m_nodesPerCol[col];
 
-			size_t sum = 0;
-			size_t count = 0;
+	std::vector<std::pair<float, size_t>> newOrder;
+	newOrder.reserve(nodes.size());
 
-			if (usePredecessors)
+	for (size_t j = 0; j < nodes.size(); j++)
+	{
+		const TrailNode& node = m_nodes[nodes[j]];
+
+		size_t sum = 0;
+		size_t count = 0;
+
+		if (usePredecessors)
+		{
+			for (size_t edgeIndex: node.incomingEdges)
 			{
-				for (TrailEdge* edge: node->incomingEdges)
-				{
-					sum += neighborIndices[edge->origin];
-					count++;
-				}
+				sum += m_nodePositionsInCol[m_edges[edgeIndex].origin];
+				count++;
 			}
-			else
+		}
+		else
+		{
+			for (size_t edgeIndex: node.outgoingEdges)
 			{
-				for (TrailEdge* edge: node->outgoingEdges)
-				{
-					sum += neighborIndices[edge->target];
-					count++;
-				}
+				sum += m_nodePositionsInCol[m_edges[edgeIndex].target];
+				count++;
 			}
+		}
+
+		float value = float(j);
+		if (count)
+		{
+			value = float(sum) / count;
+		}
+		newOrder.emplace_back(value, nodes[j]);
+	}
+
+	std::stable_sort(
+		newOrder.begin(),
+		newOrder.end(),
+		[](const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) {
+			return a.first < b.first;
+		});
+
+	for (size_t j = 0; j < newOrder.size(); j++)
+	{
+		nodes[j] = newOrder[j].second;
+		m_nodePositionsInCol[nodes[j]] = j;
+	}
+}
+
+size_t TrailLayouter::getEdgeCrossingCount() const
+{
+	size_t crossingCount = 0;
+
+	std::vector<std::pair<size_t, size_t>> edgePositions;
+	std::vector<size_t> tree;
 
-			float value = float(j);
-			if (count)
+	for (size_t i = 0; i + 1 < m_nodesPerCol.size(); i++)
+	{
+		edgePositions.clear();
+		for (size_t nodeIndex: m_nodesPerCol[i])
+		{
+			for (size_t edgeIndex: m_nodes[nodeIndex].outgoingEdges)
 			{
-				value = float(sum) / count;
+				const size_t target = m_edges[edgeIndex].target;
+				if (m_nodes[target].level == m_nodes[nodeIndex].level + 1)
+				{
+					edgePositions.emplace_back(
+						m_nodePositionsInCol[nodeIndex], m_nodePositionsInCol[target]);
+				}
 			}
-			newOrder.emplace(value, node);
 		}
 
-		nodes.clear();
-		for (std::pair<float, TrailNode*> p: newOrder)
+		std::sort(edgePositions.begin(), edgePositions.end());
+
+		// Two edges cross if their targets are in the opposite order of their origins. The edges
+		// with a target before or at the current one are counted with a binary indexed tree.
+		tree.assign(m_nodesPerCol[i + 1].size() + 1, 0);
+		for (size_t j = 0; j < edgePositions.size(); j++)
 		{
-			nodes.push_back(p.second);
+			size_t previousCount = 0;
+			for (size_t k = edgePositions[j].second + 1; k > 0; k -= k & (~k + 1))
+			{
+				previousCount += tree[k];
+			}
+
+			crossingCount += j - previousCount;
+
+			for (size_t k = edgePositions[j].second + 1; k < tree.size(); k += k & (~k + 1))
+			{
+				tree[k]++;
+			}
 		}
-		m_nodesPerCol[i] = nodes;
 	}
+
+	return crossingCount;
 }
 
 void TrailLayouter::layout()
@@ -396,15 +509,14 @@ void TrailLayouter::layout()
 
 	for (size_t i = 0; i < m_nodesPerCol.size(); i++)
 	{
-		std::vector<TrailNode*>& nodes = m_nodesPerCol[i];
-
 		int width = 0;
 		int height = -30;
 
-		for (TrailNode* node: nodes)
+		for (size_t nodeIndex: m_nodesPerCol[i])
 		{
-			height += node->size.getValue(yIdx) + 30;
-			width = std::max(width, node->size.getValue(xIdx));
+			const TrailNode& node = m_nodes[nodeIndex];
+			height += node.size.getValue(yIdx) + 30;
+			width = std::max(width, node.size.getValue(xIdx));
 		}
 
 		widthsPerCol.push_back(width);
@@ -421,17 +533,17 @@ void TrailLayouter::layout()
 	int x = 0;
 	for (size_t i = 0; i < m_nodesPerCol.size(); i++)
 	{
-		std::vector<TrailNode*>& nodes = m_nodesPerCol[i];
 		int y = -heightsPerCol[i] / 2;
 
-		for (TrailNode* node: nodes)
+		for (size_t nodeIndex: m_nodesPerCol[i])
 		{
-			node->pos = horizontalLayout() ? Vec2i(x, y) : Vec2i(y, x);
-			y += node->size.getValue(yIdx) + 30;
+			TrailNode& node = m_nodes[nodeIndex];
+			node.pos = horizontalLayout() ? Vec2i(x, y) : Vec2i(y, x);
+			y += node.size.getValue(yIdx) + 30;
 
-			if (!node->id)
+			if (!node.id)
 			{
-				node->size.setValue(xIdx, widthsPerCol[i]);
+				node.size.setValue(xIdx, widthsPerCol[i]);
 			}
 		}
 
@@ -465,36 +577,40 @@ void TrailLayouter::layout()
 	// put into grid
 }
 
-void TrailLayouter::moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bool forward)
+void TrailLayouter::moveNodesToAveragePosition(const std::vector<size_t>& nodes, bool forward)
 {
 	unsigned int yIdx = horizontalLayout() ? 1 : 0;
 
-	std::map<int, std::vector<TrailNode*>> averagePositions;
-	for (TrailNode* node: nodes)
+	std::map<int, std::vector<size_t>> averagePositions;
+	for (size_t nodeIndex: nodes)
 	{
+		const TrailNode& node = m_nodes[nodeIndex];
+
 		int sum = 0;
 		int count = 0;
 
-		if ((forward && node->incomingEdges.size()) || (!forward && !node->outgoingEdges.size()))
+		if ((forward && node.incomingEdges.size()) || (!forward && !node.outgoingEdges.size()))
 		{
-			for (TrailEdge* edge: node->incomingEdges)
+			for (size_t edgeIndex: node.incomingEdges)
 			{
-				sum += edge->origin->pos.getValue(yIdx) + edge->origin->size.getValue(yIdx) / 2;
+				const TrailNode& origin = m_nodes[m_edges[edgeIndex].origin];
+				sum += origin.pos.getValue(yIdx) + origin.size.getValue(yIdx) / 2;
 				count++;
 			}
 		}
 		else
 		{
-			for (TrailEdge* edge: node->outgoingEdges)
+			for (size_t edgeIndex: node.outgoingEdges)
 			{
-				sum += edge->target->pos.getValue(yIdx) + edge->target->size.getValue(yIdx) / 2;
+				const TrailNode& target = m_nodes[m_edges[edgeIndex].target];
+				sum += target.pos.getValue(yIdx) + target.size.getValue(yIdx) / 2;
 				count++;
 			}
 		}
 
 		if (count)
 		{
-			averagePositions[sum / count].push_back(node);
+			averagePositions[sum / count].push_back(nodeIndex);
 		}
 	}
 
@@ -504,7 +620,7 @@ void TrailLayouter::moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bo
 	}
 
 	int averagePosition = 0;
-	for (const std::pair<int, std::vector<TrailNode*>>& p: averagePositions)
+	for (const std::pair<int, std::vector<size_t>>& p: averagePositions)
 	{
 		averagePosition += p.first;
 	}
@@ -512,7 +628,7 @@ void TrailLayouter::moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bo
 
 
 	std::multimap<int, int> distanceFromAveragePosition;
-	for (std::pair<int, std::vector<TrailNode*>> p: averagePositions)
+	for (const std::pair<int, std::vector<size_t>>& p: averagePositions)
 	{
 		distanceFromAveragePosition.emplace(std::abs(averagePosition - p.first), p.first);
 	}
@@ -523,12 +639,12 @@ void TrailLayouter::moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bo
 	for (std::pair<int, int> p: distanceFromAveragePosition)
 	{
 		int groupAveragePosition = p.second;
-		std::vector<TrailNode*> nodeGroup = averagePositions.find(groupAveragePosition)->second;
+		const std::vector<size_t>& nodeGroup = averagePositions.find(groupAveragePosition)->second;
 
 		int size = -30;
-		for (TrailNode* node: nodeGroup)
+		for (size_t nodeIndex: nodeGroup)
 		{
-			size += node->size.getValue(yIdx) + 30;
+			size += m_nodes[nodeIndex].size.getValue(yIdx) + 30;
 		}
 
 		int top = groupAveragePosition - size / 2;
@@ -563,10 +679,11 @@ void TrailLayouter::moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bo
 
 		int y = top;
 
-		for (TrailNode* node: nodeGroup)
+		for (size_t nodeIndex: nodeGroup)
 		{
-			node->pos.setValue(yIdx, y);
-			y += node->size.getValue(yIdx) + 30;
+			TrailNode& node = m_nodes[nodeIndex];
+			node.pos.setValue(yIdx, y);
+			y += node.size.getValue(yIdx) + 30;
 		}
 
 		if (currentTop == currentBottom)
@@ -587,38 +704,38 @@ void TrailLayouter::moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bo
 
 void TrailLayouter::retrievePositions(const std::map<Id, Id>& topLevelAncestorIds)
 {
-	for (std::shared_ptr<TrailNode>& node: m_allNodes)
+	for (const TrailNode& node: m_nodes)
 	{
-		if (node->dummyNode)
+		if (node.dummyNode)
 		{
-			if (node->level != -1)
+			if (node.level != -1)
 			{
-				node->dummyNode->position = node->pos;
+				node.dummyNode->position = node.pos;
 			}
 			else
 			{
-				node->dummyNode->visible = false;
+				node.dummyNode->visible = false;
 			}
 		}
 	}
 
-	for (std::shared_ptr<TrailEdge>& edge: m_allEdges)
+	for (const TrailEdge& edge: m_edges)
 	{
-		if (edge->virtualNodes.size())
+		if (edge.virtualNodes.size())
 		{
-			for (DummyEdge* dummyEdge: edge->dummyEdges)
+			for (DummyEdge* dummyEdge: edge.dummyEdges)
 			{
-				bool forward = edge->target->id ==
+				bool forward = m_nodes[edge.target].id ==
 					topLevelAncestorIds.find(dummyEdge->targetId)->second;
-				for (size_t i = 0; i < edge->virtualNodes.size(); i++)
+				for (size_t i = 0; i < edge.virtualNodes.size(); i++)
 				{
-					TrailNode* node =
-						edge->virtualNodes[forward ? i : edge->virtualNodes.size() - 1 - i];
+					const TrailNode& node =
+						m_nodes[edge.virtualNodes[forward ? i : edge.virtualNodes.size() - 1 - i]];
 					dummyEdge->path.push_back(Vec4i(
-						node->pos.x,
-						node->pos.y,
-						node->pos.x + node->size.x,
-						node->pos.y + node->size.y));
+						node.pos.x,
+						node.pos.y,
+						node.pos.x + node.size.x,
+						node.pos.y + node.size.y));
 				}
 			}
 		}
@@ -628,23 +745,24 @@ void TrailLayouter::retrievePositions(const std::map<Id, Id>& topLevelAncestorId
 void TrailLayouter::print()
 {
 	std::cout << "graph: " << std::endl;
-	for (std::shared_ptr<TrailNode>& node: m_allNodes)
+	for (const TrailNode& node: m_nodes)
 	{
-		if (node->id)
+		if (node.id)
 		{
-			std::cout << node->id << "\t" << node->level << "\t";
-			std::cout << node->incomingEdges.size() << "\t" << node->outgoingEdges.size() << "\t";
-			std::wcout << node->name << std::endl;
+			std::cout << node.id << "\t" << node.level << "\t";
+			std::cout << node.incomingEdges.size() << "\t" << node.outgoingEdges.size() << "\t";
+			std::wcout << node.name << std::endl;
 		}
 	}
 	std::cout << std::endl;
 
-	for (std::shared_ptr<TrailEdge>& edge: m_allEdges)
+	for (const TrailEdge& edge: m_edges)
 	{
-		if (edge->origin->id || edge->target->id)
+		const TrailNode& origin = m_nodes[edge.origin];
+		const TrailNode& target = m_nodes[edge.target];
+		if (origin.id || target.id)
 		{
-			std::wcout << edge->id << L"\t" << edge->origin->name << L"\t" << edge->target->name
-					   << std::endl;
+			std::wcout << edge.id << L"\t" << origin.name << L"\t" << target.name << std::endl;
 		}
 	}
 	std::cout << std::endl;
@@ -652,38 +770,37 @@ void TrailLayouter::print()
 
 void TrailLayouter::addNode(const std::shared_ptr<DummyNode>& dummyNode)
 {
-	std::shared_ptr<TrailNode> node = std::make_shared<TrailNode>();
-	node->id = dummyNode->tokenId;
-	node->name = dummyNode->name;
-	node->dummyNode = dummyNode.get();
-	node->level = -1;
+	const size_t nodeIndex = m_nodes.size();
 
-	node->size = dummyNode->size;
+	TrailNode node;
+	node.id = dummyNode->tokenId;
+	node.name = dummyNode->name;
+	node.dummyNode = dummyNode.get();
+	node.level = -1;
 
-	m_allNodes.push_back(node);
+	node.size = dummyNode->size;
 
-	if (node->id)
+	if (node.id)
 	{
-		m_nodesById.emplace(node->id, node.get());
+		m_nodesById.emplace(node.id, nodeIndex);
 	}
 
-	if (!m_rootNode && dummyNode->hasActiveSubNode())
+	m_nodes.push_back(std::move(node));
+
+	if (m_rootNode == s_noNode && dummyNode->hasActiveSubNode())
 	{
-		m_rootNode = node.get();
+		m_rootNode = nodeIndex;
 	}
 }
 
 void TrailLayouter::addEdge(
 	const std::shared_ptr<DummyEdge> dummyEdge, const std::map<Id, Id>& topLevelAncestorIds)
 {
-	std::shared_ptr<TrailEdge> edge = std::make_shared<TrailEdge>();
 	if (!dummyEdge->data)
 	{
 		return;
 	}
 
-	edge->id = dummyEdge->data->getId();
-
 	Id originTopLevelId = topLevelAncestorIds.find(dummyEdge->ownerId)->second;
 	Id targetTopLevelId = topLevelAncestorIds.find(dummyEdge->targetId)->second;
 
@@ -700,36 +817,43 @@ void TrailLayouter::addEdge(
 		return;
 	}
 
-	edge->origin = origin->second;
-	edge->target = target->second;
-
-	for (std::shared_ptr<TrailEdge>& e: m_allEdges)
+	// edges in both directions between the same nodes are merged
+	const std::pair<size_t, size_t> nodes = std::minmax(origin->second, target->second);
+	auto it = m_edgesByNodes.find(nodes);
+	if (it != m_edgesByNodes.end())
 	{
-		if ((e->origin == edge->origin && e->target == edge->target) ||
-			(e->origin == edge->target && e->target == edge->origin))
-		{
-			e->dummyEdges.push_back(dummyEdge.get());
-			return;
-		}
+		m_edges[it->second].dummyEdges.push_back(dummyEdge.get());
+		return;
 	}
 
-	edge->dummyEdges.push_back(dummyEdge.get());
+	const size_t edgeIndex = m_edges.size();
 
-	edge->origin->outgoingEdges.insert(edge.get());
-	edge->target->incomingEdges.insert(edge.get());
+	TrailEdge edge;
+	edge.id = dummyEdge->data->getId();
+	edge.origin = origin->second;
+	edge.target = target->second;
+	edge.dummyEdges.push_back(dummyEdge.get());
 
-	m_allEdges.push_back(edge);
+	m_nodes[edge.origin].outgoingEdges.push_back(edgeIndex);
+	m_nodes[edge.target].incomingEdges.push_back(edgeIndex);
+
+	m_edgesByNodes.emplace(nodes, edgeIndex);
+	m_edges.push_back(std::move(edge));
 }
 
-void TrailLayouter::switchEdge(TrailEdge* edge)
+void TrailLayouter::switchEdge(size_t edgeIndex)
 {
-	edge->origin->outgoingEdges.erase(edge);
-	edge->origin->incomingEdges.insert(edge);
+	TrailEdge& edge = m_edges[edgeIndex];
+
+	std::vector<size_t>& originEdges = m_nodes[edge.origin].outgoingEdges;
+	originEdges.erase(std::find(originEdges.begin(), originEdges.end(), edgeIndex));
+	m_nodes[edge.origin].incomingEdges.push_back(edgeIndex);
 
-	edge->target->incomingEdges.erase(edge);
-	edge->target->outgoingEdges.insert(edge);
+	std::vector<size_t>& targetEdges = m_nodes[edge.target].incomingEdges;
+	targetEdges.erase(std::find(targetEdges.begin(), targetEdges.end(), edgeIndex));
+	m_nodes[edge.target].outgoingEdges.push_back(edgeIndex);
 
-	std::swap(edge->origin, edge->target);
+	std::swap(edge.origin, edge.target);
 }
 
 bool TrailLayouter::horizontalLayout() const
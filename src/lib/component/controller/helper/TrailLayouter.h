@@ -1,6 +1,7 @@
 #ifndef GRAPH_LAYOUTER_H
 #define GRAPH_LAYOUTER_H
 
+#include <functional>
 #include <map>
 #include <set>
 #include <vector>
@@ -23,14 +24,15 @@ public:
 
 	TrailLayouter(LayoutDirection dir);
 
+	// stops between the layout stages and leaves the nodes unchanged once isCancelled returns true
 	void layoutGraph(
 		std::vector<std::shared_ptr<DummyNode>>& dummyNodes,
 		const std::vector<std::shared_ptr<DummyEdge>>& dummyEdges,
-		const std::map<Id, Id>& topLevelAncestorIds);
+		const std::map<Id, Id>& topLevelAncestorIds,
+		std::function<bool()> isCancelled = std::function<bool()>());
 
 private:
-	struct TrailEdge;
-
+	// nodes and edges refer to each other by their index in m_nodes and m_edges
 	struct TrailNode
 	{
 		Id id;
@@ -40,8 +42,8 @@ private:
 		Vec2i pos;
 		Vec2i size;
 
-		std::set<TrailEdge*> incomingEdges;
-		std::set<TrailEdge*> outgoingEdges;
+		std::vector<size_t> incomingEdges;
+		std::vector<size_t> outgoingEdges;
 
 		DummyNode* dummyNode;
 	};
@@ -49,10 +51,10 @@ private:
 	struct TrailEdge
 	{
 		Id id;
-		TrailNode* origin;
-		TrailNode* target;
+		size_t origin;
+		size_t target;
 
-		std::vector<TrailNode*> virtualNodes;
+		std::vector<size_t> virtualNodes;
 
 		std::vector<DummyEdge*> dummyEdges;
 	};
@@ -63,37 +65,41 @@ private:
 		const std::map<Id, Id>& topLevelAncestorIds);
 
 	void removeDeadEnds();
-	void makeAcyclicRecursive(TrailNode* node, std::set<TrailNode*> predecessors);
+	void makeAcyclic();
 
 	void assignLongestPathLevels();
-	void assignRemainingLevels();
 
 	void addVirtualNodes();
 	void buildColumns();
+	void updateNodePositionsInCol();
 	void reduceEdgeCrossings();
+	void orderColumnByNeighbors(size_t col, bool usePredecessors);
+	size_t getEdgeCrossingCount() const;
 
 	void layout();
-	void moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bool forward);
+	void moveNodesToAveragePosition(const std::vector<size_t>& nodes, bool forward);
 	void retrievePositions(const std::map<Id, Id>& topLevelAncestorIds);
 
 	void print();
 
 	void addNode(const std::shared_ptr<DummyNode>& dummyNode);
 	void addEdge(const std::shared_ptr<DummyEdge> dummyEdge, const std::map<Id, Id>& topLevelAncestorIds);
-	void switchEdge(TrailEdge* edge);
+	void switchEdge(size_t edgeIndex);
 
 	bool horizontalLayout() const;
 	bool invertedLayout() const;
 
 	LayoutDirection m_direction;
 
-	std::vector<std::shared_ptr<TrailNode>> m_allNodes;
-	std::vector<std::shared_ptr<TrailEdge>> m_allEdges;
+	std::vector<TrailNode> m_nodes;
+	std::vector<TrailEdge> m_edges;
 
-	std::map<Id, TrailNode*> m_nodesById;
-	TrailNode* m_rootNode;
+	std::map<Id, size_t> m_nodesById;
+	std::map<std::pair<size_t, size_t>, size_t> m_edgesByNodes;	// smaller node index first
+	size_t m_rootNode;
 
-	std::vector<std::vector<TrailNode*>> m_nodesPerCol;
+	std::vector<std::vector<size_t>> m_nodesPerCol;
+	std::vector<size_t> m_nodePositionsInCol;	 // index of each node within its column
 };
 
 #endif	  // GRAPH_LAYOUTER_H
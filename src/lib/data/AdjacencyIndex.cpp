@@ -0,0 +1,192 @@
+#include "AdjacencyIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "tracing.h"
+
+AdjacencyIndex::AdjacencyIndex()
+{
+	clear();
+}
+
+bool AdjacencyIndex::build(std::vector<StorageEdge> edges)
+{
+	TRACE();
+
+	clear();
+
+	Id maxId = 0;
+	for (const StorageEdge& edge: edges)
+	{
+		maxId = std::max({maxId, edge.id, edge.sourceNodeId, edge.targetNodeId});
+	}
+
+	if (maxId >= std::numeric_limits<uint32_t>::max() ||
+		edges.size() >= std::numeric_limits<uint32_t>::max())
+	{
+		return false;
+	}
+
+	// the edges of every node are kept in ascending order of their ids
+	std::sort(edges.begin(), edges.end(), [](const StorageEdge& a, const StorageEdge& b) {
+		return a.id < b.id;
+	});
+
+	// only nodes with edges get an offset, so the size doesn't depend on the other element ids
+	m_nodeIds.reserve(edges.size() * 2);
+	for (const StorageEdge& edge: edges)
+	{
+		m_nodeIds.push_back(static_cast<uint32_t>(edge.sourceNodeId));
+		m_nodeIds.push_back(static_cast<uint32_t>(edge.targetNodeId));
+	}
+	std::sort(m_nodeIds.begin(), m_nodeIds.end());
+	m_nodeIds.erase(std::unique(m_nodeIds.begin(), m_nodeIds.end()), m_nodeIds.end());
+	m_nodeIds.shrink_to_fit();
+
+	std::vector<uint32_t> sourceIndices(edges.size());
+	std::vector<uint32_t> targetIndices(edges.size());
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		sourceIndices[i] = static_cast<uint32_t>(getNodeIndex(edges[i].sourceNodeId));
+		targetIndices[i] = static_cast<uint32_t>(getNodeIndex(edges[i].targetNodeId));
+	}
+
+	buildRows(edges, sourceIndices, true, m_nodeIds.size(), &m_outgoing);
+	buildRows(edges, targetIndices, false, m_nodeIds.size(), &m_incoming);
+
+	m_isBuilt = true;
+	return true;
+}
+
+void AdjacencyIndex::clear()
+{
+	m_nodeIds.clear();
+	m_nodeIds.shrink_to_fit();
+	m_outgoing = Rows();
+	m_incoming = Rows();
+	m_isBuilt = false;
+}
+
+bool AdjacencyIndex::isBuilt() const
+{
+	return m_isBuilt;
+}
+
+size_t AdjacencyIndex::getEdgeCount() const
+{
+	return m_outgoing.entries.size();
+}
+
+std::vector<StorageEdge> AdjacencyIndex::getEdgesBySourceIds(
+	const std::vector<Id>& sourceIds, int typeMask) const
+{
+	return getEdges(m_outgoing, true, sourceIds, typeMask);
+}
+
+std::vector<StorageEdge> AdjacencyIndex::getEdgesByTargetIds(
+	const std::vector<Id>& targetIds, int typeMask) const
+{
+	return getEdges(m_incoming, false, targetIds, typeMask);
+}
+
+std::vector<StorageEdge> AdjacencyIndex::getEdgesBySourceOrTargetId(Id nodeId) const
+{
+	std::vector<StorageEdge> edges;
+	addEdges(m_outgoing, true, nodeId, ~0, &edges);
+
+	// edges from a node to itself are already part of the outgoing ones
+	const size_t outgoingCount = edges.size();
+	addEdges(m_incoming, false, nodeId, ~0, &edges);
+	edges.erase(
+		std::remove_if(
+			edges.begin() + outgoingCount,
+			edges.end(),
+			[nodeId](const StorageEdge& edge) { return edge.sourceNodeId == nodeId; }),
+		edges.end());
+
+	return edges;
+}
+
+void AdjacencyIndex::buildRows(
+	const std::vector<StorageEdge>& edges,
+	const std::vector<uint32_t>& nodeIndices,
+	bool bySource,
+	size_t nodeCount,
+	Rows* rows)
+{
+	// counting sort by node index, which keeps the order of the edges of each node
+	rows->offsets.assign(nodeCount + 1, 0);
+	for (uint32_t nodeIndex: nodeIndices)
+	{
+		rows->offsets[static_cast<size_t>(nodeIndex) + 1]++;
+	}
+
+	for (size_t i = 1; i < rows->offsets.size(); i++)
+	{
+		rows->offsets[i] += rows->offsets[i - 1];
+	}
+
+	std::vector<uint32_t> positions(rows->offsets.begin(), rows->offsets.end() - 1);
+	rows->entries.resize(edges.size());
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		const StorageEdge& edge = edges[i];
+
+		Entry& entry = rows->entries[positions[nodeIndices[i]]++];
+		entry.edgeId = static_cast<uint32_t>(edge.id);
+		entry.otherNodeId = static_cast<uint32_t>(bySource ? edge.targetNodeId : edge.sourceNodeId);
+		entry.type = edge.type;
+	}
+}
+
+size_t AdjacencyIndex::getNodeIndex(Id nodeId) const
+{
+	std::vector<uint32_t>::const_iterator it = std::lower_bound(
+		m_nodeIds.begin(), m_nodeIds.end(), nodeId);
+	if (it == m_nodeIds.end() || *it != nodeId)
+	{
+		return m_nodeIds.size();
+	}
+	return static_cast<size_t>(it - m_nodeIds.begin());
+}
+
+void AdjacencyIndex::addEdges(
+	const Rows& rows, bool bySource, Id nodeId, int typeMask, std::vector<StorageEdge>* edges) const
+{
+	const size_t nodeIndex = getNodeIndex(nodeId);
+	if (nodeIndex + 1 >= rows.offsets.size())
+	{
+		return;
+	}
+
+	for (uint32_t i = rows.offsets[nodeIndex]; i < rows.offsets[nodeIndex + 1]; i++)
+	{
+		const Entry& entry = rows.entries[i];
+		if (entry.type & typeMask)
+		{
+			edges->emplace_back(
+				entry.edgeId,
+				entry.type,
+				bySource ? nodeId : entry.otherNodeId,
+				bySource ? entry.otherNodeId : nodeId);
+		}
+	}
+}
+
+std::vector<StorageEdge> AdjacencyIndex::getEdges(
+	const Rows& rows, bool bySource, const std::vector<Id>& nodeIds, int typeMask) const
+{
+	// like the database every node only contributes its edges once
+	std::vector<Id> sortedNodeIds = nodeIds;
+	std::sort(sortedNodeIds.begin(), sortedNodeIds.end());
+	sortedNodeIds.erase(
+		std::unique(sortedNodeIds.begin(), sortedNodeIds.end()), sortedNodeIds.end());
+
+	std::vector<StorageEdge> edges;
+	for (Id nodeId: sortedNodeIds)
+	{
+		addEdges(rows, bySource, nodeId, typeMask, &edges);
+	}
+	return edges;
+}
@@ -0,0 +1,77 @@
+#ifndef ADJACENCY_INDEX_H
+#define ADJACENCY_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "StorageEdge.h"
+#include "types.h"
+
+// Edges of all nodes in compressed sparse row layout, once grouped by source and once by target
+// node. The ids of nodes with edges are compacted to consecutive indices, which index offsets into
+// one array holding the edges of all nodes, so graph traversals look up the edges of a node without
+// querying the database. Ids are stored with 32 bits, build() leaves the index empty for databases
+// with larger ids.
+class AdjacencyIndex
+{
+public:
+	AdjacencyIndex();
+
+	bool build(std::vector<StorageEdge> edges);
+	void clear();
+
+	bool isBuilt() const;
+	size_t getEdgeCount() const;
+
+	// only returns edges with a type in typeMask, grouped by node in ascending order of node ids and
+	// then ordered by edge id. The database queries these replace have no defined order, so callers
+	// don't depend on it.
+	std::vector<StorageEdge> getEdgesBySourceIds(
+		const std::vector<Id>& sourceIds, int typeMask = ~0) const;
+	std::vector<StorageEdge> getEdgesByTargetIds(
+		const std::vector<Id>& targetIds, int typeMask = ~0) const;
+	std::vector<StorageEdge> getEdgesBySourceOrTargetId(Id nodeId) const;
+
+private:
+	struct Entry
+	{
+		uint32_t edgeId;
+		uint32_t otherNodeId;
+		int32_t type;
+	};
+
+	struct Rows
+	{
+		// the edges of the node at index i of m_nodeIds are entries[offsets[i]] up to
+		// entries[offsets[i + 1]]
+		std::vector<uint32_t> offsets;
+		std::vector<Entry> entries;
+	};
+
+	static void buildRows(
+		const std::vector<StorageEdge>& edges,
+		const std::vector<uint32_t>& nodeIndices,
+		bool bySource,
+		size_t nodeCount,
+		Rows* rows);
+
+	// returns m_nodeIds.size() for nodes without edges
+	size_t getNodeIndex(Id nodeId) const;
+
+	void addEdges(
+		const Rows& rows,
+		bool bySource,
+		Id nodeId,
+		int typeMask,
+		std::vector<StorageEdge>* edges) const;
+	std::vector<StorageEdge> getEdges(
+		const Rows& rows, bool bySource, const std::vector<Id>& nodeIds, int typeMask) const;
+
+	// sorted ids of all nodes with edges
+	std::vector<uint32_t> m_nodeIds;
+	Rows m_outgoing;
+	Rows m_incoming;
+	bool m_isBuilt;
+};
+
+#endif	  // ADJACENCY_INDEX_H
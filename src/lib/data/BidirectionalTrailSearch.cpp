@@ -0,0 +1,172 @@
+#include "BidirectionalTrailSearch.h"
+
+#include <map>
+
+#include "tracing.h"
+
+BidirectionalTrailSearch::BidirectionalTrailSearch(
+	GetStepsFunction getSteps, FilterNodesFunction filterNodes, FilterNodesFunction filterShownNodes)
+	: m_getSteps(getSteps), m_filterNodes(filterNodes), m_filterShownNodes(filterShownNodes)
+{
+}
+
+BidirectionalTrailSearch::Result BidirectionalTrailSearch::search(
+	Id originId, Id targetId, size_t maxDepth, size_t maxNodeCount) const
+{
+	TRACE();
+
+	Result result;
+
+	Side forwardSide;
+	forwardSide.visits.emplace(originId, Visit {0, {}});
+	forwardSide.frontier.push_back(originId);
+
+	Side backwardSide;
+	backwardSide.visits.emplace(targetId, Visit {0, {}});
+	backwardSide.frontier.push_back(targetId);
+
+	result.visitedNodeCount = originId == targetId ? 1 : 2;
+
+	std::vector<Id> meetingNodeIds;
+	if (originId == targetId)
+	{
+		meetingNodeIds.push_back(originId);
+	}
+
+	while (meetingNodeIds.empty() && !forwardSide.frontier.empty() &&
+		   !backwardSide.frontier.empty() &&
+		   (!maxDepth || forwardSide.depth + backwardSide.depth < maxDepth))
+	{
+		const bool forward = forwardSide.frontier.size() <= backwardSide.frontier.size();
+		Side& side = forward ? forwardSide : backwardSide;
+		const Side& otherSide = forward ? backwardSide : forwardSide;
+
+		// nodes found by the other side have been accepted already
+		std::map<Id, std::vector<Step>> parentsOfNewNodes;
+		std::vector<Id> nodeIdsToFilter;
+		for (const Step& step: m_getSteps(side.frontier, forward))
+		{
+			if (side.visits.find(step.otherNodeId) != side.visits.end())
+			{
+				continue;
+			}
+
+			std::vector<Step>& parents = parentsOfNewNodes[step.otherNodeId];
+			const bool isVisitedByOtherSide = otherSide.visits.find(step.otherNodeId) !=
+				otherSide.visits.end();
+			if (parents.empty() && !isVisitedByOtherSide)
+			{
+				nodeIdsToFilter.push_back(step.otherNodeId);
+			}
+			parents.push_back(step);
+		}
+
+		std::set<Id> acceptedNodeIds;
+		if (!nodeIdsToFilter.empty())
+		{
+			for (Id nodeId: m_filterNodes(nodeIdsToFilter))
+			{
+				acceptedNodeIds.insert(nodeId);
+			}
+		}
+
+		side.depth++;
+		side.frontier.clear();
+
+		for (std::pair<const Id, std::vector<Step>>& p: parentsOfNewNodes)
+		{
+			const bool isMeetingNode = otherSide.visits.find(p.first) != otherSide.visits.end();
+			if (!isMeetingNode && acceptedNodeIds.find(p.first) == acceptedNodeIds.end())
+			{
+				continue;
+			}
+
+			side.visits.emplace(p.first, Visit {side.depth, std::move(p.second)});
+			side.frontier.push_back(p.first);
+
+			if (isMeetingNode)
+			{
+				meetingNodeIds.push_back(p.first);
+			}
+			else
+			{
+				result.visitedNodeCount++;
+			}
+		}
+
+		if (meetingNodeIds.empty() && result.visitedNodeCount > maxNodeCount)
+		{
+			result.isTruncated = true;
+			break;
+		}
+	}
+
+	if (!meetingNodeIds.empty())
+	{
+		// The search stops at the first level where both sides meet, so all meeting nodes have the
+		// same distance to the origin and are part of a shortest trail.
+		result.isFound = true;
+
+		std::set<Id> trailNodeIds;
+		std::vector<Step> trailSteps;
+		addTrailsToStart(forwardSide.visits, meetingNodeIds, &trailNodeIds, &trailSteps);
+		addTrailsToStart(backwardSide.visits, meetingNodeIds, &trailNodeIds, &trailSteps);
+
+		if (m_filterShownNodes)
+		{
+			const std::vector<Id> shownNodeIds =
+				m_filterShownNodes(std::vector<Id>(trailNodeIds.begin(), trailNodeIds.end()));
+			result.nodeIds.insert(shownNodeIds.begin(), shownNodeIds.end());
+			result.nodeIds.insert(originId);
+			result.nodeIds.insert(targetId);
+		}
+		else
+		{
+			result.nodeIds = std::move(trailNodeIds);
+		}
+
+		for (const Step& step: trailSteps)
+		{
+			if (step.isEdgeShown && result.nodeIds.find(step.nodeId) != result.nodeIds.end() &&
+				result.nodeIds.find(step.otherNodeId) != result.nodeIds.end())
+			{
+				result.edgeIds.insert(step.edgeId);
+			}
+		}
+	}
+
+	return result;
+}
+
+void BidirectionalTrailSearch::addTrailsToStart(
+	const VisitMap& visits,
+	std::vector<Id> nodeIds,
+	std::set<Id>* trailNodeIds,
+	std::vector<Step>* trailSteps)
+{
+	std::set<Id> processedNodeIds;
+	while (!nodeIds.empty())
+	{
+		const Id nodeId = nodeIds.back();
+		nodeIds.pop_back();
+
+		if (!processedNodeIds.insert(nodeId).second)
+		{
+			continue;
+		}
+
+		trailNodeIds->insert(nodeId);
+
+		auto it = visits.find(nodeId);
+		if (it == visits.end())
+		{
+			continue;
+		}
+
+		for (const Step& parent: it->second.parents)
+		{
+			trailSteps->push_back(parent);
+			nodeIds.push_back(parent.nodeId);
+		}
+	}
+}
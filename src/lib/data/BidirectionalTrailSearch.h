@@ -0,0 +1,85 @@
+#ifndef BIDIRECTIONAL_TRAIL_SEARCH_H
+#define BIDIRECTIONAL_TRAIL_SEARCH_H
+
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// Finds all shortest trails between an origin and a target node. The search expands the smaller
+// frontier of a breadth-first search started at each end until both meet, so it only visits the
+// nodes around both ends instead of everything reachable from the origin up to the target's depth.
+class BidirectionalTrailSearch
+{
+public:
+	struct Step
+	{
+		Id nodeId;
+		Id edgeId;
+		Id otherNodeId;
+
+		// edges that are not shown can still be passed by trails
+		bool isEdgeShown = true;
+	};
+
+	// returns the steps from the nodes in trail direction or, if not forward, the steps leading to
+	// them in reverse
+	typedef std::function<std::vector<Step>(const std::vector<Id>& nodeIds, bool forward)>
+		GetStepsFunction;
+
+	// returns the nodes that may be part of a trail
+	typedef std::function<std::vector<Id>(const std::vector<Id>& nodeIds)> FilterNodesFunction;
+
+	struct Result
+	{
+		std::set<Id> nodeIds;
+		std::set<Id> edgeIds;
+		bool isFound = false;
+		bool isTruncated = false;
+		size_t visitedNodeCount = 0;
+	};
+
+	// filterShownNodes returns the nodes of the found trails that are shown, the others are only
+	// passed and left out of the result together with their edges, all nodes are shown if not set
+	BidirectionalTrailSearch(
+		GetStepsFunction getSteps,
+		FilterNodesFunction filterNodes,
+		FilterNodesFunction filterShownNodes = FilterNodesFunction());
+
+	// maxDepth limits the number of steps of the trails, 0 for no limit, the search gets truncated
+	// once it visited more than maxNodeCount nodes
+	Result search(Id originId, Id targetId, size_t maxDepth, size_t maxNodeCount) const;
+
+private:
+	struct Visit
+	{
+		size_t distance;
+
+		// steps from the nodes one step closer to the start of the search
+		std::vector<Step> parents;
+	};
+
+	typedef std::unordered_map<Id, Visit> VisitMap;
+
+	struct Side
+	{
+		VisitMap visits;
+		std::vector<Id> frontier;
+		size_t depth = 0;
+	};
+
+	static void addTrailsToStart(
+		const VisitMap& visits,
+		std::vector<Id> nodeIds,
+		std::set<Id>* trailNodeIds,
+		std::vector<Step>* trailSteps);
+
+	GetStepsFunction m_getSteps;
+	FilterNodesFunction m_filterNodes;
+	FilterNodesFunction m_filterShownNodes;
+};
+
+#endif	  // BIDIRECTIONAL_TRAIL_SEARCH_H
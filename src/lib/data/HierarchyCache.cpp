@@ -89,11 +89,40 @@ void HierarchyCache::HierarchyNode::addBase(size_t base, Id edgeId)
 	m_baseEdgeIds.push_back(edgeId);
 }
 
+void HierarchyCache::HierarchyNode::removeBase(Id edgeId)
+{
+	flashmapper::vector<size_t> bases;
+	flashmapper::vector<Id> baseEdgeIds;
+	for (size_t i = 0; i < m_baseEdgeIds.size(); i++)
+	{
+		if (m_baseEdgeIds[i] != edgeId)
+		{
+			bases.push_back(m_bases[i]);
+			baseEdgeIds.push_back(m_baseEdgeIds[i]);
+		}
+	}
+	m_bases = bases;
+	m_baseEdgeIds = baseEdgeIds;
+}
+
 void HierarchyCache::HierarchyNode::addChild(size_t child)
 {
 	m_children.push_back(child);
 }
 
+void HierarchyCache::HierarchyNode::removeChild(size_t child)
+{
+	flashmapper::vector<size_t> children;
+	for (size_t i = 0; i < m_children.size(); i++)
+	{
+		if (m_children[i] != child)
+		{
+			children.push_back(m_children[i]);
+		}
+	}
+	m_children = children;
+}
+
 size_t HierarchyCache::HierarchyNode::getChildrenCount() const
 {
 	return m_children.size();
@@ -199,8 +228,8 @@ void HierarchyCache::getReverseReachableInheritanceSubgraphHelper(
 		size_t base = m_bases[i];
 		HierarchyNode* baseNode = m_nodes.getByIndex(base);
 		auto emplacedBase = reverseGraph.try_emplace(baseNode->getNodeId());
-		const Id nodeId = baseNode->getNodeId();
-		const Id edgeId = (*baseNode->getBaseEdgeIds())[i];
+		const Id nodeId = sourceNode->getNodeId();
+		const Id edgeId = (*sourceNode->getBaseEdgeIds())[i];
 		emplacedBase.first->second.push_back({nodeId, edgeId});
 		if (emplacedBase.second)
 		{
@@ -212,6 +241,7 @@ void HierarchyCache::getReverseReachableInheritanceSubgraphHelper(
 flashmapper::Address HierarchyCache::writeData(flashmapper::Mapper& mapper, flashmapper::DataBlock& block) const
 {
 	mapper.writeData(m_nodes, block);
+	mapper.writeData(m_revision, block);
 
 	return block.baseOffset + block.cursor;
 }
@@ -228,6 +258,7 @@ void HierarchyCache::load(std::string filePath, flashmapper::Mapper& mapper)
 	mapper.readFromFile(filePath.c_str());
 	HierarchyCache* hierarchy = mapper.readData<HierarchyCache>();
 	m_nodes = std::move(hierarchy->m_nodes);
+	m_revision = hierarchy->m_revision;
 }
 
 void HierarchyCache::save(std::string filePath, flashmapper::Mapper& mapper)
@@ -243,6 +274,7 @@ void HierarchyCache::save(std::string filePath, flashmapper::Mapper& mapper)
 void HierarchyCache::clear()
 {
 	m_nodes.clear();
+	m_revision = 0;
 }
 
 void HierarchyCache::createConnection(
@@ -281,6 +313,103 @@ void HierarchyCache::createInheritance(Id edgeId, Id fromId, Id toId)
 	from->addBase(m_nodes.findIndex(toId), edgeId);
 }
 
+void HierarchyCache::addConnection(Id edgeId, Id fromId, Id toId)
+{
+	if (fromId == toId)
+	{
+		return;
+	}
+
+	createNode(fromId);
+	HierarchyNode* to = createNode(toId);
+	const size_t fromIndex = m_nodes.findIndex(fromId);
+	const size_t toIndex = m_nodes.findIndex(toId);
+
+	if (to->getEdgeId() == edgeId && to->getParent() == fromIndex)
+	{
+		return;
+	}
+
+	// a node has a single parent, an outdated connection is replaced
+	if (to->getParent() != INVALID_INDEX)
+	{
+		m_nodes.getByIndex(to->getParent())->removeChild(toIndex);
+	}
+
+	getNode(fromId)->addChild(toIndex);
+	to->setParent(fromIndex);
+	to->setEdgeId(edgeId);
+}
+
+void HierarchyCache::removeConnection(Id edgeId, Id toId)
+{
+	HierarchyNode* to = getNode(toId);
+	if (!to || to->getEdgeId() != edgeId)
+	{
+		return;
+	}
+
+	if (to->getParent() != INVALID_INDEX)
+	{
+		m_nodes.getByIndex(to->getParent())->removeChild(m_nodes.findIndex(toId));
+	}
+
+	to->setParent(INVALID_INDEX);
+	to->setEdgeId(0);
+}
+
+void HierarchyCache::addInheritance(Id edgeId, Id fromId, Id toId)
+{
+	HierarchyNode* from = getNode(fromId);
+	if (from)
+	{
+		flashmapper::vector<Id>& baseEdgeIds = *from->getBaseEdgeIds();
+		for (size_t i = 0; i < baseEdgeIds.size(); i++)
+		{
+			if (baseEdgeIds[i] == edgeId)
+			{
+				return;
+			}
+		}
+	}
+
+	createInheritance(edgeId, fromId, toId);
+}
+
+void HierarchyCache::removeInheritance(Id edgeId, Id fromId)
+{
+	HierarchyNode* from = getNode(fromId);
+	if (from)
+	{
+		from->removeBase(edgeId);
+	}
+}
+
+void HierarchyCache::updateNodeFlags(Id nodeId, bool visibleAsParent, bool isImplicit)
+{
+	HierarchyNode* node = getNode(nodeId);
+	if (!node)
+	{
+		return;
+	}
+
+	// same as createConnection(): visibility only applies to parents and implicitness only to
+	// nodes that are part of a member connection
+	const bool hasChildren = node->getChildrenCount() > 0;
+	node->setIsVisible(hasChildren ? visibleAsParent : true);
+	node->setIsImplicit((hasChildren || node->getParent() != INVALID_INDEX) ? isImplicit : false);
+}
+
+size_t HierarchyCache::getRevision() const
+{
+	return m_revision;
+}
+
+void HierarchyCache::setRevision(size_t revision)
+{
+	m_revision = revision;
+}
+
 Id HierarchyCache::getLastVisibleParentNodeId(Id nodeId) const
 {
 	HierarchyNode* node = nullptr;
@@ -26,6 +26,17 @@ public:
 		Id edgeId, Id fromId, Id toId, bool sourceVisible, bool sourceImplicit, bool targetImplicit);
 	void createInheritance(Id edgeId, Id fromId, Id toId);
 
+	// incremental updates of an already built cache, node flags need to be refreshed afterwards
+	void addConnection(Id edgeId, Id fromId, Id toId);
+	void removeConnection(Id edgeId, Id toId);
+	void addInheritance(Id edgeId, Id fromId, Id toId);
+	void removeInheritance(Id edgeId, Id fromId);
+	void updateNodeFlags(Id nodeId, bool visibleAsParent, bool isImplicit);
+
+	// identifies the saved state, so a file is only reused by the database it was built for
+	size_t getRevision() const;
+	void setRevision(size_t revision);
+
 	Id getLastVisibleParentNodeId(Id nodeId) const;
 	size_t getIndexOfLastVisibleParentNode(Id nodeId) const;
 
@@ -110,7 +121,10 @@ private:
 
 		void addBase(size_t base, Id edgeId);
 
+		void removeBase(Id edgeId);
+
 		void addChild(size_t child);
+		void removeChild(size_t child);
 
 		flashmapper::vector<size_t>* getBases()
 		{
@@ -155,6 +169,7 @@ private:
 	HierarchyNode* createNode(Id nodeId);
 
 	flashmapper::map<Id, HierarchyNode> m_nodes;
+	size_t m_revision = 0;
 };
 
 #endif	  // HIERARCHY_CACHE_H
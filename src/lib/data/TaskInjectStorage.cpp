@@ -1,5 +1,6 @@
 #include "TaskInjectStorage.h"
 
+#include "Blackboard.h"
 #include "Storage.h"
 #include "StorageProvider.h"
 
@@ -15,14 +16,27 @@ Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> blackboa
 {
 	if (m_storageProvider->getStorageCount() > 0)
 	{
-		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeLargestStorage();
-		if (source)
+		std::shared_ptr<Storage> target = m_target.lock();
+		if (!target)
 		{
-			if (std::shared_ptr<Storage> target = m_target.lock())
-			{
-				target->inject(source.get());
-				return STATE_SUCCESS;
-			}
+			return STATE_FAILURE;
+		}
+
+		if (std::shared_ptr<IntermediateStorage> source =
+				m_storageProvider->consumeLargestStorage())
+		{
+			target->inject(source.get());
+			blackboard->notifyUpdate();
+			return STATE_SUCCESS;
+		}
+
+		// storages of indexer processes are injected straight from their shared memory
+		if (std::shared_ptr<FlatIntermediateStorage> source =
+				m_storageProvider->consumeFlatStorage())
+		{
+			target->inject(*source);
+			blackboard->notifyUpdate();
+			return STATE_SUCCESS;
 		}
 	}
 
@@ -1,9 +1,82 @@
 #include "TaskMergeStorages.h"
 
+#include <algorithm>
+#include <thread>
+
+#include "Blackboard.h"
+#include "FlatIntermediateStorage.h"
 #include "StorageProvider.h"
 
-TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider)
-	: m_storageProvider(storageProvider)
+std::shared_ptr<IntermediateStorage> TaskMergeStorages::mergeStorages(
+	std::vector<std::shared_ptr<IntermediateStorage>> storages,
+	size_t threadCount,
+	std::vector<std::shared_ptr<FlatIntermediateStorage>> flatStorages)
+{
+	threadCount = std::max<size_t>(threadCount, 1);
+
+	if (!flatStorages.empty())
+	{
+		while (storages.size() < std::min(flatStorages.size(), threadCount))
+		{
+			storages.push_back(std::make_shared<IntermediateStorage>());
+		}
+
+		const size_t targetCount = std::min(storages.size(), threadCount);
+
+		std::vector<std::shared_ptr<std::thread>> threads;
+		for (size_t i = 0; i < targetCount; i++)
+		{
+			IntermediateStorage* target = storages[i].get();
+			threads.push_back(
+				std::make_shared<std::thread>([&flatStorages, target, targetCount, i]() {
+					for (size_t j = i; j < flatStorages.size(); j += targetCount)
+					{
+						target->inject(*flatStorages[j]);
+					}
+				}));
+		}
+
+		for (const std::shared_ptr<std::thread>& thread: threads)
+		{
+			thread->join();
+		}
+	}
+
+	while (storages.size() > 1)
+	{
+		// the largest storages receive the smallest ones, so each injection stays cheap
+		std::stable_sort(
+			storages.begin(),
+			storages.end(),
+			[](const std::shared_ptr<IntermediateStorage>& a,
+			   const std::shared_ptr<IntermediateStorage>& b) {
+				return a->getSourceLocationCount() > b->getSourceLocationCount();
+			});
+
+		const size_t pairCount = std::min(storages.size() / 2, threadCount);
+
+		std::vector<std::shared_ptr<std::thread>> threads;
+		for (size_t i = 0; i < pairCount; i++)
+		{
+			IntermediateStorage* target = storages[i].get();
+			IntermediateStorage* source = storages[storages.size() - 1 - i].get();
+			threads.push_back(
+				std::make_shared<std::thread>([target, source]() { target->inject(source); }));
+		}
+
+		for (const std::shared_ptr<std::thread>& thread: threads)
+		{
+			thread->join();
+		}
+
+		storages.resize(storages.size() - pairCount);
+	}
+
+	return storages.empty() ? nullptr : storages.front();
+}
+
+TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider, size_t threadCount)
+	: m_storageProvider(storageProvider), m_threadCount(std::max<size_t>(threadCount, 1))
 {
 }
 
@@ -13,24 +86,25 @@ Task::TaskState TaskMergeStorages::doUpdate(std::shared_ptr<Blackboard> blackboa
 {
 	if (m_storageProvider->getStorageCount() > 2)	 // largest storage won't be touched here
 	{
-		std::shared_ptr<IntermediateStorage> target = m_storageProvider->consumeSecondLargestStorage();
-		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeSecondLargestStorage();
-		if (target && source)
+		std::vector<std::shared_ptr<IntermediateStorage>> storages =
+			m_storageProvider->consumeSecondLargestStorages(2 * m_threadCount);
+		std::vector<std::shared_ptr<FlatIntermediateStorage>> flatStorages =
+			m_storageProvider->consumeFlatStorages(2 * m_threadCount);
+		if (storages.size() + flatStorages.size() > 1)
 		{
-			target->inject(source.get());
-			m_storageProvider->insert(target);
+			m_storageProvider->insert(
+				mergeStorages(std::move(storages), m_threadCount, std::move(flatStorages)));
+			blackboard->notifyUpdate();
 			return STATE_SUCCESS;
 		}
-		else
+
+		for (const std::shared_ptr<IntermediateStorage>& storage: storages)
+		{
+			m_storageProvider->insert(storage);
+		}
+		for (const std::shared_ptr<FlatIntermediateStorage>& storage: flatStorages)
 		{
-			if (target)
-			{
-				m_storageProvider->insert(target);
-			}
-			if (source)
-			{
-				m_storageProvider->insert(source);
-			}
+			m_storageProvider->insert(storage);
 		}
 	}
 
@@ -5,12 +5,21 @@
 
 #include "Task.h"
 
+class FlatIntermediateStorage;
+class IntermediateStorage;
 class StorageProvider;
 
 class TaskMergeStorages: public Task
 {
 public:
-	TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider);
+	// merges storages pairwise in rounds, each round injecting up to threadCount pairs in parallel;
+	// flat storages are injected into up to threadCount of the storages beforehand
+	static std::shared_ptr<IntermediateStorage> mergeStorages(
+		std::vector<std::shared_ptr<IntermediateStorage>> storages,
+		size_t threadCount,
+		std::vector<std::shared_ptr<FlatIntermediateStorage>> flatStorages = {});
+
+	TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider, size_t threadCount);
 
 private:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -19,6 +28,7 @@ private:
 	void doReset(std::shared_ptr<Blackboard> blackboard) override;
 
 	std::shared_ptr<StorageProvider> m_storageProvider;
+	const size_t m_threadCount;
 };
 
 #endif	  // TASK_MERGE_STORAGES_H
@@ -0,0 +1,33 @@
+#ifndef FULLTEXT_SEARCH_QUERY_H
+#define FULLTEXT_SEARCH_QUERY_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+// Parameters of a fulltext search that reports its hits in batches of files. A search that stopped
+// at maxHitCount is continued by passing the returned candidate index as firstCandidateIndex.
+struct FullTextSearchQuery
+{
+	FullTextSearchQuery(std::wstring searchTerm = L"", bool caseSensitive = false)
+		: searchTerm(std::move(searchTerm))
+		, caseSensitive(caseSensitive)
+		, maxHitCount(0)
+		, firstCandidateIndex(0)
+		, reportedHitCount(0)
+		, canceled(std::make_shared<std::atomic<bool>>(false))
+	{
+	}
+
+	std::wstring searchTerm;
+	bool caseSensitive;
+
+	size_t maxHitCount;	   // 0 for no limit
+	size_t firstCandidateIndex;
+	size_t reportedHitCount;	// hits reported before firstCandidateIndex, keeps location ids unique
+
+	// can be set from another thread to stop the search after the current batch
+	std::shared_ptr<std::atomic<bool>> canceled;
+};
+
+#endif	  // FULLTEXT_SEARCH_QUERY_H
@@ -0,0 +1,16 @@
+#ifndef FULLTEXTSEARCH_RESULT_H
+#define FULLTEXTSEARCH_RESULT_H
+
+#include <vector>
+
+#include "types.h"
+
+// contains all fulltextsearch results of one file
+struct FullTextSearchResult
+{
+	Id fileId;
+	std::vector<int> positions;
+	std::vector<int> termLens;
+};
+
+#endif	  // FULLTEXTSEARCH_RESULT_H
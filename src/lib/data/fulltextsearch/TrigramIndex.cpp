@@ -0,0 +1,983 @@
+#include "TrigramIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#include "FilePath.h"
+#include "logging.h"
+#include "tracing.h"
+#include "utility.h"
+
+namespace
+{
+const char s_fileMagic[8] = {'S', 'T', 'T', 'R', 'I', 'G', 'R', 'M'};
+const uint32_t s_fileVersion = 2;
+
+// files are passed between the threads building the index in batches of about this size
+const size_t s_buildBatchByteCount = 1024 * 1024;
+
+// every shard keeps its own posting lists, so more shards cost memory for common trigrams
+const size_t s_shardCount = 8;
+
+// smaller indexes are queried without starting threads
+const size_t s_minParallelFileCount = 10000;
+
+inline unsigned char foldCase(char c)
+{
+	const unsigned char u = static_cast<unsigned char>(c);
+	return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u + ('a' - 'A')) : u;
+}
+
+std::string foldCase(const std::string& text)
+{
+	std::string folded(text.size(), '\0');
+	std::transform(text.begin(), text.end(), folded.begin(), [](char c) {
+		return static_cast<char>(foldCase(c));
+	});
+	return folded;
+}
+
+std::vector<uint32_t> collectTrigrams(const std::string& text)
+{
+	std::vector<uint32_t> trigrams;
+	if (text.size() < 3)
+	{
+		return trigrams;
+	}
+
+	trigrams.reserve(text.size() - 2);
+	uint32_t trigram = (foldCase(text[0]) << 8) | foldCase(text[1]);
+	for (size_t i = 2; i < text.size(); i++)
+	{
+		trigram = ((trigram << 8) | foldCase(text[i])) & 0xFFFFFF;
+		trigrams.push_back(trigram);
+	}
+
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+	return trigrams;
+}
+
+struct FileBatch
+{
+	std::vector<Id> fileIds;
+	std::vector<std::string> texts;
+	size_t byteCount = 0;
+};
+
+struct TrigramBatch
+{
+	std::vector<Id> fileIds;
+	std::vector<std::vector<uint32_t>> trigrams;
+};
+
+// passes batches between the threads building the index, push() blocks while the queue is full
+template <typename T>
+class BatchQueue
+{
+public:
+	BatchQueue(size_t maxSize): m_maxSize(maxSize), m_closed(false) {}
+
+	void push(T&& batch)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_batches.size() < m_maxSize; });
+		m_batches.push_back(std::move(batch));
+		m_condition.notify_all();
+	}
+
+	// returns false once the queue is closed and all batches have been taken
+	bool pop(T* batch)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return !m_batches.empty() || m_closed; });
+		if (m_batches.empty())
+		{
+			return false;
+		}
+
+		*batch = std::move(m_batches.front());
+		m_batches.pop_front();
+		m_condition.notify_all();
+		return true;
+	}
+
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closed = true;
+		m_condition.notify_all();
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<T> m_batches;
+	const size_t m_maxSize;
+	bool m_closed;
+};
+
+// calls func for the indices 0 to count - 1 spread over up to threadCount threads
+template <typename Func>
+void forEachIndexInParallel(size_t count, size_t threadCount, Func func)
+{
+	threadCount = std::min(std::max<size_t>(threadCount, 1), count);
+	if (threadCount <= 1)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			func(i);
+		}
+		return;
+	}
+
+	std::atomic<size_t> nextIndex(0);
+	std::vector<std::shared_ptr<std::thread>> threads;
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		threads.push_back(std::make_shared<std::thread>([&]() {
+			for (size_t index = nextIndex++; index < count; index = nextIndex++)
+			{
+				func(index);
+			}
+		}));
+	}
+	for (std::shared_ptr<std::thread> thread: threads)
+	{
+		thread->join();
+	}
+}
+
+std::vector<Id> intersectPostings(
+	const std::vector<Id>& fileIds,
+	const std::unordered_map<uint32_t, std::vector<Id>>& postingsMap,
+	const std::vector<uint32_t>& trigrams)
+{
+	if (trigrams.empty())
+	{
+		return fileIds;
+	}
+
+	std::vector<const std::vector<Id>*> postings;
+	for (uint32_t trigram: trigrams)
+	{
+		auto it = postingsMap.find(trigram);
+		if (it == postingsMap.end())
+		{
+			return {};
+		}
+		postings.push_back(&it->second);
+	}
+
+	// intersect starting with the shortest list to keep the intermediate results small
+	std::sort(postings.begin(), postings.end(), [](const std::vector<Id>* a, const std::vector<Id>* b) {
+		return a->size() < b->size();
+	});
+
+	std::vector<Id> candidates = *postings[0];
+	std::vector<Id> intersection;
+	for (size_t i = 1; i < postings.size() && !candidates.empty(); i++)
+	{
+		intersection.clear();
+		std::set_intersection(
+			candidates.begin(),
+			candidates.end(),
+			postings[i]->begin(),
+			postings[i]->end(),
+			std::back_inserter(intersection));
+		candidates.swap(intersection);
+	}
+
+	return candidates;
+}
+
+size_t skipBracketExpression(const std::string& pattern, size_t pos)
+{
+	// pos is at '[', returns the position of the closing ']'
+	pos++;
+	if (pos < pattern.size() && pattern[pos] == '^')
+	{
+		pos++;
+	}
+	if (pos < pattern.size() && pattern[pos] == ']')
+	{
+		pos++;
+	}
+	while (pos < pattern.size() && pattern[pos] != ']')
+	{
+		if (pattern[pos] == '\\')
+		{
+			pos++;
+		}
+		pos++;
+	}
+	return pos;
+}
+
+size_t skipEscapeOperands(const std::string& pattern, size_t pos)
+{
+	// pos is at the character following '\\', returns the position of the last character of the
+	// escape: hex digits of "\\xhh" and "\\uhhhh", the letter of "\\cX" and all digits of "\\0" or
+	// back references
+	size_t maxOperandCount = 0;
+	bool (*isOperand)(int) = nullptr;
+	switch (pattern[pos])
+	{
+	case 'x':
+		maxOperandCount = 2;
+		isOperand = [](int c) -> bool { return std::isxdigit(c); };
+		break;
+	case 'u':
+		maxOperandCount = 4;
+		isOperand = [](int c) -> bool { return std::isxdigit(c); };
+		break;
+	case 'c':
+		maxOperandCount = 1;
+		isOperand = [](int c) -> bool { return std::isalpha(c); };
+		break;
+	default:
+		if (!std::isdigit(static_cast<unsigned char>(pattern[pos])))
+		{
+			return pos;
+		}
+		maxOperandCount = pattern.size();
+		isOperand = [](int c) -> bool { return std::isdigit(c); };
+	}
+
+	for (size_t i = 0; i < maxOperandCount && pos + 1 < pattern.size() &&
+		 isOperand(static_cast<unsigned char>(pattern[pos + 1]));
+		 i++)
+	{
+		pos++;
+	}
+	return pos;
+}
+
+size_t skipGroup(const std::string& pattern, size_t pos)
+{
+	// pos is at '(', returns the position of the matching ')'
+	int depth = 0;
+	for (; pos < pattern.size(); pos++)
+	{
+		switch (pattern[pos])
+		{
+		case '\\':
+			pos++;
+			break;
+		case '[':
+			pos = skipBracketExpression(pattern, pos);
+			break;
+		case '(':
+			depth++;
+			break;
+		case ')':
+			if (--depth == 0)
+			{
+				return pos;
+			}
+			break;
+		}
+	}
+	return pos;
+}
+
+template <typename T>
+void writeValue(std::ofstream& stream, T value)
+{
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& stream, T& value)
+{
+	stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return static_cast<bool>(stream);
+}
+
+void writeIds(std::ofstream& stream, const std::vector<Id>& ids)
+{
+	writeValue<uint64_t>(stream, ids.size());
+	for (Id id: ids)
+	{
+		writeValue<uint64_t>(stream, id);
+	}
+}
+
+bool readIds(std::ifstream& stream, std::vector<Id>& ids)
+{
+	uint64_t count = 0;
+	if (!readValue(stream, count))
+	{
+		return false;
+	}
+
+	ids.resize(static_cast<size_t>(count));
+	for (Id& id: ids)
+	{
+		uint64_t value = 0;
+		if (!readValue(stream, value))
+		{
+			return false;
+		}
+		id = static_cast<Id>(value);
+	}
+	return true;
+}
+}	 // namespace
+
+std::vector<uint32_t> TrigramIndex::getTermTrigrams(const std::string& term)
+{
+	return collectTrigrams(term);
+}
+
+std::vector<uint32_t> TrigramIndex::getRegexTrigrams(const std::string& pattern)
+{
+	// collect the literal runs that are part of every match, anything else splits a run
+	std::vector<std::string> literals;
+	std::string literal;
+	auto finishLiteral = [&literals, &literal]() {
+		if (literal.size() >= 3)
+		{
+			literals.push_back(literal);
+		}
+		literal.clear();
+	};
+
+	for (size_t i = 0; i < pattern.size(); i++)
+	{
+		const char c = pattern[i];
+		switch (c)
+		{
+		case '|':
+			// alternatives make no literal mandatory
+			return {};
+
+		case '\\':
+			if (i + 1 < pattern.size())
+			{
+				i++;
+				if (std::isalnum(static_cast<unsigned char>(pattern[i])))
+				{
+					// character classes, anchors, control escapes and back references
+					i = skipEscapeOperands(pattern, i);
+					finishLiteral();
+				}
+				else
+				{
+					literal.push_back(pattern[i]);
+				}
+			}
+			break;
+
+		case '[':
+			i = skipBracketExpression(pattern, i);
+			finishLiteral();
+			break;
+
+		case '(':
+			i = skipGroup(pattern, i);
+			finishLiteral();
+			break;
+
+		case '*':
+		case '?':
+		case '{':
+			// the preceding character is optional
+			if (!literal.empty())
+			{
+				literal.pop_back();
+			}
+			finishLiteral();
+			if (c == '{')
+			{
+				i = pattern.find('}', i);
+				if (i == std::string::npos)
+				{
+					i = pattern.size();
+				}
+			}
+			break;
+
+		case '+':
+			// the preceding character occurs at least once, but may be repeated
+			finishLiteral();
+			break;
+
+		case '.':
+		case '^':
+		case '$':
+		case ')':
+		case ']':
+		case '}':
+			finishLiteral();
+			break;
+
+		default:
+			literal.push_back(c);
+		}
+	}
+	finishLiteral();
+
+	std::vector<uint32_t> trigrams;
+	for (const std::string& l: literals)
+	{
+		utility::append(trigrams, collectTrigrams(l));
+	}
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+	return trigrams;
+}
+
+FullTextSearchResult TrigramIndex::findTerm(
+	Id fileId, const std::string& text, const std::string& term, bool caseSensitive)
+{
+	FullTextSearchResult result;
+	result.fileId = fileId;
+
+	if (term.empty())
+	{
+		return result;
+	}
+
+	const std::string foldedText = caseSensitive ? std::string() : foldCase(text);
+	const std::string& haystack = caseSensitive ? text : foldedText;
+	const std::string needle = caseSensitive ? term : foldCase(term);
+
+	size_t pos = haystack.find(needle);
+	while (pos != std::string::npos)
+	{
+		result.positions.push_back(static_cast<int>(pos));
+		result.termLens.push_back(static_cast<int>(needle.size()));
+		pos = haystack.find(needle, pos + needle.size());
+	}
+
+	return result;
+}
+
+FullTextSearchResult TrigramIndex::findRegex(Id fileId, const std::string& text, const std::regex& regex)
+{
+	FullTextSearchResult result;
+	result.fileId = fileId;
+
+	size_t lineStart = 0;
+	while (lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+		if (lineEnd == std::string::npos)
+		{
+			lineEnd = text.size();
+		}
+
+		const std::sregex_iterator end;
+		for (std::sregex_iterator it(text.begin() + lineStart, text.begin() + lineEnd, regex);
+			 it != end;
+			 it++)
+		{
+			if (it->length() > 0)
+			{
+				result.positions.push_back(static_cast<int>(lineStart + it->position()));
+				result.termLens.push_back(static_cast<int>(it->length()));
+			}
+		}
+
+		lineStart = lineEnd + 1;
+	}
+
+	return result;
+}
+
+TrigramIndex::TrigramIndex()
+{
+	clear();
+}
+
+void TrigramIndex::addFile(Id fileId, const std::string& text)
+{
+	const std::vector<uint32_t> trigrams = collectTrigrams(text);
+
+	std::lock_guard<std::mutex> lock(m_addFileMutex);
+	Shard& shard = m_shards[getShardIndex(fileId)];
+	shard.fileIds.push_back(fileId);
+	for (uint32_t trigram: trigrams)
+	{
+		shard.postings[trigram].push_back(fileId);
+	}
+}
+
+size_t TrigramIndex::addFiles(
+	std::function<void(const std::function<void(Id, std::string&&)>&)> readFiles,
+	size_t threadCount)
+{
+	TRACE();
+
+	threadCount = std::max<size_t>(threadCount, 1);
+	BatchQueue<FileBatch> fileQueue(2 * threadCount);
+	BatchQueue<TrigramBatch> trigramQueue(2 * threadCount);
+
+	std::vector<std::shared_ptr<std::thread>> collectThreads;
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		collectThreads.push_back(std::make_shared<std::thread>([&fileQueue, &trigramQueue]() {
+			FileBatch fileBatch;
+			while (fileQueue.pop(&fileBatch))
+			{
+				TrigramBatch trigramBatch;
+				trigramBatch.fileIds = std::move(fileBatch.fileIds);
+				for (const std::string& text: fileBatch.texts)
+				{
+					trigramBatch.trigrams.push_back(collectTrigrams(text));
+				}
+				trigramQueue.push(std::move(trigramBatch));
+			}
+		}));
+	}
+
+	std::thread addThread([this, &trigramQueue]() {
+		TrigramBatch trigramBatch;
+		while (trigramQueue.pop(&trigramBatch))
+		{
+			std::lock_guard<std::mutex> lock(m_addFileMutex);
+			for (size_t i = 0; i < trigramBatch.fileIds.size(); i++)
+			{
+				const Id fileId = trigramBatch.fileIds[i];
+				Shard& shard = m_shards[getShardIndex(fileId)];
+				shard.fileIds.push_back(fileId);
+				for (uint32_t trigram: trigramBatch.trigrams[i])
+				{
+					shard.postings[trigram].push_back(fileId);
+				}
+			}
+		}
+	});
+
+	auto joinThreads = [&]() {
+		fileQueue.close();
+		for (std::shared_ptr<std::thread> thread: collectThreads)
+		{
+			thread->join();
+		}
+		trigramQueue.close();
+		addThread.join();
+	};
+
+	size_t byteCount = 0;
+	FileBatch fileBatch;
+	try
+	{
+		readFiles([&](Id fileId, std::string&& text) {
+			if (text.empty())
+			{
+				return;
+			}
+
+			byteCount += text.size();
+			fileBatch.byteCount += text.size();
+			fileBatch.fileIds.push_back(fileId);
+			fileBatch.texts.push_back(std::move(text));
+
+			if (fileBatch.byteCount >= s_buildBatchByteCount)
+			{
+				fileQueue.push(std::move(fileBatch));
+				fileBatch = FileBatch();
+			}
+		});
+	}
+	catch (...)
+	{
+		joinThreads();
+		throw;
+	}
+
+	if (!fileBatch.fileIds.empty())
+	{
+		fileQueue.push(std::move(fileBatch));
+	}
+	joinThreads();
+
+	return byteCount;
+}
+
+void TrigramIndex::finishSetup()
+{
+	TRACE();
+
+	// after an update only the lists of added files are out of order
+	for (Shard& shard: m_shards)
+	{
+		if (!std::is_sorted(shard.fileIds.begin(), shard.fileIds.end()))
+		{
+			std::sort(shard.fileIds.begin(), shard.fileIds.end());
+		}
+		for (auto& p: shard.postings)
+		{
+			if (!std::is_sorted(p.second.begin(), p.second.end()))
+			{
+				std::sort(p.second.begin(), p.second.end());
+			}
+		}
+	}
+}
+
+std::vector<Id> TrigramIndex::update(
+	const std::map<Id, std::string>& fileStamps, size_t threadCount)
+{
+	TRACE();
+
+	std::vector<std::vector<Id>> removedFileIds(m_shards.size());
+	for (const auto& p: m_fileStamps)
+	{
+		auto it = fileStamps.find(p.first);
+		if (it == fileStamps.end() || it->second != p.second)
+		{
+			removedFileIds[getShardIndex(p.first)].push_back(p.first);
+		}
+	}
+
+	std::vector<Id> addedFileIds;
+	for (const auto& p: fileStamps)
+	{
+		auto it = m_fileStamps.find(p.first);
+		if (it == m_fileStamps.end() || it->second != p.second)
+		{
+			addedFileIds.push_back(p.first);
+		}
+	}
+
+	// the removed ids of every shard are sorted like the stamps
+	forEachIndexInParallel(m_shards.size(), threadCount, [this, &removedFileIds](size_t i) {
+		const std::vector<Id>& removed = removedFileIds[i];
+		if (removed.empty())
+		{
+			return;
+		}
+
+		auto isRemoved = [&removed](Id fileId) {
+			return std::binary_search(removed.begin(), removed.end(), fileId);
+		};
+
+		Shard& shard = m_shards[i];
+		shard.fileIds.erase(
+			std::remove_if(shard.fileIds.begin(), shard.fileIds.end(), isRemoved),
+			shard.fileIds.end());
+
+		for (auto it = shard.postings.begin(); it != shard.postings.end();)
+		{
+			it->second.erase(
+				std::remove_if(it->second.begin(), it->second.end(), isRemoved), it->second.end());
+			if (it->second.empty())
+			{
+				it = shard.postings.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	});
+
+	m_fileStamps = fileStamps;
+	return addedFileIds;
+}
+
+void TrigramIndex::clear()
+{
+	m_shards.assign(s_shardCount, Shard());
+	m_fileStamps.clear();
+}
+
+size_t TrigramIndex::getFileCount() const
+{
+	size_t fileCount = 0;
+	for (const Shard& shard: m_shards)
+	{
+		fileCount += shard.fileIds.size();
+	}
+	return fileCount;
+}
+
+std::vector<Id> TrigramIndex::getCandidateFileIds(
+	const std::vector<uint32_t>& trigrams, size_t threadCount) const
+{
+	std::vector<std::vector<Id>> shardCandidates(m_shards.size());
+	forEachIndexInParallel(
+		m_shards.size(),
+		getFileCount() < s_minParallelFileCount ? 1 : threadCount,
+		[this, &trigrams, &shardCandidates](size_t i) {
+			shardCandidates[i] = intersectPostings(
+				m_shards[i].fileIds, m_shards[i].postings, trigrams);
+		});
+
+	std::vector<Id> candidates;
+	for (const std::vector<Id>& ids: shardCandidates)
+	{
+		utility::append(candidates, ids);
+	}
+	std::sort(candidates.begin(), candidates.end());
+	return candidates;
+}
+
+std::vector<FullTextSearchResult> TrigramIndex::search(
+	const std::string& term,
+	bool caseSensitive,
+	bool isRegex,
+	std::function<std::string(Id)> getFileText,
+	size_t threadCount) const
+{
+	std::vector<FullTextSearchResult> results;
+	search(
+		term,
+		caseSensitive,
+		isRegex,
+		getFileText,
+		threadCount,
+		0,
+		0,
+		[&results](std::vector<FullTextSearchResult>&& batch) {
+			utility::append(results, batch);
+			return true;
+		});
+	return results;
+}
+
+size_t TrigramIndex::search(
+	const std::string& term,
+	bool caseSensitive,
+	bool isRegex,
+	std::function<std::string(Id)> getFileText,
+	size_t threadCount,
+	size_t firstCandidateIndex,
+	size_t batchSize,
+	std::function<bool(std::vector<FullTextSearchResult>&&)> onBatch) const
+{
+	TRACE();
+
+	std::shared_ptr<std::regex> regex;
+	if (isRegex)
+	{
+		try
+		{
+			regex = std::make_shared<std::regex>(
+				term,
+				caseSensitive ? std::regex::ECMAScript
+							  : std::regex::ECMAScript | std::regex::icase);
+		}
+		catch (const std::regex_error& e)
+		{
+			LOG_WARNING("Invalid regular expression for fulltext search: " + std::string(e.what()));
+			return 0;
+		}
+	}
+
+	const std::vector<Id> candidateFileIds = getCandidateFileIds(
+		isRegex ? getRegexTrigrams(term) : getTermTrigrams(term), threadCount);
+
+	if (batchSize == 0)
+	{
+		batchSize = candidateFileIds.size();
+	}
+
+	size_t verifiedCount = 0;
+	size_t matchedCount = 0;
+	size_t candidateIndex = firstCandidateIndex;
+	bool stopped = false;
+	while (candidateIndex < candidateFileIds.size() && !stopped)
+	{
+		const std::vector<Id> batchFileIds(
+			candidateFileIds.begin() + candidateIndex,
+			candidateFileIds.begin() + std::min(candidateIndex + batchSize, candidateFileIds.size()));
+		candidateIndex += batchFileIds.size();
+
+		std::vector<FullTextSearchResult> results;
+		std::mutex resultsMutex;
+		std::vector<std::shared_ptr<std::thread>> threads;
+		for (const std::vector<Id>& part:
+			 utility::splitToEquallySizedParts(batchFileIds, std::max<size_t>(threadCount, 1)))
+		{
+			threads.push_back(std::make_shared<std::thread>([&, part]() {
+				for (Id fileId: part)
+				{
+					const std::string text = getFileText(fileId);
+					FullTextSearchResult result = regex
+						? findRegex(fileId, text, *regex)
+						: findTerm(fileId, text, term, caseSensitive);
+					if (!result.positions.empty())
+					{
+						std::lock_guard<std::mutex> lock(resultsMutex);
+						results.push_back(std::move(result));
+					}
+				}
+			}));
+		}
+
+		for (std::shared_ptr<std::thread> thread: threads)
+		{
+			thread->join();
+		}
+
+		std::sort(
+			results.begin(),
+			results.end(),
+			[](const FullTextSearchResult& a, const FullTextSearchResult& b) {
+				return a.fileId < b.fileId;
+			});
+
+		verifiedCount += batchFileIds.size();
+		matchedCount += results.size();
+		stopped = !onBatch(std::move(results));
+	}
+
+	LOG_INFO(
+		"Fulltext search verified " + std::to_string(verifiedCount) + " of " +
+		std::to_string(candidateFileIds.size()) + " candidates in " +
+		std::to_string(getFileCount()) + " files, " + std::to_string(matchedCount) +
+		" files matched");
+
+	return candidateIndex < candidateFileIds.size() ? candidateIndex : 0;
+}
+
+bool TrigramIndex::save(const FilePath& filePath, const std::string& fingerprint) const
+{
+	TRACE();
+
+	std::ofstream stream(filePath.str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		LOG_ERROR("Could not write fulltext search index to " + filePath.str());
+		return false;
+	}
+
+	stream.write(s_fileMagic, sizeof(s_fileMagic));
+	writeValue<uint32_t>(stream, s_fileVersion);
+	writeValue<uint64_t>(stream, fingerprint.size());
+	stream.write(fingerprint.data(), fingerprint.size());
+
+	writeValue<uint64_t>(stream, m_shards.size());
+	for (const Shard& shard: m_shards)
+	{
+		writeIds(stream, shard.fileIds);
+
+		writeValue<uint64_t>(stream, shard.postings.size());
+		for (const auto& p: shard.postings)
+		{
+			writeValue<uint32_t>(stream, p.first);
+			writeIds(stream, p.second);
+		}
+	}
+
+	writeValue<uint64_t>(stream, m_fileStamps.size());
+	for (const auto& p: m_fileStamps)
+	{
+		writeValue<uint64_t>(stream, p.first);
+		writeValue<uint64_t>(stream, p.second.size());
+		stream.write(p.second.data(), p.second.size());
+	}
+
+	return static_cast<bool>(stream);
+}
+
+bool TrigramIndex::load(const FilePath& filePath, const std::string& fingerprint)
+{
+	return doLoad(filePath, &fingerprint);
+}
+
+bool TrigramIndex::load(const FilePath& filePath)
+{
+	return doLoad(filePath, nullptr);
+}
+
+size_t TrigramIndex::getShardIndex(Id fileId) const
+{
+	return static_cast<size_t>(fileId % m_shards.size());
+}
+
+bool TrigramIndex::doLoad(const FilePath& filePath, const std::string* fingerprint)
+{
+	TRACE();
+
+	clear();
+
+	std::ifstream stream(filePath.str(), std::ios::in | std::ios::binary);
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	char magic[sizeof(s_fileMagic)];
+	uint32_t version = 0;
+	uint64_t fingerprintSize = 0;
+	if (!stream.read(magic, sizeof(magic)) ||
+		!std::equal(magic, magic + sizeof(magic), s_fileMagic) || !readValue(stream, version) ||
+		version != s_fileVersion || !readValue(stream, fingerprintSize) ||
+		(fingerprint && fingerprintSize != fingerprint->size()))
+	{
+		return false;
+	}
+
+	std::string storedFingerprint(static_cast<size_t>(fingerprintSize), '\0');
+	if (!stream.read(&storedFingerprint[0], storedFingerprint.size()) ||
+		(fingerprint && storedFingerprint != *fingerprint))
+	{
+		return false;
+	}
+
+	uint64_t shardCount = 0;
+	if (!readValue(stream, shardCount) || shardCount != m_shards.size())
+	{
+		return false;
+	}
+
+	for (Shard& shard: m_shards)
+	{
+		uint64_t trigramCount = 0;
+		if (!readIds(stream, shard.fileIds) || !readValue(stream, trigramCount))
+		{
+			clear();
+			return false;
+		}
+
+		shard.postings.reserve(static_cast<size_t>(trigramCount));
+		for (uint64_t i = 0; i < trigramCount; i++)
+		{
+			uint32_t trigram = 0;
+			if (!readValue(stream, trigram) || !readIds(stream, shard.postings[trigram]))
+			{
+				clear();
+				return false;
+			}
+		}
+	}
+
+	uint64_t stampCount = 0;
+	if (!readValue(stream, stampCount))
+	{
+		clear();
+		return false;
+	}
+
+	for (uint64_t i = 0; i < stampCount; i++)
+	{
+		uint64_t fileId = 0;
+		uint64_t stampSize = 0;
+		if (!readValue(stream, fileId) || !readValue(stream, stampSize))
+		{
+			clear();
+			return false;
+		}
+
+		std::string stamp(static_cast<size_t>(stampSize), '\0');
+		if (!stream.read(&stamp[0], stamp.size()))
+		{
+			clear();
+			return false;
+		}
+		m_fileStamps.emplace_hint(m_fileStamps.end(), static_cast<Id>(fileId), std::move(stamp));
+	}
+
+	return true;
+}
@@ -0,0 +1,104 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FullTextSearchResult.h"
+#include "types.h"
+
+class FilePath;
+
+// Posting lists of all byte trigrams occurring in the indexed file contents. Trigrams are built from
+// ASCII case folded text, so one index serves case-sensitive and case-insensitive queries. A query
+// only reads the contents of files containing all trigrams of the term (or of the literal parts of a
+// regular expression) and verifies the matches there. Result positions and lengths are in bytes.
+// Files are split into shards by their id. The shards are queried in parallel and a refresh only
+// removes and adds the files whose content changed.
+class TrigramIndex
+{
+public:
+	static std::vector<uint32_t> getTermTrigrams(const std::string& term);
+
+	// trigrams every match of the pattern has to contain, empty if none can be derived
+	static std::vector<uint32_t> getRegexTrigrams(const std::string& pattern);
+
+	static FullTextSearchResult findTerm(
+		Id fileId, const std::string& text, const std::string& term, bool caseSensitive);
+
+	// matches the regular expression line by line, so '^' and '$' refer to line boundaries
+	static FullTextSearchResult findRegex(Id fileId, const std::string& text, const std::regex& regex);
+
+	TrigramIndex();
+
+	// can be called from multiple threads, call finishSetup() afterwards
+	void addFile(Id fileId, const std::string& text);
+
+	// readFiles passes all files to the given callback. The trigrams of the read files are collected
+	// on threadCount threads and added to the posting lists by a single thread. Returns the number
+	// of bytes read, call finishSetup() afterwards.
+	size_t addFiles(
+		std::function<void(const std::function<void(Id, std::string&&)>&)> readFiles,
+		size_t threadCount);
+
+	void finishSetup();
+
+	// fileStamps identify the content of all files that should be indexed. Removes the files that
+	// are gone or whose stamp changed and returns the ids of the files that have to be added.
+	std::vector<Id> update(const std::map<Id, std::string>& fileStamps, size_t threadCount);
+
+	void clear();
+	size_t getFileCount() const;
+
+	std::vector<Id> getCandidateFileIds(
+		const std::vector<uint32_t>& trigrams, size_t threadCount = 1) const;
+
+	std::vector<FullTextSearchResult> search(
+		const std::string& term,
+		bool caseSensitive,
+		bool isRegex,
+		std::function<std::string(Id)> getFileText,
+		size_t threadCount) const;
+
+	// verifies the candidate files in batches of batchSize (0 for a single batch), starting at
+	// firstCandidateIndex. onBatch gets the matching files of each batch and returns false to stop.
+	// Returns the candidate index to continue from after a stop, 0 if all candidates were verified.
+	size_t search(
+		const std::string& term,
+		bool caseSensitive,
+		bool isRegex,
+		std::function<std::string(Id)> getFileText,
+		size_t threadCount,
+		size_t firstCandidateIndex,
+		size_t batchSize,
+		std::function<bool(std::vector<FullTextSearchResult>&&)> onBatch) const;
+
+	// the fingerprint identifies the indexed file contents, load() fails if it does not match
+	bool save(const FilePath& filePath, const std::string& fingerprint) const;
+	bool load(const FilePath& filePath, const std::string& fingerprint);
+
+	// loads the index saved for any fingerprint, call update() to replace the outdated files
+	bool load(const FilePath& filePath);
+
+private:
+	struct Shard
+	{
+		std::vector<Id> fileIds;
+		std::unordered_map<uint32_t, std::vector<Id>> postings;
+	};
+
+	size_t getShardIndex(Id fileId) const;
+	bool doLoad(const FilePath& filePath, const std::string* fingerprint);
+
+	std::mutex m_addFileMutex;
+	std::vector<Shard> m_shards;
+	std::map<Id, std::string> m_fileStamps;
+};
+
+#endif	  // TRIGRAM_INDEX_H
@@ -2,7 +2,7 @@
 
 #include "logging.h"
 
-Graph::Graph(): m_trailMode(TRAIL_NONE) {}
+Graph::Graph(): m_trailMode(TRAIL_NONE), m_isTrailTruncated(false) {}
 
 Graph::~Graph()
 {
@@ -300,6 +300,16 @@ void Graph::setHasTrailOrigin(bool hasOrigin)
 	m_hasTrailOrigin = hasOrigin;
 }
 
+bool Graph::isTrailTruncated() const
+{
+	return m_isTrailTruncated;
+}
+
+void Graph::setIsTrailTruncated(bool isTruncated)
+{
+	m_isTrailTruncated = isTruncated;
+}
+
 void Graph::print(std::wostream& ostream) const
 {
 	ostream << L"Graph:\n";
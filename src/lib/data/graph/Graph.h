@@ -62,6 +62,10 @@ public:
 	bool hasTrailOrigin() const;
 	void setHasTrailOrigin(bool hasOrigin);
 
+	// the trail search stopped before it could find all trails
+	bool isTrailTruncated() const;
+	void setIsTrailTruncated(bool isTruncated);
+
 	void print(std::wostream& ostream) const;
 	void printBasic(std::wostream& ostream) const;
 
@@ -76,6 +80,7 @@ private:
 
 	TrailMode m_trailMode;
 	bool m_hasTrailOrigin;
+	bool m_isTrailTruncated;
 };
 
 std::wostream& operator<<(std::wostream& ostream, const Graph& graph);
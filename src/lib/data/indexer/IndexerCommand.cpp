@@ -25,6 +25,31 @@ const FilePath& IndexerCommand::getSourceFilePath() const
 	return m_sourceFilePath;
 }
 
+std::string IndexerCommand::getPreprocessorContextKey() const
+{
+	return "";
+}
+
+const std::set<FilePath>& IndexerCommand::getAlreadyIndexedFilePaths() const
+{
+	return m_alreadyIndexedFilePaths;
+}
+
+void IndexerCommand::setAlreadyIndexedFilePaths(std::set<FilePath> filePaths)
+{
+	m_alreadyIndexedFilePaths = std::move(filePaths);
+}
+
+const std::set<FilePath>& IndexerCommand::getShareableFilePaths() const
+{
+	return m_shareableFilePaths;
+}
+
+void IndexerCommand::setShareableFilePaths(std::set<FilePath> filePaths)
+{
+	m_shareableFilePaths = std::move(filePaths);
+}
+
 QJsonObject IndexerCommand::doSerialize() const
 {
 	QJsonObject jsonObject;
@@ -25,11 +25,25 @@ public:
 
 	const FilePath& getSourceFilePath() const;
 
+	// Identifies the preprocessor setup of this command. Shareable headers that were completely
+	// recorded by a command with the same key don't need to be recorded again. Empty if nothing can
+	// be shared.
+	virtual std::string getPreprocessorContextKey() const;
+
+	const std::set<FilePath>& getAlreadyIndexedFilePaths() const;
+	void setAlreadyIndexedFilePaths(std::set<FilePath> filePaths);
+
+	// headers recorded by this command that expand the same way in every file that includes them
+	const std::set<FilePath>& getShareableFilePaths() const;
+	void setShareableFilePaths(std::set<FilePath> filePaths);
+
 protected:
 	virtual QJsonObject doSerialize() const;
 
 private:
 	FilePath m_sourceFilePath;
+	std::set<FilePath> m_alreadyIndexedFilePaths;
+	std::set<FilePath> m_shareableFilePaths;
 };
 
 #endif	  // INDEXER_COMMAND_H
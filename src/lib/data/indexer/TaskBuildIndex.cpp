@@ -244,7 +244,8 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 	{
 		LOG_INFO_STREAM(<< "waiting, too many storages queued: " << providerStorageCount);
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		// merging and injecting storages notifies the blackboard
+		blackboard->waitForUpdate(blackboard->getUpdateCount(), 100);
 
 		return true;
 	}
@@ -269,13 +270,18 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 		}
 
 		LOG_INFO_STREAM(<< storageManager->getProcessId() << " - storage count: " << storageCount);
-		m_storageProvider->insert(storageManager->popIntermediateStorage());
+		if (std::shared_ptr<FlatIntermediateStorage> storage =
+				storageManager->popIntermediateStorage())
+		{
+			m_storageProvider->insert(storage);
+		}
 		poppedStorageCount++;
 	} while (TimeStamp::now().deltaMS(t) <
 			 500);	  // don't process all storages at once to allow for status updates in-between
 
 	if (poppedStorageCount > 0)
 	{
+		// also wakes up the tasks waiting for new storages
 		blackboard->update<int>(
 			"indexed_source_file_count", [=](int count) { return count + poppedStorageCount; });
 		return true;
@@ -9,10 +9,12 @@
 TaskFillIndexerCommandsQueue::TaskFillIndexerCommandsQueue(
 	const std::string& appUUID,
 	std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-	size_t maximumQueueSize)
+	size_t maximumQueueSize,
+	std::map<FilePath, utility::IndexingCost> indexingCosts)
 	: m_indexerCommandProvider(std::move(indexerCommandProvider))
 	, m_indexerCommandManager(appUUID, 0, true)
 	, m_maximumQueueSize(maximumQueueSize)
+	, m_indexingCosts(std::move(indexingCosts))
 {
 }
 
@@ -20,8 +22,10 @@ void TaskFillIndexerCommandsQueue::doEnter(std::shared_ptr<Blackboard> blackboar
 {
 	{
 		std::lock_guard<std::mutex> lock(m_commandsMutex);
-		for (const FilePath& filePath:
-			 utility::partitionFilePathsBySize(m_indexerCommandProvider->getAllSourceFilePaths(), 2))
+		// dispatching the longest translation units first keeps a single straggler from
+		// running on its own at the end of indexing
+		for (const FilePath& filePath: utility::orderFilePathsByExpectedDuration(
+				 m_indexerCommandProvider->getAllSourceFilePaths(), m_indexingCosts))
 		{
 			m_filePathQueue.emplace(filePath);
 		}
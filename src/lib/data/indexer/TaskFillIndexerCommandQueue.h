@@ -1,6 +1,7 @@
 #ifndef TASK_FILL_INDEXER_COMMAND_QUEUE_H
 #define TASK_FILL_INDEXER_COMMAND_QUEUE_H
 
+#include <map>
 #include <queue>
 
 #include "MessageIndexingInterrupted.h"
@@ -8,6 +9,7 @@
 #include "Task.h"
 
 #include "InterprocessIndexerCommandManager.h"
+#include "utilityFile.h"
 
 class IndexerCommandProvider;
 
@@ -19,7 +21,8 @@ public:
 	TaskFillIndexerCommandsQueue(
 		const std::string& appUUID,
 		std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-		size_t maximumQueueSize);
+		size_t maximumQueueSize,
+		std::map<FilePath, utility::IndexingCost> indexingCosts = {});
 
 protected:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -38,6 +41,9 @@ private:
 
 	const size_t m_maximumQueueSize;
 
+	// indexing costs of previous runs, used to dispatch expensive commands first
+	const std::map<FilePath, utility::IndexingCost> m_indexingCosts;
+
 	std::queue<FilePath> m_filePathQueue;
 	std::mutex m_commandsMutex;
 
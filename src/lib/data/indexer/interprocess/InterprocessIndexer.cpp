@@ -3,8 +3,10 @@
 #include "FileRegister.h"
 #include "IndexerCommand.h"
 #include "IndexerComposite.h"
+#include "IntermediateStorage.h"
 #include "LanguagePackageManager.h"
 #include "ScopedFunctor.h"
+#include "TimeStamp.h"
 #include "logging.h"
 
 InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId)
@@ -86,11 +88,49 @@ void InterprocessIndexer::work()
 			m_interprocessIndexingStatusManager.startIndexingSourceFile(
 				indexerCommand->getSourceFilePath());
 
+			const std::string contextKey = indexerCommand->getPreprocessorContextKey();
+			if (!contextKey.empty())
+			{
+				indexerCommand->setAlreadyIndexedFilePaths(
+					m_interprocessIndexingStatusManager.getIndexedFilePaths(contextKey));
+				LOG_INFO_STREAM(
+					<< m_processId << " skipping "
+					<< indexerCommand->getAlreadyIndexedFilePaths().size()
+					<< " files already indexed in the same context");
+			}
+
 			LOG_INFO_STREAM(<< m_processId << " starting to index current file");
+			const TimeStamp indexingStart = TimeStamp::now();
 			std::shared_ptr<IntermediateStorage> result = indexer->index(indexerCommand);
 
 			if (result)
 			{
+				if (!contextKey.empty())
+				{
+					// files with errors or with content depending on the including file stay
+					// unregistered, so other translation units record them again
+					const std::set<FilePath>& shareableFilePaths =
+						indexerCommand->getShareableFilePaths();
+					std::vector<FilePath> sharedFilePaths;
+					for (const StorageFile& file: result->getStorageFiles())
+					{
+						const FilePath filePath(file.filePath);
+						if (file.indexed && file.complete &&
+							shareableFilePaths.find(filePath) != shareableFilePaths.end())
+						{
+							sharedFilePaths.push_back(filePath);
+						}
+					}
+					m_interprocessIndexingStatusManager.addIndexedFilePaths(
+						contextKey, sharedFilePaths);
+				}
+
+				// remembered in the index to dispatch expensive translation units first next time
+				result->setFileIndexingCost(
+					indexerCommand->getSourceFilePath().wstr(),
+					TimeStamp::now().deltaMS(indexingStart),
+					result->getByteSize(sizeof(std::string)));
+
 				LOG_INFO_STREAM(<< m_processId << " pushing index to shared memory");
 				m_interprocessIntermediateStorageManager.pushIntermediateStorage(result);
 			}
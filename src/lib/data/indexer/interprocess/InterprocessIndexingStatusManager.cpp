@@ -8,6 +8,7 @@ const char* InterprocessIndexingStatusManager::s_sharedMemoryNamePrefix = "ists_
 const char* InterprocessIndexingStatusManager::s_indexingFilesKeyName = "indexing_files";
 const char* InterprocessIndexingStatusManager::s_currentFilesKeyName = "current_files";
 const char* InterprocessIndexingStatusManager::s_crashedFilesKeyName = "crashed_files";
+const char* InterprocessIndexingStatusManager::s_indexedFilesKeyName = "indexed_files";
 const char* InterprocessIndexingStatusManager::s_finishedProcessIdsKeyName = "finished_process_ids";
 const char* InterprocessIndexingStatusManager::s_indexingInterruptedKeyName =
 	"indexing_interrupted_flag";
@@ -202,3 +203,79 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
 
 	return crashedFiles;
 }
+
+void InterprocessIndexingStatusManager::addIndexedFilePaths(
+	const std::string& contextKey, const std::vector<FilePath>& filePaths)
+{
+	if (contextKey.empty() || filePaths.empty())
+	{
+		return;
+	}
+
+	std::vector<std::string> entries;
+	size_t estimatedSize = 0;
+	for (const FilePath& filePath: filePaths)
+	{
+		entries.push_back(contextKey + ':' + utility::encodeToUtf8(filePath.wstr()));
+		estimatedSize += sizeof(SharedMemory::String) + entries.back().size() + 64;
+	}
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	const size_t overestimationMultiplier = 3;
+	estimatedSize *= overestimationMultiplier;
+
+	while (access.getFreeMemorySize() < estimatedSize)
+	{
+		LOG_INFO_STREAM(
+			<< "grow memory - est: " << estimatedSize << " size: " << access.getMemorySize()
+			<< " free: " << access.getFreeMemorySize());
+		access.growMemory(access.getMemorySize());
+	}
+
+	SharedMemory::Set<SharedMemory::String>* indexedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Set<SharedMemory::String>>(
+			s_indexedFilesKeyName);
+	if (indexedFilesPtr)
+	{
+		for (const std::string& entry: entries)
+		{
+			SharedMemory::String str(access.getAllocator());
+			str = entry.c_str();
+			indexedFilesPtr->insert(str);
+		}
+	}
+}
+
+std::set<FilePath> InterprocessIndexingStatusManager::getIndexedFilePaths(const std::string& contextKey)
+{
+	std::set<FilePath> indexedFiles;
+	if (contextKey.empty())
+	{
+		return indexedFiles;
+	}
+
+	const std::string prefix = contextKey + ':';
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Set<SharedMemory::String>* indexedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Set<SharedMemory::String>>(
+			s_indexedFilesKeyName);
+	if (indexedFilesPtr)
+	{
+		SharedMemory::String prefixStr(access.getAllocator());
+		prefixStr = prefix.c_str();
+
+		// entries are ordered, so all paths of this context follow the prefix
+		for (SharedMemory::Set<SharedMemory::String>::const_iterator it = indexedFilesPtr->lower_bound(
+				 prefixStr);
+			 it != indexedFilesPtr->end() && it->compare(0, prefix.size(), prefix.c_str()) == 0;
+			 it++)
+		{
+			indexedFiles.insert(FilePath(utility::decodeFromUtf8(it->c_str() + prefix.size())));
+		}
+	}
+
+	return indexedFiles;
+}
@@ -23,12 +23,18 @@ public:
 	std::vector<FilePath> getCurrentlyIndexedSourceFilePaths();
 	std::vector<FilePath> getCrashedSourceFilePaths();
 
+	// registry of files that have been completely recorded by some indexer, shared between all
+	// indexer processes and grouped by preprocessor context
+	void addIndexedFilePaths(const std::string& contextKey, const std::vector<FilePath>& filePaths);
+	std::set<FilePath> getIndexedFilePaths(const std::string& contextKey);
+
 private:
 	static const char* s_sharedMemoryNamePrefix;
 
 	static const char* s_indexingFilesKeyName;
 	static const char* s_currentFilesKeyName;
 	static const char* s_crashedFilesKeyName;
+	static const char* s_indexedFilesKeyName;
 	static const char* s_finishedProcessIdsKeyName;
 	static const char* s_indexingInterruptedKeyName;
 };
@@ -1,7 +1,8 @@
 #include "InterprocessIntermediateStorageManager.h"
 
+#include "FlatIntermediateStorage.h"
 #include "IntermediateStorage.h"
-#include "SharedIntermediateStorage.h"
+#include "SharedMemoryBuffer.h"
 #include "logging.h"
 
 const char* InterprocessIntermediateStorageManager::s_sharedMemoryNamePrefix = "iist_";
@@ -9,128 +10,147 @@ const char* InterprocessIntermediateStorageManager::s_sharedMemoryNamePrefix = "
 const char* InterprocessIntermediateStorageManager::s_intermediateStoragesKeyName =
 	"intermediate_storages";
 
+const char* InterprocessIntermediateStorageManager::s_pushedStorageCountKeyName =
+	"pushed_storage_count";
+
 InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
 	: BaseInterprocessDataManager(
 		  s_sharedMemoryNamePrefix + std::to_string(processId) + "_" + instanceUuid,
-		  3 * 1048576 /* 3 MB */,
+		  65536 /* 64 kB */,
 		  instanceUuid,
 		  processId,
 		  isOwner)
-	, m_insertsWithoutGrowth(0)
+	, m_isOwner(isOwner)
 {
 }
 
-void InterprocessIntermediateStorageManager::pushIntermediateStorage(
-	const std::shared_ptr<IntermediateStorage>& intermediateStorage)
+InterprocessIntermediateStorageManager::~InterprocessIntermediateStorageManager()
 {
-	const size_t requiredInsertsToShrink = 10;
-
-	const size_t overestimationMultiplier = 2;
-	const size_t requiredSize = (intermediateStorage->getByteSize(sizeof(SharedMemory::String)) +
-								 sizeof(SharedIntermediateStorage)) *
-			overestimationMultiplier +
-		1048576 /* 1 MB */;
-
-	SharedMemory::ScopedAccess access(&m_sharedMemory);
-
-	const size_t freeMemory = access.getFreeMemorySize();
-	if (freeMemory < requiredSize)
+	if (!m_isOwner)
 	{
-		const size_t requiredGrowth = requiredSize - freeMemory;
-
-		LOG_INFO_STREAM(
-			<< "grow memory - est: " << requiredSize << " size: " << access.getMemorySize()
-			<< " free: " << access.getFreeMemorySize() << " alloc: " << requiredGrowth);
-
-		access.growMemory(requiredGrowth);
-
-		LOG_INFO("growing memory succeeded");
+		return;
+	}
 
-		m_insertsWithoutGrowth = 0;
+	try
+	{
+		SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+		SharedMemory::Queue<SharedMemory::String>* queue =
+			access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
+				s_intermediateStoragesKeyName);
+		if (queue)
+		{
+			for (const SharedMemory::String& bufferName: *queue)
+			{
+				SharedMemoryBuffer::deleteSharedMemoryBuffer(bufferName.c_str());
+			}
+		}
 	}
-	else
+	catch (boost::interprocess::interprocess_exception& e)
 	{
-		m_insertsWithoutGrowth++;
+		LOG_ERROR_STREAM(<< "Unable to remove queued intermediate storages: " << e.what());
 	}
+}
 
-	SharedMemory::Queue<SharedIntermediateStorage>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
-			s_intermediateStoragesKeyName);
-	if (!queue)
+void InterprocessIntermediateStorageManager::pushIntermediateStorage(
+	const std::shared_ptr<IntermediateStorage>& intermediateStorage)
+{
+	const std::string bufferName = getNextBufferName();
+
+	// the storage is written without holding the lock, the app is not blocked while it is written
+	try
 	{
+		SharedMemoryBuffer buffer(
+			bufferName,
+			FlatIntermediateStorage::getByteSize(*intermediateStorage),
+			SharedMemoryBuffer::CREATE);
+		FlatIntermediateStorage::write(*intermediateStorage, buffer.getData());
+	}
+	catch (boost::interprocess::interprocess_exception& e)
+	{
+		LOG_ERROR_STREAM(<< "Unable to write intermediate storage to shared memory: " << e.what());
+		SharedMemoryBuffer::deleteSharedMemoryBuffer(bufferName);
 		return;
 	}
 
-	queue->push_back(SharedIntermediateStorage(access.getAllocator()));
-	SharedIntermediateStorage& storage = queue->back();
-
-	storage.setStorageNodes(intermediateStorage->getStorageNodes());
-	storage.setStorageFiles(intermediateStorage->getStorageFiles());
-	storage.setStorageSymbols(intermediateStorage->getStorageSymbols());
-	storage.setStorageEdges(intermediateStorage->getStorageEdges());
-	storage.setStorageLocalSymbols(intermediateStorage->getStorageLocalSymbols());
-	storage.setStorageSourceLocations(intermediateStorage->getStorageSourceLocations());
-	storage.setStorageOccurrences(intermediateStorage->getStorageOccurrences());
-	storage.setStorageComponentAccesses(intermediateStorage->getComponentAccesses());
-	storage.setStorageErrors(intermediateStorage->getErrors());
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
-	storage.setNextId(intermediateStorage->getNextId());
+	// the queue keeps growing while the app does not fetch the storages
+	const size_t overestimationMultiplier = 3;
+	const size_t estimatedSize = overestimationMultiplier *
+		(sizeof(SharedMemory::String) + bufferName.size() + 64);
 
-	if (m_insertsWithoutGrowth >= requiredInsertsToShrink)
+	try
 	{
-		m_insertsWithoutGrowth = 0;
-
-		LOG_INFO("shrinking shared memory");
-		access.shrinkToFitMemory();
-		LOG_INFO_STREAM(
-			<< "shrunk memory - size: " << access.getMemorySize()
-			<< " free: " << access.getFreeMemorySize());
+		while (access.getFreeMemorySize() < estimatedSize)
+		{
+			LOG_INFO_STREAM(
+				<< "grow memory - est: " << estimatedSize << " size: " << access.getMemorySize()
+				<< " free: " << access.getFreeMemorySize());
+			access.growMemory(access.getMemorySize());
+		}
+
+		SharedMemory::Queue<SharedMemory::String>* queue =
+			access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
+				s_intermediateStoragesKeyName);
+		if (!queue)
+		{
+			SharedMemoryBuffer::deleteSharedMemoryBuffer(bufferName);
+			return;
+		}
+
+		queue->push_back(SharedMemory::String(bufferName.c_str(), access.getAllocator()));
+	}
+	catch (boost::interprocess::interprocess_exception& e)
+	{
+		// also thrown as bad_alloc if the queue could not allocate its entry
+		LOG_ERROR_STREAM(<< "Unable to queue intermediate storage: " << e.what());
+		SharedMemoryBuffer::deleteSharedMemoryBuffer(bufferName);
 	}
-
-	LOG_INFO(access.logString());
 }
 
-std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::popIntermediateStorage()
+std::shared_ptr<FlatIntermediateStorage> InterprocessIntermediateStorageManager::
+	popIntermediateStorage()
 {
-	SharedMemory::ScopedAccess access(&m_sharedMemory);
-
-	SharedMemory::Queue<SharedIntermediateStorage>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
-			s_intermediateStoragesKeyName);
-	if (!queue || !queue->size())
+	std::string bufferName;
 	{
-		return nullptr;
+		SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+		SharedMemory::Queue<SharedMemory::String>* queue =
+			access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
+				s_intermediateStoragesKeyName);
+		if (!queue || !queue->size())
+		{
+			return nullptr;
+		}
+
+		bufferName = queue->front().c_str();
+		queue->pop_front();
 	}
 
-	SharedIntermediateStorage& sharedIntermediateStorage = queue->front();
-
-	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
-
-	storage->setStorageNodes(sharedIntermediateStorage.getStorageNodes());
-	storage->setStorageFiles(sharedIntermediateStorage.getStorageFiles());
-	storage->setStorageSymbols(sharedIntermediateStorage.getStorageSymbols());
-	storage->setStorageEdges(sharedIntermediateStorage.getStorageEdges());
-	storage->setStorageLocalSymbols(sharedIntermediateStorage.getStorageLocalSymbols());
-	storage->setStorageSourceLocations(sharedIntermediateStorage.getStorageSourceLocations());
-	storage->setStorageOccurrences(sharedIntermediateStorage.getStorageOccurrences());
-	storage->setComponentAccesses(sharedIntermediateStorage.getStorageComponentAccesses());
-	storage->setErrors(sharedIntermediateStorage.getStorageErrors());
-
-	storage->setNextId(sharedIntermediateStorage.getNextId());
-
-	queue->pop_front();
-	LOG_INFO(access.logString());
+	// the buffer is only used by this process from here on, so it is read without locking and
+	// removed once the last view on it is gone
+	try
+	{
+		return FlatIntermediateStorage::create(std::make_shared<SharedMemoryBuffer>(
+			bufferName, 0, SharedMemoryBuffer::OPEN_AND_DELETE));
+	}
+	catch (boost::interprocess::interprocess_exception& e)
+	{
+		LOG_ERROR_STREAM(<< "Unable to read intermediate storage from shared memory: " << e.what());
+		SharedMemoryBuffer::deleteSharedMemoryBuffer(bufferName);
+	}
 
-	return storage;
+	return nullptr;
 }
 
 size_t InterprocessIntermediateStorageManager::getIntermediateStorageCount()
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
-	SharedMemory::Queue<SharedIntermediateStorage>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
+	SharedMemory::Queue<SharedMemory::String>* queue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
 			s_intermediateStoragesKeyName);
 	if (!queue)
 	{
@@ -139,3 +159,23 @@ size_t InterprocessIntermediateStorageManager::getIntermediateStorageCount()
 
 	return queue->size();
 }
+
+std::string InterprocessIntermediateStorageManager::getNextBufferName()
+{
+	// the count lives in shared memory, so a restarted indexer process does not reuse the names of
+	// buffers that are still queued
+	size_t pushedStorageCount = 0;
+	{
+		SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+		size_t* count = access.accessValue<size_t>(s_pushedStorageCountKeyName);
+		if (count)
+		{
+			pushedStorageCount = (*count)++;
+		}
+	}
+
+	return SharedMemory::checkName(
+		std::to_string(m_processId) + "_" + std::to_string(pushedStorageCount) + "_" +
+		m_instanceUuid);
+}
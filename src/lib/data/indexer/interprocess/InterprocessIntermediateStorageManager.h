@@ -3,24 +3,30 @@
 
 #include "BaseInterprocessDataManager.h"
 
+class FlatIntermediateStorage;
 class IntermediateStorage;
 
+// Each pushed storage is written into a shared memory buffer of its own, the queue in the shared
+// memory of the manager only holds the names of these buffers.
 class InterprocessIntermediateStorageManager: public BaseInterprocessDataManager
 {
 public:
 	InterprocessIntermediateStorageManager(const std::string& instanceUuid, Id processId, bool isOwner);
-	virtual ~InterprocessIntermediateStorageManager() = default;
+	virtual ~InterprocessIntermediateStorageManager();
 
 	void pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& intermediateStorage);
-	std::shared_ptr<IntermediateStorage> popIntermediateStorage();
+	std::shared_ptr<FlatIntermediateStorage> popIntermediateStorage();
 
 	size_t getIntermediateStorageCount();
 
 private:
+	std::string getNextBufferName();
+
 	static const char* s_sharedMemoryNamePrefix;
 	static const char* s_intermediateStoragesKeyName;
+	static const char* s_pushedStorageCountKeyName;
 
-	size_t m_insertsWithoutGrowth;
+	const bool m_isOwner;
 };
 
 #endif	  // INTERPROCESS_INTERMEDIATE_STORAGE_MANAGER_H
@@ -0,0 +1,590 @@
+#include "FlatIntermediateStorage.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "IntermediateStorage.h"
+#include "SharedMemoryBuffer.h"
+#include "logging.h"
+
+namespace
+{
+const uint32_t s_magic = 0x54534946;	// "FIST"
+const uint32_t s_version = 1;
+
+struct StringRef
+{
+	uint64_t offset;
+	uint64_t size;	  // in bytes
+};
+
+struct Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t nextId;
+	uint64_t nodeCount;
+	uint64_t fileCount;
+	uint64_t symbolCount;
+	uint64_t edgeCount;
+	uint64_t localSymbolCount;
+	uint64_t sourceLocationCount;
+	uint64_t occurrenceCount;
+	uint64_t componentAccessCount;
+	uint64_t errorCount;
+	uint64_t stringPoolSize;
+};
+
+struct NodeRecord
+{
+	uint64_t id;
+	int64_t type;
+	StringRef serializedName;
+};
+
+struct FileRecord
+{
+	uint64_t id;
+	StringRef filePath;
+	StringRef languageIdentifier;
+	StringRef modificationTime;
+	uint64_t indexingDuration;
+	uint64_t storageSize;
+	uint32_t indexed;
+	uint32_t complete;
+};
+
+struct SymbolRecord
+{
+	uint64_t id;
+	int64_t definitionKind;
+};
+
+struct EdgeRecord
+{
+	uint64_t id;
+	uint64_t sourceNodeId;
+	uint64_t targetNodeId;
+	int64_t type;
+};
+
+struct LocalSymbolRecord
+{
+	uint64_t id;
+	StringRef name;
+};
+
+struct SourceLocationRecord
+{
+	uint64_t id;
+	uint64_t fileNodeId;
+	uint64_t startLine;
+	uint64_t startCol;
+	uint64_t endLine;
+	uint64_t endCol;
+	int64_t type;
+};
+
+struct OccurrenceRecord
+{
+	uint64_t elementId;
+	uint64_t sourceLocationId;
+};
+
+struct ComponentAccessRecord
+{
+	uint64_t nodeId;
+	int64_t type;
+};
+
+struct ErrorRecord
+{
+	uint64_t id;
+	StringRef message;
+	StringRef translationUnit;
+	uint32_t fatal;
+	uint32_t indexed;
+};
+
+size_t getStringByteSize(const std::wstring& str)
+{
+	return str.size() * sizeof(wchar_t);
+}
+
+size_t getStringByteSize(const std::string& str)
+{
+	return str.size();
+}
+
+size_t getRecordsByteSize(const IntermediateStorage& storage)
+{
+	return storage.getStorageNodes().size() * sizeof(NodeRecord) +
+		storage.getStorageFiles().size() * sizeof(FileRecord) +
+		storage.getStorageSymbols().size() * sizeof(SymbolRecord) +
+		storage.getStorageEdges().size() * sizeof(EdgeRecord) +
+		storage.getStorageLocalSymbols().size() * sizeof(LocalSymbolRecord) +
+		storage.getStorageSourceLocations().size() * sizeof(SourceLocationRecord) +
+		storage.getStorageOccurrences().size() * sizeof(OccurrenceRecord) +
+		storage.getComponentAccesses().size() * sizeof(ComponentAccessRecord) +
+		storage.getErrors().size() * sizeof(ErrorRecord);
+}
+
+size_t getStringPoolByteSize(const IntermediateStorage& storage)
+{
+	size_t size = 0;
+	for (const StorageNode& node: storage.getStorageNodes())
+	{
+		size += getStringByteSize(node.serializedName);
+	}
+	for (const StorageFile& file: storage.getStorageFiles())
+	{
+		size += getStringByteSize(file.filePath) + getStringByteSize(file.languageIdentifier) +
+			getStringByteSize(file.modificationTime);
+	}
+	for (const StorageLocalSymbol& localSymbol: storage.getStorageLocalSymbols())
+	{
+		size += getStringByteSize(localSymbol.name);
+	}
+	for (const StorageError& error: storage.getErrors())
+	{
+		size += getStringByteSize(error.message) + getStringByteSize(error.translationUnit);
+	}
+	return size;
+}
+
+class Writer
+{
+public:
+	Writer(char* buffer, size_t stringPoolOffset)
+		: m_buffer(buffer), m_recordOffset(sizeof(Header)), m_stringOffset(stringPoolOffset)
+	{
+	}
+
+	template <typename T>
+	void writeRecord(const T& record)
+	{
+		std::memcpy(m_buffer + m_recordOffset, &record, sizeof(T));
+		m_recordOffset += sizeof(T);
+	}
+
+	template <typename StringType>
+	StringRef writeString(const StringType& str)
+	{
+		StringRef ref;
+		ref.offset = m_stringOffset;
+		ref.size = getStringByteSize(str);
+
+		std::memcpy(m_buffer + m_stringOffset, str.data(), ref.size);
+		m_stringOffset += ref.size;
+		return ref;
+	}
+
+private:
+	char* m_buffer;
+	size_t m_recordOffset;
+	size_t m_stringOffset;
+};
+
+template <typename RecordType>
+RecordType readRecord(const char* data, size_t offset)
+{
+	// copied instead of cast, so reading does not depend on the alignment within the buffer
+	RecordType record;
+	std::memcpy(&record, data + offset, sizeof(RecordType));
+	return record;
+}
+
+template <typename StringType>
+StringType readString(const char* data, const StringRef& ref)
+{
+	typedef typename StringType::value_type CharType;
+
+	StringType str(ref.size / sizeof(CharType), CharType(0));
+	if (ref.size)
+	{
+		std::memcpy(&str[0], data + ref.offset, ref.size);
+	}
+	return str;
+}
+
+template <typename CharType>
+bool isValidString(const StringRef& ref, size_t stringPoolOffset, size_t stringPoolSize)
+{
+	return ref.offset >= stringPoolOffset && ref.offset - stringPoolOffset <= stringPoolSize &&
+		ref.size <= stringPoolSize - (ref.offset - stringPoolOffset) &&
+		ref.size % sizeof(CharType) == 0;
+}
+}	 // namespace
+
+size_t FlatIntermediateStorage::getByteSize(const IntermediateStorage& storage)
+{
+	return sizeof(Header) + getRecordsByteSize(storage) + getStringPoolByteSize(storage);
+}
+
+void FlatIntermediateStorage::write(const IntermediateStorage& storage, char* buffer)
+{
+	Header header;
+	std::memset(&header, 0, sizeof(Header));
+	header.magic = s_magic;
+	header.version = s_version;
+	header.nextId = storage.getNextId();
+	header.nodeCount = storage.getStorageNodes().size();
+	header.fileCount = storage.getStorageFiles().size();
+	header.symbolCount = storage.getStorageSymbols().size();
+	header.edgeCount = storage.getStorageEdges().size();
+	header.localSymbolCount = storage.getStorageLocalSymbols().size();
+	header.sourceLocationCount = storage.getStorageSourceLocations().size();
+	header.occurrenceCount = storage.getStorageOccurrences().size();
+	header.componentAccessCount = storage.getComponentAccesses().size();
+	header.errorCount = storage.getErrors().size();
+	header.stringPoolSize = getStringPoolByteSize(storage);
+	std::memcpy(buffer, &header, sizeof(Header));
+
+	Writer writer(buffer, sizeof(Header) + getRecordsByteSize(storage));
+
+	for (const StorageNode& node: storage.getStorageNodes())
+	{
+		NodeRecord record;
+		record.id = node.id;
+		record.type = node.type;
+		record.serializedName = writer.writeString(node.serializedName);
+		writer.writeRecord(record);
+	}
+
+	for (const StorageFile& file: storage.getStorageFiles())
+	{
+		FileRecord record;
+		record.id = file.id;
+		record.filePath = writer.writeString(file.filePath);
+		record.languageIdentifier = writer.writeString(file.languageIdentifier);
+		record.modificationTime = writer.writeString(file.modificationTime);
+		record.indexingDuration = file.indexingDuration;
+		record.storageSize = file.storageSize;
+		record.indexed = file.indexed;
+		record.complete = file.complete;
+		writer.writeRecord(record);
+	}
+
+	for (const StorageSymbol& symbol: storage.getStorageSymbols())
+	{
+		SymbolRecord record;
+		record.id = symbol.id;
+		record.definitionKind = symbol.definitionKind;
+		writer.writeRecord(record);
+	}
+
+	for (const StorageEdge& edge: storage.getStorageEdges())
+	{
+		EdgeRecord record;
+		record.id = edge.id;
+		record.sourceNodeId = edge.sourceNodeId;
+		record.targetNodeId = edge.targetNodeId;
+		record.type = edge.type;
+		writer.writeRecord(record);
+	}
+
+	for (const StorageLocalSymbol& localSymbol: storage.getStorageLocalSymbols())
+	{
+		LocalSymbolRecord record;
+		record.id = localSymbol.id;
+		record.name = writer.writeString(localSymbol.name);
+		writer.writeRecord(record);
+	}
+
+	for (const StorageSourceLocation& location: storage.getStorageSourceLocations())
+	{
+		SourceLocationRecord record;
+		record.id = location.id;
+		record.fileNodeId = location.fileNodeId;
+		record.startLine = location.startLine;
+		record.startCol = location.startCol;
+		record.endLine = location.endLine;
+		record.endCol = location.endCol;
+		record.type = location.type;
+		writer.writeRecord(record);
+	}
+
+	for (const StorageOccurrence& occurrence: storage.getStorageOccurrences())
+	{
+		OccurrenceRecord record;
+		record.elementId = occurrence.elementId;
+		record.sourceLocationId = occurrence.sourceLocationId;
+		writer.writeRecord(record);
+	}
+
+	for (const StorageComponentAccess& componentAccess: storage.getComponentAccesses())
+	{
+		ComponentAccessRecord record;
+		record.nodeId = componentAccess.nodeId;
+		record.type = componentAccess.type;
+		writer.writeRecord(record);
+	}
+
+	for (const StorageError& error: storage.getErrors())
+	{
+		ErrorRecord record;
+		record.id = error.id;
+		record.message = writer.writeString(error.message);
+		record.translationUnit = writer.writeString(error.translationUnit);
+		record.fatal = error.fatal;
+		record.indexed = error.indexed;
+		writer.writeRecord(record);
+	}
+}
+
+std::shared_ptr<FlatIntermediateStorage> FlatIntermediateStorage::create(
+	std::shared_ptr<SharedMemoryBuffer> buffer)
+{
+	std::shared_ptr<FlatIntermediateStorage> storage(new FlatIntermediateStorage(buffer));
+	if (!storage->init())
+	{
+		return nullptr;
+	}
+	return storage;
+}
+
+std::vector<StorageNode> FlatIntermediateStorage::getStorageNodes() const
+{
+	std::vector<StorageNode> nodes;
+	nodes.reserve(m_nodes.count);
+	for (size_t i = 0; i < m_nodes.count; i++)
+	{
+		const NodeRecord record = getRecord<NodeRecord>(m_nodes, i);
+		nodes.emplace_back(
+			record.id,
+			static_cast<int>(record.type),
+			readString<std::wstring>(m_data, record.serializedName));
+	}
+	return nodes;
+}
+
+std::vector<StorageFile> FlatIntermediateStorage::getStorageFiles() const
+{
+	std::vector<StorageFile> files;
+	files.reserve(m_files.count);
+	for (size_t i = 0; i < m_files.count; i++)
+	{
+		const FileRecord record = getRecord<FileRecord>(m_files, i);
+		files.emplace_back(
+			record.id,
+			readString<std::wstring>(m_data, record.filePath),
+			readString<std::wstring>(m_data, record.languageIdentifier),
+			readString<std::string>(m_data, record.modificationTime),
+			record.indexed != 0,
+			record.complete != 0);
+		files.back().indexingDuration = record.indexingDuration;
+		files.back().storageSize = record.storageSize;
+	}
+	return files;
+}
+
+std::vector<StorageSymbol> FlatIntermediateStorage::getStorageSymbols() const
+{
+	std::vector<StorageSymbol> symbols;
+	symbols.reserve(m_symbols.count);
+	for (size_t i = 0; i < m_symbols.count; i++)
+	{
+		const SymbolRecord record = getRecord<SymbolRecord>(m_symbols, i);
+		symbols.emplace_back(record.id, static_cast<int>(record.definitionKind));
+	}
+	return symbols;
+}
+
+std::vector<StorageEdge> FlatIntermediateStorage::getStorageEdges() const
+{
+	std::vector<StorageEdge> edges;
+	edges.reserve(m_edges.count);
+	for (size_t i = 0; i < m_edges.count; i++)
+	{
+		const EdgeRecord record = getRecord<EdgeRecord>(m_edges, i);
+		edges.emplace_back(
+			record.id, static_cast<int>(record.type), record.sourceNodeId, record.targetNodeId);
+	}
+	return edges;
+}
+
+std::set<StorageLocalSymbol> FlatIntermediateStorage::getStorageLocalSymbols() const
+{
+	// set elements were written in order, so inserting at the end keeps construction linear
+	std::set<StorageLocalSymbol> localSymbols;
+	for (size_t i = 0; i < m_localSymbols.count; i++)
+	{
+		const LocalSymbolRecord record = getRecord<LocalSymbolRecord>(m_localSymbols, i);
+		localSymbols.emplace_hint(
+			localSymbols.end(), record.id, readString<std::wstring>(m_data, record.name));
+	}
+	return localSymbols;
+}
+
+std::vector<StorageSourceLocation> FlatIntermediateStorage::getStorageSourceLocations() const
+{
+	std::vector<StorageSourceLocation> sourceLocations;
+	sourceLocations.reserve(m_sourceLocations.count);
+	for (size_t i = 0; i < m_sourceLocations.count; i++)
+	{
+		const SourceLocationRecord record = getRecord<SourceLocationRecord>(m_sourceLocations, i);
+		sourceLocations.emplace_back(
+			record.id,
+			record.fileNodeId,
+			record.startLine,
+			record.startCol,
+			record.endLine,
+			record.endCol,
+			static_cast<int>(record.type));
+	}
+	return sourceLocations;
+}
+
+std::vector<StorageOccurrence> FlatIntermediateStorage::getStorageOccurrences() const
+{
+	std::vector<StorageOccurrence> occurrences;
+	occurrences.reserve(m_occurrences.count);
+	for (size_t i = 0; i < m_occurrences.count; i++)
+	{
+		const OccurrenceRecord record = getRecord<OccurrenceRecord>(m_occurrences, i);
+		occurrences.emplace_back(record.elementId, record.sourceLocationId);
+	}
+	return occurrences;
+}
+
+std::vector<StorageComponentAccess> FlatIntermediateStorage::getComponentAccesses() const
+{
+	std::vector<StorageComponentAccess> componentAccesses;
+	componentAccesses.reserve(m_componentAccesses.count);
+	for (size_t i = 0; i < m_componentAccesses.count; i++)
+	{
+		const ComponentAccessRecord record =
+			getRecord<ComponentAccessRecord>(m_componentAccesses, i);
+		componentAccesses.emplace_back(record.nodeId, static_cast<int>(record.type));
+	}
+	return componentAccesses;
+}
+
+std::set<StorageElementComponent> FlatIntermediateStorage::getElementComponents() const
+{
+	// element components are not part of the layout, indexers don't record any
+	return std::set<StorageElementComponent>();
+}
+
+std::vector<StorageError> FlatIntermediateStorage::getErrors() const
+{
+	std::vector<StorageError> errors;
+	errors.reserve(m_errors.count);
+	for (size_t i = 0; i < m_errors.count; i++)
+	{
+		const ErrorRecord record = getRecord<ErrorRecord>(m_errors, i);
+		errors.emplace_back(
+			record.id,
+			readString<std::wstring>(m_data, record.message),
+			readString<std::wstring>(m_data, record.translationUnit),
+			record.fatal != 0,
+			record.indexed != 0);
+	}
+	return errors;
+}
+
+Id FlatIntermediateStorage::getNextId() const
+{
+	return m_nextId;
+}
+
+size_t FlatIntermediateStorage::getSourceLocationCount() const
+{
+	return m_sourceLocations.count;
+}
+
+FlatIntermediateStorage::FlatIntermediateStorage(std::shared_ptr<SharedMemoryBuffer> buffer)
+	: m_buffer(buffer), m_data(buffer->getData()), m_nextId(0)
+{
+}
+
+bool FlatIntermediateStorage::init()
+{
+	const size_t bufferSize = m_buffer->getSize();
+	if (bufferSize < sizeof(Header))
+	{
+		LOG_ERROR("Flat intermediate storage is truncated.");
+		return false;
+	}
+
+	const Header header = readRecord<Header>(m_data, 0);
+	if (header.magic != s_magic || header.version != s_version)
+	{
+		LOG_ERROR("Flat intermediate storage has an invalid header.");
+		return false;
+	}
+
+	size_t offset = sizeof(Header);
+	bool countsValid = true;
+	auto assignRange = [&](RecordRange& range, uint64_t count, size_t recordSize) {
+		if (count > (bufferSize - offset) / recordSize)
+		{
+			countsValid = false;
+			return;
+		}
+		range.offset = offset;
+		range.count = static_cast<size_t>(count);
+		offset += range.count * recordSize;
+	};
+
+	assignRange(m_nodes, header.nodeCount, sizeof(NodeRecord));
+	assignRange(m_files, header.fileCount, sizeof(FileRecord));
+	assignRange(m_symbols, header.symbolCount, sizeof(SymbolRecord));
+	assignRange(m_edges, header.edgeCount, sizeof(EdgeRecord));
+	assignRange(m_localSymbols, header.localSymbolCount, sizeof(LocalSymbolRecord));
+	assignRange(m_sourceLocations, header.sourceLocationCount, sizeof(SourceLocationRecord));
+	assignRange(m_occurrences, header.occurrenceCount, sizeof(OccurrenceRecord));
+	assignRange(m_componentAccesses, header.componentAccessCount, sizeof(ComponentAccessRecord));
+	assignRange(m_errors, header.errorCount, sizeof(ErrorRecord));
+
+	if (!countsValid || header.stringPoolSize > bufferSize - offset)
+	{
+		LOG_ERROR("Flat intermediate storage has invalid element counts.");
+		return false;
+	}
+
+	// strings are checked once here, so the getters can read them without any checks
+	const size_t stringPoolOffset = offset;
+	const size_t stringPoolSize = static_cast<size_t>(header.stringPoolSize);
+	bool stringsValid = true;
+
+	for (size_t i = 0; i < m_nodes.count && stringsValid; i++)
+	{
+		const NodeRecord record = getRecord<NodeRecord>(m_nodes, i);
+		stringsValid =
+			isValidString<wchar_t>(record.serializedName, stringPoolOffset, stringPoolSize);
+	}
+	for (size_t i = 0; i < m_files.count && stringsValid; i++)
+	{
+		const FileRecord record = getRecord<FileRecord>(m_files, i);
+		stringsValid = isValidString<wchar_t>(record.filePath, stringPoolOffset, stringPoolSize) &&
+			isValidString<wchar_t>(record.languageIdentifier, stringPoolOffset, stringPoolSize) &&
+			isValidString<char>(record.modificationTime, stringPoolOffset, stringPoolSize);
+	}
+	for (size_t i = 0; i < m_localSymbols.count && stringsValid; i++)
+	{
+		const LocalSymbolRecord record = getRecord<LocalSymbolRecord>(m_localSymbols, i);
+		stringsValid = isValidString<wchar_t>(record.name, stringPoolOffset, stringPoolSize);
+	}
+	for (size_t i = 0; i < m_errors.count && stringsValid; i++)
+	{
+		const ErrorRecord record = getRecord<ErrorRecord>(m_errors, i);
+		stringsValid = isValidString<wchar_t>(record.message, stringPoolOffset, stringPoolSize) &&
+			isValidString<wchar_t>(record.translationUnit, stringPoolOffset, stringPoolSize);
+	}
+
+	if (!stringsValid)
+	{
+		LOG_ERROR("Flat intermediate storage has invalid strings.");
+		return false;
+	}
+
+	m_nextId = header.nextId;
+	return true;
+}
+
+template <typename RecordType>
+RecordType FlatIntermediateStorage::getRecord(const RecordRange& range, size_t index) const
+{
+	return readRecord<RecordType>(m_data, range.offset + index * sizeof(RecordType));
+}
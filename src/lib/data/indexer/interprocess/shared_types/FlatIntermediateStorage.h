@@ -0,0 +1,84 @@
+#ifndef FLAT_INTERMEDIATE_STORAGE_H
+#define FLAT_INTERMEDIATE_STORAGE_H
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "StorageComponentAccess.h"
+#include "StorageEdge.h"
+#include "StorageElementComponent.h"
+#include "StorageError.h"
+#include "StorageFile.h"
+#include "StorageLocalSymbol.h"
+#include "StorageNode.h"
+#include "StorageOccurrence.h"
+#include "StorageSourceLocation.h"
+#include "StorageSymbol.h"
+#include "types.h"
+
+class IntermediateStorage;
+class SharedMemoryBuffer;
+
+// Compact binary layout of an IntermediateStorage used for transferring indexing results between
+// processes. The buffer starts with a header holding the element counts, followed by one array of
+// fixed size records per element type and a pool containing all strings. The indexer writes the
+// buffer once into shared memory, the app injects it from there through a FlatIntermediateStorage
+// viewing the mapped buffer.
+class FlatIntermediateStorage
+{
+public:
+	static size_t getByteSize(const IntermediateStorage& storage);
+
+	// buffer needs to provide at least getByteSize(storage) bytes
+	static void write(const IntermediateStorage& storage, char* buffer);
+
+	// returns nullptr if the buffer does not contain a valid layout
+	static std::shared_ptr<FlatIntermediateStorage> create(
+		std::shared_ptr<SharedMemoryBuffer> buffer);
+
+	// build the elements straight from the records and the string pool of the buffer
+	std::vector<StorageNode> getStorageNodes() const;
+	std::vector<StorageFile> getStorageFiles() const;
+	std::vector<StorageSymbol> getStorageSymbols() const;
+	std::vector<StorageEdge> getStorageEdges() const;
+	std::set<StorageLocalSymbol> getStorageLocalSymbols() const;
+	std::vector<StorageSourceLocation> getStorageSourceLocations() const;
+	std::vector<StorageOccurrence> getStorageOccurrences() const;
+	std::vector<StorageComponentAccess> getComponentAccesses() const;
+	std::set<StorageElementComponent> getElementComponents() const;
+	std::vector<StorageError> getErrors() const;
+
+	Id getNextId() const;
+	size_t getSourceLocationCount() const;
+
+private:
+	struct RecordRange
+	{
+		size_t offset = 0;
+		size_t count = 0;
+	};
+
+	FlatIntermediateStorage(std::shared_ptr<SharedMemoryBuffer> buffer);
+
+	bool init();
+
+	template <typename RecordType>
+	RecordType getRecord(const RecordRange& range, size_t index) const;
+
+	std::shared_ptr<SharedMemoryBuffer> m_buffer;
+	const char* m_data;
+
+	Id m_nextId;
+	RecordRange m_nodes;
+	RecordRange m_files;
+	RecordRange m_symbols;
+	RecordRange m_edges;
+	RecordRange m_localSymbols;
+	RecordRange m_sourceLocations;
+	RecordRange m_occurrences;
+	RecordRange m_componentAccesses;
+	RecordRange m_errors;
+};
+
+#endif	  // FLAT_INTERMEDIATE_STORAGE_H
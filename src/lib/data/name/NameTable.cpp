@@ -0,0 +1,314 @@
+#include "NameTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FilePath.h"
+#include "logging.h"
+#include "tracing.h"
+#include "utilityString.h"
+
+namespace
+{
+const char s_fileMagic[8] = {'S', 'T', 'N', 'A', 'M', 'E', 'S', ' '};
+const uint32_t s_fileVersion = 1;
+
+// longer blocks save more space but make lookups decode more names
+const size_t s_blockSize = 16;
+
+template <typename T>
+void writeValue(std::ostream& stream, T value)
+{
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writePadding(std::ostream& stream, size_t writtenSize)
+{
+	const char zeros[8] = {};
+	stream.write(zeros, (8 - writtenSize % 8) % 8);
+}
+
+size_t getPaddedSize(size_t size)
+{
+	return size + (8 - size % 8) % 8;
+}
+
+void appendVarInt(std::string& data, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	data.push_back(static_cast<char>(value));
+}
+
+bool readVarInt(const char** pos, const char* end, uint64_t* value)
+{
+	*value = 0;
+	for (int shift = 0; *pos < end && shift < 64; shift += 7)
+	{
+		const unsigned char byte = static_cast<unsigned char>(*(*pos)++);
+		*value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+}	 // namespace
+
+bool NameTable::save(
+	std::vector<std::pair<Id, std::string>> names,
+	const FilePath& filePath,
+	const std::string& revision)
+{
+	TRACE();
+
+	std::sort(
+		names.begin(),
+		names.end(),
+		[](const std::pair<Id, std::string>& a, const std::pair<Id, std::string>& b) {
+			return a.second < b.second;
+		});
+
+	uint64_t minId = 0;
+	uint64_t maxId = 0;
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		minId = i ? std::min<uint64_t>(minId, names[i].first) : names[i].first;
+		maxId = i ? std::max<uint64_t>(maxId, names[i].first) : names[i].first;
+	}
+	const uint64_t idCount = names.empty() ? 0 : maxId - minId + 1;
+
+	std::vector<uint32_t> nameIndices(static_cast<size_t>(idCount), 0);
+	std::vector<uint64_t> blockOffsets;
+	std::string data;
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		const std::string& name = names[i].second;
+		nameIndices[static_cast<size_t>(names[i].first - minId)] = static_cast<uint32_t>(i + 1);
+
+		if (i % s_blockSize == 0)
+		{
+			blockOffsets.push_back(data.size());
+			appendVarInt(data, name.size());
+			data.append(name);
+		}
+		else
+		{
+			const std::string& previousName = names[i - 1].second;
+			const size_t sharedSize = static_cast<size_t>(
+				std::mismatch(
+					name.begin(),
+					name.begin() + std::min(name.size(), previousName.size()),
+					previousName.begin())
+					.first -
+				name.begin());
+
+			appendVarInt(data, sharedSize);
+			appendVarInt(data, name.size() - sharedSize);
+			data.append(name, sharedSize, std::string::npos);
+		}
+	}
+
+	std::ofstream stream(filePath.str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		LOG_ERROR("Could not write name table to " + filePath.str());
+		return false;
+	}
+
+	stream.write(s_fileMagic, sizeof(s_fileMagic));
+	writeValue<uint32_t>(stream, s_fileVersion);
+	writeValue<uint32_t>(stream, static_cast<uint32_t>(revision.size()));
+	stream.write(revision.data(), revision.size());
+	writePadding(stream, revision.size());
+
+	writeValue<uint64_t>(stream, minId);
+	writeValue<uint64_t>(stream, idCount);
+	writeValue<uint64_t>(stream, names.size());
+	writeValue<uint64_t>(stream, blockOffsets.size());
+	writeValue<uint64_t>(stream, data.size());
+
+	stream.write(
+		reinterpret_cast<const char*>(nameIndices.data()), nameIndices.size() * sizeof(uint32_t));
+	writePadding(stream, nameIndices.size() * sizeof(uint32_t));
+	stream.write(
+		reinterpret_cast<const char*>(blockOffsets.data()), blockOffsets.size() * sizeof(uint64_t));
+	stream.write(data.data(), data.size());
+
+	return static_cast<bool>(stream);
+}
+
+NameTable::NameTable()
+{
+	clear();
+}
+
+NameTable::~NameTable() {}
+
+bool NameTable::load(const FilePath& filePath, const std::string& revision)
+{
+	TRACE();
+
+	clear();
+
+	if (!filePath.exists())
+	{
+		return false;
+	}
+
+	std::unique_ptr<boost::interprocess::mapped_region> region;
+	try
+	{
+		boost::interprocess::file_mapping file(filePath.str().c_str(), boost::interprocess::read_only);
+		region = std::make_unique<boost::interprocess::mapped_region>(
+			file, boost::interprocess::read_only);
+	}
+	catch (const boost::interprocess::interprocess_exception& e)
+	{
+		LOG_WARNING("Could not map name table " + filePath.str() + ": " + e.what());
+		return false;
+	}
+
+	const char* begin = static_cast<const char*>(region->get_address());
+	const size_t size = region->get_size();
+
+	const size_t revisionOffset = sizeof(s_fileMagic) + 2 * sizeof(uint32_t);
+	if (size < revisionOffset || !std::equal(s_fileMagic, s_fileMagic + sizeof(s_fileMagic), begin))
+	{
+		return false;
+	}
+
+	uint32_t version = 0;
+	uint32_t revisionSize = 0;
+	std::memcpy(&version, begin + sizeof(s_fileMagic), sizeof(uint32_t));
+	std::memcpy(&revisionSize, begin + sizeof(s_fileMagic) + sizeof(uint32_t), sizeof(uint32_t));
+	if (version != s_fileVersion || revisionSize != revision.size() ||
+		size < revisionOffset + revisionSize ||
+		revision.compare(0, std::string::npos, begin + revisionOffset, revisionSize) != 0)
+	{
+		return false;
+	}
+
+	// all following sections start at multiples of 8 bytes
+	const size_t countsOffset = revisionOffset + getPaddedSize(revisionSize);
+	if (size < countsOffset + 5 * sizeof(uint64_t))
+	{
+		return false;
+	}
+
+	const uint64_t* counts = reinterpret_cast<const uint64_t*>(begin + countsOffset);
+	const uint64_t idCount = counts[1];
+	const uint64_t blockCount = counts[3];
+	const uint64_t dataSize = counts[4];
+
+	const size_t nameIndicesOffset = countsOffset + 5 * sizeof(uint64_t);
+	const size_t blockOffsetsOffset = nameIndicesOffset +
+		getPaddedSize(static_cast<size_t>(idCount) * sizeof(uint32_t));
+	const size_t dataOffset = blockOffsetsOffset + static_cast<size_t>(blockCount) * sizeof(uint64_t);
+	if (size != dataOffset + dataSize)
+	{
+		LOG_WARNING("Name table " + filePath.str() + " is corrupted");
+		return false;
+	}
+
+	m_minId = counts[0];
+	m_idCount = idCount;
+	m_nameCount = counts[2];
+	m_blockCount = blockCount;
+	m_dataSize = dataSize;
+	m_nameIndices = reinterpret_cast<const uint32_t*>(begin + nameIndicesOffset);
+	m_blockOffsets = reinterpret_cast<const uint64_t*>(begin + blockOffsetsOffset);
+	m_data = begin + dataOffset;
+	m_region = std::move(region);
+
+	return true;
+}
+
+void NameTable::clear()
+{
+	m_region.reset();
+
+	m_nameIndices = nullptr;
+	m_blockOffsets = nullptr;
+	m_data = nullptr;
+
+	m_minId = 0;
+	m_idCount = 0;
+	m_nameCount = 0;
+	m_blockCount = 0;
+	m_dataSize = 0;
+}
+
+bool NameTable::isLoaded() const
+{
+	return m_region != nullptr;
+}
+
+size_t NameTable::getNameCount() const
+{
+	return static_cast<size_t>(m_nameCount);
+}
+
+std::string_view NameTable::getSerializedName(Id id, std::string* buffer) const
+{
+	if (id < m_minId || id - m_minId >= m_idCount || !m_nameIndices[id - m_minId])
+	{
+		return std::string_view();
+	}
+
+	const uint64_t nameIndex = m_nameIndices[id - m_minId] - 1;
+	const uint64_t blockIndex = nameIndex / s_blockSize;
+	if (blockIndex >= m_blockCount || m_blockOffsets[blockIndex] >= m_dataSize)
+	{
+		return std::string_view();
+	}
+
+	const char* pos = m_data + m_blockOffsets[blockIndex];
+	const char* end = m_data + m_dataSize;
+
+	uint64_t size = 0;
+	if (!readVarInt(&pos, end, &size) || size > static_cast<uint64_t>(end - pos))
+	{
+		return std::string_view();
+	}
+
+	if (nameIndex % s_blockSize == 0)
+	{
+		return std::string_view(pos, static_cast<size_t>(size));
+	}
+
+	buffer->assign(pos, static_cast<size_t>(size));
+	pos += size;
+
+	for (uint64_t i = 0; i < nameIndex % s_blockSize; i++)
+	{
+		uint64_t sharedSize = 0;
+		if (!readVarInt(&pos, end, &sharedSize) || !readVarInt(&pos, end, &size) ||
+			sharedSize > buffer->size() || size > static_cast<uint64_t>(end - pos))
+		{
+			return std::string_view();
+		}
+
+		buffer->resize(static_cast<size_t>(sharedSize));
+		buffer->append(pos, static_cast<size_t>(size));
+		pos += size;
+	}
+
+	return std::string_view(*buffer);
+}
+
+std::wstring NameTable::getSerializedName(Id id) const
+{
+	std::string buffer;
+	const std::string_view name = getSerializedName(id, &buffer);
+	return name.empty() ? std::wstring() : utility::decodeFromUtf8(std::string(name));
+}
@@ -0,0 +1,65 @@
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}	 // namespace boost
+
+class FilePath;
+
+// Read-only table of the serialized names of all nodes. It is saved as a file next to the database
+// and memory mapped, so names are only paged in when they are looked up. Names are stored as UTF-8
+// and sorted, which places the names of a symbol's children next to each other. Within each block of
+// names every name only stores the part that differs from the name before it (front coding).
+class NameTable
+{
+public:
+	// names are UTF-8 encoded serialized name hierarchies
+	static bool save(
+		std::vector<std::pair<Id, std::string>> names,
+		const FilePath& filePath,
+		const std::string& revision);
+
+	NameTable();
+	~NameTable();
+
+	// maps the file, fails if it was saved for another revision of the database
+	bool load(const FilePath& filePath, const std::string& revision);
+	void clear();
+
+	bool isLoaded() const;
+	size_t getNameCount() const;
+
+	// The view points into the mapped file for the first name of a block and into buffer for all
+	// other names. It is empty if the table holds no name for the id.
+	std::string_view getSerializedName(Id id, std::string* buffer) const;
+	std::wstring getSerializedName(Id id) const;
+
+private:
+	std::unique_ptr<boost::interprocess::mapped_region> m_region;
+
+	const uint32_t* m_nameIndices;	  // name index + 1 for each id starting at m_minId, 0 for none
+	const uint64_t* m_blockOffsets;
+	const char* m_data;
+
+	uint64_t m_minId;
+	uint64_t m_idCount;
+	uint64_t m_nameCount;
+	uint64_t m_blockCount;
+	uint64_t m_dataSize;
+};
+
+#endif	  // NAME_TABLE_H
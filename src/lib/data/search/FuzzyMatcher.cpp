@@ -0,0 +1,338 @@
+#include "FuzzyMatcher.h"
+
+#include <cwctype>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#	define FUZZY_MATCHER_X64
+#	include <immintrin.h>
+#	if defined(_MSC_VER)
+#		include <intrin.h>
+#	endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions for functions explicitly targeting it
+#if defined(FUZZY_MATCHER_X64) && (defined(__GNUC__) || defined(__clang__))
+#	define FUZZY_MATCHER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#	define FUZZY_MATCHER_TARGET_AVX2
+#endif
+
+std::atomic<FuzzyMatcher::FindFunction> FuzzyMatcher::s_findFunction(nullptr);
+std::atomic<FuzzyMatcher::Kernel> FuzzyMatcher::s_kernel(FuzzyMatcher::KERNEL_SCALAR);
+
+namespace
+{
+bool isAscii(wchar_t c)
+{
+	return static_cast<unsigned long>(c) < 0x80;
+}
+
+wchar_t toUpperAscii(wchar_t lowerChar)
+{
+	return (lowerChar >= L'a' && lowerChar <= L'z') ? wchar_t(lowerChar - L'a' + L'A') : lowerChar;
+}
+
+// the vectorized kernels only lower ASCII letters themselves, which is not what every locale does
+bool lowersAsciiLettersOnly()
+{
+	for (wchar_t c = 0; c < 0x80; c++)
+	{
+		const wchar_t expected = (c >= L'A' && c <= L'Z') ? wchar_t(c - L'A' + L'a') : c;
+		if (static_cast<wchar_t>(towlower(c)) != expected)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t findScalar(const wchar_t* text, size_t size, wchar_t lowerChar)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		if (static_cast<wchar_t>(towlower(text[i])) == lowerChar)
+		{
+			return i;
+		}
+	}
+	return size;
+}
+
+#ifdef FUZZY_MATCHER_X64
+bool cpuSupportsAvx2()
+{
+#	if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return false;
+	}
+
+	// the OS has to save the AVX registers as well
+	__cpuid(info, 1);
+	const bool usesXsave = (info[2] & (1 << 27)) != 0;
+	const bool hasAvx = (info[2] & (1 << 28)) != 0;
+	if (!usesXsave || !hasAvx || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#	else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#	endif
+}
+
+unsigned int countTrailingZeros(unsigned int mask)
+{
+#	if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#	else
+	return __builtin_ctz(mask);
+#	endif
+}
+
+// wchar_t has 16 bits on Windows and 32 bits elsewhere
+__m128i broadcastSse2(wchar_t c)
+{
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		return _mm_set1_epi16(static_cast<short>(c));
+	}
+	else
+	{
+		return _mm_set1_epi32(static_cast<int>(c));
+	}
+}
+
+__m128i compareSse2(__m128i a, __m128i b)
+{
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		return _mm_cmpeq_epi16(a, b);
+	}
+	else
+	{
+		return _mm_cmpeq_epi32(a, b);
+	}
+}
+
+size_t findSse2(const wchar_t* text, size_t size, wchar_t lowerChar)
+{
+	if (!isAscii(lowerChar))
+	{
+		return findScalar(text, size, lowerChar);
+	}
+
+	const size_t blockSize = sizeof(__m128i) / sizeof(wchar_t);
+	const __m128i lower = broadcastSse2(lowerChar);
+	const __m128i upper = broadcastSse2(toUpperAscii(lowerChar));
+	const __m128i nonAsciiBits = broadcastSse2(static_cast<wchar_t>(~0x7F));
+	const __m128i zero = _mm_setzero_si128();
+
+	size_t i = 0;
+	for (; i + blockSize <= size; i += blockSize)
+	{
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+
+		// non-ASCII characters may lower to ASCII ones, so these blocks are lowered one by one
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(block, nonAsciiBits), zero)) != 0xFFFF)
+		{
+			const size_t pos = findScalar(text + i, blockSize, lowerChar);
+			if (pos != blockSize)
+			{
+				return i + pos;
+			}
+			continue;
+		}
+
+		const int mask = _mm_movemask_epi8(
+			_mm_or_si128(compareSse2(block, lower), compareSse2(block, upper)));
+		if (mask)
+		{
+			return i + countTrailingZeros(mask) / sizeof(wchar_t);
+		}
+	}
+
+	return i + findScalar(text + i, size - i, lowerChar);
+}
+
+FUZZY_MATCHER_TARGET_AVX2 __m256i broadcastAvx2(wchar_t c)
+{
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		return _mm256_set1_epi16(static_cast<short>(c));
+	}
+	else
+	{
+		return _mm256_set1_epi32(static_cast<int>(c));
+	}
+}
+
+FUZZY_MATCHER_TARGET_AVX2 __m256i compareAvx2(__m256i a, __m256i b)
+{
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		return _mm256_cmpeq_epi16(a, b);
+	}
+	else
+	{
+		return _mm256_cmpeq_epi32(a, b);
+	}
+}
+
+FUZZY_MATCHER_TARGET_AVX2 size_t findAvx2(const wchar_t* text, size_t size, wchar_t lowerChar)
+{
+	if (!isAscii(lowerChar))
+	{
+		return findScalar(text, size, lowerChar);
+	}
+
+	const size_t blockSize = sizeof(__m256i) / sizeof(wchar_t);
+	const __m256i lower = broadcastAvx2(lowerChar);
+	const __m256i upper = broadcastAvx2(toUpperAscii(lowerChar));
+	const __m256i nonAsciiBits = broadcastAvx2(static_cast<wchar_t>(~0x7F));
+
+	size_t i = 0;
+	for (; i + blockSize <= size; i += blockSize)
+	{
+		const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+
+		// non-ASCII characters may lower to ASCII ones, so these blocks are lowered one by one
+		if (!_mm256_testz_si256(block, nonAsciiBits))
+		{
+			const size_t pos = findScalar(text + i, blockSize, lowerChar);
+			if (pos != blockSize)
+			{
+				return i + pos;
+			}
+			continue;
+		}
+
+		const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(
+			_mm256_or_si256(compareAvx2(block, lower), compareAvx2(block, upper))));
+		if (mask)
+		{
+			return i + countTrailingZeros(mask) / sizeof(wchar_t);
+		}
+	}
+
+	// the remaining characters fit into one SSE2 block at most
+	return i + findSse2(text + i, size - i, lowerChar);
+}
+#endif	  // FUZZY_MATCHER_X64
+}	 // namespace
+
+FuzzyMatcher::Kernel FuzzyMatcher::getKernel()
+{
+	getFindFunction();
+	return s_kernel;
+}
+
+bool FuzzyMatcher::isKernelSupported(Kernel kernel)
+{
+	switch (kernel)
+	{
+	case KERNEL_SCALAR:
+		return true;
+#ifdef FUZZY_MATCHER_X64
+	case KERNEL_SSE2:
+		return true;
+	case KERNEL_AVX2:
+		return cpuSupportsAvx2();
+#endif
+	default:
+		return false;
+	}
+}
+
+void FuzzyMatcher::setKernel(Kernel kernel)
+{
+	if (!isKernelSupported(kernel))
+	{
+		kernel = KERNEL_SCALAR;
+	}
+
+	FindFunction findFunction = &findScalar;
+#ifdef FUZZY_MATCHER_X64
+	if (kernel == KERNEL_SSE2)
+	{
+		findFunction = &findSse2;
+	}
+	else if (kernel == KERNEL_AVX2)
+	{
+		findFunction = &findAvx2;
+	}
+#endif
+
+	s_kernel = kernel;
+	s_findFunction = findFunction;
+}
+
+size_t FuzzyMatcher::find(const wchar_t* text, size_t size, wchar_t lowerChar)
+{
+	return getFindFunction()(text, size, lowerChar);
+}
+
+size_t FuzzyMatcher::match(
+	const wchar_t* text,
+	size_t size,
+	const std::wstring& lowerQuery,
+	size_t queryPos,
+	size_t offset,
+	std::vector<size_t>* indices)
+{
+	const FindFunction findFunction = getFindFunction();
+
+	size_t i = 0;
+	while (queryPos < lowerQuery.size() && i < size)
+	{
+		const size_t pos = i + findFunction(text + i, size - i, lowerQuery[queryPos]);
+		if (pos == size)
+		{
+			break;
+		}
+
+		indices->push_back(offset + pos);
+		i = pos + 1;
+		queryPos++;
+	}
+
+	return queryPos;
+}
+
+FuzzyMatcher::Kernel FuzzyMatcher::detectKernel()
+{
+	if (!lowersAsciiLettersOnly())
+	{
+		return KERNEL_SCALAR;
+	}
+
+	if (isKernelSupported(KERNEL_AVX2))
+	{
+		return KERNEL_AVX2;
+	}
+
+	if (isKernelSupported(KERNEL_SSE2))
+	{
+		return KERNEL_SSE2;
+	}
+
+	return KERNEL_SCALAR;
+}
+
+FuzzyMatcher::FindFunction FuzzyMatcher::getFindFunction()
+{
+	FindFunction findFunction = s_findFunction;
+	if (!findFunction)
+	{
+		setKernel(detectKernel());
+		findFunction = s_findFunction;
+	}
+	return findFunction;
+}
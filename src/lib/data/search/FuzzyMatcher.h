@@ -0,0 +1,49 @@
+#ifndef FUZZY_MATCHER_H
+#define FUZZY_MATCHER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Case-insensitive greedy subsequence matching of lower case queries, used when walking the search
+// index and when rescoring search matches. Blocks of ASCII text are compared with SSE2 or AVX2
+// instructions, depending on what the CPU supports, other text is lowered with towlower.
+class FuzzyMatcher
+{
+public:
+	enum Kernel
+	{
+		KERNEL_SCALAR,
+		KERNEL_SSE2,
+		KERNEL_AVX2
+	};
+
+	// best kernel supported by the CPU and the current locale, picked on first use
+	static Kernel getKernel();
+	static bool isKernelSupported(Kernel kernel);
+	static void setKernel(Kernel kernel);
+
+	// position of the first character in text lowering to lowerChar, size if there is none
+	static size_t find(const wchar_t* text, size_t size, wchar_t lowerChar);
+
+	// matches the characters of lowerQuery starting at queryPos one after another in text, appends
+	// their positions plus offset to indices and returns the query position matching stopped at
+	static size_t match(
+		const wchar_t* text,
+		size_t size,
+		const std::wstring& lowerQuery,
+		size_t queryPos,
+		size_t offset,
+		std::vector<size_t>* indices);
+
+private:
+	typedef size_t (*FindFunction)(const wchar_t*, size_t, wchar_t);
+
+	static Kernel detectKernel();
+	static FindFunction getFindFunction();
+
+	static std::atomic<FindFunction> s_findFunction;
+	static std::atomic<Kernel> s_kernel;
+};
+
+#endif	  // FUZZY_MATCHER_H
@@ -3,7 +3,10 @@
 #include <algorithm>
 #include <ctype.h>
 #include <iterator>
+#include <thread>
+#include <unordered_map>
 
+#include "FuzzyMatcher.h"
 #include "utility.h"
 #include "utilityString.h"
 #include "boost/archive/binary_iarchive.hpp"
@@ -16,6 +19,17 @@
 
 #pragma optimize("", off)
 
+namespace
+{
+// compaction pays off once a considerable part of the elements has been removed
+const size_t s_minRemovedElementCountForCompaction = 1000;
+const size_t s_maxRemovedElementPercentage = 25;
+
+// short queries match large parts of the index, their paths are cheaper to find again than to keep
+const size_t s_maxCachedPathCount = 100000;
+const size_t s_maxCachedQueryCount = 32;
+}	 // namespace
+
 SearchIndex::SearchIndex()
 {
 	clear();
@@ -24,6 +38,11 @@ SearchIndex::SearchIndex()
 SearchIndex::~SearchIndex() {}
 
 void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
+{
+	doAddNode(id, std::move(name), type, false);
+}
+
+void SearchIndex::doAddNode(Id id, std::wstring name, NodeType type, bool updateGates)
 {
 	size_t currentNodeI = 0;	   // SearchNode* currentNode = &m_nodes[0];
 
@@ -61,11 +80,25 @@ void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
 
 				n->edges.emplace(e->s[0], m_edges.size()-1);
 
+				if (updateGates)
+				{
+					e->gate = m_edges[currentEdgeI].gate;
+				}
+
 				currentEdge = &m_edges[currentEdgeI];
 				currentEdge->s = m_edges[currentEdgeI].s.substr(0, matchCount);
 				currentEdge->target = (long)m_nodes.size() - 1;
 			}
 
+			if (updateGates)
+			{
+				// gates only need to contain all characters reachable through their edge
+				for (const wchar_t& c: name)
+				{
+					currentEdge->gate.insert(towlower(c));
+				}
+			}
+
 			name = name.substr(matchCount);
 			currentNodeI = currentEdge->target;
 		}
@@ -77,6 +110,14 @@ void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
 			m_edges.push_back(SearchEdge((long)m_nodes.size() - 1, std::move(name)));
 			SearchEdge* e = m_edges.back();
 
+			if (updateGates)
+			{
+				for (const wchar_t& c: e->s)
+				{
+					e->gate.insert(towlower(c));
+				}
+			}
+
 			m_nodes[currentNodeI].edges.emplace(e->s[0], m_edges.size() - 1);
 			currentNodeI = m_nodes.size() - 1;
 
@@ -85,6 +126,233 @@ void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
 	}
 
 	m_nodes[currentNodeI].elementIds.emplace(id, type);
+
+	auto it = m_elementNodes.find(id);
+	if (it != m_elementNodes.end())
+	{
+		*it->second = (long)currentNodeI;
+	}
+	else
+	{
+		m_elementNodes.emplace(id, (long)currentNodeI);
+	}
+}
+
+void SearchIndex::insertNode(Id id, std::wstring name, NodeType type)
+{
+	long previousNodeIndex = -1;
+	auto it = m_elementNodes.find(id);
+	if (it != m_elementNodes.end() && *it->second >= 0)
+	{
+		previousNodeIndex = *it->second;
+		removeElementFromNode(id, previousNodeIndex);
+	}
+
+	doAddNode(id, std::move(name), type, true);
+
+	// an element inserted under its previous name ends up at the same node, so nothing is left behind
+	if (previousNodeIndex >= 0 && *m_elementNodes.find(id)->second != previousNodeIndex)
+	{
+		m_removedElementCount++;
+	}
+}
+
+void SearchIndex::removeNode(Id id)
+{
+	auto it = m_elementNodes.find(id);
+	if (it == m_elementNodes.end() || *it->second < 0)
+	{
+		return;
+	}
+
+	removeElementFromNode(id, *it->second);
+
+	*it->second = -1;
+	m_removedElementCount++;
+}
+
+void SearchIndex::removeElementFromNode(Id id, long nodeIndex)
+{
+	SearchNode* node = &m_nodes[nodeIndex];
+	flashmapper::map<Id, NodeType, uint16_t> elementIds;
+	for (const auto& p: node->elementIds)
+	{
+		if (p.first != id)
+		{
+			elementIds.emplace(p.first, *p.second);
+		}
+	}
+	node->elementIds = elementIds;
+}
+
+size_t SearchIndex::getRemovedElementCount() const
+{
+	return m_removedElementCount;
+}
+
+bool SearchIndex::needsCompaction() const
+{
+	return m_removedElementCount >= s_minRemovedElementCountForCompaction &&
+		m_removedElementCount * 100 > m_elementNodes.size() * s_maxRemovedElementPercentage;
+}
+
+std::shared_ptr<SearchIndex> SearchIndex::createCompactedIndex() const
+{
+	std::shared_ptr<SearchIndex> index = std::make_shared<SearchIndex>();
+	addElementsRecursive(0, L"", index.get());
+	index->finishSetup();
+	index->setRevision(m_revision);
+	return index;
+}
+
+size_t SearchIndex::getRevision() const
+{
+	return m_revision;
+}
+
+void SearchIndex::setRevision(size_t revision)
+{
+	m_revision = revision;
+}
+
+void SearchIndex::addElementsRecursive(long nodeIndex, const std::wstring& text, SearchIndex* index) const
+{
+	const SearchNode* node = &m_nodes[nodeIndex];
+	for (const auto& p: node->elementIds)
+	{
+		index->addNode(p.first, text, *p.second);
+	}
+
+	for (const auto& p: node->edges)
+	{
+		const SearchEdge* edge = &m_edges[*p.second];
+		addElementsRecursive(edge->target, text + edge->s.data(), index);
+	}
+}
+
+void SearchIndex::build(std::vector<Element> elements, size_t threadCount)
+{
+	clear();
+
+	threadCount = std::max<size_t>(threadCount, 1);
+
+	// names are unevenly distributed over first characters, so the biggest groups get assigned
+	// first, each to the partition with the fewest elements so far
+	std::unordered_map<wchar_t, size_t> groupSizes;
+	for (const Element& element: elements)
+	{
+		groupSizes[element.name.empty() ? 0 : element.name[0]]++;
+	}
+
+	std::vector<std::pair<size_t, wchar_t>> groups;
+	for (const auto& p: groupSizes)
+	{
+		groups.emplace_back(p.second, p.first);
+	}
+	std::sort(groups.begin(), groups.end(), std::greater<std::pair<size_t, wchar_t>>());
+
+	std::vector<size_t> partitionSizes(threadCount, 0);
+	std::unordered_map<wchar_t, size_t> groupPartitions;
+	for (const std::pair<size_t, wchar_t>& group: groups)
+	{
+		const size_t partition =
+			std::min_element(partitionSizes.begin(), partitionSizes.end()) - partitionSizes.begin();
+		partitionSizes[partition] += group.first;
+		groupPartitions[group.second] = partition;
+	}
+
+	std::vector<std::vector<Element>> partitions(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		partitions[i].reserve(partitionSizes[i]);
+	}
+	for (Element& element: elements)
+	{
+		partitions[groupPartitions[element.name.empty() ? 0 : element.name[0]]].push_back(
+			std::move(element));
+	}
+	elements.clear();
+
+	std::vector<SearchIndex> subIndices(threadCount);
+	std::vector<std::shared_ptr<std::thread>> threads;
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		if (partitions[i].empty())
+		{
+			continue;
+		}
+
+		threads.push_back(std::make_shared<std::thread>([i, &partitions, &subIndices]() {
+			SearchIndex& subIndex = subIndices[i];
+			for (Element& element: partitions[i])
+			{
+				subIndex.addNode(element.id, std::move(element.name), element.type);
+			}
+			partitions[i].clear();
+			subIndex.finishSetup();
+		}));
+	}
+
+	for (std::shared_ptr<std::thread> thread: threads)
+	{
+		thread->join();
+	}
+
+	for (const SearchIndex& subIndex: subIndices)
+	{
+		appendSubIndex(subIndex);
+	}
+}
+
+void SearchIndex::appendSubIndex(const SearchIndex& subIndex)
+{
+	// the sub root is merged into the root, all other nodes and edges are appended
+	const long nodeOffset = (long)m_nodes.size() - 1;
+	const long edgeOffset = (long)m_edges.size();
+
+	const SearchNode* subRoot = &subIndex.m_nodes[0];
+	m_nodes[0].containedTypes.add(subRoot->containedTypes);
+	for (const auto& p: subRoot->elementIds)
+	{
+		m_nodes[0].elementIds.emplace(p.first, *p.second);
+	}
+	for (const auto& p: subRoot->edges)
+	{
+		m_nodes[0].edges.emplace(p.first, *p.second + edgeOffset);
+	}
+
+	for (size_t i = 1; i < subIndex.m_nodes.size(); i++)
+	{
+		SearchNode node = subIndex.m_nodes[i];
+		for (auto& p: node.edges)
+		{
+			*p.second += edgeOffset;
+		}
+		m_nodes.push_back(node);
+	}
+
+	for (size_t i = 0; i < subIndex.m_edges.size(); i++)
+	{
+		SearchEdge edge = subIndex.m_edges[i];
+		edge.target += nodeOffset;
+		m_edges.push_back(edge);
+	}
+
+	for (const auto& p: subIndex.m_elementNodes)
+	{
+		// removed elements keep -1 and elements of the sub root now belong to the root
+		long nodeIndex = *p.second;
+		if (nodeIndex > 0)
+		{
+			nodeIndex += nodeOffset;
+		}
+		else if (nodeIndex < 0)
+		{
+			nodeIndex = -1;
+		}
+		m_elementNodes.emplace(p.first, nodeIndex);
+	}
+	m_removedElementCount += subIndex.m_removedElementCount;
 }
 
 void SearchIndex::finishSetup()
@@ -99,6 +367,9 @@ void SearchIndex::clear()
 {
 	m_nodes.clear();
 	m_edges.clear();
+	m_elementNodes.clear();
+	m_removedElementCount = 0;
+	m_revision = 0;
 
 	m_nodes.push_back(SearchNode());
 }
@@ -107,51 +378,72 @@ std::vector<SearchResult> SearchIndex::search(
 	const std::wstring& query,
 	NodeTypeSet acceptedNodeTypes,
 	size_t maxResultCount,
-	size_t maxBestScoredResultsLength) const
+	size_t maxBestScoredResultsLength,
+	SearchCache* cache) const
 {
 	// find paths containing query
-	std::vector<SearchPath> paths;
-	searchRecursive(
-		SearchPath(L"", {}, &m_nodes[0]), utility::toLowerCase(query), acceptedNodeTypes, &paths);
+	const std::shared_ptr<const std::vector<SearchPath>> paths = findPaths(
+		utility::toLowerCase(query), acceptedNodeTypes, cache);
 
-	// create scored search results
-	std::multiset<SearchResult> searchResults = createScoredResults(
-		paths, acceptedNodeTypes, maxResultCount * 3);
+	// create scored search results, ordered by score
+	std::vector<SearchResult> searchResults = createScoredResults(
+		*paths, acceptedNodeTypes, maxResultCount * 3);
 
 	// find maximum length for best scores
-	std::multiset<size_t> resultLengths;
-	for (const SearchResult& result: searchResults)
-	{
-		resultLengths.insert(result.text.size());
-	}
 	size_t maxResultLength = 0;
-	if (resultLengths.size() > 1000)
+	if (searchResults.size() > 1000)
 	{
-		auto it = resultLengths.begin();
-		std::advance(it, 1000);
-		maxResultLength = *it;
+		std::vector<size_t> resultLengths;
+		resultLengths.reserve(searchResults.size());
+		for (const SearchResult& result: searchResults)
+		{
+			resultLengths.push_back(result.text.size());
+		}
+		std::nth_element(resultLengths.begin(), resultLengths.begin() + 1000, resultLengths.end());
+		maxResultLength = resultLengths[1000];
 	}
 
-	// find best scores
-	std::map<std::wstring, SearchResult> scoresCache;
-	std::multiset<SearchResult> bestResults;
-	for (const SearchResult& result: searchResults)
+	// find best scores and keep the maxResultCount best results in a heap with the worst on top,
+	// equally scored results keep their order
+	typedef std::pair<size_t, SearchResult> OrderedResult;
+	const auto isBetter = [](const OrderedResult& a, const OrderedResult& b) {
+		return a.second.score > b.second.score ||
+			(a.second.score == b.second.score && a.first < b.first);
+	};
+
+	ScoresCache scoresCache;
+	std::vector<OrderedResult> bestResults;
+	for (size_t i = 0; i < searchResults.size(); i++)
 	{
-		if (!maxResultLength || result.text.size() <= maxResultLength)
+		if (maxResultLength && searchResults[i].text.size() > maxResultLength)
 		{
-			bestResults.insert(bestScoredResult(result, &scoresCache, maxBestScoredResultsLength));
+			continue;
+		}
+
+		SearchResult result = bestScoredResult(
+			std::move(searchResults[i]), &scoresCache, maxBestScoredResultsLength);
+
+		if (!maxResultCount || bestResults.size() < maxResultCount)
+		{
+			bestResults.emplace_back(i, std::move(result));
+			std::push_heap(bestResults.begin(), bestResults.end(), isBetter);
+		}
+		else if (result.score > bestResults.front().second.score)
+		{
+			std::pop_heap(bestResults.begin(), bestResults.end(), isBetter);
+			bestResults.back() = OrderedResult(i, std::move(result));
+			std::push_heap(bestResults.begin(), bestResults.end(), isBetter);
 		}
 	}
+	std::sort_heap(bestResults.begin(), bestResults.end(), isBetter);
 
-	// narrow down to max result count
-	auto it = bestResults.end();
-	if (maxResultCount && bestResults.size() > maxResultCount)
+	std::vector<SearchResult> results;
+	results.reserve(bestResults.size());
+	for (OrderedResult& p: bestResults)
 	{
-		it = bestResults.begin();
-		std::advance(it, maxResultCount);
+		results.push_back(std::move(p.second));
 	}
-
-	return std::vector<SearchResult>(bestResults.begin(), it);
+	return results;
 }
 
 void SearchIndex::populateEdgeGate(SearchEdge* e)
@@ -182,13 +474,117 @@ void SearchIndex::populateEdgeGate(SearchEdge* e)
 	}
 }
 
+void SearchIndex::SearchCache::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+}
+
+std::shared_ptr<const std::vector<SearchIndex::SearchPath>> SearchIndex::findPaths(
+	const std::wstring& lowerQuery, NodeTypeSet acceptedNodeTypes, SearchCache* cache) const
+{
+	std::shared_ptr<const std::vector<SearchPath>> previousPaths;
+	size_t previousQueryLength = 0;
+
+	if (cache)
+	{
+		std::lock_guard<std::mutex> lock(cache->m_mutex);
+
+		// keep the queries the current one extends, they are ordered by length
+		cache->m_entries.erase(
+			std::remove_if(
+				cache->m_entries.begin(),
+				cache->m_entries.end(),
+				[&](const SearchCache::Entry& entry) {
+					return entry.acceptedNodeTypes != acceptedNodeTypes ||
+						!utility::isPrefix(entry.query, lowerQuery);
+				}),
+			cache->m_entries.end());
+
+		if (!cache->m_entries.empty())
+		{
+			if (cache->m_entries.back().query.size() == lowerQuery.size())
+			{
+				return cache->m_entries.back().paths;
+			}
+
+			previousPaths = cache->m_entries.back().paths;
+			previousQueryLength = cache->m_entries.back().query.size();
+		}
+	}
+
+	std::shared_ptr<std::vector<SearchPath>> paths = std::make_shared<std::vector<SearchPath>>();
+	if (previousPaths)
+	{
+		refinePaths(
+			*previousPaths, lowerQuery.substr(previousQueryLength), acceptedNodeTypes, paths.get());
+	}
+	else
+	{
+		std::wstring text;
+		std::vector<size_t> indices;
+		searchRecursive(
+			&m_nodes[0], lowerQuery, 0, acceptedNodeTypes, &text, &indices, paths.get());
+	}
+
+	if (cache && paths->size() <= s_maxCachedPathCount)
+	{
+		std::lock_guard<std::mutex> lock(cache->m_mutex);
+
+		if (cache->m_entries.size() >= s_maxCachedQueryCount)
+		{
+			cache->m_entries.erase(cache->m_entries.begin());
+		}
+
+		if (cache->m_entries.empty() || cache->m_entries.back().query.size() < lowerQuery.size())
+		{
+			cache->m_entries.push_back({lowerQuery, acceptedNodeTypes, paths});
+		}
+	}
+
+	return paths;
+}
+
+void SearchIndex::refinePaths(
+	const std::vector<SearchPath>& paths,
+	const std::wstring& addedQuery,
+	NodeTypeSet acceptedNodeTypes,
+	std::vector<SearchPath>* results) const
+{
+	// each path matched the previous query up to its last index, so the added characters are
+	// consumed from the rest of its last edge first, exactly like searchRecursive would have done
+	std::wstring text;
+	std::vector<size_t> indices;
+	for (const SearchPath& path: paths)
+	{
+		text.assign(path.text.data(), path.text.size());
+		indices = path.indices;
+
+		const size_t start = indices.empty() ? 0 : indices.back() + 1;
+		const size_t j = FuzzyMatcher::match(
+			text.data() + start, text.size() - start, addedQuery, 0, start, &indices);
+
+		if (j == addedQuery.size())
+		{
+			results->emplace_back(text, indices, path.node);
+		}
+		else
+		{
+			searchRecursive(path.node, addedQuery, j, acceptedNodeTypes, &text, &indices, results);
+		}
+	}
+}
+
 void SearchIndex::searchRecursive(
-	const SearchPath& path,
-	const std::wstring& remainingQuery,
+	const SearchNode* node,
+	const std::wstring& query,
+	size_t queryPos,
 	NodeTypeSet acceptedNodeTypes,
+	std::wstring* text,
+	std::vector<size_t>* indices,
 	std::vector<SearchIndex::SearchPath>* results) const
 {
-	for (const auto& p: path.node->edges)
+	for (const auto& p: node->edges)
 	{
 		const SearchEdge* currentEdge = &m_edges[*p.second];
 
@@ -199,9 +595,9 @@ void SearchIndex::searchRecursive(
 
 		// test if s passes the edge's gate.
 		bool passesGate = true;
-		for (const wchar_t& c: remainingQuery)
+		for (size_t j = queryPos; j < query.size(); j++)
 		{
-			if (currentEdge->gate.find(c) == currentEdge->gate.end())
+			if (currentEdge->gate.find(query[j]) == currentEdge->gate.end())
 			{
 				passesGate = false;
 				break;
@@ -215,97 +611,125 @@ void SearchIndex::searchRecursive(
 
 		// consume characters for edge
 		const flashmapper::wstring& edgeString = currentEdge->s;
-		SearchPath currentPath {(path.text + edgeString).data(), path.indices, &m_nodes[currentEdge->target]};
+		const size_t textSize = text->size();
+		const size_t indexCount = indices->size();
+		text->append(edgeString.data(), edgeString.size());
 
-		size_t j = 0;
-		for (size_t i = 0; i < edgeString.size() && j < remainingQuery.size(); i++)
-		{
-			if (towlower(edgeString[i]) == remainingQuery[j])
-			{
-				currentPath.indices.push_back(path.text.size() + i);
-				j++;
-			}
-		}
+		const size_t j = FuzzyMatcher::match(
+			text->data() + textSize, edgeString.size(), query, queryPos, textSize, indices);
 
-		if (j == remainingQuery.size())
+		if (j == query.size())
 		{
-			results->push_back(std::move(currentPath));
+			results->emplace_back(*text, *indices, &m_nodes[currentEdge->target]);
 		}
 		else
 		{
-			searchRecursive(currentPath, remainingQuery.substr(j), acceptedNodeTypes, results);
+			searchRecursive(
+				&m_nodes[currentEdge->target], query, j, acceptedNodeTypes, text, indices, results);
 		}
+
+		text->resize(textSize);
+		indices->resize(indexCount);
 	}
 }
 
-std::multiset<SearchResult> SearchIndex::createScoredResults(
+std::vector<SearchResult> SearchIndex::createScoredResults(
 	const std::vector<SearchPath>& paths, NodeTypeSet acceptedNodeTypes, size_t maxResultCount) const
 {
-	// score and order initial paths
-	std::multimap<int, SearchPath, std::greater<int>> scoredPaths;
-	for (const SearchPath& path: paths)
+	// score and order initial paths, equally scored paths keep their order
+	std::vector<std::pair<int, size_t>> scoredPaths;
+	scoredPaths.reserve(paths.size());
+	for (size_t i = 0; i < paths.size(); i++)
 	{
-		scoredPaths.emplace(scoreText(path.text.data(), path.indices), path);
+		scoredPaths.emplace_back(scoreText(paths[i].text.data(), paths[i].indices), i);
 	}
-
-	// score paths and subpaths
-	std::multiset<SearchResult> searchResults;
-	for (const std::pair<int, SearchPath>& p: scoredPaths)
+	std::stable_sort(
+		scoredPaths.begin(),
+		scoredPaths.end(),
+		[](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b) {
+			return a.first > b.first;
+		});
+
+	// score paths and subpaths breadth first. Subpaths only reference the edge leading to them and
+	// their parent, so the text is only built for nodes holding accepted elements.
+	struct SubPath
+	{
+		const SearchNode* node;
+		const SearchEdge* edge;
+		size_t parentIndex;
+	};
+
+	std::vector<SubPath> subPaths;
+	std::vector<const SearchEdge*> subPathEdges;
+	std::wstring text;
+
+	std::vector<SearchResult> searchResults;
+	bool isFull = false;
+	for (size_t pathIndex = 0; pathIndex < scoredPaths.size() && !isFull; pathIndex++)
 	{
-		std::vector<SearchPath> currentPaths;
-		currentPaths.push_back(p.second);
+		const SearchPath& path = paths[scoredPaths[pathIndex].second];
 
-		while (!currentPaths.empty())
+		subPaths.clear();
+		subPaths.push_back({path.node, nullptr, 0});
+
+		for (size_t i = 0; i < subPaths.size(); i++)
 		{
-			std::vector<SearchPath> nextPaths;
+			const SearchNode* node = subPaths[i].node;
 
-			for (const SearchPath& path: currentPaths)
+			if (!node->elementIds.empty() && acceptedNodeTypes.intersectsWith(node->containedTypes))
 			{
-				if (!path.node->elementIds.empty() &&
-					(acceptedNodeTypes.intersectsWith(path.node->containedTypes)))
+				std::vector<Id> elementIds;
+				for (const auto& p: node->elementIds)
 				{
-					std::vector<Id> elementIds;
-					for (const auto& p: path.node->elementIds)
+					if (acceptedNodeTypes.contains(*p.second))
 					{
-						if (acceptedNodeTypes.contains(*p.second))
-						{
-							elementIds.push_back(p.first);
-						}
+						elementIds.push_back(p.first);
 					}
+				}
 
-					if (!elementIds.empty())
+				if (!elementIds.empty())
+				{
+					subPathEdges.clear();
+					for (size_t j = i; subPaths[j].edge; j = subPaths[j].parentIndex)
 					{
-						searchResults.emplace(
-							path.text.data(),
-							std::move(elementIds),
-							path.indices,
-							scoreText(path.text.data(), path.indices));
-
-						if (maxResultCount && searchResults.size() >= maxResultCount)
-						{
-							return searchResults;
-						}
+						subPathEdges.push_back(subPaths[j].edge);
 					}
-				}
 
-				for (auto p: path.node->edges)
-				{
-					const SearchEdge* edge = &m_edges[*p.second];
-					nextPaths.emplace_back((path.text + edge->s).data(), path.indices, &m_nodes[edge->target]);
+					text.assign(path.text.data(), path.text.size());
+					for (auto it = subPathEdges.rbegin(); it != subPathEdges.rend(); it++)
+					{
+						text.append((*it)->s.data(), (*it)->s.size());
+					}
+
+					searchResults.emplace_back(
+						text, std::move(elementIds), path.indices, scoreText(text, path.indices));
+
+					if (maxResultCount && searchResults.size() >= maxResultCount)
+					{
+						isFull = true;
+						break;
+					}
 				}
 			}
 
-			currentPaths = std::move(nextPaths);
+			for (const auto& p: node->edges)
+			{
+				const SearchEdge* edge = &m_edges[*p.second];
+				subPaths.push_back({&m_nodes[edge->target], edge, i});
+			}
 		}
 	}
 
+	std::stable_sort(
+		searchResults.begin(), searchResults.end(), [](const SearchResult& a, const SearchResult& b) {
+			return a.score > b.score;
+		});
+
 	return searchResults;
 }
 
 SearchResult SearchIndex::bestScoredResult(
-	SearchResult result,
-	std::map<std::wstring, SearchResult>* scoresCache,
-	size_t maxBestScoredResultsLength)
+	SearchResult result, ScoresCache* scoresCache, size_t maxBestScoredResultsLength)
 {
 	const std::wstring text = result.text;
 
@@ -323,23 +747,24 @@ SearchResult SearchIndex::bestScoredResult(
 	if (it != scoresCache->end())
 	{
 		// std::cout << "cached: " << it->first << " " << it->second.score << std::endl;
-		SearchResult cachedResult = it->second;
-		cachedResult.text = text;
-		cachedResult.elementIds = result.elementIds;
-		return cachedResult;
+		result.text = text;
+		result.indices = it->second.indices;
+		result.score = it->second.score;
+		return result;
 	}
 
-	const std::vector<size_t> indices = result.indices;
+	// the indices are changed in place while recursing and restored afterwards
+	std::vector<size_t> indices = result.indices;
 	bestScoredResultRecursive(
 		utility::toLowerCase(result.text),
-		indices,
+		&indices,
 		indices.back(),
 		indices.size() - 1,
 		scoresCache,
 		&result);
 
 	// std::cout << "save: " << result.text << " " << result.score << std::endl;
-	scoresCache->emplace(result.text, result);
+	scoresCache->emplace(result.text, ScoredIndices {result.score, result.indices});
 
 	result.text = text;
 
@@ -348,10 +773,10 @@ SearchResult SearchIndex::bestScoredResult(
 
 void SearchIndex::bestScoredResultRecursive(
 	const std::wstring& lowerText,
-	const std::vector<size_t>& indices,
+	std::vector<size_t>* indices,
 	const size_t lastIndex,
 	const size_t indicesPos,
-	std::map<std::wstring, SearchResult>* scoresCache,
+	ScoresCache* scoresCache,
 	SearchResult* result)
 {
 	// left for debugging
@@ -372,9 +797,9 @@ void SearchIndex::bestScoredResultRecursive(
 	// }
 	// std::cout << "\n" << std::endl;
 
-	if (indicesPos + 1 == indices.size())
+	if (indicesPos + 1 == indices->size())
 	{
-		for (size_t i = (indices.back() == lastIndex ? lowerText.size() - 1 : indices.back() - 1);
+		for (size_t i = (indices->back() == lastIndex ? lowerText.size() - 1 : indices->back() - 1);
 			 i > lastIndex;
 			 i--)
 		{
@@ -391,46 +816,45 @@ void SearchIndex::bestScoredResultRecursive(
 					return;
 				}
 
-				std::vector<size_t> newIndices = indices;
-				newIndices[indicesPos] = i;
+				const size_t oldTextPos = (*indices)[indicesPos];
+				(*indices)[indicesPos] = i;
 
-				int newScore = scoreText(result->text, newIndices);
+				int newScore = scoreText(result->text, *indices);
 				if (newScore > result->score)
 				{
 					result->score = newScore;
-					result->indices = newIndices;
+					result->indices = *indices;
 				}
 
-				bestScoredResultRecursive(
-					lowerText, newIndices, lastIndex, indicesPos, scoresCache, result);
+				bestScoredResultRecursive(lowerText, indices, lastIndex, indicesPos, scoresCache, result);
+				(*indices)[indicesPos] = oldTextPos;
 
 				// std::cout << "save: " << lowerTextPart << " " << result->score << std::endl;
-				scoresCache->emplace(lowerTextPart, *result);
+				scoresCache->emplace(lowerTextPart, ScoredIndices {result->score, result->indices});
 				break;
 			}
 		}
 	}
 	else
 	{
-		size_t oldTextPos = indices[indicesPos];
-		size_t nextTextPos = indices[indicesPos + 1];
+		size_t oldTextPos = (*indices)[indicesPos];
+		size_t nextTextPos = (*indices)[indicesPos + 1];
 
 		for (size_t i = oldTextPos + 1; i < nextTextPos; i++)
 		{
 			if (lowerText[i] == lowerText[oldTextPos])
 			{
-				std::vector<size_t> newIndices = indices;
-				newIndices[indicesPos] = i;
+				(*indices)[indicesPos] = i;
 
-				int newScore = scoreText(result->text, newIndices);
+				int newScore = scoreText(result->text, *indices);
 				if (newScore > result->score)
 				{
 					result->score = newScore;
-					result->indices = newIndices;
+					result->indices = *indices;
 				}
 
-				bestScoredResultRecursive(
-					lowerText, newIndices, lastIndex, indicesPos, scoresCache, result);
+				bestScoredResultRecursive(lowerText, indices, lastIndex, indicesPos, scoresCache, result);
+				(*indices)[indicesPos] = oldTextPos;
 				break;
 			}
 		}
@@ -438,7 +862,7 @@ void SearchIndex::bestScoredResultRecursive(
 
 	for (size_t i = indicesPos; i > 0; i--)
 	{
-		if (indices[i] - indices[i - 1] > 1)
+		if ((*indices)[i] - (*indices)[i - 1] > 1)
 		{
 			bestScoredResultRecursive(lowerText, indices, lastIndex, i - 1, scoresCache, result);
 			break;
@@ -532,22 +956,21 @@ SearchResult SearchIndex::rescoreText(
 	// try if match is within text
 	else
 	{
-		size_t idx = 0;
 		size_t textSize = text.size();
 		if (maxBestScoredResultsLength && textSize > maxBestScoredResultsLength)
 		{
 			textSize = maxBestScoredResultsLength;
 		}
 
-		for (size_t i = 0; i < textSize && idx < indices.size(); i++)
+		std::wstring lowerQuery;
+		lowerQuery.reserve(indices.size());
+		for (size_t index: indices)
 		{
-			if (towlower(text[i]) == towlower(fulltext[indices[idx]]))
-			{
-				textIndices.push_back(i);
-				idx++;
-			}
+			lowerQuery.push_back(towlower(fulltext[index]));
 		}
 
+		const size_t idx = FuzzyMatcher::match(text.data(), textSize, lowerQuery, 0, 0, &textIndices);
+
 		// match was not found
 		if (idx != indices.size())
 		{
@@ -559,7 +982,7 @@ SearchResult SearchIndex::rescoreText(
 	result.score = scoreText(text, textIndices);
 	result.indices = textIndices;
 
-	std::map<std::wstring, SearchResult> scoresCache;
+	ScoresCache scoresCache;
 	result = bestScoredResult(result, &scoresCache, maxBestScoredResultsLength);
 
 	for (size_t i = 0; i < result.indices.size(); i++)
@@ -592,6 +1015,9 @@ flashmapper::Address SearchIndex::writeData(flashmapper::Mapper& mapper, flashma
 {
 	mapper.writeData(m_nodes, block);
 	mapper.writeData(m_edges, block);
+	mapper.writeData(m_elementNodes, block);
+	mapper.writeData(m_removedElementCount, block);
+	mapper.writeData(m_revision, block);
 
 	return block.baseOffset + block.cursor;
 
@@ -601,6 +1027,7 @@ void SearchIndex::resolveData(flashmapper::DataBlock& block)
 {
 	m_nodes.resolveData(block);
 	m_edges.resolveData(block);
+	m_elementNodes.resolveData(block);
 }
 
 flashmapper::Address SearchIndex::SearchNode::writeData(flashmapper::Mapper& mapper, flashmapper::DataBlock& block)
@@ -637,11 +1064,15 @@ void SearchIndex::load(std::string filePath, flashmapper::Mapper& mapper)
 {
 	m_nodes.clear();
 	m_edges.clear();
+	m_elementNodes.clear();
 
 	mapper.readFromFile(filePath.c_str());
 	SearchIndex* index = mapper.readData<SearchIndex>();
 	m_nodes = std::move(index->m_nodes);
 	m_edges = std::move(index->m_edges);
+	m_elementNodes = std::move(index->m_elementNodes);
+	m_removedElementCount = index->m_removedElementCount;
+	m_revision = index->m_revision;
 }
 
 void SearchIndex::save(std::string filePath, flashmapper::Mapper& mapper)
@@ -3,8 +3,10 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Node.h"
@@ -40,7 +42,44 @@ struct SearchResult
 
 class SearchIndex : flashmapper::ComplexMapper
 {
+private:
+	struct SearchPath;
+
 public:
+	// Remembers the paths matching the latest queries of an autocompletion session. A query that
+	// extends one of them only refines these paths instead of searching the whole trie again, which
+	// keeps typing responsive on large indices. Has to be cleared whenever the index changes.
+	class SearchCache
+	{
+	public:
+		void clear();
+
+	private:
+		friend class SearchIndex;
+
+		struct Entry
+		{
+			std::wstring query;
+			NodeTypeSet acceptedNodeTypes;
+			std::shared_ptr<const std::vector<SearchPath>> paths;
+		};
+
+		std::mutex m_mutex;
+		std::vector<Entry> m_entries;
+	};
+
+	struct Element
+	{
+		Element(Id id, std::wstring name, NodeType type)
+			: id(id), name(std::move(name)), type(type)
+		{
+		}
+
+		Id id;
+		std::wstring name;
+		NodeType type;
+	};
+
 	SearchIndex();
 	~SearchIndex();
 
@@ -51,15 +90,35 @@ public:
 	void finishSetup();
 	void clear();
 
+	// Replaces the content with the elements and finishes the setup. Elements are partitioned by
+	// their first character, so each thread builds an independent sub-trie including its edge gates,
+	// which get stitched together below the root afterwards.
+	void build(std::vector<Element> elements, size_t threadCount);
+
+	// incremental updates of an index that has been set up already. Removed elements leave their
+	// nodes and edges behind until the index gets compacted.
+	void insertNode(Id id, std::wstring name, NodeType type = NodeType(NODE_SYMBOL));
+	void removeNode(Id id);
+
+	size_t getRemovedElementCount() const;
+	bool needsCompaction() const;
+	std::shared_ptr<SearchIndex> createCompactedIndex() const;
+
+	// identifies the saved state, so a file is only reused by the database it was built for
+	size_t getRevision() const;
+	void setRevision(size_t revision);
+
 	void load(std::string filePath, flashmapper::Mapper& mapper);
 	void save(std::string filePath, flashmapper::Mapper& mapper);
 
-	// maxResultCount == 0 means "no restriction".
+	// maxResultCount == 0 means "no restriction". Passing a cache reuses the paths of a previous
+	// query the new one starts with.
 	std::vector<SearchResult> search(
 		const std::wstring& query,
 		NodeTypeSet acceptedNodeTypes,
 		size_t maxResultCount,
-		size_t maxBestScoredResultsLength = 0) const;
+		size_t maxBestScoredResultsLength = 0,
+		SearchCache* cache = nullptr) const;
 
 private:
 	struct SearchEdge;
@@ -105,28 +164,52 @@ private:
 		SearchNode* node;
 	};
 
+	void doAddNode(Id id, std::wstring name, NodeType type, bool updateGates);
+	void removeElementFromNode(Id id, long nodeIndex);
+	void addElementsRecursive(long nodeIndex, const std::wstring& text, SearchIndex* index) const;
+	void appendSubIndex(const SearchIndex& subIndex);
+
 	void populateEdgeGate(SearchEdge* e);
+	std::shared_ptr<const std::vector<SearchPath>> findPaths(
+		const std::wstring& lowerQuery, NodeTypeSet acceptedNodeTypes, SearchCache* cache) const;
+	void refinePaths(
+		const std::vector<SearchPath>& paths,
+		const std::wstring& addedQuery,
+		NodeTypeSet acceptedNodeTypes,
+		std::vector<SearchPath>* results) const;
+	// matches query from queryPos on below node, text and indices hold the path to node and are
+	// restored before returning
 	void searchRecursive(
-		const SearchPath& path,
-		const std::wstring& remainingQuery,
+		const SearchNode* node,
+		const std::wstring& query,
+		size_t queryPos,
 		NodeTypeSet acceptedNodeTypes,
+		std::wstring* text,
+		std::vector<size_t>* indices,
 		std::vector<SearchIndex::SearchPath>* results) const;
 
-	std::multiset<SearchResult> createScoredResults(
+	// results ordered by score, collection stops after maxResultCount results
+	std::vector<SearchResult> createScoredResults(
 		const std::vector<SearchPath>& paths,
 		NodeTypeSet acceptedNodeTypes,
 		size_t maxResultCount) const;
 
+	// best score found for a text prefix
+	struct ScoredIndices
+	{
+		int score;
+		std::vector<size_t> indices;
+	};
+	typedef std::unordered_map<std::wstring, ScoredIndices> ScoresCache;
+
 	static SearchResult bestScoredResult(
-		SearchResult result,
-		std::map<std::wstring, SearchResult>* scoresCache,
-		size_t maxBestScoredResultsLength);
+		SearchResult result, ScoresCache* scoresCache, size_t maxBestScoredResultsLength);
 	static void bestScoredResultRecursive(
 		const std::wstring& lowerText,
-		const std::vector<size_t>& indices,
+		std::vector<size_t>* indices,
 		const size_t lastIndex,
 		const size_t indicesPos,
-		std::map<std::wstring, SearchResult>* scoresCache,
+		ScoresCache* scoresCache,
 		SearchResult* result);
 	static int scoreText(const std::wstring& text, const std::vector<size_t>& indices);
 
@@ -142,6 +225,11 @@ public:
 
 	flashmapper::vector<SearchNode> m_nodes;
 	flashmapper::vector<SearchEdge> m_edges;
+
+	// index of the node holding each element, -1 after the element has been removed
+	flashmapper::map<Id, long> m_elementNodes;
+	size_t m_removedElementCount;
+	size_t m_revision;
 };
 
 #endif	  // SEARCH_INDEX_H
@@ -187,6 +187,9 @@ void IntermediateStorage::addFile(const StorageFile& file)
 		{
 			storedFile.languageIdentifier = file.languageIdentifier;
 		}
+
+		storedFile.indexingDuration = std::max(storedFile.indexingDuration, file.indexingDuration);
+		storedFile.storageSize = std::max(storedFile.storageSize, file.storageSize);
 	}
 	else
 	{
@@ -196,6 +199,21 @@ void IntermediateStorage::addFile(const StorageFile& file)
 	}
 }
 
+void IntermediateStorage::setFileIndexingCost(
+	const std::wstring& filePath, size_t indexingDuration, size_t storageSize)
+{
+	StorageFile key;
+	key.filePath = filePath;
+
+	auto it = m_filesIndex.find(key);
+	if (it != m_filesIndex.end())
+	{
+		StorageFile& storedFile = m_files[it->second];
+		storedFile.indexingDuration = indexingDuration;
+		storedFile.storageSize = storageSize;
+	}
+}
+
 void IntermediateStorage::setFileLanguage(Id fileId, const std::wstring& languageIdentifier)
 {
 	auto it = m_filesIdIndex.find(fileId);
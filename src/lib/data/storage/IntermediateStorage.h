@@ -28,6 +28,7 @@ public:
 	void addSymbols(const std::vector<StorageSymbol>& symbols) override;
 	void addFile(const StorageFile& file) override;
 	void setFileLanguage(Id fileId, const std::wstring& languageIdentifier);
+	void setFileIndexingCost(const std::wstring& filePath, size_t indexingDuration, size_t storageSize);
 	Id addEdge(const StorageEdgeData& edgeData) override;
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 	Id addLocalSymbol(const StorageLocalSymbolData& localSymbolData) override;
@@ -1,14 +1,16 @@
 #include "PersistentStorage.h"
 
-#include <queue>
+#include <chrono>
 #include <sstream>
 
 #include "AccessKind.h"
 #include "ApplicationSettings.h"
+#include "BidirectionalTrailSearch.h"
 #include "ElementComponentKind.h"
 #include "FileInfo.h"
 #include "FilePath.h"
 #include "Graph.h"
+#include "LineOffsetTable.h"
 #include "MessageErrorCountUpdate.h"
 #include "MessageStatus.h"
 #include "NodeTypeSet.h"
@@ -32,8 +34,25 @@
 
 #pragma optimize("", off)
 
+namespace
+{
+// candidate files verified per thread before the hits are reported
+const size_t s_fullTextSearchBatchFileCount = 16;
+
+// name hierarchies of recently shown nodes
+const size_t s_nameHierarchyCacheSize = 50000;
+
+// trail searches between two nodes stop after visiting this many nodes instead of stalling the UI
+const size_t s_maxTrailSearchNodeCount = 100000;
+
+// smaller batches are deserialized without starting threads
+const size_t s_minParallelNameHierarchyCount = 2000;
+}	 // namespace
+
 PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& bookmarkPath)
-	: m_sqliteIndexStorage(dbPath), m_sqliteBookmarkStorage(bookmarkPath)
+	: m_nameHierarchyCache(s_nameHierarchyCacheSize)
+	, m_sqliteIndexStorage(dbPath)
+	, m_sqliteBookmarkStorage(bookmarkPath)
 {
 	m_commandIndex.addNode(0, SearchMatch::getCommandName(SearchMatch::COMMAND_ALL));
 	m_commandIndex.addNode(0, SearchMatch::getCommandName(SearchMatch::COMMAND_ERROR));
@@ -49,7 +68,14 @@ PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& boo
 
 	m_commandIndex.finishSetup();
 
-	m_sqliteFullTextSearchIndex.setStorage(&m_sqliteIndexStorage);
+}
+
+PersistentStorage::~PersistentStorage()
+{
+	joinSearchIndexCompaction();
+
+	std::lock_guard<std::mutex> lock(m_nameHierarchyCacheMutex);
+	logNameHierarchyCacheStats();
 }
 
 std::pair<Id, bool> PersistentStorage::addNode(const StorageNodeData& data)
@@ -92,6 +118,12 @@ void PersistentStorage::addFile(const StorageFile& data)
 			m_sqliteIndexStorage.setFileCompleteIfNoError(
 				storedFile.id, storedFile.filePath, data.complete);
 		}
+
+		if (data.indexingDuration > 0 || data.storageSize > 0)
+		{
+			m_sqliteIndexStorage.setFileIndexingCost(
+				storedFile.id, data.indexingDuration, data.storageSize);
+		}
 	}
 }
 
@@ -248,6 +280,9 @@ void PersistentStorage::startInjection()
 {
 	beforeErrorRecording();
 
+	m_injectionStart = TimeStamp::now();
+	m_preInjectionRowCount = m_sqliteIndexStorage.getInsertedRowCount();
+
 	m_sqliteIndexStorage.beginTransaction();
 }
 
@@ -255,6 +290,12 @@ void PersistentStorage::finishInjection()
 {
 	m_sqliteIndexStorage.commitTransaction();
 
+	const size_t rowCount = m_sqliteIndexStorage.getInsertedRowCount() - m_preInjectionRowCount;
+	const size_t durationMS = std::max<size_t>(TimeStamp::now().deltaMS(m_injectionStart), 1);
+	LOG_INFO_STREAM(
+		<< "Injected " << rowCount << " rows in " << durationMS
+		<< " ms (" << rowCount * 1000 / durationMS << " rows/s)");
+
 	afterErrorRecording();
 }
 
@@ -355,13 +396,30 @@ void PersistentStorage::clear()
 
 void PersistentStorage::clearCaches()
 {
+	joinSearchIndexCompaction();
+
 	m_symbolIndex.clear();
 	m_fileIndex.clear();
+	{
+		std::lock_guard<std::mutex> lock(m_searchCacheMutex);
+		m_symbolSearchCache.clear();
+		m_fileSearchCache.clear();
+	}
+	m_nameTable.clear();
+	{
+		std::lock_guard<std::mutex> lock(m_nameHierarchyCacheMutex);
+		logNameHierarchyCacheStats();
+		m_nameHierarchyCache.clear();
+	}
 
 	m_filePathMapCache.clear();
 	m_hierarchyCache.clear();
-	m_fullTextSearchIndex.clear();
-	m_fullTextSearchCodec = "";
+	m_adjacencyIndex.clear();
+	{
+		std::lock_guard<std::mutex> lock(m_fullTextSearchMutex);
+		m_trigramIndex.clear();
+		m_fullTextSearchCodec = "";
+	}
 }
 
 void PersistentStorage::updateOverview()
@@ -486,8 +544,10 @@ void PersistentStorage::buildCaches()
 	m_sqliteIndexStorage.beginTransaction();
 	buildFilePathMaps();
 	buildSearchIndex();
+	buildNameTable();
 	buildMemberEdgeIdOrderMap();
 	buildHierarchyCache();
+	buildAdjacencyIndex();
 	m_sqliteIndexStorage.commitTransaction();
 }
 
@@ -514,24 +574,59 @@ Id PersistentStorage::getNodeIdForNameHierarchy(const NameHierarchy& nameHierarc
 std::vector<Id> PersistentStorage::getNodeIdsForNameHierarchies(
 	const std::vector<NameHierarchy> nameHierarchies) const
 {
-	std::vector<Id> nodeIds;
+	TRACE();
+
+	std::vector<std::wstring> serializedNames;
+	serializedNames.reserve(nameHierarchies.size());
 	for (const NameHierarchy& name: nameHierarchies)
 	{
-		Id nodeId = getNodeIdForNameHierarchy(name);
-		if (nodeId)
+		serializedNames.push_back(NameHierarchy::serialize(name));
+	}
+
+	std::unordered_map<std::wstring, Id> nodeIds;
+	for (StorageNode& node: m_sqliteIndexStorage.getNodesBySerializedNames(serializedNames))
+	{
+		nodeIds.emplace(std::move(node.serializedName), node.id);
+	}
+
+	std::vector<Id> orderedNodeIds;
+	for (const std::wstring& serializedName: serializedNames)
+	{
+		auto it = nodeIds.find(serializedName);
+		if (it != nodeIds.end())
 		{
-			nodeIds.push_back(nodeId);
+			orderedNodeIds.push_back(it->second);
 		}
 	}
-	return nodeIds;
+	return orderedNodeIds;
 }
 
 NameHierarchy PersistentStorage::getNameHierarchyForNodeId(Id nodeId) const
 {
 	TRACE();
 
-	return NameHierarchy::deserialize(
-		m_sqliteIndexStorage.getFirstById<StorageNode>(nodeId).serializedName);
+	NameHierarchy nameHierarchy;
+	{
+		std::lock_guard<std::mutex> lock(m_nameHierarchyCacheMutex);
+		if (m_nameHierarchyCache.getValue(nodeId, &nameHierarchy))
+		{
+			return nameHierarchy;
+		}
+	}
+
+	std::wstring serializedName = m_nameTable.getSerializedName(nodeId);
+	if (serializedName.empty())
+	{
+		serializedName = m_sqliteIndexStorage.getFirstById<StorageNode>(nodeId).serializedName;
+	}
+
+	nameHierarchy = NameHierarchy::deserialize(serializedName);
+	if (!serializedName.empty())
+	{
+		std::lock_guard<std::mutex> lock(m_nameHierarchyCacheMutex);
+		m_nameHierarchyCache.setValue(nodeId, nameHierarchy);
+	}
+	return nameHierarchy;
 }
 
 std::vector<NameHierarchy> PersistentStorage::getNameHierarchiesForNodeIds(
@@ -539,14 +634,150 @@ std::vector<NameHierarchy> PersistentStorage::getNameHierarchiesForNodeIds(
 {
 	TRACE();
 
-	std::vector<NameHierarchy> nameHierarchies;
-	for (const StorageNode& storageNode: m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIds))
+	// same order as the database returns them
+	std::vector<Id> sortedNodeIds = nodeIds;
+	std::sort(sortedNodeIds.begin(), sortedNodeIds.end());
+	sortedNodeIds.erase(std::unique(sortedNodeIds.begin(), sortedNodeIds.end()), sortedNodeIds.end());
+
+	std::vector<char> resolved;
+	std::vector<NameHierarchy> nameHierarchies =
+		getNameHierarchiesForSortedNodeIds(sortedNodeIds, &resolved);
+
+	if (std::find(resolved.begin(), resolved.end(), char(false)) != resolved.end())
+	{
+		std::vector<NameHierarchy> resolvedNameHierarchies;
+		for (size_t i = 0; i < nameHierarchies.size(); i++)
+		{
+			if (resolved[i])
+			{
+				resolvedNameHierarchies.push_back(std::move(nameHierarchies[i]));
+			}
+		}
+		return resolvedNameHierarchies;
+	}
+
+	return nameHierarchies;
+}
+
+std::vector<NameHierarchy> PersistentStorage::getNameHierarchiesForSortedNodeIds(
+	const std::vector<Id>& sortedNodeIds, std::vector<char>* resolvedNames) const
+{
+	std::vector<NameHierarchy> nameHierarchies(sortedNodeIds.size());
+	// not std::vector<bool>, threads write to neighbouring elements
+	std::vector<char> resolved(sortedNodeIds.size(), true);
+	std::vector<size_t> missingIndices;
+	{
+		std::lock_guard<std::mutex> lock(m_nameHierarchyCacheMutex);
+		for (size_t i = 0; i < sortedNodeIds.size(); i++)
+		{
+			if (!m_nameHierarchyCache.getValue(sortedNodeIds[i], &nameHierarchies[i]))
+			{
+				missingIndices.push_back(i);
+			}
+		}
+	}
+
+	if (!missingIndices.empty())
 	{
-		nameHierarchies.push_back(NameHierarchy::deserialize(storageNode.serializedName));
+		// names missing in the name table are queried from the database all at once
+		std::vector<std::wstring> serializedNames(missingIndices.size());
+		std::vector<Id> unresolvedNodeIds;
+		for (size_t i = 0; i < missingIndices.size(); i++)
+		{
+			const Id nodeId = sortedNodeIds[missingIndices[i]];
+			serializedNames[i] = m_nameTable.getSerializedName(nodeId);
+			if (serializedNames[i].empty())
+			{
+				unresolvedNodeIds.push_back(nodeId);
+			}
+		}
+
+		if (!unresolvedNodeIds.empty())
+		{
+			std::unordered_map<Id, std::wstring> unresolvedNames;
+			for (StorageNode& storageNode:
+				 m_sqliteIndexStorage.getAllByIds<StorageNode>(unresolvedNodeIds))
+			{
+				unresolvedNames.emplace(storageNode.id, std::move(storageNode.serializedName));
+			}
+
+			for (size_t i = 0; i < missingIndices.size(); i++)
+			{
+				if (serializedNames[i].empty())
+				{
+					auto it = unresolvedNames.find(sortedNodeIds[missingIndices[i]]);
+					if (it != unresolvedNames.end())
+					{
+						serializedNames[i] = std::move(it->second);
+					}
+				}
+			}
+		}
+
+		auto deserializeNames = [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++)
+			{
+				if (serializedNames[i].empty())
+				{
+					resolved[missingIndices[i]] = false;
+				}
+				else
+				{
+					nameHierarchies[missingIndices[i]] = NameHierarchy::deserialize(serializedNames[i]);
+				}
+			}
+		};
+
+		const size_t threadCount = missingIndices.size() < s_minParallelNameHierarchyCount
+			? 1
+			: std::max(utility::getIdealThreadCount(), 1);
+		if (threadCount == 1)
+		{
+			deserializeNames(0, missingIndices.size());
+		}
+		else
+		{
+			// every thread writes to its own range of names
+			const size_t partSize = (missingIndices.size() + threadCount - 1) / threadCount;
+			std::vector<std::shared_ptr<std::thread>> threads;
+			for (size_t first = 0; first < missingIndices.size(); first += partSize)
+			{
+				threads.push_back(std::make_shared<std::thread>(
+					deserializeNames, first, std::min(first + partSize, missingIndices.size())));
+			}
+			for (std::shared_ptr<std::thread> thread: threads)
+			{
+				thread->join();
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_nameHierarchyCacheMutex);
+		for (size_t index: missingIndices)
+		{
+			if (resolved[index])
+			{
+				m_nameHierarchyCache.setValue(sortedNodeIds[index], nameHierarchies[index]);
+			}
+		}
 	}
+
+	*resolvedNames = std::move(resolved);
 	return nameHierarchies;
 }
 
+void PersistentStorage::logNameHierarchyCacheStats() const
+{
+	// logged once per cache lifetime instead of for every batch of names
+	const size_t hitCount = m_nameHierarchyCache.getHitCount();
+	const size_t lookupCount = hitCount + m_nameHierarchyCache.getMissCount();
+	if (lookupCount)
+	{
+		LOG_INFO(
+			"Name hierarchy cache: " + std::to_string(lookupCount) + " lookups, " +
+			std::to_string(hitCount * 100 / lookupCount) + "% hit rate");
+	}
+}
+
 std::map<Id, std::pair<Id, NameHierarchy>> PersistentStorage::getNodeIdToParentFileMap(
 	const std::vector<Id>& nodeIds) const
 {
@@ -603,18 +834,27 @@ StorageEdge PersistentStorage::getEdgeById(Id edgeId) const
 	return m_sqliteIndexStorage.getEdgeById(edgeId);
 }
 
-std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLocations(
-	const std::wstring& searchTerm, bool caseSensitive) const
+size_t PersistentStorage::getFullTextSearchLocations(
+	const FullTextSearchQuery& query,
+	std::function<void(std::shared_ptr<SourceLocationCollection>)> onResults) const
 {
 	TRACE();
 
-	std::shared_ptr<SourceLocationCollection> collection =
-		std::make_shared<SourceLocationCollection>();
+	const std::wstring& searchTerm = query.searchTerm;
 	if (searchTerm.empty())
 	{
-		return collection;
+		return 0;
 	}
 
+	// a search term enclosed in slashes is a regular expression
+	const bool isRegex = searchTerm.size() > 2 && searchTerm.front() == L'/' &&
+		searchTerm.back() == L'/';
+	const std::wstring queryKind = std::wstring(isRegex ? L"regex, " : L"") + L"case-" +
+		(query.caseSensitive ? L"sensitive" : L"insensitive");
+
+	// the caller may count the reported hits in its query while the batches are streamed
+	const size_t reportedHitCount = query.reportedHitCount;
+
 	const TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
 	{
 		std::lock_guard<std::mutex> lock(m_fullTextSearchMutex);
@@ -622,109 +862,163 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLo
 		if (m_fullTextSearchCodec != codec.getName())
 		{
 			MessageStatus(L"Building fulltext search index", false, true).dispatch();
-			//buildFullTextSearchIndex();
+			buildFullTextSearchIndex();
 		}
 	}
 
-	MessageStatus(
-		std::wstring(L"Searching fulltext (case-") +
-			(caseSensitive ? L"sensitive" : L"insensitive") + L"): " + searchTerm,
-		false,
-		true)
-		.dispatch();
+	MessageStatus(L"Searching fulltext (" + queryKind + L"): " + searchTerm, false, true).dispatch();
+
+	const size_t threadCount = std::max(utility::getIdealThreadCount(), 1);
+	const bool isUtf8 = utility::equalsCaseInsensitive<std::string>(codec.getName(), "UTF-8");
+	size_t hitCount = 0;
+	size_t fileCount = 0;
+
+	// the texts read for verifying a batch are kept to resolve the positions of its matches
+	std::unordered_map<Id, std::string> fileTexts;
+	std::mutex fileTextsMutex;
+
+	const size_t nextCandidateIndex = m_trigramIndex.search(
+		codec.encode(isRegex ? searchTerm.substr(1, searchTerm.size() - 2) : searchTerm),
+		query.caseSensitive,
+		isRegex,
+		[this, &fileTexts, &fileTextsMutex](Id fileId) {
+			std::string text = m_sqliteIndexStorage.getFileContentById(fileId)->getText();
+			std::lock_guard<std::mutex> lock(fileTextsMutex);
+			fileTexts[fileId] = text;
+			return text;
+		},
+		threadCount,
+		query.firstCandidateIndex,
+		s_fullTextSearchBatchFileCount * threadCount,
+		[&](std::vector<FullTextSearchResult>&& results) {
+			if (*query.canceled)
+			{
+				return false;
+			}
 
-	{
-		std::vector<std::shared_ptr<std::thread>> threads;
-		std::mutex collectionMutex;
-		for (std::vector<FullTextSearchResult> fileResults: utility::splitToEquallySizedParts(
-				 m_sqliteFullTextSearchIndex.searchForTerm(searchTerm), utility::getIdealThreadCount()))
-		{
-			std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-				[this,
-				 &searchTerm,
-				 &caseSensitive,
-				 &codec,
-				 /*no ref here!*/ fileResults,
-				 &collection,
-				 &collectionMutex]() {
-					for (const FullTextSearchResult& fileResult: fileResults)
-					{
-						const FilePath filePath = getFileNodePath(fileResult.fileId);
-						std::shared_ptr<TextAccess> fileContent = getFileContent(filePath, false);
+			if (results.empty())
+			{
+				fileTexts.clear();
+				return true;
+			}
 
-						int charsTotal = 0;
-						int lineNumber = 1;
-						std::wstring line = codec.decode(fileContent->getLine(lineNumber));
+			std::shared_ptr<SourceLocationCollection> collection =
+				std::make_shared<SourceLocationCollection>();
+			// Set first bit to 1 to avoid collisions
+			const Id firstLocationId = ~(~Id(0) >> 1) + reportedHitCount + hitCount + 1;
 
-						const int posCount = fileResult.positions.size();
-						for (int i=0; i<posCount; i++)
+			std::vector<std::shared_ptr<std::thread>> threads;
+			std::mutex collectionMutex;
+			for (std::vector<FullTextSearchResult> fileResults:
+				 utility::splitToEquallySizedParts(results, threadCount))
+			{
+				std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
+					[this,
+					 &codec,
+					 isUtf8,
+					 &fileTexts,
+					 /*no ref here!*/ fileResults,
+					 &collection,
+					 &collectionMutex,
+					 firstLocationId]() {
+						// decoders keep state, so every thread needs its own
+						const TextCodec threadCodec(codec.getName());
+
+						for (const FullTextSearchResult& fileResult: fileResults)
 						{
-							int pos = fileResult.positions[i];
-							int termLength = fileResult.termLens[i];
-							while (charsTotal + (int)line.length() <= pos)
-							{
-								charsTotal += static_cast<int>(line.length());
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
+							const FilePath filePath = getFileNodePath(fileResult.fileId);
 
-							ParseLocation location;
-							location.startLineNumber = lineNumber;
-							location.startColumnNumber = pos - charsTotal + 1;
-
-							if (caseSensitive &&
-								line.substr(location.startColumnNumber - 1, termLength) != searchTerm)
+							// the threads only read the texts of the batch
+							auto textIt = fileTexts.find(fileResult.fileId);
+							if (textIt == fileTexts.end())
 							{
 								continue;
 							}
-							while ((charsTotal + (int)line.length()) < pos + termLength)
-							{
-								charsTotal += static_cast<int>(line.length());
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
-							location.endLineNumber = lineNumber;
-							location.endColumnNumber = pos + termLength - charsTotal;
-
+							const std::string& text = textIt->second;
+							const LineOffsetTable lineOffsets(text);
+
+							// positions are byte offsets into the text, columns are counted in
+							// characters
+							auto getCharacterCount = [&](size_t lineStart, size_t pos) {
+								pos = std::min(pos, text.size());
+								return isUtf8 ? LineOffsetTable::getUtf8CharacterCount(
+													text.data() + lineStart, pos - lineStart)
+											  : threadCodec.decode(
+													text.substr(lineStart, pos - lineStart))
+													.length();
+							};
+
+							const size_t posCount = fileResult.positions.size();
+							for (size_t i = 0; i < posCount; i++)
 							{
-								std::lock_guard<std::mutex> lock(collectionMutex);
-								// Set first bit to 1 to avoid collisions
-								const Id locationId = ~(~Id(0) >> 1) +
-									collection->getSourceLocationCount() + 1;
-								collection->addSourceLocation(
-									LOCATION_FULLTEXT_SEARCH,
-									locationId,
-									std::vector<Id>(),
-									filePath,
-									location.startLineNumber,
-									location.startColumnNumber,
-									location.endLineNumber,
-									location.endColumnNumber);
+								const size_t pos = fileResult.positions[i];
+								const size_t termLength = fileResult.termLens[i];
+								const size_t lastPos = termLength ? pos + termLength - 1 : pos;
+
+								ParseLocation location;
+								location.startLineNumber = lineOffsets.getLineNumber(pos);
+								location.startColumnNumber = static_cast<unsigned int>(
+									getCharacterCount(
+										lineOffsets.getLineStart(location.startLineNumber), pos) +
+									1);
+
+								location.endLineNumber = lineOffsets.getLineNumber(lastPos);
+								location.endColumnNumber = static_cast<unsigned int>(
+									getCharacterCount(
+										lineOffsets.getLineStart(location.endLineNumber),
+										pos + termLength));
+
+								{
+									std::lock_guard<std::mutex> lock(collectionMutex);
+									collection->addSourceLocation(
+										LOCATION_FULLTEXT_SEARCH,
+										firstLocationId + collection->getSourceLocationCount(),
+										std::vector<Id>(),
+										filePath,
+										location.startLineNumber,
+										location.startColumnNumber,
+										location.endLineNumber,
+										location.endColumnNumber);
+								}
 							}
 						}
-					}
-				});
-			threads.push_back(thread);
-		}
+					});
+				threads.push_back(thread);
+			}
 
-		for (std::shared_ptr<std::thread> thread: threads)
-		{
-			thread->join();
-		}
-	}
+			for (std::shared_ptr<std::thread> thread: threads)
+			{
+				thread->join();
+			}
+			fileTexts.clear();
 
-	addCompleteFlagsToSourceLocationCollection(collection.get());
+			addCompleteFlagsToSourceLocationCollection(collection.get());
 
-	MessageStatus(
-		std::to_wstring(collection->getSourceLocationCount()) + L" results in " +
-			std::to_wstring(collection->getSourceLocationFileCount()) +
-			L" files for fulltext search (case-" + (caseSensitive ? L"sensitive" : L"insensitive") +
-			L"): " + searchTerm,
-		false,
-		false)
-		.dispatch();
+			hitCount += collection->getSourceLocationCount();
+			fileCount += collection->getSourceLocationFileCount();
 
-	return collection;
+			onResults(collection);
+
+			return !*query.canceled && (query.maxHitCount == 0 || hitCount < query.maxHitCount);
+		});
+
+	std::wstring status = std::to_wstring(reportedHitCount + hitCount) + L" results";
+	if (query.firstCandidateIndex == 0)
+	{
+		status += L" in " + std::to_wstring(fileCount) + L" files";
+	}
+	status += L" for fulltext search (" + queryKind + L"): " + searchTerm;
+	if (*query.canceled)
+	{
+		status += L" (canceled)";
+	}
+	else if (nextCandidateIndex)
+	{
+		status += L" (limit reached, scroll down to load more)";
+	}
+	MessageStatus(status, false, false).dispatch();
+
+	return *query.canceled ? 0 : nextCandidateIndex;
 }
 
 std::vector<SearchMatch> PersistentStorage::getAutocompletionMatches(
@@ -829,8 +1123,16 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 	size_t maxBestScoredResultsLength) const
 {
 	// search in indices
-	const std::vector<SearchResult> results = m_symbolIndex.search(
-		query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength);
+	std::vector<SearchResult> results;
+	{
+		std::lock_guard<std::mutex> lock(m_searchCacheMutex);
+		results = m_symbolIndex.search(
+			query,
+			acceptedNodeTypes,
+			maxResultsCount,
+			maxBestScoredResultsLength,
+			&m_symbolSearchCache);
+	}
 
 	// fetch StorageNodes for node ids
 	std::map<Id, StorageNode> storageNodeMap;
@@ -919,11 +1221,14 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 std::vector<SearchMatch> PersistentStorage::getAutocompletionFileMatches(
 	const std::wstring& query, size_t maxResultsCount) const
 {
-	const std::vector<SearchResult> results = m_fileIndex.search(
-		query,
-		NodeTypeSet::all().getWithMatchingKept([](const NodeType& type) { return type.isFile(); }),
-		maxResultsCount,
-		100);
+	const NodeTypeSet fileTypes =
+		NodeTypeSet::all().getWithMatchingKept([](const NodeType& type) { return type.isFile(); });
+
+	std::vector<SearchResult> results;
+	{
+		std::lock_guard<std::mutex> lock(m_searchCacheMutex);
+		results = m_fileIndex.search(query, fileTypes, maxResultsCount, 100, &m_fileSearchCache);
+	}
 
 	// create SearchMatches
 	std::vector<SearchMatch> matches;
@@ -1067,7 +1372,10 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForAll() const
 					auto fn_it = m_filePathMapCache.m_fileNodeIndexed.find(storageNode.id);
 					if (fn_it != m_filePathMapCache.m_fileNodeIndexed.end() && fn_it->second)
 					{
-						addFileNodeToGraph(storageNode, graph.get());
+						addFileNodeToGraph(
+							storageNode.id,
+							NameHierarchy::deserialize(storageNode.serializedName),
+							graph.get());
 					}
 				}
 				else
@@ -1083,7 +1391,12 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForAll() const
 						(type.isPackage() ||
 						 !m_hierarchyCache.isChildOfVisibleNodeOrInvisible(storageNode.id)))
 					{
-						addNodeToGraph(storageNode, type, graph.get(), false);
+						addNodeToGraph(
+							storageNode.id,
+							type,
+							NameHierarchy::deserialize(storageNode.serializedName),
+							graph.get(),
+							false);
 					}
 				}
 			});
@@ -1178,7 +1491,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 				edgeIds.clear();
 
 				for (const StorageEdge& edge:
-					 m_sqliteIndexStorage.getEdgesBySourceOrTargetId(elementId))
+					 getEdgesBySourceOrTargetId(elementId))
 				{
 					Edge::EdgeType edgeType = Edge::intToType(edge.type);
 					if (edgeType == Edge::EDGE_MEMBER)
@@ -1343,267 +1656,107 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(
 
 	std::set<Id> nodeIds;
 	std::set<Id> edgeIds;
+	bool isTruncated = false;
 
-	nodeIds.insert(originId ? originId : targetId);
-	bool forward = originId;
-	size_t currentDepth = 0;
+	if (originId && targetId)
+	{
+		BidirectionalTrailSearch::Result result =
+			getTrailSearch(nodeTypes, edgeTypes, nodeNonIndexed, directed)
+				.search(originId, targetId, depth, s_maxTrailSearchNodeCount);
 
-	std::vector<Id> nodeIdsToProcess = {*nodeIds.begin()};
+		LOG_INFO(
+			"Trail search visited " + std::to_string(result.visitedNodeCount) + " nodes" +
+			(result.isTruncated ? " and was truncated" : ""));
 
-	struct TrailNode
+		if (result.isFound)
+		{
+			nodeIds = std::move(result.nodeIds);
+			edgeIds = std::move(result.edgeIds);
+		}
+		else
+		{
+			nodeIds.insert(originId);
+		}
+		isTruncated = result.isTruncated;
+	}
+	else
 	{
-		Id id = 0;
-		std::set<TrailNode*> parents;
-		std::set<Id> edgeIds;
-	};
+		addTrailNodesAndEdgeIds(
+			originId ? originId : targetId,
+			originId != 0,
+			nodeTypes,
+			edgeTypes,
+			nodeNonIndexed,
+			depth,
+			directed,
+			&nodeIds,
+			&edgeIds);
+	}
+
+	std::shared_ptr<Graph> graph = std::make_shared<Graph>();
+
+	addNodesWithParentsAndEdgesToGraph(
+		utility::toVector(nodeIds), utility::toVector(edgeIds), graph.get(), false);
+	addComponentAccessToGraph(graph.get());
+	addComponentIsAmbiguousToGraph(graph.get());
+	graph->setIsTrailTruncated(isTruncated);
 
-	bool isTerminatedTrail = originId && targetId;
-	std::map<Id, TrailNode> trailNodes;
+	return graph;
+}
+
+NodeKindMask PersistentStorage::getAvailableNodeTypes() const
+{
+	TRACE();
 
-	if (isTerminatedTrail)
+	NodeKindMask mask = 0;
+	for (int type: m_sqliteIndexStorage.getAvailableNodeTypes(true))
 	{
-		TrailNode root;
-		root.id = originId;
-		trailNodes.emplace(originId, root);
+		mask |= intToNodeKind(type);
 	}
+	return mask;
+}
 
-	while (nodeIdsToProcess.size() && (!depth || currentDepth < depth))
+Edge::TypeMask PersistentStorage::getAvailableEdgeTypes() const
+{
+	TRACE();
+
+	Edge::TypeMask mask = 0;
+	for (int type: m_sqliteIndexStorage.getAvailableEdgeTypes(true))
 	{
-		std::vector<StorageEdge> edges = forward
-			? m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess)
-			: m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess);
+		mask |= Edge::intToType(type);
+	}
+	return mask;
+}
 
-		if (!directed || edgeTypes & Edge::LAYOUT_VERTICAL)
-		{
-			utility::append(
-				edges,
-				forward ? m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess)
-						: m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess));
-		}
+// TODO: rename: getActiveElementIdsForId; TODO: make separate function for declarationId
+std::vector<Id> PersistentStorage::getActiveTokenIdsForId(Id tokenId, Id* declarationId) const
+{
+	TRACE();
 
-		std::vector<Id> nodeIdsToCheck;
-		std::map<Id, std::vector<StorageEdge>> edgesToInsert;
+	std::vector<Id> activeTokenIds;
 
-		for (const StorageEdge& edge: edges)
-		{
-			if (Edge::intToType(edge.type) & edgeTypes && edgeIds.find(edge.id) == edgeIds.end())
-			{
-				bool isForward = forward == !(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
+	bool isNode = m_sqliteIndexStorage.isNode(tokenId);
+	bool isEdge = m_sqliteIndexStorage.isEdge(tokenId);
 
-				const Id targetNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
-				const Id sourceNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+	if (!isEdge && !isNode)
+	{
+		return activeTokenIds;
+	}
 
-				if (nodeIds.find(targetNodeId) == nodeIds.end())
-				{
-					nodeIdsToCheck.push_back(targetNodeId);
-					edgesToInsert[targetNodeId].push_back(edge);
-				}
-				else if (nodeIds.find(sourceNodeId) == nodeIds.end())
-				{
-					if (!directed)
-					{
-						nodeIdsToCheck.push_back(sourceNodeId);
-						edgesToInsert[sourceNodeId].push_back(edge);
-					}
-				}
-				else
-				{
-					edgeIds.insert(edge.id);
+	activeTokenIds.push_back(tokenId);
 
-					if (isTerminatedTrail)
-					{
-						TrailNode& target = trailNodes[targetNodeId];
-						TrailNode& origin = trailNodes[sourceNodeId];
-						target.id = targetNodeId;
-						origin.id = sourceNodeId;
-						target.parents.insert(&origin);
-						target.edgeIds.insert(edge.id);
-					}
-				}
-			}
+	if (isNode)
+	{
+		*declarationId = tokenId;
+
+		for (const StorageEdge& edge: getEdgesByTargetIds({tokenId}))
+		{
+			activeTokenIds.push_back(edge.id);
 		}
+	}
 
-		nodeIdsToProcess.clear();
-
-		if (nodeTypes != 0)
-		{
-			for (const StorageNode& node:
-				 m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIdsToCheck))
-			{
-				NodeKind kind = intToNodeKind(node.type);
-				if (kind & nodeTypes || (kind == NODE_SYMBOL && nodeNonIndexed))
-				{
-					if (!nodeNonIndexed)
-					{
-						if (kind == NODE_FILE)
-						{
-							auto it = m_filePathMapCache.m_fileNodeIndexed.find(node.id);
-							if (it == m_filePathMapCache.m_fileNodeIndexed.end() || !it->second)
-							{
-								continue;
-							}
-						}
-						else
-						{
-							auto it = m_filePathMapCache.m_symbolDefinitionKinds.find(node.id);
-							if (it == m_filePathMapCache.m_symbolDefinitionKinds.end() || *it->second == DEFINITION_NONE)
-							{
-								continue;
-							}
-						}
-					}
-
-					// FIXME: don't add namespace nodes to the graph, because it destroys trail
-					// layouting Remove when namespaces are proper nodes with children
-					if ((kind & (NODE_MODULE | NODE_NAMESPACE | NODE_PACKAGE)) == 0)
-					{
-						nodeIds.insert(node.id);
-						for (const StorageEdge& edge: edgesToInsert[node.id])
-						{
-							if ((Edge::intToType(edge.type) & Edge::EDGE_MEMBER) == 0)
-							{
-								edgeIds.insert(edge.id);
-							}
-						}
-					}
-					nodeIdsToProcess.push_back(node.id);
-
-					if (isTerminatedTrail)
-					{
-						TrailNode& targetNode = trailNodes[node.id];
-						targetNode.id = node.id;
-
-						for (const StorageEdge& edge: edgesToInsert[node.id])
-						{
-							targetNode.edgeIds.insert(edge.id);
-
-							Id sourceNodeId =
-								(edge.targetNodeId == node.id ? edge.sourceNodeId
-															  : edge.targetNodeId);
-							TrailNode& oldNode = trailNodes[sourceNodeId];
-							targetNode.parents.insert(&oldNode);
-						}
-					}
-				}
-			}
-		}
-		else
-		{
-			for (const Id nodeId: nodeIdsToCheck)
-			{
-				nodeIds.insert(nodeId);
-				nodeIdsToProcess.push_back(nodeId);
-
-				for (const StorageEdge& edge: edgesToInsert[nodeId])
-				{
-					edgeIds.insert(edge.id);
-				}
-			}
-		}
-
-		edgesToInsert.clear();
-
-		currentDepth++;
-	}
-
-	if (isTerminatedTrail)
-	{
-		nodeIds.clear();
-		edgeIds.clear();
-
-		if (trailNodes.find(targetId) != trailNodes.end())
-		{
-			std::queue<TrailNode*> nodesToProcess;
-			nodesToProcess.push(&trailNodes[targetId]);
-
-			while (nodesToProcess.size())
-			{
-				TrailNode* currentNode = nodesToProcess.front();
-				nodesToProcess.pop();
-
-				if (nodeIds.find(currentNode->id) != nodeIds.end())
-				{
-					continue;
-				}
-
-				nodeIds.insert(currentNode->id);
-				edgeIds.insert(currentNode->edgeIds.begin(), currentNode->edgeIds.end());
-
-				for (TrailNode* parent: currentNode->parents)
-				{
-					nodesToProcess.push(parent);
-				}
-			}
-		}
-		else
-		{
-			nodeIds.insert(originId);
-		}
-	}
-
-	std::shared_ptr<Graph> graph = std::make_shared<Graph>();
-
-	addNodesWithParentsAndEdgesToGraph(
-		utility::toVector(nodeIds), utility::toVector(edgeIds), graph.get(), false);
-	addComponentAccessToGraph(graph.get());
-	addComponentIsAmbiguousToGraph(graph.get());
-
-	return graph;
-}
-
-NodeKindMask PersistentStorage::getAvailableNodeTypes() const
-{
-	TRACE();
-
-	NodeKindMask mask = 0;
-	for (int type: m_sqliteIndexStorage.getAvailableNodeTypes(true))
-	{
-		mask |= intToNodeKind(type);
-	}
-	return mask;
-}
-
-Edge::TypeMask PersistentStorage::getAvailableEdgeTypes() const
-{
-	TRACE();
-
-	Edge::TypeMask mask = 0;
-	for (int type: m_sqliteIndexStorage.getAvailableEdgeTypes(true))
-	{
-		mask |= Edge::intToType(type);
-	}
-	return mask;
-}
-
-// TODO: rename: getActiveElementIdsForId; TODO: make separate function for declarationId
-std::vector<Id> PersistentStorage::getActiveTokenIdsForId(Id tokenId, Id* declarationId) const
-{
-	TRACE();
-
-	std::vector<Id> activeTokenIds;
-
-	bool isNode = m_sqliteIndexStorage.isNode(tokenId);
-	bool isEdge = m_sqliteIndexStorage.isEdge(tokenId);
-
-	if (!isEdge && !isNode)
-	{
-		return activeTokenIds;
-	}
-
-	activeTokenIds.push_back(tokenId);
-
-	if (isNode)
-	{
-		*declarationId = tokenId;
-
-		for (const StorageEdge& edge: m_sqliteIndexStorage.getEdgesByTargetId(tokenId))
-		{
-			activeTokenIds.push_back(edge.id);
-		}
-	}
-
-	return activeTokenIds;
-}
+	return activeTokenIds;
+}
 
 std::vector<Id> PersistentStorage::getNodeIdsForLocationIds(const std::vector<Id>& locationIds) const
 {
@@ -1851,6 +2004,35 @@ bool PersistentStorage::hasContentForFile(const FilePath& filePath) const
 	return false;
 }
 
+std::map<FilePath, std::string> PersistentStorage::getFileContentHashesForAllFiles() const
+{
+	TRACE();
+
+	std::map<FilePath, std::string> contentHashes;
+	for (const auto& p: m_sqliteIndexStorage.getFileContentHashes())
+	{
+		contentHashes.emplace(FilePath(p.first), p.second);
+	}
+	return contentHashes;
+}
+
+std::map<FilePath, utility::IndexingCost> PersistentStorage::getIndexingCostsForAllFiles() const
+{
+	TRACE();
+
+	std::map<FilePath, utility::IndexingCost> indexingCosts;
+	m_sqliteIndexStorage.forEach<StorageFile>([&](StorageFile&& file) {
+		if (file.indexingDuration > 0 || file.storageSize > 0)
+		{
+			utility::IndexingCost cost;
+			cost.duration = file.indexingDuration;
+			cost.storageSize = file.storageSize;
+			indexingCosts.emplace(FilePath(file.filePath), cost);
+		}
+	});
+	return indexingCosts;
+}
+
 FileInfo PersistentStorage::getFileInfoForFileId(Id id) const
 {
 	StorageFile storageFile = m_sqliteIndexStorage.getFirstById<StorageFile>(id);
@@ -2270,7 +2452,7 @@ TooltipInfo PersistentStorage::getTooltipInfoForTokenIds(
 
 	info.count = 0;
 	info.countText = "reference";
-	for (const auto& edge: m_sqliteIndexStorage.getEdgesByTargetId(node.id))
+	for (const auto& edge: getEdgesByTargetIds({node.id}))
 	{
 		if (Edge::intToType(edge.type) != Edge::EDGE_MEMBER)
 		{
@@ -2470,7 +2652,7 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 			ApplicationSettings::getInstance()->getCodeTabWidth());
 
 		std::vector<Id> typeNodeIds;
-		for (const auto& edge: m_sqliteIndexStorage.getEdgesBySourceId(node.id))
+		for (const auto& edge: getEdgesBySourceIds({node.id}))
 		{
 			if (Edge::intToType(edge.type) == Edge::EDGE_TYPE_USAGE)
 			{
@@ -2877,6 +3059,230 @@ std::set<FilePath> PersistentStorage::getReferencingByImports(const std::set<Fil
 	return paths;
 }
 
+void PersistentStorage::addTrailNodesAndEdgeIds(
+	Id startNodeId,
+	bool forward,
+	NodeKindMask nodeTypes,
+	Edge::TypeMask edgeTypes,
+	bool nodeNonIndexed,
+	size_t depth,
+	bool directed,
+	std::set<Id>* nodeIds,
+	std::set<Id>* edgeIds) const
+{
+	TRACE();
+
+	nodeIds->insert(startNodeId);
+	size_t currentDepth = 0;
+
+	std::vector<Id> nodeIdsToProcess = {startNodeId};
+
+	while (nodeIdsToProcess.size() && (!depth || currentDepth < depth))
+	{
+		std::vector<StorageEdge> edges = forward
+			? getEdgesBySourceIds(nodeIdsToProcess, edgeTypes)
+			: getEdgesByTargetIds(nodeIdsToProcess, edgeTypes);
+
+		if (!directed || edgeTypes & Edge::LAYOUT_VERTICAL)
+		{
+			utility::append(
+				edges,
+				forward ? getEdgesByTargetIds(nodeIdsToProcess, edgeTypes)
+						: getEdgesBySourceIds(nodeIdsToProcess, edgeTypes));
+		}
+
+		std::vector<Id> nodeIdsToCheck;
+		std::map<Id, std::vector<StorageEdge>> edgesToInsert;
+
+		for (const StorageEdge& edge: edges)
+		{
+			if (Edge::intToType(edge.type) & edgeTypes && edgeIds->find(edge.id) == edgeIds->end())
+			{
+				bool isForward = forward == !(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
+
+				const Id targetNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
+				const Id sourceNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+
+				if (nodeIds->find(targetNodeId) == nodeIds->end())
+				{
+					nodeIdsToCheck.push_back(targetNodeId);
+					edgesToInsert[targetNodeId].push_back(edge);
+				}
+				else if (nodeIds->find(sourceNodeId) == nodeIds->end())
+				{
+					if (!directed)
+					{
+						nodeIdsToCheck.push_back(sourceNodeId);
+						edgesToInsert[sourceNodeId].push_back(edge);
+					}
+				}
+				else
+				{
+					edgeIds->insert(edge.id);
+				}
+			}
+		}
+
+		nodeIdsToProcess.clear();
+
+		if (nodeTypes != 0)
+		{
+			for (const StorageNode& node:
+				 m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIdsToCheck))
+			{
+				if (!isTrailNode(node, nodeTypes, nodeNonIndexed))
+				{
+					continue;
+				}
+
+				// FIXME: don't add namespace nodes to the graph, because it destroys trail
+				// layouting Remove when namespaces are proper nodes with children
+				if ((intToNodeKind(node.type) & (NODE_MODULE | NODE_NAMESPACE | NODE_PACKAGE)) == 0)
+				{
+					nodeIds->insert(node.id);
+					for (const StorageEdge& edge: edgesToInsert[node.id])
+					{
+						if ((Edge::intToType(edge.type) & Edge::EDGE_MEMBER) == 0)
+						{
+							edgeIds->insert(edge.id);
+						}
+					}
+				}
+				nodeIdsToProcess.push_back(node.id);
+			}
+		}
+		else
+		{
+			for (const Id nodeId: nodeIdsToCheck)
+			{
+				nodeIds->insert(nodeId);
+				nodeIdsToProcess.push_back(nodeId);
+
+				for (const StorageEdge& edge: edgesToInsert[nodeId])
+				{
+					edgeIds->insert(edge.id);
+				}
+			}
+		}
+
+		edgesToInsert.clear();
+
+		currentDepth++;
+	}
+}
+
+BidirectionalTrailSearch PersistentStorage::getTrailSearch(
+	NodeKindMask nodeTypes, Edge::TypeMask edgeTypes, bool nodeNonIndexed, bool directed) const
+{
+	// edges in vertical layout, like inheritance, point against the direction of the trail
+	const Edge::TypeMask horizontalEdgeTypes = edgeTypes & ~Edge::LAYOUT_VERTICAL;
+	const Edge::TypeMask verticalEdgeTypes = edgeTypes & Edge::LAYOUT_VERTICAL;
+
+	// the search passes through namespace nodes and member edges but leaves them out of the
+	// result, matching the nodes and edges that addTrailNodesAndEdgeIds adds to the graph
+	const bool hideNamespacesAndMembers = nodeTypes != 0;
+
+	return BidirectionalTrailSearch(
+		[this, horizontalEdgeTypes, verticalEdgeTypes, directed, hideNamespacesAndMembers](
+			const std::vector<Id>& nodeIds, bool forward) {
+			std::vector<BidirectionalTrailSearch::Step> steps;
+			auto addSteps = [&steps, hideNamespacesAndMembers](
+								const std::vector<StorageEdge>& edges, bool fromSource) {
+				for (const StorageEdge& edge: edges)
+				{
+					steps.push_back(
+						{fromSource ? edge.sourceNodeId : edge.targetNodeId,
+						 edge.id,
+						 fromSource ? edge.targetNodeId : edge.sourceNodeId,
+						 !hideNamespacesAndMembers ||
+							 (Edge::intToType(edge.type) & Edge::EDGE_MEMBER) == 0});
+				}
+			};
+
+			const Edge::TypeMask sourceEdgeTypes = directed
+				? (forward ? horizontalEdgeTypes : verticalEdgeTypes)
+				: horizontalEdgeTypes | verticalEdgeTypes;
+			const Edge::TypeMask targetEdgeTypes = directed
+				? (forward ? verticalEdgeTypes : horizontalEdgeTypes)
+				: horizontalEdgeTypes | verticalEdgeTypes;
+
+			if (sourceEdgeTypes)
+			{
+				addSteps(getEdgesBySourceIds(nodeIds, sourceEdgeTypes), true);
+			}
+			if (targetEdgeTypes)
+			{
+				addSteps(getEdgesByTargetIds(nodeIds, targetEdgeTypes), false);
+			}
+			return steps;
+		},
+		[this, nodeTypes, nodeNonIndexed](const std::vector<Id>& nodeIds) {
+			if (nodeTypes == 0)
+			{
+				return nodeIds;
+			}
+
+			std::vector<Id> trailNodeIds;
+			for (const StorageNode& node: m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIds))
+			{
+				if (isTrailNode(node, nodeTypes, nodeNonIndexed))
+				{
+					trailNodeIds.push_back(node.id);
+				}
+			}
+			return trailNodeIds;
+		},
+		[this, hideNamespacesAndMembers](const std::vector<Id>& nodeIds) {
+			if (!hideNamespacesAndMembers)
+			{
+				return nodeIds;
+			}
+
+			std::vector<Id> shownNodeIds;
+			for (const StorageNode& node: m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIds))
+			{
+				if ((intToNodeKind(node.type) & (NODE_MODULE | NODE_NAMESPACE | NODE_PACKAGE)) == 0)
+				{
+					shownNodeIds.push_back(node.id);
+				}
+			}
+			return shownNodeIds;
+		});
+}
+
+bool PersistentStorage::isTrailNode(
+	const StorageNode& node, NodeKindMask nodeTypes, bool nodeNonIndexed) const
+{
+	const NodeKind kind = intToNodeKind(node.type);
+	if (!(kind & nodeTypes) && !(kind == NODE_SYMBOL && nodeNonIndexed))
+	{
+		return false;
+	}
+
+	if (!nodeNonIndexed)
+	{
+		if (kind == NODE_FILE)
+		{
+			auto it = m_filePathMapCache.m_fileNodeIndexed.find(node.id);
+			if (it == m_filePathMapCache.m_fileNodeIndexed.end() || !it->second)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			auto it = m_filePathMapCache.m_symbolDefinitionKinds.find(node.id);
+			if (it == m_filePathMapCache.m_symbolDefinitionKinds.end() ||
+				*it->second == DEFINITION_NONE)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 void PersistentStorage::addNodesToGraph(
 	const std::vector<Id>& newNodeIds, Graph* graph, bool addChildCount) const
 {
@@ -2903,30 +3309,45 @@ void PersistentStorage::addNodesToGraph(
 		return;
 	}
 
-	for (const StorageNode& storageNode: m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIds))
+	// names are resolved from the name table and the name hierarchy cache instead of the database
+	const std::vector<std::pair<Id, int>> nodeTypes = m_sqliteIndexStorage.getNodeTypesByIds(nodeIds);
+
+	std::vector<Id> sortedNodeIds;
+	sortedNodeIds.reserve(nodeTypes.size());
+	for (const std::pair<Id, int>& nodeType: nodeTypes)
+	{
+		sortedNodeIds.push_back(nodeType.first);
+	}
+
+	std::vector<char> resolved;
+	std::vector<NameHierarchy> nameHierarchies =
+		getNameHierarchiesForSortedNodeIds(sortedNodeIds, &resolved);
+
+	for (size_t i = 0; i < nodeTypes.size(); i++)
 	{
-		const NodeType type(intToNodeKind(storageNode.type));
+		const NodeType type(intToNodeKind(nodeTypes[i].second));
 		if (type.isFile())
 		{
-			addFileNodeToGraph(storageNode, graph);
+			addFileNodeToGraph(nodeTypes[i].first, nameHierarchies[i], graph);
 		}
 		else
 		{
-			addNodeToGraph(storageNode, type, graph, addChildCount);
+			addNodeToGraph(
+				nodeTypes[i].first, type, std::move(nameHierarchies[i]), graph, addChildCount);
 		}
 	}
 }
 
-void PersistentStorage::addFileNodeToGraph(const StorageNode& storageNode, Graph* const graph) const
+void PersistentStorage::addFileNodeToGraph(
+	Id nodeId, const NameHierarchy& nameHierarchy, Graph* const graph) const
 {
-	NameHierarchy nameHierarchy = NameHierarchy::deserialize(storageNode.serializedName);
 	const FilePath filePath(nameHierarchy.getRawName());
 
-	bool complete = getFileNodeComplete(storageNode.id);
-	bool indexed = getFileNodeIndexed(storageNode.id);
+	bool complete = getFileNodeComplete(nodeId);
+	bool indexed = getFileNodeIndexed(nodeId);
 
 	Node* node = graph->createNode(
-		storageNode.id,
+		nodeId,
 		NodeType(NODE_FILE),
 		NameHierarchy(filePath.fileName(), NAME_DELIMITER_FILE),
 		indexed ? DEFINITION_EXPLICIT : DEFINITION_NONE);
@@ -2934,21 +3355,24 @@ void PersistentStorage::addFileNodeToGraph(const StorageNode& storageNode, Graph
 }
 
 void PersistentStorage::addNodeToGraph(
-	const StorageNode& newNode, const NodeType& type, Graph* graph, bool addChildCount) const
+	Id nodeId,
+	const NodeType& type,
+	NameHierarchy nameHierarchy,
+	Graph* graph,
+	bool addChildCount) const
 {
-	NameHierarchy nameHierarchy = NameHierarchy::deserialize(newNode.serializedName);
 	DefinitionKind defKind = DEFINITION_NONE;
-	auto it = m_filePathMapCache.m_symbolDefinitionKinds.find(newNode.id);
+	auto it = m_filePathMapCache.m_symbolDefinitionKinds.find(nodeId);
 	if (it != m_filePathMapCache.m_symbolDefinitionKinds.end())
 	{
 		defKind = *it->second;
 	}
 
-	Node* node = graph->createNode(newNode.id, type, std::move(nameHierarchy), defKind);
+	Node* node = graph->createNode(nodeId, type, std::move(nameHierarchy), defKind);
 
 	if (addChildCount)
 	{
-		node->setChildCount(m_hierarchyCache.getFirstChildIdsCountForNodeId(newNode.id));
+		node->setChildCount(m_hierarchyCache.getFirstChildIdsCountForNodeId(nodeId));
 	}
 }
 
@@ -3058,8 +3482,7 @@ void PersistentStorage::addBundledEdgesToGraph(
 		connectedNodeIds[isSource ? edge.targetNodeId : edge.sourceNodeId].push_back(edgeInfo);
 	}
 
-	const std::vector<StorageEdge> outgoingEdges = m_sqliteIndexStorage.getEdgesBySourceIds(
-		childNodeIds);
+	const std::vector<StorageEdge> outgoingEdges = getEdgesBySourceIds(childNodeIds);
 	for (const StorageEdge& outEdge: outgoingEdges)
 	{
 		EdgeInfo edgeInfo;
@@ -3068,8 +3491,7 @@ void PersistentStorage::addBundledEdgesToGraph(
 		connectedNodeIds[outEdge.targetNodeId].push_back(edgeInfo);
 	}
 
-	const std::vector<StorageEdge> incomingEdges = m_sqliteIndexStorage.getEdgesByTargetIds(
-		childNodeIds);
+	const std::vector<StorageEdge> incomingEdges = getEdgesByTargetIds(childNodeIds);
 	for (const StorageEdge& inEdge: incomingEdges)
 	{
 		EdgeInfo edgeInfo;
@@ -3349,7 +3771,16 @@ void PersistentStorage::buildSearchIndex()
 	const FilePath symbolIndexPath = dbPath.getParentDirectory().getConcatenated(FilePath("symbols.idx"));
 	const FilePath fileIndexPath = dbPath.getParentDirectory().getConcatenated(FilePath("files.idx"));
 
-	if (symbolIndexPath.exists())
+	{
+		std::lock_guard<std::mutex> lock(m_searchCacheMutex);
+		m_symbolSearchCache.clear();
+		m_fileSearchCache.clear();
+	}
+
+	// same as for the hierarchy cache, saved indices are updated with the recorded changes
+	const std::string revision = m_sqliteIndexStorage.getSearchIndexRevision();
+	if (!revision.empty() && symbolIndexPath.exists() && fileIndexPath.exists() &&
+		m_sqliteIndexStorage.isRecordingSearchIndexChanges())
 	{
 		m_symbolIndex.load(symbolIndexPath.str(), m_symbolIndexMapper);
 		m_fileIndex.load(fileIndexPath.str(), m_fileIndexMapper);
@@ -3357,9 +3788,26 @@ void PersistentStorage::buildSearchIndex()
 #if _FlashMapper_Statics_Enable
 		flashmapper::printStaticsInfo();
 #endif // #if _FlashMapper_Statics_Enable
-		return;
+
+		if (std::to_string(m_symbolIndex.getRevision()) == revision &&
+			std::to_string(m_fileIndex.getRevision()) == revision)
+		{
+			if (updateSearchIndex())
+			{
+				saveSearchIndex(symbolIndexPath, fileIndexPath);
+			}
+			return;
+		}
+
+		LOG_INFO("Search index does not match the database, rebuilding it");
+		m_symbolIndex.clear();
+		m_fileIndex.clear();
 	}
 
+	std::vector<SearchIndex::Element> fileElements;
+	std::vector<SearchIndex::Element> symbolElements;
+	std::vector<DefinitionKind> symbolDefinitionKinds;
+
 	m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
 		const NodeType type(intToNodeKind(node.type));
 		if (type.isFile())
@@ -3373,14 +3821,8 @@ void PersistentStorage::buildSearchIndex()
 			auto it = m_filePathMapCache.m_fileNodePaths.find(node.id);
 			if (it != m_filePathMapCache.m_fileNodePaths.end())
 			{
-				FilePath filePath(std::wstring(it->second->data()));
-
-				if (filePath.exists())
-				{
-					filePath.makeRelativeTo(dbPath);
-				}
-
-				m_fileIndex.addNode(node.id, filePath.wstr(), type);
+				fileElements.emplace_back(
+					node.id, getFileSearchName(FilePath(std::wstring(it->second->data()))), type);
 			}
 		}
 		else
@@ -3390,76 +3832,306 @@ void PersistentStorage::buildSearchIndex()
 				(it != m_filePathMapCache.m_symbolDefinitionKinds.end() ? *it->second : DEFINITION_NONE);
 			if (defKind != DEFINITION_IMPLICIT)
 			{
-				const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+				// the serialized name gets replaced by the search name below
+				symbolElements.emplace_back(node.id, std::move(node.serializedName), type);
+				symbolDefinitionKinds.push_back(defKind);
+			}
+		}
+	});
 
-				// we don't use the signature here, so elements with the same signature share the
-				// same node.
-				std::wstring name = nameHierarchy.getQualifiedName();
+	const size_t threadCount = std::max(utility::getIdealThreadCount(), 1);
 
-				// replace template arguments with .. to avoid clutter in search results and have
-				// different template specializations share the same node.
-				if (defKind == DEFINITION_NONE &&
-					nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
-				{
-					name = utility::replaceBetween(name, L'<', L'>', L"..");
-				}
+	{
+		std::vector<std::shared_ptr<std::thread>> threads;
+		const size_t chunkSize = symbolElements.size() / threadCount + 1;
+		for (size_t start = 0; start < symbolElements.size(); start += chunkSize)
+		{
+			const size_t end = std::min(start + chunkSize, symbolElements.size());
+			threads.push_back(std::make_shared<std::thread>(
+				[this, start, end, &symbolElements, &symbolDefinitionKinds]() {
+					for (size_t i = start; i < end; i++)
+					{
+						symbolElements[i].name = getSymbolSearchName(
+							symbolElements[i].name, symbolDefinitionKinds[i]);
+					}
+				}));
+		}
 
-				m_symbolIndex.addNode(node.id, std::move(name), type);
-			}
+		for (std::shared_ptr<std::thread> thread: threads)
+		{
+			thread->join();
 		}
-	});
+	}
+
+	TimeStamp start = TimeStamp::now();
+	const size_t elementCount = symbolElements.size() + fileElements.size();
 
-	m_symbolIndex.finishSetup();
-	m_fileIndex.finishSetup();
+	m_symbolIndex.build(std::move(symbolElements), threadCount);
+	m_fileIndex.build(std::move(fileElements), threadCount);
 
-	m_symbolIndex.save(symbolIndexPath.str(), m_symbolIndexMapper);
-	m_fileIndex.save(fileIndexPath.str(), m_fileIndexMapper);
+	LOG_INFO(
+		"Built search index for " + std::to_string(elementCount) + " nodes with " +
+		std::to_string(threadCount) + " threads in " +
+		std::to_string(TimeStamp::now().deltaMS(start)) + " ms");
+
+	saveSearchIndex(symbolIndexPath, fileIndexPath);
 }
 
-void PersistentStorage::buildFullTextSearchIndex() const
+bool PersistentStorage::updateSearchIndex()
 {
 	TRACE();
 
-	TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+	const std::vector<Id> nodeIds = m_sqliteIndexStorage.getSearchIndexChangedNodeIds();
+	if (nodeIds.empty())
+	{
+		return false;
+	}
 
-	m_fullTextSearchCodec = codec.getName();
+	// the file path map cache only reflects the state of the last full build, so the current
+	// values are taken from the database
+	std::map<Id, DefinitionKind> definitionKinds;
+	m_sqliteIndexStorage.forEachByIds<StorageSymbol>(
+		nodeIds, [&definitionKinds](StorageSymbol&& symbol) {
+			definitionKinds.emplace(symbol.id, intToDefinitionKind(symbol.definitionKind));
+		});
 
-	//m_fullTextSearchIndex.clear();
-	m_sqliteFullTextSearchIndex.clear();
+	// like the full build only indexed files are searchable, files that are not indexed anymore
+	// don't get inserted again and are removed below
+	std::map<Id, std::wstring> indexedFilePaths;
+	m_sqliteIndexStorage.forEachByIds<StorageFile>(nodeIds, [&indexedFilePaths](StorageFile&& file) {
+		if (file.indexed)
+		{
+			indexedFilePaths.emplace(file.id, file.filePath);
+		}
+	});
 
-	std::vector<std::shared_ptr<std::thread>> threads;
-	{
-		std::vector<StorageFile> indexedFiles;
-		for (const StorageFile& file: m_sqliteIndexStorage.getAll<StorageFile>())
+	// inserting replaces the previous entry of a node, so only nodes that are not inserted again
+	// get removed
+	std::set<Id> insertedFileIds;
+	std::set<Id> insertedSymbolIds;
+	m_sqliteIndexStorage.forEachByIds<StorageNode>(nodeIds, [&](StorageNode&& node) {
+		const NodeType type(intToNodeKind(node.type));
+		if (type.isFile())
 		{
-			if (file.indexed)
+			auto it = indexedFilePaths.find(node.id);
+			if (it != indexedFilePaths.end())
 			{
-				indexedFiles.push_back(file);
+				m_fileIndex.insertNode(node.id, getFileSearchName(FilePath(it->second)), type);
+				insertedFileIds.insert(node.id);
 			}
 		}
-		for (std::vector<StorageFile> part:
-			 utility::splitToEquallySizedParts(indexedFiles, utility::getIdealThreadCount()))
+		else
 		{
-			std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-				[&](const std::vector<StorageFile>& files) {
-					for (const StorageFile& file: files)
-					{
-						/*m_fullTextSearchIndex.addFile(
-							file.id,
-							codec.decode(m_sqliteIndexStorage.getFileContentByPath(file.filePath)->getText()));*/
-						m_sqliteFullTextSearchIndex.addFile(
-							file.id,
-							m_sqliteIndexStorage.getFileContentByPath(file.filePath)->getText());
-					}
-				},
-				part);
-			threads.push_back(thread);
+			auto it = definitionKinds.find(node.id);
+			const DefinitionKind defKind = (it != definitionKinds.end() ? it->second : DEFINITION_NONE);
+			if (defKind != DEFINITION_IMPLICIT)
+			{
+				m_symbolIndex.insertNode(
+					node.id, getSymbolSearchName(node.serializedName, defKind), type);
+				insertedSymbolIds.insert(node.id);
+			}
+		}
+	});
+
+	for (Id nodeId: nodeIds)
+	{
+		if (insertedSymbolIds.find(nodeId) == insertedSymbolIds.end())
+		{
+			m_symbolIndex.removeNode(nodeId);
 		}
+		if (insertedFileIds.find(nodeId) == insertedFileIds.end())
+		{
+			m_fileIndex.removeNode(nodeId);
+		}
+	}
+
+	const size_t insertedNodeCount = insertedFileIds.size() + insertedSymbolIds.size();
+
+	LOG_INFO(
+		"Updated search index: " + std::to_string(nodeIds.size()) + " changed nodes, " +
+		std::to_string(insertedNodeCount) + " inserted");
+
+	return true;
+}
+
+void PersistentStorage::saveSearchIndex(const FilePath& symbolIndexPath, const FilePath& fileIndexPath)
+{
+	joinSearchIndexCompaction();
+
+	const size_t revision = static_cast<size_t>(
+		std::chrono::system_clock::now().time_since_epoch().count());
+
+	// updated indices may still reference the data read by their mappers
+	flashmapper::Mapper symbolIndexMapper;
+	m_symbolIndex.setRevision(revision);
+	m_symbolIndex.save(symbolIndexPath.str(), symbolIndexMapper);
+
+	flashmapper::Mapper fileIndexMapper;
+	m_fileIndex.setRevision(revision);
+	m_fileIndex.save(fileIndexPath.str(), fileIndexMapper);
+
+	m_sqliteIndexStorage.resetSearchIndexChanges();
+	m_sqliteIndexStorage.setSearchIndexRevision(std::to_string(revision));
+
+	const bool compactSymbolIndex = m_symbolIndex.needsCompaction();
+	const bool compactFileIndex = m_fileIndex.needsCompaction();
+	if (!compactSymbolIndex && !compactFileIndex)
+	{
+		return;
+	}
+
+	// the loaded indices stay in use, only the saved files are replaced by compacted versions that
+	// get loaded the next time
+	m_searchIndexCompactionThread = std::make_shared<std::thread>(
+		[this, compactSymbolIndex, compactFileIndex, symbolIndexPath, fileIndexPath]() {
+			TimeStamp start = TimeStamp::now();
+
+			if (compactSymbolIndex)
+			{
+				flashmapper::Mapper mapper;
+				m_symbolIndex.createCompactedIndex()->save(symbolIndexPath.str(), mapper);
+			}
+
+			if (compactFileIndex)
+			{
+				flashmapper::Mapper mapper;
+				m_fileIndex.createCompactedIndex()->save(fileIndexPath.str(), mapper);
+			}
+
+			LOG_INFO(
+				"Compacted search index in " + std::to_string(TimeStamp::now().deltaMS(start)) +
+				" ms");
+		});
+}
+
+void PersistentStorage::joinSearchIndexCompaction()
+{
+	if (m_searchIndexCompactionThread)
+	{
+		m_searchIndexCompactionThread->join();
+		m_searchIndexCompactionThread.reset();
+	}
+}
+
+std::wstring PersistentStorage::getSymbolSearchName(
+	const std::wstring& serializedName, DefinitionKind definitionKind) const
+{
+	const NameHierarchy nameHierarchy = NameHierarchy::deserialize(serializedName);
+
+	// we don't use the signature here, so elements with the same signature share the
+	// same node.
+	std::wstring name = nameHierarchy.getQualifiedName();
+
+	// replace template arguments with .. to avoid clutter in search results and have
+	// different template specializations share the same node.
+	if (definitionKind == DEFINITION_NONE &&
+		nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
+	{
+		name = utility::replaceBetween(name, L'<', L'>', L"..");
 	}
-	for (std::shared_ptr<std::thread> thread: threads)
+
+	return name;
+}
+
+std::wstring PersistentStorage::getFileSearchName(FilePath filePath) const
+{
+	if (filePath.exists())
 	{
-		thread->join();
+		filePath.makeRelativeTo(getIndexDbFilePath());
 	}
+
+	return filePath.wstr();
+}
+
+void PersistentStorage::buildNameTable()
+{
+	TRACE();
+
+	const FilePath dbPath = getIndexDbFilePath();
+	const FilePath nameTablePath = dbPath.getParentDirectory().getConcatenated(
+		FilePath("names.idx"));
+
+	// node names only change along with the search index, so its revision identifies them as well
+	const std::string revision = m_sqliteIndexStorage.getSearchIndexRevision();
+	if (revision.empty() || m_nameTable.load(nameTablePath, revision))
+	{
+		return;
+	}
+
+	TimeStamp start = TimeStamp::now();
+
+	std::vector<std::pair<Id, std::string>> names;
+	m_sqliteIndexStorage.forEach<StorageNode>([&names](StorageNode&& node) {
+		names.emplace_back(node.id, utility::encodeToUtf8(node.serializedName));
+	});
+	const size_t nameCount = names.size();
+
+	if (NameTable::save(std::move(names), nameTablePath, revision) &&
+		m_nameTable.load(nameTablePath, revision))
+	{
+		LOG_INFO(
+			"Built name table for " + std::to_string(nameCount) + " nodes in " +
+			std::to_string(TimeStamp::now().deltaMS(start)) + " ms");
+	}
+}
+
+void PersistentStorage::buildFullTextSearchIndex() const
+{
+	TRACE();
+
+	TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+
+	m_fullTextSearchCodec = codec.getName();
+
+	const FilePath dbPath = getIndexDbFilePath();
+	const FilePath trigramIndexPath = dbPath.getParentDirectory().getConcatenated(
+		FilePath("fulltext.idx"));
+	const std::string fingerprint = m_sqliteIndexStorage.getFileContentFingerprint();
+
+	if (trigramIndexPath.exists() && m_trigramIndex.load(trigramIndexPath, fingerprint))
+	{
+		LOG_INFO(
+			"Loaded fulltext search index for " + std::to_string(m_trigramIndex.getFileCount()) +
+			" files");
+		return;
+	}
+
+	TimeStamp start = TimeStamp::now();
+
+	const size_t threadCount = std::max(utility::getIdealThreadCount(), 1);
+	const std::map<Id, std::string> fileStamps = m_sqliteIndexStorage.getIndexedFileContentStamps();
+
+	// the index saved before the last refresh only needs the changed files to be replaced
+	if (!trigramIndexPath.exists() || !m_trigramIndex.load(trigramIndexPath))
+	{
+		m_trigramIndex.clear();
+	}
+	const std::vector<Id> addedFileIds = m_trigramIndex.update(fileStamps, threadCount);
+
+	// one query streams the file contents while other threads collect their trigrams
+	const size_t byteCount = m_trigramIndex.addFiles(
+		[this, &fileStamps, &addedFileIds](const std::function<void(Id, std::string&&)>& addFile) {
+			if (addedFileIds.size() == fileStamps.size())
+			{
+				m_sqliteIndexStorage.forEachIndexedFileContent(addFile);
+			}
+			else
+			{
+				m_sqliteIndexStorage.forEachFileContent(addedFileIds, addFile);
+			}
+		},
+		threadCount);
+
+	m_trigramIndex.finishSetup();
+	m_trigramIndex.save(trigramIndexPath, fingerprint);
+
+	const float megaByteCount = float(byteCount) / (1024 * 1024);
+	const size_t durationMS = std::max<size_t>(TimeStamp::now().deltaMS(start), 1);
+	LOG_INFO(
+		"Built fulltext search index for " + std::to_string(m_trigramIndex.getFileCount()) +
+		" files, added " + std::to_string(addedFileIds.size()) + " files (" +
+		std::to_string(megaByteCount) + " MB) in " + std::to_string(durationMS) + " ms, " +
+		std::to_string(megaByteCount * 1000 / durationMS) + " MB/s");
 }
 
 void PersistentStorage::buildMemberEdgeIdOrderMap()
@@ -3542,10 +4214,24 @@ void PersistentStorage::buildHierarchyCache()
 	const FilePath dbPath = getIndexDbFilePath();
 	const FilePath hierarchyCachePath = dbPath.getParentDirectory().getConcatenated(
 		FilePath("hierarchy.idx"));
-	if (hierarchyCachePath.exists())
+	// a saved cache is only valid for the database it was built for, all changes made to the
+	// database since then have been recorded and get applied on top
+	const std::string revision = m_sqliteIndexStorage.getHierarchyCacheRevision();
+	if (!revision.empty() && hierarchyCachePath.exists() &&
+		m_sqliteIndexStorage.isRecordingHierarchyChanges())
 	{
 		m_hierarchyCache.load(hierarchyCachePath.str(), m_hierarchyCacheMapper);
-		return;
+		if (std::to_string(m_hierarchyCache.getRevision()) == revision)
+		{
+			if (updateHierarchyCache())
+			{
+				saveHierarchyCache(hierarchyCachePath);
+			}
+			return;
+		}
+
+		LOG_INFO("Hierarchy cache does not match the database, rebuilding it");
+		m_hierarchyCache.clear();
 	}
 
 	std::vector<Id> sourceNodeIds;
@@ -3603,5 +4289,169 @@ void PersistentStorage::buildHierarchyCache()
 			m_hierarchyCache.createInheritance(edge.id, edge.sourceNodeId, edge.targetNodeId);
 		});
 
-	m_hierarchyCache.save(hierarchyCachePath.str(), m_hierarchyCacheMapper);
+	saveHierarchyCache(hierarchyCachePath);
+}
+
+bool PersistentStorage::updateHierarchyCache()
+{
+	TRACE();
+
+	const std::vector<StorageHierarchyChange> changes =
+		m_sqliteIndexStorage.getAll<StorageHierarchyChange>();
+	if (changes.empty())
+	{
+		return false;
+	}
+
+	const int memberType = Edge::typeToInt(Edge::EDGE_MEMBER);
+	const int inheritanceType = Edge::typeToInt(Edge::EDGE_INHERITANCE);
+
+	std::set<Id> changedNodeIds;
+	for (const StorageHierarchyChange& change: changes)
+	{
+		if (change.edgeType == memberType)
+		{
+			if (change.removed)
+			{
+				m_hierarchyCache.removeConnection(change.elementId, change.targetNodeId);
+			}
+			else
+			{
+				m_hierarchyCache.addConnection(
+					change.elementId, change.sourceNodeId, change.targetNodeId);
+			}
+		}
+		else if (change.edgeType == inheritanceType)
+		{
+			if (change.removed)
+			{
+				m_hierarchyCache.removeInheritance(change.elementId, change.sourceNodeId);
+			}
+			else
+			{
+				m_hierarchyCache.addInheritance(
+					change.elementId, change.sourceNodeId, change.targetNodeId);
+			}
+		}
+
+		changedNodeIds.insert(change.sourceNodeId);
+		changedNodeIds.insert(change.targetNodeId);
+	}
+
+	const std::vector<Id> nodeIds = utility::toVector(changedNodeIds);
+
+	std::set<Id> invisibleParentNodeIds;
+	m_sqliteIndexStorage.forEachByIds<StorageNode>(
+		nodeIds, [&invisibleParentNodeIds](StorageNode&& node) {
+			if (!NodeType(intToNodeKind(node.type)).isVisibleAsParentInGraph())
+			{
+				invisibleParentNodeIds.insert(node.id);
+			}
+		});
+
+	std::set<Id> implicitNodeIds;
+	m_sqliteIndexStorage.forEachByIds<StorageSymbol>(
+		nodeIds, [&implicitNodeIds](StorageSymbol&& symbol) {
+			if (intToDefinitionKind(symbol.definitionKind) == DEFINITION_IMPLICIT)
+			{
+				implicitNodeIds.insert(symbol.id);
+			}
+		});
+
+	for (Id nodeId: nodeIds)
+	{
+		m_hierarchyCache.updateNodeFlags(
+			nodeId,
+			invisibleParentNodeIds.find(nodeId) == invisibleParentNodeIds.end(),
+			implicitNodeIds.find(nodeId) != implicitNodeIds.end());
+	}
+
+	LOG_INFO(
+		"Applied " + std::to_string(changes.size()) + " changes to the hierarchy cache");
+
+	return true;
+}
+
+void PersistentStorage::saveHierarchyCache(const FilePath& hierarchyCachePath)
+{
+	const size_t revision = static_cast<size_t>(
+		std::chrono::system_clock::now().time_since_epoch().count());
+
+	// an updated cache may still reference the data read by m_hierarchyCacheMapper
+	flashmapper::Mapper mapper;
+	m_hierarchyCache.setRevision(revision);
+	m_hierarchyCache.save(hierarchyCachePath.str(), mapper);
+
+	m_sqliteIndexStorage.resetHierarchyChanges();
+	m_sqliteIndexStorage.setHierarchyCacheRevision(std::to_string(revision));
+}
+
+void PersistentStorage::buildAdjacencyIndex()
+{
+	TRACE();
+
+	// not saved to a file, reading all edges once is about as fast as reading a saved index
+	TimeStamp start = TimeStamp::now();
+
+	std::vector<StorageEdge> edges;
+	m_sqliteIndexStorage.forEach<StorageEdge>(
+		[&edges](StorageEdge&& edge) { edges.emplace_back(edge); });
+	const size_t edgeCount = edges.size();
+
+	if (m_adjacencyIndex.build(std::move(edges)))
+	{
+		LOG_INFO(
+			"Built adjacency index for " + std::to_string(edgeCount) + " edges in " +
+			std::to_string(TimeStamp::now().deltaMS(start)) + " ms");
+	}
+	else
+	{
+		LOG_WARNING("Ids are too large for the adjacency index, querying edges from the database");
+	}
+}
+
+std::vector<StorageEdge> PersistentStorage::getEdgesBySourceIds(
+	const std::vector<Id>& sourceIds, Edge::TypeMask edgeTypes) const
+{
+	if (m_adjacencyIndex.isBuilt())
+	{
+		return m_adjacencyIndex.getEdgesBySourceIds(sourceIds, edgeTypes);
+	}
+
+	std::vector<StorageEdge> edges = m_sqliteIndexStorage.getEdgesBySourceIds(sourceIds);
+	edges.erase(
+		std::remove_if(
+			edges.begin(),
+			edges.end(),
+			[edgeTypes](const StorageEdge& edge) { return !(edge.type & edgeTypes); }),
+		edges.end());
+	return edges;
+}
+
+std::vector<StorageEdge> PersistentStorage::getEdgesByTargetIds(
+	const std::vector<Id>& targetIds, Edge::TypeMask edgeTypes) const
+{
+	if (m_adjacencyIndex.isBuilt())
+	{
+		return m_adjacencyIndex.getEdgesByTargetIds(targetIds, edgeTypes);
+	}
+
+	std::vector<StorageEdge> edges = m_sqliteIndexStorage.getEdgesByTargetIds(targetIds);
+	edges.erase(
+		std::remove_if(
+			edges.begin(),
+			edges.end(),
+			[edgeTypes](const StorageEdge& edge) { return !(edge.type & edgeTypes); }),
+		edges.end());
+	return edges;
+}
+
+std::vector<StorageEdge> PersistentStorage::getEdgesBySourceOrTargetId(Id nodeId) const
+{
+	if (m_adjacencyIndex.isBuilt())
+	{
+		return m_adjacencyIndex.getEdgesBySourceOrTargetId(nodeId);
+	}
+
+	return m_sqliteIndexStorage.getEdgesBySourceOrTargetId(nodeId);
 }
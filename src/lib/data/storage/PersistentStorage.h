@@ -1,18 +1,25 @@
 #ifndef PERSISTENT_STORAGE_H
 #define PERSISTENT_STORAGE_H
 
+#include <map>
 #include <memory>
+#include <thread>
 #include <vector>
 
-#include "FullTextSearchIndex.h"
-#include "SqliteFullTextSearchIndex.h"
+#include "AdjacencyIndex.h"
+#include "BidirectionalTrailSearch.h"
 #include "HierarchyCache.h"
+#include "LruCache.h"
+#include "NameTable.h"
 #include "SearchIndex.h"
 #include "SqliteBookmarkStorage.h"
 #include "SqliteIndexStorage.h"
 #include "Storage.h"
 #include "StorageAccess.h"
+#include "TimeStamp.h"
+#include "TrigramIndex.h"
 #include "flashmapper.h"
+#include "utilityFile.h"
 
 class PersistentStorage
 	: public Storage
@@ -20,6 +27,7 @@ class PersistentStorage
 {
 public:
 	PersistentStorage(const FilePath& dbPath, const FilePath& bookmarkPath);
+	~PersistentStorage();
 
 	std::pair<Id, bool> addNode(const StorageNodeData& data) override;
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes) override;
@@ -112,8 +120,9 @@ public:
 
 	StorageEdge getEdgeById(Id edgeId) const override;
 
-	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+	size_t getFullTextSearchLocations(
+		const FullTextSearchQuery& query,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> onResults) const override;
 
 	std::vector<SearchMatch> getAutocompletionMatches(
 		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
@@ -163,6 +172,8 @@ public:
 
 	std::shared_ptr<TextAccess> getFileContent(const FilePath& filePath, bool showsErrors) const override;
 	bool hasContentForFile(const FilePath& filePath) const;
+	std::map<FilePath, std::string> getFileContentHashesForAllFiles() const;
+	std::map<FilePath, utility::IndexingCost> getIndexingCostsForAllFiles() const;
 
 	FileInfo getFileInfoForFileId(Id id) const override;
 
@@ -311,6 +322,26 @@ private:
 	std::set<FilePath> getReferencingByIncludes(const std::set<FilePath>& filePaths) const;
 	std::set<FilePath> getReferencingByImports(const std::set<FilePath>& filePaths) const;
 
+	void addTrailNodesAndEdgeIds(
+		Id startNodeId,
+		bool forward,
+		NodeKindMask nodeTypes,
+		Edge::TypeMask edgeTypes,
+		bool nodeNonIndexed,
+		size_t depth,
+		bool directed,
+		std::set<Id>* nodeIds,
+		std::set<Id>* edgeIds) const;
+	BidirectionalTrailSearch getTrailSearch(
+		NodeKindMask nodeTypes, Edge::TypeMask edgeTypes, bool nodeNonIndexed, bool directed) const;
+	bool isTrailNode(const StorageNode& node, NodeKindMask nodeTypes, bool nodeNonIndexed) const;
+
+	// resolvedNames holds false for node ids without a name, their name hierarchies stay empty
+	std::vector<NameHierarchy> getNameHierarchiesForSortedNodeIds(
+		const std::vector<Id>& sortedNodeIds, std::vector<char>* resolvedNames) const;
+	// requires m_nameHierarchyCacheMutex to be locked
+	void logNameHierarchyCacheStats() const;
+
 	void addNodesToGraph(const std::vector<Id>& nodeIds, Graph* graph, bool addChildCount) const;
 	void addEdgesToGraph(const std::vector<Id>& edgeIds, Graph* graph) const;
 	void addNodesWithParentsAndEdgesToGraph(
@@ -318,9 +349,14 @@ private:
 		const std::vector<Id>& edgeIds,
 		Graph* graph,
 		bool addChildCount) const;
-	inline void addFileNodeToGraph(const StorageNode& storageNode, Graph* const graph) const;
+	inline void addFileNodeToGraph(
+		Id nodeId, const NameHierarchy& nameHierarchy, Graph* const graph) const;
 	void addNodeToGraph(
-		const StorageNode& newNode, const NodeType& type, Graph* graph, bool addChildCount) const;
+		Id nodeId,
+		const NodeType& type,
+		NameHierarchy nameHierarchy,
+		Graph* graph,
+		bool addChildCount) const;
 	void addBundledEdgesToGraph(
 		Id nodeId, const std::vector<StorageEdge>& edgesToBundle, Graph* graph) const;
 	void addFileContentsToGraph(Id fileId, Graph* graph) const;
@@ -332,22 +368,48 @@ private:
 
 	void buildFilePathMaps();
 	void buildSearchIndex();
+	bool updateSearchIndex();
+	void saveSearchIndex(const FilePath& symbolIndexPath, const FilePath& fileIndexPath);
+	void joinSearchIndexCompaction();
+	std::wstring getSymbolSearchName(
+		const std::wstring& serializedName, DefinitionKind definitionKind) const;
+	std::wstring getFileSearchName(FilePath filePath) const;
+	void buildNameTable();
 	void buildFullTextSearchIndex() const;
 	void buildMemberEdgeIdOrderMap();
 	void buildHierarchyCache();
+	bool updateHierarchyCache();
+	void saveHierarchyCache(const FilePath& hierarchyCachePath);
+	void buildAdjacencyIndex();
+
+	// use the adjacency index once it is built and query the database before
+	std::vector<StorageEdge> getEdgesBySourceIds(
+		const std::vector<Id>& sourceIds, Edge::TypeMask edgeTypes = ~0) const;
+	std::vector<StorageEdge> getEdgesByTargetIds(
+		const std::vector<Id>& targetIds, Edge::TypeMask edgeTypes = ~0) const;
+	std::vector<StorageEdge> getEdgesBySourceOrTargetId(Id nodeId) const;
 
 	bool m_preIndexingErrorCountSet = false;
 	size_t m_preIndexingErrorCount = 0;
 	size_t m_preInjectionErrorCount = 0;
 
+	TimeStamp m_injectionStart;
+	size_t m_preInjectionRowCount = 0;
+
 	SearchIndex m_commandIndex;
 	SearchIndex m_symbolIndex;
 	flashmapper::Mapper m_symbolIndexMapper;
 	SearchIndex m_fileIndex;
 	flashmapper::Mapper m_fileIndexMapper;
-
-	mutable FullTextSearchIndex m_fullTextSearchIndex;
-	mutable SqliteFullTextSearchIndex m_sqliteFullTextSearchIndex;
+	mutable SearchIndex::SearchCache m_symbolSearchCache;
+	mutable SearchIndex::SearchCache m_fileSearchCache;
+	mutable std::mutex m_searchCacheMutex;	  // the search caches are filled by every search
+	NameTable m_nameTable;
+	mutable LruCache<Id, NameHierarchy> m_nameHierarchyCache;
+	mutable std::mutex m_nameHierarchyCacheMutex;
+	std::shared_ptr<std::thread> m_searchIndexCompactionThread;
+
+	mutable TrigramIndex m_trigramIndex;
 	mutable std::string m_fullTextSearchCodec;
 	mutable std::mutex m_fullTextSearchMutex;
 
@@ -359,6 +421,8 @@ private:
 	HierarchyCache m_hierarchyCache;
 	flashmapper::Mapper m_hierarchyCacheMapper;
 
+	AdjacencyIndex m_adjacencyIndex;
+
 	mutable FilePathMapCache m_filePathMapCache;
 	flashmapper::Mapper m_filePathMapCacheMapper;
 };
@@ -1,11 +1,23 @@
 #include "Storage.h"
 
+#include "FlatIntermediateStorage.h"
 #include "logging.h"
 #include "tracing.h"
 
 Storage::Storage() {}
 
 void Storage::inject(Storage* injected)
+{
+	injectStorage(*injected);
+}
+
+void Storage::inject(const FlatIntermediateStorage& injected)
+{
+	injectStorage(injected);
+}
+
+template <typename StorageType>
+void Storage::injectStorage(const StorageType& injected)
 {
 	std::lock_guard<std::mutex> lock(m_dataMutex);
 
@@ -18,7 +30,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject errors");
 
-		for (const StorageError& error: injected->getErrors())
+		for (const StorageError& error: injected.getErrors())
 		{
 			Id errorId = addError(error);
 			injectedIdToOwnElementId.emplace(error.id, errorId);
@@ -28,7 +40,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject nodes");
 
-		const std::vector<StorageNode>& nodes = injected->getStorageNodes();
+		const std::vector<StorageNode>& nodes = injected.getStorageNodes();
 
 		std::vector<Id> nodeIds = addNodes(nodes);
 
@@ -44,18 +56,21 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject files");
 
-		for (const StorageFile& file: injected->getStorageFiles())
+		for (const StorageFile& file: injected.getStorageFiles())
 		{
 			auto it = injectedIdToOwnElementId.find(file.id);
 			if (it != injectedIdToOwnElementId.end())
 			{
-				addFile(StorageFile(
+				StorageFile ownFile(
 					it->second,
 					file.filePath,
 					file.languageIdentifier,
 					file.modificationTime,
 					file.indexed,
-					file.complete));
+					file.complete);
+				ownFile.indexingDuration = file.indexingDuration;
+				ownFile.storageSize = file.storageSize;
+				addFile(ownFile);
 			}
 		}
 	}
@@ -63,7 +78,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject symbols");
 
-		std::vector<StorageSymbol> symbols = injected->getStorageSymbols();
+		std::vector<StorageSymbol> symbols = injected.getStorageSymbols();
 		for (size_t i = 0; i < symbols.size(); i++)
 		{
 			auto it = injectedIdToOwnElementId.find(symbols[i].id);
@@ -85,7 +100,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject edges");
 
-		std::vector<StorageEdge> edges = injected->getStorageEdges();
+		std::vector<StorageEdge> edges = injected.getStorageEdges();
 		for (size_t i = 0; i < edges.size(); i++)
 		{
 			StorageEdge& edge = edges[i];
@@ -134,7 +149,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject local symbols");
 
-		const std::set<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
+		const std::set<StorageLocalSymbol>& symbols = injected.getStorageLocalSymbols();
 		std::vector<Id> symbolIds = addLocalSymbols(symbols);
 
 		auto it = symbols.begin();
@@ -151,7 +166,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject locations");
 
-		const std::set<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
+		const auto& oldLocations = injected.getStorageSourceLocations();
 		std::vector<StorageSourceLocation> locations;
 		locations.reserve(oldLocations.size());
 
@@ -193,7 +208,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject occurrences");
 
-		const std::set<StorageOccurrence>& oldOccurrences = injected->getStorageOccurrences();
+		const auto& oldOccurrences = injected.getStorageOccurrences();
 
 		std::vector<StorageOccurrence> occurrences;
 		occurrences.reserve(oldOccurrences.size());
@@ -235,7 +250,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject element components");
 
-		const std::set<StorageElementComponent>& oldComponents = injected->getElementComponents();
+		const std::set<StorageElementComponent>& oldComponents = injected.getElementComponents();
 		std::vector<StorageElementComponent> components;
 		components.reserve(oldComponents.size());
 
@@ -254,7 +269,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject accesses");
 
-		const std::set<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
+		const auto& oldAccesses = injected.getComponentAccesses();
 		std::vector<StorageComponentAccess> accesses;
 		accesses.reserve(oldAccesses.size());
 
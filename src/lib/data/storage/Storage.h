@@ -18,6 +18,8 @@
 #include "StorageSymbol.h"
 #include "types.h"
 
+class FlatIntermediateStorage;
+
 class Storage
 {
 public:
@@ -55,8 +57,12 @@ public:
 	virtual const std::vector<StorageError>& getErrors() const = 0;
 
 	void inject(Storage* injected);
+	void inject(const FlatIntermediateStorage& injected);
 
 private:
+	template <typename StorageType>
+	void injectStorage(const StorageType& injected);
+
 	virtual void startInjection();
 	virtual void finishInjection();
 
@@ -1,6 +1,7 @@
 #ifndef STORAGE_ACCESS_H
 #define STORAGE_ACCESS_H
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -12,6 +13,7 @@
 #include "ErrorCountInfo.h"
 #include "ErrorFilter.h"
 #include "ErrorInfo.h"
+#include "FullTextSearchQuery.h"
 #include "LocationType.h"
 #include "Node.h"
 #include "NodeBookmark.h"
@@ -50,8 +52,12 @@ public:
 
 	virtual StorageEdge getEdgeById(Id edgeId) const = 0;
 
-	virtual std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const = 0;
+	// a searchTerm enclosed in slashes, like "/get\w+Id/", is matched as regular expression. The hits
+	// are passed to onResults in batches of files, returns the candidate index to continue the search
+	// from if it stopped at the hit limit, 0 otherwise.
+	virtual size_t getFullTextSearchLocations(
+		const FullTextSearchQuery& query,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> onResults) const = 0;
 	virtual std::vector<SearchMatch> getAutocompletionMatches(
 		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const = 0;
 	virtual std::vector<SearchMatch> getSearchMatchesForTokenIds(
@@ -11,15 +11,22 @@
 
 void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 {
+	std::lock_guard<std::mutex> lock(m_subjectMutex);
 	m_subject = subject;
 }
 
+std::shared_ptr<StorageAccess> StorageAccessProxy::getSubject() const
+{
+	std::lock_guard<std::mutex> lock(m_subjectMutex);
+	return m_subject.lock();
+}
+
 #define UNWRAP(...) __VA_ARGS__
 
 #define DEF_GETTER_0(_METHOD_NAME_, _RETURN_TYPE_, _DEFAULT_VALUE_)                                \
 	UNWRAP(_RETURN_TYPE_) StorageAccessProxy::_METHOD_NAME_() const                                \
 	{                                                                                              \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                             \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                 \
 		{                                                                                          \
 			return subject->_METHOD_NAME_();                                                       \
 		}                                                                                          \
@@ -29,7 +36,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 #define DEF_GETTER_1(_METHOD_NAME_, _PARAM_1_TYPE_, _RETURN_TYPE_, _DEFAULT_VALUE_)                \
 	UNWRAP(_RETURN_TYPE_) StorageAccessProxy::_METHOD_NAME_(_PARAM_1_TYPE_ p1) const               \
 	{                                                                                              \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                             \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                 \
 		{                                                                                          \
 			return subject->_METHOD_NAME_(p1);                                                     \
 		}                                                                                          \
@@ -40,7 +47,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 	UNWRAP(_RETURN_TYPE_)                                                                           \
 	StorageAccessProxy::_METHOD_NAME_(_PARAM_1_TYPE_ p1, _PARAM_2_TYPE_ p2) const                   \
 	{                                                                                               \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                              \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                  \
 		{                                                                                           \
 			return subject->_METHOD_NAME_(p1, p2);                                                  \
 		}                                                                                           \
@@ -52,7 +59,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 	UNWRAP(_RETURN_TYPE_)                                                                            \
 	StorageAccessProxy::_METHOD_NAME_(_PARAM_1_TYPE_ p1, _PARAM_2_TYPE_ p2, _PARAM_3_TYPE_ p3) const \
 	{                                                                                                \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                               \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                   \
 		{                                                                                            \
 			return subject->_METHOD_NAME_(p1, p2, p3);                                               \
 		}                                                                                            \
@@ -71,7 +78,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 	StorageAccessProxy::_METHOD_NAME_(                                                             \
 		_PARAM_1_TYPE_ p1, _PARAM_2_TYPE_ p2, _PARAM_3_TYPE_ p3, _PARAM_4_TYPE_ p4) const          \
 	{                                                                                              \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                             \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                 \
 		{                                                                                          \
 			return subject->_METHOD_NAME_(p1, p2, p3, p4);                                         \
 		}                                                                                          \
@@ -92,7 +99,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 		_PARAM_1_TYPE_ p1, _PARAM_2_TYPE_ p2, _PARAM_3_TYPE_ p3, _PARAM_4_TYPE_ p4, _PARAM_5_TYPE_ p5) \
 		const                                                                                          \
 	{                                                                                                  \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                                 \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                     \
 		{                                                                                              \
 			return subject->_METHOD_NAME_(p1, p2, p3, p4, p5);                                         \
 		}                                                                                              \
@@ -118,7 +125,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 		_PARAM_5_TYPE_ p5,                                                                         \
 		_PARAM_6_TYPE_ p6) const                                                                   \
 	{                                                                                              \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                             \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                 \
 		{                                                                                          \
 			return subject->_METHOD_NAME_(p1, p2, p3, p4, p5, p6);                                 \
 		}                                                                                          \
@@ -146,7 +153,7 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 		_PARAM_6_TYPE_ p6,                                                                         \
 		_PARAM_7_TYPE_ p7) const                                                                   \
 	{                                                                                              \
-		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                             \
+		if (std::shared_ptr<StorageAccess> subject = getSubject())                                 \
 		{                                                                                          \
 			return subject->_METHOD_NAME_(p1, p2, p3, p4, p5, p6, p7);                             \
 		}                                                                                          \
@@ -166,10 +173,10 @@ DEF_GETTER_1(getNodeTypeForNodeWithId, Id, NodeType, NodeType(NODE_SYMBOL))
 DEF_GETTER_1(getEdgeById, Id, StorageEdge, StorageEdge())
 DEF_GETTER_2(
 	getFullTextSearchLocations,
-	const std::wstring&,
-	bool,
-	std::shared_ptr<SourceLocationCollection>,
-	std::make_shared<SourceLocationCollection>())
+	const FullTextSearchQuery&,
+	std::function<void(std::shared_ptr<SourceLocationCollection>)>,
+	size_t,
+	0)
 DEF_GETTER_3(
 	getAutocompletionMatches,
 	const std::wstring&,
@@ -251,7 +258,7 @@ DEF_GETTER_1(
 
 Id StorageAccessProxy::addNodeBookmark(const NodeBookmark& bookmark)
 {
-	if (std::shared_ptr<StorageAccess> subject = m_subject.lock())
+	if (std::shared_ptr<StorageAccess> subject = getSubject())
 	{
 		return subject->addNodeBookmark(bookmark);
 	}
@@ -261,7 +268,7 @@ Id StorageAccessProxy::addNodeBookmark(const NodeBookmark& bookmark)
 
 Id StorageAccessProxy::addEdgeBookmark(const EdgeBookmark& bookmark)
 {
-	if (std::shared_ptr<StorageAccess> subject = m_subject.lock())
+	if (std::shared_ptr<StorageAccess> subject = getSubject())
 	{
 		return subject->addEdgeBookmark(bookmark);
 	}
@@ -271,7 +278,7 @@ Id StorageAccessProxy::addEdgeBookmark(const EdgeBookmark& bookmark)
 
 Id StorageAccessProxy::addBookmarkCategory(const std::wstring& categoryName)
 {
-	if (std::shared_ptr<StorageAccess> subject = m_subject.lock())
+	if (std::shared_ptr<StorageAccess> subject = getSubject())
 	{
 		return subject->addBookmarkCategory(categoryName);
 	}
@@ -285,7 +292,7 @@ void StorageAccessProxy::updateBookmark(
 	const std::wstring& comment,
 	const std::wstring& categoryName)
 {
-	if (std::shared_ptr<StorageAccess> subject = m_subject.lock())
+	if (std::shared_ptr<StorageAccess> subject = getSubject())
 	{
 		subject->updateBookmark(bookmarkId, name, comment, categoryName);
 	}
@@ -293,7 +300,7 @@ void StorageAccessProxy::updateBookmark(
 
 void StorageAccessProxy::removeBookmark(const Id id)
 {
-	if (std::shared_ptr<StorageAccess> subject = m_subject.lock())
+	if (std::shared_ptr<StorageAccess> subject = getSubject())
 	{
 		subject->removeBookmark(id);
 	}
@@ -301,7 +308,7 @@ void StorageAccessProxy::removeBookmark(const Id id)
 
 void StorageAccessProxy::removeBookmarkCategory(const Id id)
 {
-	if (std::shared_ptr<StorageAccess> subject = m_subject.lock())
+	if (std::shared_ptr<StorageAccess> subject = getSubject())
 	{
 		subject->removeBookmarkCategory(id);
 	}
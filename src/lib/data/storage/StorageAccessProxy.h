@@ -2,6 +2,7 @@
 #define STORAGE_ACCESS_PROXY_H
 
 #include <memory>
+#include <mutex>
 
 #include "StorageAccess.h"
 
@@ -27,8 +28,9 @@ public:
 
 	StorageEdge getEdgeById(Id edgeId) const override;
 
-	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+	size_t getFullTextSearchLocations(
+		const FullTextSearchQuery& query,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> onResults) const override;
 	std::vector<SearchMatch> getAutocompletionMatches(
 		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
 	std::vector<SearchMatch> getSearchMatchesForTokenIds(const std::vector<Id>& tokenIds) const override;
@@ -106,7 +108,12 @@ public:
 		const std::vector<Id>& locationIds, const std::vector<Id>& localSymbolIds) const override;
 
 private:
+	// controllers query the storage from the scheduler and from their own threads; the subject
+	// guards its own state, so the lock is only held while the subject is swapped or fetched
+	std::shared_ptr<StorageAccess> getSubject() const;
+
 	std::weak_ptr<StorageAccess> m_subject;
+	mutable std::mutex m_subjectMutex;
 };
 
 #endif	  // STORAGE_ACCESS_PROXY_H
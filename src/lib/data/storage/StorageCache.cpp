@@ -7,6 +7,8 @@
 
 void StorageCache::clear()
 {
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
+
 	m_graphForAll.reset();
 
 	m_storageStats = StorageStats();
@@ -16,9 +18,21 @@ void StorageCache::clear()
 
 std::shared_ptr<Graph> StorageCache::getGraphForAll() const
 {
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		if (m_graphForAll)
+		{
+			return m_graphForAll;
+		}
+	}
+
+	// queried without holding the lock, so other callers are not blocked by the query
+	std::shared_ptr<Graph> graph = StorageAccessProxy::getGraphForAll();
+
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
 	if (!m_graphForAll)
 	{
-		m_graphForAll = StorageAccessProxy::getGraphForAll();
+		m_graphForAll = graph;
 	}
 
 	return m_graphForAll;
@@ -26,9 +40,20 @@ std::shared_ptr<Graph> StorageCache::getGraphForAll() const
 
 StorageStats StorageCache::getStorageStats() const
 {
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		if (m_storageStats.nodeCount)
+		{
+			return m_storageStats;
+		}
+	}
+
+	StorageStats stats = StorageAccessProxy::getStorageStats();
+
+	std::lock_guard<std::mutex> lock(m_cacheMutex);
 	if (!m_storageStats.nodeCount)
 	{
-		m_storageStats = StorageAccessProxy::getStorageStats();
+		m_storageStats = stats;
 	}
 
 	return m_storageStats;
@@ -2,6 +2,7 @@
 #define STORAGE_CACHE_H
 
 #include <map>
+#include <mutex>
 
 #include "StorageAccessProxy.h"
 
@@ -30,6 +31,7 @@ public:
 private:
 	mutable std::shared_ptr<Graph> m_graphForAll;
 	mutable StorageStats m_storageStats;
+	mutable std::mutex m_cacheMutex;
 
 	bool m_useErrorCache = false;
 	ErrorCountInfo m_errorCount;
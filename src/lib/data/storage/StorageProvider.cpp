@@ -5,13 +5,14 @@
 int StorageProvider::getStorageCount() const
 {
 	std::lock_guard<std::mutex> lock(m_storagesMutex);
-	return static_cast<int>(m_storages.size());
+	return static_cast<int>(m_storages.size() + m_flatStorages.size());
 }
 
 void StorageProvider::clear()
 {
 	std::lock_guard<std::mutex> lock(m_storagesMutex);
-	return m_storages.clear();
+	m_storages.clear();
+	m_flatStorages.clear();
 }
 
 void StorageProvider::insert(std::shared_ptr<IntermediateStorage> storage)
@@ -30,17 +31,27 @@ void StorageProvider::insert(std::shared_ptr<IntermediateStorage> storage)
 	m_storages.insert(it, storage);
 }
 
-std::shared_ptr<IntermediateStorage> StorageProvider::consumeSecondLargestStorage()
+void StorageProvider::insert(std::shared_ptr<FlatIntermediateStorage> storage)
 {
-	std::shared_ptr<IntermediateStorage> ret;
+	std::lock_guard<std::mutex> lock(m_storagesMutex);
+	m_flatStorages.push_back(storage);
+}
+
+std::vector<std::shared_ptr<IntermediateStorage>> StorageProvider::consumeSecondLargestStorages(
+	size_t maxCount)
+{
+	std::vector<std::shared_ptr<IntermediateStorage>> ret;
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
 		if (m_storages.size() > 1)
 		{
 			std::list<std::shared_ptr<IntermediateStorage>>::iterator it = m_storages.begin();
 			it++;
-			ret = *it;
-			m_storages.erase(it);
+			while (it != m_storages.end() && ret.size() < maxCount)
+			{
+				ret.push_back(*it);
+				it = m_storages.erase(it);
+			}
 		}
 	}
 	return ret;
@@ -61,6 +72,41 @@ std::shared_ptr<IntermediateStorage> StorageProvider::consumeLargestStorage()
 	return ret;
 }
 
+std::vector<std::shared_ptr<FlatIntermediateStorage>> StorageProvider::consumeFlatStorages(
+	size_t maxCount)
+{
+	std::vector<std::shared_ptr<FlatIntermediateStorage>> ret;
+	{
+		std::lock_guard<std::mutex> lock(m_storagesMutex);
+		std::list<std::shared_ptr<FlatIntermediateStorage>>::iterator it = m_flatStorages.begin();
+		if (m_storages.empty() && it != m_flatStorages.end())
+		{
+			it++;
+		}
+		while (it != m_flatStorages.end() && ret.size() < maxCount)
+		{
+			ret.push_back(*it);
+			it = m_flatStorages.erase(it);
+		}
+	}
+	return ret;
+}
+
+std::shared_ptr<FlatIntermediateStorage> StorageProvider::consumeFlatStorage()
+{
+	std::shared_ptr<FlatIntermediateStorage> ret;
+	{
+		std::lock_guard<std::mutex> lock(m_storagesMutex);
+		if (!m_flatStorages.empty())
+		{
+			ret = m_flatStorages.front();
+			m_flatStorages.pop_front();
+		}
+	}
+
+	return ret;
+}
+
 void StorageProvider::logCurrentState() const
 {
 	std::string logString = "Storages waiting for injection:";
@@ -70,6 +116,10 @@ void StorageProvider::logCurrentState() const
 		{
 			logString += " " + std::to_string(storage->getSourceLocationCount()) + ";";
 		}
+		for (const std::shared_ptr<FlatIntermediateStorage>& storage: m_flatStorages)
+		{
+			logString += " " + std::to_string(storage->getSourceLocationCount()) + " (flat);";
+		}
 	}
 	LOG_INFO(logString);
 }
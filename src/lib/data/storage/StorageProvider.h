@@ -1,10 +1,12 @@
 #ifndef STORAGE_PROVIDER_H
 #define STORAGE_PROVIDER_H
 
+#include "FlatIntermediateStorage.h"
 #include "IntermediateStorage.h"
 #include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 class StorageProvider
 {
@@ -14,17 +16,27 @@ public:
 	void clear();
 
 	void insert(std::shared_ptr<IntermediateStorage> storage);
+	void insert(std::shared_ptr<FlatIntermediateStorage> storage);
 
-	// returns empty shared_ptr if no storages available
-	std::shared_ptr<IntermediateStorage> consumeSecondLargestStorage();
+	// returns up to maxCount storages, starting with the second largest one; the largest storage is
+	// left for injection
+	std::vector<std::shared_ptr<IntermediateStorage>> consumeSecondLargestStorages(size_t maxCount);
 
 	// returns empty shared_ptr if no storages available
 	std::shared_ptr<IntermediateStorage> consumeLargestStorage();
 
+	// returns up to maxCount flat storages in the order of insertion; if no other storages are
+	// available the oldest one is left for injection
+	std::vector<std::shared_ptr<FlatIntermediateStorage>> consumeFlatStorages(size_t maxCount);
+
+	// returns empty shared_ptr if no flat storages available
+	std::shared_ptr<FlatIntermediateStorage> consumeFlatStorage();
+
 	void logCurrentState() const;
 
 private:
 	std::list<std::shared_ptr<IntermediateStorage>> m_storages;	   // larger storages are in front
+	std::list<std::shared_ptr<FlatIntermediateStorage>> m_flatStorages;
 	mutable std::mutex m_storagesMutex;
 };
 
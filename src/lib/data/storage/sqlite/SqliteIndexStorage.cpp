@@ -1,8 +1,11 @@
 #include "SqliteIndexStorage.h"
 
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 
+#include "ContentHash.h"
+#include "Edge.h"
 #include "FileSystem.h"
 #include "LocationType.h"
 #include "SourceLocationCollection.h"
@@ -10,9 +13,8 @@
 #include "TextAccess.h"
 #include "logging.h"
 #include "utilityString.h"
-#include <sstream>
 
-const size_t SqliteIndexStorage::s_storageVersion = 25;
+const size_t SqliteIndexStorage::s_storageVersion = 28;
 
 namespace
 {
@@ -52,6 +54,7 @@ void SqliteIndexStorage::setMode(const StorageModeType mode)
 	m_tempLocalSymbolIndex.clear();
 	m_tempSourceLocationIndices.clear();
 
+	// indices not needed for writing are dropped here and rebuilt once when switching back
 	std::vector<std::pair<int, SqliteDatabaseIndex>> indices = getIndices();
 	for (size_t i = 0; i < indices.size(); i++)
 	{
@@ -64,6 +67,13 @@ void SqliteIndexStorage::setMode(const StorageModeType mode)
 			indices[i].second.removeFromDatabase(m_database);
 		}
 	}
+
+	setBulkLoadEnabled(mode == STORAGE_MODE_WRITE);
+}
+
+size_t SqliteIndexStorage::getInsertedRowCount() const
+{
+	return m_insertedRowCount;
 }
 
 std::string SqliteIndexStorage::getProjectSettingsText() const
@@ -76,6 +86,131 @@ void SqliteIndexStorage::setProjectSettingsText(std::string text)
 	insertOrUpdateMetaValue("project_settings", text);
 }
 
+std::string SqliteIndexStorage::getHierarchyCacheRevision() const
+{
+	return getMetaValue("hierarchy_cache_revision");
+}
+
+void SqliteIndexStorage::setHierarchyCacheRevision(const std::string& revision)
+{
+	insertOrUpdateMetaValue("hierarchy_cache_revision", revision);
+}
+
+bool SqliteIndexStorage::isRecordingHierarchyChanges() const
+{
+	return hasTable("hierarchy_change");
+}
+
+void SqliteIndexStorage::resetHierarchyChanges()
+{
+	const std::string hierarchyEdgeTypes = std::to_string(Edge::typeToInt(Edge::EDGE_MEMBER)) +
+		", " + std::to_string(Edge::typeToInt(Edge::EDGE_INHERITANCE));
+
+	executeStatement(
+		"CREATE TABLE IF NOT EXISTS hierarchy_change("
+		"element_id INTEGER NOT NULL, "
+		"edge_type INTEGER NOT NULL, "
+		"source_node_id INTEGER NOT NULL, "
+		"target_node_id INTEGER NOT NULL, "
+		"removed INTEGER NOT NULL);");
+
+	// deleting elements cascades to edges and nodes, which fires these triggers as well
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS hierarchy_change_edge_insert AFTER INSERT ON edge "
+		"WHEN new.type IN (" + hierarchyEdgeTypes + ") BEGIN "
+		"INSERT INTO hierarchy_change VALUES("
+		"new.id, new.type, new.source_node_id, new.target_node_id, 0); "
+		"END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS hierarchy_change_edge_delete AFTER DELETE ON edge "
+		"WHEN old.type IN (" + hierarchyEdgeTypes + ") BEGIN "
+		"INSERT INTO hierarchy_change VALUES("
+		"old.id, old.type, old.source_node_id, old.target_node_id, 1); "
+		"END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS hierarchy_change_node_update AFTER UPDATE OF type ON node "
+		"BEGIN "
+		"INSERT INTO hierarchy_change VALUES(new.id, 0, new.id, new.id, 0); "
+		"END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS hierarchy_change_node_delete AFTER DELETE ON node "
+		"BEGIN "
+		"INSERT INTO hierarchy_change VALUES(old.id, 0, old.id, old.id, 1); "
+		"END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS hierarchy_change_symbol_insert AFTER INSERT ON symbol "
+		"BEGIN "
+		"INSERT INTO hierarchy_change VALUES(new.id, 0, new.id, new.id, 0); "
+		"END;");
+
+	executeStatement("DELETE FROM hierarchy_change;");
+}
+
+std::string SqliteIndexStorage::getSearchIndexRevision() const
+{
+	return getMetaValue("search_index_revision");
+}
+
+void SqliteIndexStorage::setSearchIndexRevision(const std::string& revision)
+{
+	insertOrUpdateMetaValue("search_index_revision", revision);
+}
+
+bool SqliteIndexStorage::isRecordingSearchIndexChanges() const
+{
+	return hasTable("search_index_change");
+}
+
+void SqliteIndexStorage::resetSearchIndexChanges()
+{
+	executeStatement(
+		"CREATE TABLE IF NOT EXISTS search_index_change("
+		"node_id INTEGER NOT NULL);");
+
+	// the indexed name depends on the node's name and type, the symbol's definition kind and the
+	// file's path and indexed state
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS search_index_change_node_insert AFTER INSERT ON node "
+		"BEGIN INSERT INTO search_index_change VALUES(new.id); END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS search_index_change_node_update "
+		"AFTER UPDATE OF type, serialized_name ON node "
+		"BEGIN INSERT INTO search_index_change VALUES(new.id); END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS search_index_change_node_delete AFTER DELETE ON node "
+		"BEGIN INSERT INTO search_index_change VALUES(old.id); END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS search_index_change_symbol_insert AFTER INSERT ON symbol "
+		"BEGIN INSERT INTO search_index_change VALUES(new.id); END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS search_index_change_file_insert AFTER INSERT ON file "
+		"BEGIN INSERT INTO search_index_change VALUES(new.id); END;");
+	executeStatement(
+		"CREATE TRIGGER IF NOT EXISTS search_index_change_file_update "
+		"AFTER UPDATE OF path, indexed ON file "
+		"BEGIN INSERT INTO search_index_change VALUES(new.id); END;");
+
+	executeStatement("DELETE FROM search_index_change;");
+}
+
+std::vector<Id> SqliteIndexStorage::getSearchIndexChangedNodeIds() const
+{
+	std::vector<Id> nodeIds;
+
+	CppSQLite3Query q = executeQuery("SELECT DISTINCT node_id FROM search_index_change;");
+	while (!q.eof())
+	{
+		const Id nodeId = q.getIntField(0, 0);
+		if (nodeId != 0)
+		{
+			nodeIds.push_back(nodeId);
+		}
+		q.nextRow();
+	}
+
+	return nodeIds;
+}
+
 Id SqliteIndexStorage::addNode(const StorageNodeData& data)
 {
 	std::vector<Id> ids = addNodes({StorageNode(0, data)});
@@ -103,6 +238,7 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
 
 	std::vector<Id> nodeIds(nodes.size(), 0);
 	std::vector<StorageNode> nodesToInsert;
+	const Id firstElementId = getNextElementId();
 	for (size_t i = 0; i < nodes.size(); i++)
 	{
 		const StorageNodeData& data = nodes[i];
@@ -131,8 +267,7 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
 			}
 			else
 			{
-				executeStatement(m_insertElementStmt);
-				const Id id = static_cast<Id>(m_database.lastRowId());
+				const Id id = firstElementId + nodesToInsert.size();
 
 				nodesToInsert.emplace_back(id, data);
 				nodeIds[i] = id;
@@ -152,8 +287,8 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
 
 	if (nodesToInsert.size())
 	{
+		addElements(firstElementId, nodesToInsert.size());
 		m_insertNodeBatchStatement.execute(nodesToInsert, this);
-		m_insertNodeFTSBatchStatement.execute(nodesToInsert, this);
 	}
 
 	return nodeIds;
@@ -186,9 +321,11 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 
 	std::shared_ptr<TextAccess> content = TextAccess::createFromFile(filePath);
 	int lineCount = 0;
+	std::string contentHash;
 	if (data.indexed)
 	{
 		lineCount = content->getLineCount();
+		contentHash = ContentHash::hashText(content->getText());
 	}
 
 	bool success = false;
@@ -200,6 +337,9 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 		m_insertFileStmt.bind(5, data.indexed);
 		m_insertFileStmt.bind(6, data.complete);
 		m_insertFileStmt.bind(7, lineCount);
+		m_insertFileStmt.bind(8, contentHash.c_str());
+		m_insertFileStmt.bind(9, int(data.indexingDuration));
+		m_insertFileStmt.bind(10, int(data.storageSize));
 		success = executeStatement(m_insertFileStmt);
 	}
 
@@ -210,10 +350,6 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 		success = executeStatement(m_insertFileContentStmt);
 	}
 
-	m_insertFileContentFTSStmt.bind(1, int(data.id));
-	m_insertFileContentFTSStmt.bind(2, content->getText().c_str());
-	success = success && executeStatement(m_insertFileContentFTSStmt);
-
 	return success;
 }
 
@@ -236,6 +372,7 @@ std::vector<Id> SqliteIndexStorage::addEdges(const std::vector<StorageEdge>& edg
 
 	std::vector<Id> edgeIds(edges.size(), 0);
 	std::vector<StorageEdge> edgesToInsert;
+	const Id firstElementId = getNextElementId();
 	for (size_t i = 0; i < edges.size(); i++)
 	{
 		const StorageEdge& data = edges[i];
@@ -246,8 +383,7 @@ std::vector<Id> SqliteIndexStorage::addEdges(const std::vector<StorageEdge>& edg
 		}
 		else
 		{
-			executeStatement(m_insertElementStmt);
-			const Id id = static_cast<Id>(m_database.lastRowId());
+			const Id id = firstElementId + edgesToInsert.size();
 
 			edgeIds[i] = id;
 			edgesToInsert.emplace_back(id, data);
@@ -258,6 +394,7 @@ std::vector<Id> SqliteIndexStorage::addEdges(const std::vector<StorageEdge>& edg
 
 	if (edgesToInsert.size())
 	{
+		addElements(firstElementId, edgesToInsert.size());
 		m_insertEdgeBatchStatement.execute(edgesToInsert, this);
 	}
 
@@ -286,6 +423,7 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 	std::vector<Id> symbolIds(symbols.size(), 0);
 	std::vector<StorageLocalSymbol> symbolsToInsert;
+	const Id firstElementId = getNextElementId();
 	auto it = symbols.begin();
 	for (size_t i = 0; i < symbols.size(); i++)
 	{
@@ -306,8 +444,7 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 		if (!symbolIds[i])
 		{
-			executeStatement(m_insertElementStmt);
-			const Id id = static_cast<Id>(m_database.lastRowId());
+			const Id id = firstElementId + symbolsToInsert.size();
 
 			symbolIds[i] = id;
 			symbolsToInsert.emplace_back(id, data);
@@ -322,6 +459,7 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 	if (symbolsToInsert.size())
 	{
+		addElements(firstElementId, symbolsToInsert.size());
 		m_insertLocalSymbolBatchStatement.execute(symbolsToInsert, this);
 	}
 
@@ -375,7 +513,6 @@ std::vector<Id> SqliteIndexStorage::addSourceLocations(const std::vector<Storage
 		}
 		else
 		{
-			executeStatement(m_insertElementStmt);
 			Id id = lastRowId + 1 + locationsToInsert.size();
 
 			locationIds[i] = id;
@@ -387,6 +524,7 @@ std::vector<Id> SqliteIndexStorage::addSourceLocations(const std::vector<Storage
 
 	if (locationsToInsert.size())
 	{
+		addElements(getNextElementId(), locationsToInsert.size());
 		m_insertSourceLocationBatchStatement.execute(locationsToInsert, this);
 	}
 
@@ -449,8 +587,8 @@ StorageError SqliteIndexStorage::addError(const StorageErrorData& data)
 
 	if (id == 0)
 	{
-		executeStatement(m_insertElementStmt);
-		id = static_cast<Id>(m_database.lastRowId());
+		id = getNextElementId();
+		addElements(id, 1);
 
 		m_insertErrorStmt.bind(1, int(id));
 		m_insertErrorStmt.bind(2, utility::encodeToUtf8(sanitizedMessage).c_str());
@@ -458,16 +596,27 @@ StorageError SqliteIndexStorage::addError(const StorageErrorData& data)
 		m_insertErrorStmt.bind(4, data.indexed);
 		m_insertErrorStmt.bind(5, utility::encodeToUtf8(data.translationUnit).c_str());
 
-		const bool success = executeStatement(m_insertErrorStmt);
-		if (success)
-		{
-			id = static_cast<Id>(m_database.lastRowId());
-		}
+		executeStatement(m_insertErrorStmt);
 	}
 
 	return StorageError(id, data);
 }
 
+Id SqliteIndexStorage::getNextElementId() const
+{
+	return static_cast<Id>(executeStatementScalar("SELECT MAX(id) FROM element", 0)) + 1;
+}
+
+bool SqliteIndexStorage::addElements(Id firstId, size_t count)
+{
+	std::vector<Id> ids(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		ids[i] = firstId + i;
+	}
+	return m_insertElementBatchStatement.execute(ids, this);
+}
+
 void SqliteIndexStorage::removeElement(Id id)
 {
 	std::vector<Id> ids;
@@ -802,6 +951,101 @@ StorageNode SqliteIndexStorage::getNodeBySerializedName(const std::wstring& seri
 	return StorageNode();
 }
 
+std::vector<StorageNode> SqliteIndexStorage::getNodesBySerializedNames(
+	const std::vector<std::wstring>& serializedNames) const
+{
+	// stays below the default limit of 999 bound parameters per statement
+	const size_t chunkSize = 500;
+
+	std::vector<StorageNode> nodes;
+	for (size_t start = 0; start < serializedNames.size(); start += chunkSize)
+	{
+		const size_t end = std::min(start + chunkSize, serializedNames.size());
+
+		std::string statement =
+			"SELECT id, type, serialized_name FROM node WHERE serialized_name IN (?";
+		for (size_t i = start + 1; i < end; i++)
+		{
+			statement += ", ?";
+		}
+		statement += ");";
+
+		CppSQLite3Statement stmt = m_database.compileStatement(statement.c_str());
+		for (size_t i = start; i < end; i++)
+		{
+			stmt.bind(
+				static_cast<int>(i - start + 1), utility::encodeToUtf8(serializedNames[i]).c_str());
+		}
+
+		CppSQLite3Query q = executeQuery(stmt);
+		while (!q.eof())
+		{
+			const Id id = q.getIntField(0, 0);
+			const int type = q.getIntField(1, -1);
+			const std::string name = q.getStringField(2, "");
+
+			if (id != 0 && type != -1)
+			{
+				nodes.emplace_back(id, type, utility::decodeFromUtf8(name));
+			}
+
+			q.nextRow();
+		}
+
+		stmt.reset();
+	}
+
+	return nodes;
+}
+
+std::vector<std::pair<Id, int>> SqliteIndexStorage::getNodeTypesByIds(
+	const std::vector<Id>& nodeIds) const
+{
+	// stays below the default limit of 999 bound parameters per statement
+	const size_t chunkSize = 500;
+
+	// chunks are queried in ascending order, so the result stays sorted by id
+	std::vector<Id> sortedNodeIds = nodeIds;
+	std::sort(sortedNodeIds.begin(), sortedNodeIds.end());
+
+	std::vector<std::pair<Id, int>> nodeTypes;
+	for (size_t start = 0; start < sortedNodeIds.size(); start += chunkSize)
+	{
+		const size_t end = std::min(start + chunkSize, sortedNodeIds.size());
+
+		std::string statement = "SELECT id, type FROM node WHERE id IN (?";
+		for (size_t i = start + 1; i < end; i++)
+		{
+			statement += ", ?";
+		}
+		statement += ") ORDER BY id;";
+
+		CppSQLite3Statement stmt = m_database.compileStatement(statement.c_str());
+		for (size_t i = start; i < end; i++)
+		{
+			stmt.bind(static_cast<int>(i - start + 1), int(sortedNodeIds[i]));
+		}
+
+		CppSQLite3Query q = executeQuery(stmt);
+		while (!q.eof())
+		{
+			const Id id = q.getIntField(0, 0);
+			const int type = q.getIntField(1, -1);
+
+			if (id != 0 && type != -1)
+			{
+				nodeTypes.emplace_back(id, type);
+			}
+
+			q.nextRow();
+		}
+
+		stmt.reset();
+	}
+
+	return nodeTypes;
+}
+
 void splitEnums(int value, int bits, std::vector<int>& types)
 {
 	for (int i = 0; i < bits; i++)
@@ -886,6 +1130,43 @@ std::vector<StorageFile> SqliteIndexStorage::getFilesByPaths(const std::vector<F
 		"WHERE file.path IN ('" + utility::join(utility::toStrings(filePaths), "', '") + "')");
 }
 
+std::map<std::wstring, std::string> SqliteIndexStorage::getFileContentHashes() const
+{
+	std::map<std::wstring, std::string> contentHashes;
+
+	CppSQLite3Query q = executeQuery("SELECT path, content_hash FROM file;");
+	while (!q.eof())
+	{
+		const std::string contentHash = q.getStringField(1, "");
+		if (!contentHash.empty())
+		{
+			contentHashes.emplace(utility::decodeFromUtf8(q.getStringField(0, "")), contentHash);
+		}
+		q.nextRow();
+	}
+
+	return contentHashes;
+}
+
+std::string SqliteIndexStorage::getFileContentFingerprint() const
+{
+	ContentHash hash;
+
+	CppSQLite3Query q = executeQuery(
+		"SELECT file.id, file.modification_time, file.content_hash "
+		"FROM file INNER JOIN filecontent ON file.id = filecontent.id "
+		"ORDER BY file.id;");
+	while (!q.eof())
+	{
+		const std::string row = std::to_string(q.getInt64Field(0, 0)) + ' ' +
+			q.getStringField(1, "") + ' ' + q.getStringField(2, "") + '\n';
+		hash.update(row.data(), row.size());
+		q.nextRow();
+	}
+
+	return hash.finish();
+}
+
 std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) const
 {
 	CppSQLite3Query q = executeQuery(
@@ -898,6 +1179,58 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) co
 	return TextAccess::createFromString("");
 }
 
+void SqliteIndexStorage::forEachIndexedFileContent(
+	std::function<void(Id, std::string&&)> func) const
+{
+	CppSQLite3Query q = executeQuery(
+		"SELECT filecontent.id, filecontent.content "
+		"FROM filecontent "
+		"INNER JOIN file ON filecontent.id = file.id "
+		"WHERE file.indexed = 1;");
+	while (!q.eof())
+	{
+		func(q.getInt64Field(0, 0), q.getStringField(1, ""));
+		q.nextRow();
+	}
+}
+
+void SqliteIndexStorage::forEachFileContent(
+	const std::vector<Id>& fileIds, std::function<void(Id, std::string&&)> func) const
+{
+	if (fileIds.empty())
+	{
+		return;
+	}
+
+	CppSQLite3Query q = executeQuery(
+		"SELECT id, content FROM filecontent WHERE id IN (" +
+		utility::join(utility::toStrings(fileIds), ',') + ");");
+	while (!q.eof())
+	{
+		func(q.getInt64Field(0, 0), q.getStringField(1, ""));
+		q.nextRow();
+	}
+}
+
+std::map<Id, std::string> SqliteIndexStorage::getIndexedFileContentStamps() const
+{
+	std::map<Id, std::string> stamps;
+
+	CppSQLite3Query q = executeQuery(
+		"SELECT file.id, file.modification_time, file.content_hash "
+		"FROM file INNER JOIN filecontent ON file.id = filecontent.id "
+		"WHERE file.indexed = 1;");
+	while (!q.eof())
+	{
+		stamps.emplace(
+			q.getInt64Field(0, 0),
+			std::string(q.getStringField(1, "")) + ' ' + q.getStringField(2, ""));
+		q.nextRow();
+	}
+
+	return stamps;
+}
+
 std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::wstring& filePath) const
 {
 	try
@@ -929,6 +1262,14 @@ void SqliteIndexStorage::setFileIndexed(Id fileId, bool indexed)
 		" WHERE id == " + std::to_string(fileId) + ";");
 }
 
+void SqliteIndexStorage::setFileIndexingCost(Id fileId, size_t indexingDuration, size_t storageSize)
+{
+	executeStatement(
+		"UPDATE file SET indexing_duration = " + std::to_string(indexingDuration) +
+		", storage_size = " + std::to_string(storageSize) + " WHERE id == " +
+		std::to_string(fileId) + ";");
+}
+
 void SqliteIndexStorage::setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete)
 {
 	bool fileHasErrors = doGetFirst<StorageSourceLocation>(
@@ -1303,14 +1644,18 @@ void SqliteIndexStorage::clearTables()
 {
 	try
 	{
+		m_database.execDML("DROP TABLE IF EXISTS main.search_index_change;");
+		m_database.execDML("DROP TABLE IF EXISTS main.hierarchy_change;");
 		m_database.execDML("DROP TABLE IF EXISTS main.error;");
 		m_database.execDML("DROP TABLE IF EXISTS main.component_access;");
 		m_database.execDML("DROP TABLE IF EXISTS main.occurrence;");
 		m_database.execDML("DROP TABLE IF EXISTS main.source_location;");
 		m_database.execDML("DROP TABLE IF EXISTS main.local_symbol;");
+		m_database.execDML("DROP TABLE IF EXISTS main.filecontent_fts;");
 		m_database.execDML("DROP TABLE IF EXISTS main.filecontent;");
 		m_database.execDML("DROP TABLE IF EXISTS main.file;");
 		m_database.execDML("DROP TABLE IF EXISTS main.symbol;");
+		m_database.execDML("DROP TABLE IF EXISTS main.node_fts;");
 		m_database.execDML("DROP TABLE IF EXISTS main.node;");
 		m_database.execDML("DROP TABLE IF EXISTS main.edge;");
 		m_database.execDML("DROP TABLE IF EXISTS main.element_component;");
@@ -1361,8 +1706,6 @@ void SqliteIndexStorage::setupTables()
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES element(id) ON DELETE CASCADE);");
 
-		m_database.execDML("CREATE VIRTUAL TABLE IF NOT EXISTS node_fts USING fts4(serialized_name);");
-
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS symbol("
 			"id INTEGER NOT NULL, "
@@ -1379,6 +1722,9 @@ void SqliteIndexStorage::setupTables()
 			"indexed INTEGER, "
 			"complete INTEGER, "
 			"line_count INTEGER, "
+			"content_hash TEXT, "
+			"indexing_duration INTEGER, "
+			"storage_size INTEGER, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES node(id) ON DELETE CASCADE);");
 
@@ -1391,8 +1737,6 @@ void SqliteIndexStorage::setupTables()
 			"ON DELETE CASCADE "
 			"ON UPDATE CASCADE);");
 
-		m_database.execDML("CREATE VIRTUAL TABLE IF NOT EXISTS filecontent_fts using fts4(content)");
-
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS local_symbol("
 			"id INTEGER NOT NULL, "
@@ -1466,15 +1810,6 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 				stmt.bind(int(index) * 3 + 3, utility::encodeToUtf8(node.serializedName).c_str());
 			},
 			m_database);
-		m_insertNodeFTSBatchStatement.compile(
-			"INSERT OR IGNORE INTO node_fts(docid, serialized_name) VALUES",
-			2,
-			[](CppSQLite3Statement& stmt, const StorageNode& node, size_t index)
-			{
-				stmt.bind(int(index) * 2 + 1, int(node.id));
-				stmt.bind(int(index) * 2 + 2, utility::encodeToUtf8(node.serializedName).c_str());
-			},
-			m_database);
 		m_insertEdgeBatchStatement.compile(
 			"INSERT INTO edge(id, type, source_node_id, target_node_id) VALUES",
 			4,
@@ -1531,16 +1866,21 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 			},
 			m_database);
 
-		m_insertElementStmt = m_database.compileStatement("INSERT INTO element(id) VALUES(NULL);");
+		m_insertElementBatchStatement.compile(
+			"INSERT INTO element(id) VALUES",
+			1,
+			[](CppSQLite3Statement& stmt, const Id& id, size_t index) {
+				stmt.bind(int(index) + 1, int(id));
+			},
+			m_database);
 		m_insertElementComponentStmt = m_database.compileStatement(
 			"INSERT INTO element_component(id, element_id, type, data) VALUES(NULL, ?, ?, ?);");
 		m_insertFileStmt = m_database.compileStatement(
 			"INSERT INTO file(id, path, language, modification_time, indexed, complete, "
-			"line_count) VALUES(?, ?, ?, ?, ?, ?, ?);");
+			"line_count, content_hash, indexing_duration, storage_size) "
+			"VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?);");
 		m_insertFileContentStmt = m_database.compileStatement(
 			"INSERT OR IGNORE INTO filecontent(id, content) VALUES(?, ?);");
-		m_insertFileContentFTSStmt = m_database.compileStatement(
-			"INSERT OR REPLACE INTO filecontent_fts(docid, content) VALUES(?, ?);");
 		m_checkErrorExistsStmt = m_database.compileStatement(
 			"SELECT id FROM error WHERE "
 			"message = ? AND "
@@ -1560,49 +1900,6 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 	}
 }
 
-bool SqliteIndexStorage::addFTSFileContent(const Id id, const std::string& data)
-{	
-	m_insertFileContentFTSStmt.bind(1, int(id));
-	m_insertFileContentFTSStmt.bind(2, data.c_str());
-	return executeStatement(m_insertFileContentFTSStmt);
-}
-
-std::vector<std::vector<long>> SqliteIndexStorage::queryFTSFileContentOffsets(const std::string& query)
-{
-	std::vector<std::vector<long>> offsets;
-	CppSQLite3Query q = executeQuery(
-		"select docid, offsets(filecontent_fts) from filecontent_fts where content match \"" + query + "*\"");
-	while (!q.eof())
-	{
-		std::vector<long> offset;
-		//LOG_INFO_STREAM(<< "FileID:" << q.getInt64Field(0) << "OffsetsInfo:" << q.getStringField(1));
-		offset.push_back(q.getInt64Field(0));
-		std::istringstream ss(q.getStringField(1));
-		std::string token;
-		int count = 0;
-		while (std::getline(ss, token, ' '))
-		{
-			if ((count % 4) > 1)
-			{
-				offset.push_back(std::stol(token));
-				//LOG_INFO_STREAM(<< token);
-			}
-			count++;
-		}
-
-		offsets.push_back(offset);
-
-		q.nextRow();
-	}
-
-	return offsets;
-}
-
-bool SqliteIndexStorage::clearFTSFileContent()
-{
-	return executeStatement("delete from filecontent_fts;");
-}
-
 template <>
 void SqliteIndexStorage::forEach<StorageEdge>(
 	const std::string& query, std::function<void(StorageEdge&&)> func) const
@@ -1667,12 +1964,41 @@ void SqliteIndexStorage::forEach<StorageSymbol>(
 	}
 }
 
+template <>
+void SqliteIndexStorage::forEach<StorageHierarchyChange>(
+	const std::string& query, std::function<void(StorageHierarchyChange&&)> func) const
+{
+	// rows are visited in insertion order, so changes can be replayed
+	CppSQLite3Query q = executeQuery(
+		"SELECT element_id, edge_type, source_node_id, target_node_id, removed FROM "
+		"hierarchy_change " +
+		query + " ORDER BY rowid;");
+
+	while (!q.eof())
+	{
+		const Id elementId = q.getIntField(0, 0);
+		const int edgeType = q.getIntField(1, 0);
+		const Id sourceId = q.getIntField(2, 0);
+		const Id targetId = q.getIntField(3, 0);
+		const bool removed = q.getIntField(4, 0);
+
+		if (elementId != 0)
+		{
+			func(StorageHierarchyChange(elementId, edgeType, sourceId, targetId, removed));
+		}
+
+		q.nextRow();
+	}
+}
+
 template <>
 void SqliteIndexStorage::forEach<StorageFile>(
 	const std::string& query, std::function<void(StorageFile&&)> func) const
 {
 	CppSQLite3Query q = executeQuery(
-		"SELECT id, path, language, modification_time, indexed, complete FROM file " + query + ";");
+		"SELECT id, path, language, modification_time, indexed, complete, indexing_duration, "
+		"storage_size FROM file " +
+		query + ";");
 
 	while (!q.eof())
 	{
@@ -1682,16 +2008,21 @@ void SqliteIndexStorage::forEach<StorageFile>(
 		const std::string modificationTime = q.getStringField(3, "");
 		const bool indexed = q.getIntField(4, 0);
 		const bool complete = q.getIntField(5, 0);
+		const size_t indexingDuration = q.getIntField(6, 0);
+		const size_t storageSize = q.getIntField(7, 0);
 
 		if (id != 0)
 		{
-			func(StorageFile(
+			StorageFile file(
 				id,
 				utility::decodeFromUtf8(filePath),
 				utility::decodeFromUtf8(languageIdentifier),
 				modificationTime,
 				indexed,
-				complete));
+				complete);
+			file.indexingDuration = indexingDuration;
+			file.storageSize = storageSize;
+			func(std::move(file));
 		}
 		q.nextRow();
 	}
@@ -1,6 +1,7 @@
 #ifndef SQLITE_INDEX_STORAGE_H
 #define SQLITE_INDEX_STORAGE_H
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,6 +16,7 @@
 #include "StorageElementComponent.h"
 #include "StorageError.h"
 #include "StorageFile.h"
+#include "StorageHierarchyChange.h"
 #include "StorageLocalSymbol.h"
 #include "StorageNode.h"
 #include "StorageOccurrence.h"
@@ -45,19 +47,36 @@ public:
 
 	virtual size_t getStaticVersion() const;
 
+	// STORAGE_MODE_WRITE also switches the database to bulk loading
 	void setMode(const StorageModeType mode);
 
+	// number of rows written by batch inserts since this storage was opened
+	size_t getInsertedRowCount() const;
+
 	std::string getProjectSettingsText() const;
 	void setProjectSettingsText(std::string text);
 
+	std::string getHierarchyCacheRevision() const;
+	void setHierarchyCacheRevision(const std::string& revision);
+
+	// once started, triggers record all changes relevant for the HierarchyCache in the database, so
+	// they travel along when the database file gets copied for a refresh
+	bool isRecordingHierarchyChanges() const;
+	void resetHierarchyChanges();
+
+	std::string getSearchIndexRevision() const;
+	void setSearchIndexRevision(const std::string& revision);
+
+	// same as above for all nodes that need to be updated in the symbol and file SearchIndex
+	bool isRecordingSearchIndexChanges() const;
+	void resetSearchIndexChanges();
+	std::vector<Id> getSearchIndexChangedNodeIds() const;
+
 	Id addNode(const StorageNodeData& data);
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes);
 	bool addSymbol(const StorageSymbol& data);
 	bool addSymbols(const std::vector<StorageSymbol>& symbols);
 	bool addFile(const StorageFile& data);
-	bool addFTSFileContent(const Id id, const std::string& data);
-	std::vector<std::vector<long>> queryFTSFileContentOffsets(const std::string& query);
-	bool clearFTSFileContent();
 	Id addEdge(const StorageEdgeData& data);
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges);
 	Id addLocalSymbol(const StorageLocalSymbolData& data);
@@ -103,6 +122,11 @@ public:
 
 	StorageNode getNodeById(Id id) const;
 	StorageNode getNodeBySerializedName(const std::wstring& serializedName) const;
+	// issues one query per chunk of names, names without node are left out
+	std::vector<StorageNode> getNodesBySerializedNames(
+		const std::vector<std::wstring>& serializedNames) const;
+	// node ids and types ordered by id, without reading the serialized names
+	std::vector<std::pair<Id, int>> getNodeTypesByIds(const std::vector<Id>& nodeIds) const;
 
 	void tryGetOrUpdateEnummasks(std::vector<int>& types,const std::string& key,const std::string& table,bool fromOverview) const;
 	void getElementTypes(std::vector<int>& types, const std::string& table) const;
@@ -115,8 +139,22 @@ public:
 	std::vector<StorageFile> getFilesByPaths(const std::vector<FilePath>& filePaths) const;
 	std::shared_ptr<TextAccess> getFileContentByPath(const std::wstring& filePath) const;
 	std::shared_ptr<TextAccess> getFileContentById(Id fileId) const;
+	// streams the contents of all indexed files with a single query
+	void forEachIndexedFileContent(std::function<void(Id, std::string&&)> func) const;
+	void forEachFileContent(
+		const std::vector<Id>& fileIds, std::function<void(Id, std::string&&)> func) const;
+
+	// maps the ids of indexed files with stored content to a stamp that changes with their content
+	std::map<Id, std::string> getIndexedFileContentStamps() const;
+
+	// maps file paths to the hash of their stored content, files without stored content are omitted
+	std::map<std::wstring, std::string> getFileContentHashes() const;
+
+	// identifies the stored contents of all files, changes whenever a file content is added or removed
+	std::string getFileContentFingerprint() const;
 
 	void setFileIndexed(Id fileId, bool indexed);
+	void setFileIndexingCost(Id fileId, size_t indexingDuration, size_t storageSize);
 	void setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete);
 	void setNodeType(int type, Id nodeId);
 
@@ -248,6 +286,10 @@ private:
 
 	std::vector<std::pair<int, SqliteDatabaseIndex>> getIndices() const;
 
+	// element ids are assigned in blocks and the rows are inserted in batches afterwards
+	Id getNextElementId() const;
+	bool addElements(Id firstId, size_t count);
+
 	virtual void clearTables();
 	virtual void setupTables();
 	virtual void setupPrecompiledStatements();
@@ -351,6 +393,7 @@ private:
 					}
 
 					i += batchSize;
+					storage->m_insertedRowCount += batchSize;
 				}
 			}
 
@@ -363,8 +406,8 @@ private:
 		std::function<void(CppSQLite3Statement& stmt, const StorageType&, size_t)> m_bindValuesFunc;
 	};
 
+	InsertBatchStatement<Id> m_insertElementBatchStatement;
 	InsertBatchStatement<StorageNode> m_insertNodeBatchStatement;
-	InsertBatchStatement<StorageNode> m_insertNodeFTSBatchStatement;
 	InsertBatchStatement<StorageEdge> m_insertEdgeBatchStatement;
 	InsertBatchStatement<StorageSymbol> m_insertSymbolBatchStatement;
 	InsertBatchStatement<StorageLocalSymbol> m_insertLocalSymbolBatchStatement;
@@ -372,13 +415,13 @@ private:
 	InsertBatchStatement<StorageOccurrence> m_insertOccurrenceBatchStatement;
 	InsertBatchStatement<StorageComponentAccess> m_insertComponentAccessBatchStatement;
 
-	CppSQLite3Statement m_insertElementStmt;
 	CppSQLite3Statement m_insertElementComponentStmt;
 	CppSQLite3Statement m_insertFileStmt;
 	CppSQLite3Statement m_insertFileContentStmt;
-	CppSQLite3Statement m_insertFileContentFTSStmt;
 	CppSQLite3Statement m_checkErrorExistsStmt;
 	CppSQLite3Statement m_insertErrorStmt;
+
+	size_t m_insertedRowCount = 0;
 };
 
 template <>
@@ -102,6 +102,24 @@ void SqliteStorage::optimizeMemory() const
 	executeStatement("VACUUM;");
 }
 
+void SqliteStorage::setBulkLoadEnabled(bool enabled) const
+{
+	if (enabled)
+	{
+		executeStatement("PRAGMA synchronous=OFF;");
+		executeStatement("PRAGMA journal_mode=MEMORY;");
+		executeStatement("PRAGMA temp_store=MEMORY;");
+		executeStatement("PRAGMA cache_size=-262144;");	   // 256 MB
+	}
+	else
+	{
+		executeStatement("PRAGMA synchronous=FULL;");
+		executeStatement("PRAGMA journal_mode=DELETE;");
+		executeStatement("PRAGMA temp_store=DEFAULT;");
+		executeStatement("PRAGMA cache_size=-2000;");	 // sqlite default
+	}
+}
+
 FilePath SqliteStorage::getDbFilePath() const
 {
 	return m_dbFilePath;
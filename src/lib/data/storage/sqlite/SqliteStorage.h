@@ -27,6 +27,9 @@ public:
 
 	void optimizeMemory() const;
 
+	// trades durability for insertion speed while the database gets filled from scratch
+	void setBulkLoadEnabled(bool enabled) const;
+
 	FilePath getDbFilePath() const;
 
 	bool isEmpty() const;
@@ -14,6 +14,8 @@ struct StorageFile
 		, modificationTime("")
 		, indexed(true)
 		, complete(true)
+		, indexingDuration(0)
+		, storageSize(0)
 	{
 	}
 
@@ -30,6 +32,8 @@ struct StorageFile
 		, modificationTime(std::move(modificationTime))
 		, indexed(indexed)
 		, complete(complete)
+		, indexingDuration(0)
+		, storageSize(0)
 	{
 	}
 
@@ -44,6 +48,10 @@ struct StorageFile
 	std::string modificationTime;
 	bool indexed;
 	bool complete;
+
+	// cost of indexing the translation unit of this source file, only set for source files
+	size_t indexingDuration;	// in milliseconds
+	size_t storageSize;			// byte size of the produced intermediate storage
 };
 
 #endif	  // STORAGE_FILE_H
@@ -0,0 +1,31 @@
+#ifndef STORAGE_HIERARCHY_CHANGE_H
+#define STORAGE_HIERARCHY_CHANGE_H
+
+#include "types.h"
+
+// A member or inheritance edge that has been added to or removed from the database. Changes of a
+// node's type or definition kind are stored with edgeType 0 and the node id as source and target.
+struct StorageHierarchyChange
+{
+	StorageHierarchyChange()
+		: elementId(0), edgeType(0), sourceNodeId(0), targetNodeId(0), removed(false)
+	{
+	}
+
+	StorageHierarchyChange(Id elementId, int edgeType, Id sourceNodeId, Id targetNodeId, bool removed)
+		: elementId(elementId)
+		, edgeType(edgeType)
+		, sourceNodeId(sourceNodeId)
+		, targetNodeId(targetNodeId)
+		, removed(removed)
+	{
+	}
+
+	Id elementId;
+	int edgeType;
+	Id sourceNodeId;
+	Id targetNodeId;
+	bool removed;
+};
+
+#endif	  // STORAGE_HIERARCHY_CHANGE_H
@@ -616,6 +616,12 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		}
 	}
 
+	int mergeThreadCount = ApplicationSettings::getInstance()->getStorageMergeThreadCount();
+	if (mergeThreadCount <= 0)
+	{
+		mergeThreadCount = std::max(utility::getIdealThreadCount(), 1);
+	}
+
 	if (!indexerCommandProvider->empty())
 	{
 		const int adjustedIndexerThreadCount = std::min<int>(
@@ -651,8 +657,13 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		taskParserWrapper->setTask(taskParallelIndexing);
 
 		// add task for refilling the indexer command queue
+		std::map<FilePath, utility::IndexingCost> indexingCosts;
+		if (!m_storage->isIncompatible())
+		{
+			indexingCosts = m_storage->getIndexingCostsForAllFiles();
+		}
 		taskParallelIndexing->addTask(std::make_shared<TaskFillIndexerCommandsQueue>(
-			m_appUUID, std::move(indexerCommandProvider), 20));
+			m_appUUID, std::move(indexerCommandProvider), 20, std::move(indexingCosts)));
 
 		// add task for indexing
 		bool multiProcess = ApplicationSettings::getInstance()->getMultiProcessIndexingEnabled() &&
@@ -660,7 +671,7 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		taskParallelIndexing->addChildTasks(std::make_shared<TaskGroupSequence>()->addChildTasks(
 			// block until there are indexer commands to process
 			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
 				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
 					"indexer_command_queue_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
 			std::make_shared<TaskBuildIndex>(
@@ -670,14 +681,14 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
 			// block until there are indexers running
 			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
 				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
 					"indexer_threads_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
 			// merge until all indexers stopped and nothing left to merge
 			std::make_shared<TaskDecoratorRepeat>(
 				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
 				->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
-					std::make_shared<TaskMergeStorages>(storageProvider),
+					std::make_shared<TaskMergeStorages>(storageProvider, mergeThreadCount),
 					std::make_shared<TaskReturnSuccessIf<bool>>(
 						"indexer_threads_stopped",
 						TaskReturnSuccessIf<bool>::CONDITION_EQUALS,
@@ -687,11 +698,11 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
 			// block until there are indexers running
 			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
 				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
 					"indexer_threads_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
 			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
 				->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
 					std::make_shared<TaskInjectStorage>(storageProvider, tempStorage),
 					// continuing when indexers still running, even if there are no storages right now.
@@ -710,7 +721,7 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		// add task that injects the remaining intermediate storages into the persistent storage
 		taskSequential->addTask(
 			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
 				->addChildTask(std::make_shared<TaskInjectStorage>(storageProvider, tempStorage)));
 	}
 	else
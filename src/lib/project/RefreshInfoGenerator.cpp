@@ -1,13 +1,16 @@
 #include "RefreshInfoGenerator.h"
 
+#include <thread>
+
+#include "ContentHash.h"
 #include "FileInfo.h"
 #include "FileSystem.h"
 #include "PersistentStorage.h"
 #include "RefreshInfo.h"
 #include "SourceGroup.h"
 #include "SourceGroupStatusType.h"
-#include "TextAccess.h"
 #include "utility.h"
+#include "utilityApp.h"
 
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
@@ -21,6 +24,8 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 
 	{
 		const std::vector<FileInfo> fileInfosFromStorage = storage->getFileInfoForAllFiles();
+		const std::set<FilePath> changedContentFilePaths = getChangedFilePaths(
+			fileInfosFromStorage, storage);
 
 		std::set<FilePath> alreadyKnownPaths;
 		{
@@ -46,7 +51,7 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 			{
 				if (storage->getFilePathIndexed(info.path))
 				{
-					if (didFileChange(info, storage))
+					if (changedContentFilePaths.find(info.path) != changedContentFilePaths.end())
 					{
 						changedFilePaths.insert(info.path);
 					}
@@ -60,7 +65,9 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 					changedFilePaths.insert(info.path);
 				}
 			}
-			else if (!storage->getFilePathIndexed(info.path) && !didFileChange(info, storage))
+			else if (
+				!storage->getFilePathIndexed(info.path) &&
+				changedContentFilePaths.find(info.path) == changedContentFilePaths.end())
 			{
 				unchangedNonindexedFilePaths.insert(info.path);
 			}
@@ -230,36 +237,61 @@ std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(
 	return allSourceFilePaths;
 }
 
-bool RefreshInfoGenerator::didFileChange(
-	const FileInfo& info, std::shared_ptr<const PersistentStorage> storage)
+std::set<FilePath> RefreshInfoGenerator::getChangedFilePaths(
+	const std::vector<FileInfo>& fileInfos, std::shared_ptr<const PersistentStorage> storage)
 {
-	FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
-	if (diskFileInfo.lastWriteTime > info.lastWriteTime)
+	// only files with a newer modification time are candidates, their content hashes decide
+	std::vector<FilePath> modifiedFilePaths;
+	for (const FileInfo& info: fileInfos)
 	{
-		if (!storage->hasContentForFile(info.path))
+		if (FileSystem::getFileInfoForPath(info.path).lastWriteTime > info.lastWriteTime)
 		{
-			return true;
+			modifiedFilePaths.push_back(info.path);
 		}
+	}
 
-		std::shared_ptr<TextAccess> storedFileContent = storage->getFileContent(info.path, false);
-		std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(diskFileInfo.path);
+	std::set<FilePath> changedFilePaths;
+	if (modifiedFilePaths.empty())
+	{
+		return changedFilePaths;
+	}
 
-		const std::vector<std::string>& diskFileLines = diskFileContent->getAllLines();
-		const std::vector<std::string>& storedFileLines = storedFileContent->getAllLines();
+	const std::map<FilePath, std::string> storedContentHashes =
+		storage->getFileContentHashesForAllFiles();
 
-		if (diskFileLines.size() != storedFileLines.size())
-		{
-			return true;
-		}
+	const std::vector<std::vector<FilePath>> parts = utility::splitToEquallySizedParts(
+		modifiedFilePaths, utility::getIdealThreadCount());
+	std::vector<std::vector<FilePath>> changedFilePathsPerPart(parts.size());
 
-		for (size_t i = 0; i < diskFileLines.size(); i++)
-		{
-			if (diskFileLines[i] != storedFileLines[i])
-			{
-				return true;
-			}
-		}
-		return false;
+	std::vector<std::shared_ptr<std::thread>> threads;
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		threads.push_back(std::make_shared<std::thread>(
+			[&storedContentHashes](
+				const std::vector<FilePath>& filePaths, std::vector<FilePath>& changedPaths) {
+				for (const FilePath& filePath: filePaths)
+				{
+					auto it = storedContentHashes.find(filePath);
+					if (it == storedContentHashes.end() ||
+						it->second != ContentHash::hashFile(filePath))
+					{
+						changedPaths.push_back(filePath);
+					}
+				}
+			},
+			std::cref(parts[i]),
+			std::ref(changedFilePathsPerPart[i])));
 	}
-	return false;
+
+	for (std::shared_ptr<std::thread> thread: threads)
+	{
+		thread->join();
+	}
+
+	for (const std::vector<FilePath>& changedPaths: changedFilePathsPerPart)
+	{
+		changedFilePaths.insert(changedPaths.begin(), changedPaths.end());
+	}
+
+	return changedFilePaths;
 }
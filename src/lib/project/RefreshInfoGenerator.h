@@ -29,7 +29,10 @@ private:
 	static std::set<FilePath> getAllSourceFilePaths(
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
-	static bool didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage);
+	// hashes the content of all files with a newer modification time on disk in parallel and
+	// returns the ones that differ from the content hash stored at indexing time
+	static std::set<FilePath> getChangedFilePaths(
+		const std::vector<FileInfo>& fileInfos, std::shared_ptr<const PersistentStorage> storage);
 };
 
 #endif	  // REFRESH_INFO_GENERATOR_H
@@ -383,6 +383,16 @@ void ApplicationSettings::setIndexerThreadCount(const int count)
 	setValue<int>("indexing/indexer_thread_count", count);
 }
 
+int ApplicationSettings::getStorageMergeThreadCount() const
+{
+	return getValue<int>("indexing/storage_merge_thread_count", 0);
+}
+
+void ApplicationSettings::setStorageMergeThreadCount(const int count)
+{
+	setValue<int>("indexing/storage_merge_thread_count", count);
+}
+
 bool ApplicationSettings::getMultiProcessIndexingEnabled() const
 {
 	return getValue<bool>("indexing/multi_process_indexing", true);
@@ -550,6 +560,16 @@ void ApplicationSettings::setCodeSnippetExpandRange(int range)
 	setValue<int>("code/snippet/expand_range", range);
 }
 
+int ApplicationSettings::getCodeFullTextSearchMaxHitCount() const
+{
+	return getValue<int>("code/fulltext_search/max_hit_count", 2000);
+}
+
+void ApplicationSettings::setCodeFullTextSearchMaxHitCount(int count)
+{
+	setValue<int>("code/fulltext_search/max_hit_count", count);
+}
+
 bool ApplicationSettings::getCodeViewModeSingle() const
 {
 	return getValue<bool>("code/view_mode_single", false);
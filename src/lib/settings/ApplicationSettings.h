@@ -95,6 +95,9 @@ public:
 	int getIndexerThreadCount() const;
 	void setIndexerThreadCount(const int count);
 
+	int getStorageMergeThreadCount() const;
+	void setStorageMergeThreadCount(const int count);
+
 	bool getMultiProcessIndexingEnabled() const;
 	void setMultiProcessIndexingEnabled(bool enabled);
 
@@ -147,6 +150,10 @@ public:
 	int getCodeSnippetExpandRange() const;
 	void setCodeSnippetExpandRange(int range);
 
+	// 0 for no limit
+	int getCodeFullTextSearchMaxHitCount() const;
+	void setCodeFullTextSearchMaxHitCount(int count);
+
 	bool getCodeViewModeSingle() const;
 	void setCodeViewModeSingle(bool enabled);
 
@@ -0,0 +1,109 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Keeps the values of at most maxSize keys and drops the least recently used key when full.
+template <typename KeyType, typename ValType>
+class LruCache
+{
+public:
+	LruCache(size_t maxSize);
+
+	bool getValue(const KeyType& key, ValType* value);
+	void setValue(const KeyType& key, const ValType& value);
+	void clear();
+
+	size_t getSize() const;
+	size_t getHitCount() const;
+	size_t getMissCount() const;
+
+private:
+	typedef std::list<std::pair<KeyType, ValType>> ListType;
+
+	const size_t m_maxSize;
+	ListType m_list;	// most recently used first
+	std::unordered_map<KeyType, typename ListType::iterator> m_map;
+
+	size_t m_hitCount;
+	size_t m_missCount;
+};
+
+template <typename KeyType, typename ValType>
+LruCache<KeyType, ValType>::LruCache(size_t maxSize)
+	: m_maxSize(maxSize), m_hitCount(0), m_missCount(0)
+{
+}
+
+template <typename KeyType, typename ValType>
+bool LruCache<KeyType, ValType>::getValue(const KeyType& key, ValType* value)
+{
+	auto it = m_map.find(key);
+	if (it == m_map.end())
+	{
+		++m_missCount;
+		return false;
+	}
+
+	++m_hitCount;
+	m_list.splice(m_list.begin(), m_list, it->second);
+	*value = it->second->second;
+	return true;
+}
+
+template <typename KeyType, typename ValType>
+void LruCache<KeyType, ValType>::setValue(const KeyType& key, const ValType& value)
+{
+	if (!m_maxSize)
+	{
+		return;
+	}
+
+	auto it = m_map.find(key);
+	if (it != m_map.end())
+	{
+		it->second->second = value;
+		m_list.splice(m_list.begin(), m_list, it->second);
+		return;
+	}
+
+	if (m_list.size() >= m_maxSize)
+	{
+		m_map.erase(m_list.back().first);
+		m_list.pop_back();
+	}
+
+	m_list.emplace_front(key, value);
+	m_map.emplace(key, m_list.begin());
+}
+
+template <typename KeyType, typename ValType>
+void LruCache<KeyType, ValType>::clear()
+{
+	m_list.clear();
+	m_map.clear();
+	m_hitCount = 0;
+	m_missCount = 0;
+}
+
+template <typename KeyType, typename ValType>
+size_t LruCache<KeyType, ValType>::getSize() const
+{
+	return m_list.size();
+}
+
+template <typename KeyType, typename ValType>
+size_t LruCache<KeyType, ValType>::getHitCount() const
+{
+	return m_hitCount;
+}
+
+template <typename KeyType, typename ValType>
+size_t LruCache<KeyType, ValType>::getMissCount() const
+{
+	return m_missCount;
+}
+
+#endif	  // LRU_CACHE_H
@@ -6,10 +6,12 @@
 FileRegister::FileRegister(
 	const FilePath& currentPath,
 	const std::set<FilePath>& indexedPaths,
-	const std::set<FilePathFilter>& excludeFilters)
+	const std::set<FilePathFilter>& excludeFilters,
+	const std::set<FilePath>& alreadyIndexedPaths)
 	: m_currentPath(currentPath)
 	, m_indexedPaths(indexedPaths)
 	, m_excludeFilters(excludeFilters)
+	, m_alreadyIndexedPaths(alreadyIndexedPaths)
 	, m_hasFilePathCache([&](const std::wstring& f) {
 		const FilePath filePath(f);
 		bool ret = false;
@@ -18,6 +20,11 @@ FileRegister::FileRegister(
 		{
 			ret = true;
 		}
+		else if (m_alreadyIndexedPaths.find(filePath) != m_alreadyIndexedPaths.end())
+		{
+			// completely recorded by another translation unit with the same preprocessor context
+			return false;
+		}
 
 		if (!ret)
 		{
@@ -57,3 +64,26 @@ bool FileRegister::hasFilePath(const FilePath& filePath) const
 {
 	return m_hasFilePathCache.getValue(filePath.wstr());
 }
+
+void FileRegister::addShareableFilePath(const FilePath& filePath)
+{
+	m_shareableFilePaths.insert(filePath);
+}
+
+void FileRegister::addNonShareableFilePath(const FilePath& filePath)
+{
+	m_nonShareableFilePaths.insert(filePath);
+}
+
+std::set<FilePath> FileRegister::getShareableFilePaths() const
+{
+	std::set<FilePath> shareableFilePaths;
+	for (const FilePath& filePath: m_shareableFilePaths)
+	{
+		if (m_nonShareableFilePaths.find(filePath) == m_nonShareableFilePaths.end())
+		{
+			shareableFilePaths.insert(filePath);
+		}
+	}
+	return shareableFilePaths;
+}
@@ -14,16 +14,26 @@ public:
 	FileRegister(
 		const FilePath& currentPath,
 		const std::set<FilePath>& indexedPaths,
-		const std::set<FilePathFilter>& excludeFilters);
+		const std::set<FilePathFilter>& excludeFilters,
+		const std::set<FilePath>& alreadyIndexedPaths = {});
 	virtual ~FileRegister();
 
 	virtual bool hasFilePath(const FilePath& filePath) const;
 
+	// headers whose recorded content doesn't depend on the file that included them
+	void addShareableFilePath(const FilePath& filePath);
+	// headers whose templates may get instantiated differently in other translation units
+	void addNonShareableFilePath(const FilePath& filePath);
+	std::set<FilePath> getShareableFilePaths() const;
+
 private:
 	const FilePath& m_currentPath;
 	const std::set<FilePath> m_indexedPaths;
 	const std::set<FilePathFilter> m_excludeFilters;
+	const std::set<FilePath> m_alreadyIndexedPaths;
 	mutable UnorderedCache<std::wstring, bool> m_hasFilePathCache;
+	std::set<FilePath> m_shareableFilePaths;
+	std::set<FilePath> m_nonShareableFilePaths;
 };
 
 #endif	  // FILE_REGISTER_H
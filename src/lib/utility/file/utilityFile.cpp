@@ -51,6 +51,97 @@ std::vector<FilePath> utility::partitionFilePathsBySize(std::vector<FilePath> fi
 	return sortedFilePaths;
 }
 
+std::vector<FilePath> utility::orderFilePathsByExpectedDuration(
+	const std::vector<FilePath>& filePaths, const std::map<FilePath, IndexingCost>& knownCosts)
+{
+	struct ExpectedCost
+	{
+		FilePath path;
+		unsigned long long int byteSize;
+		IndexingCost known;
+		double cost;
+	};
+
+	std::vector<ExpectedCost> costs;
+	costs.reserve(filePaths.size());
+
+	// relate durations of known files to their sizes for estimating files without a duration
+	double knownDurationSum = 0.0;
+	double knownByteSizeSum = 0.0;
+	double knownStorageDurationSum = 0.0;
+	double knownStorageSizeSum = 0.0;
+	for (const FilePath& path: filePaths)
+	{
+		ExpectedCost cost;
+		cost.path = path;
+		cost.byteSize = path.exists() ? FileSystem::getFileByteSize(path) : 1;
+		cost.cost = 0.0;
+
+		auto it = knownCosts.find(path);
+		if (it != knownCosts.end())
+		{
+			cost.known = it->second;
+		}
+
+		if (cost.known.duration > 0)
+		{
+			knownDurationSum += cost.known.duration;
+			knownByteSizeSum += cost.byteSize;
+
+			if (cost.known.storageSize > 0)
+			{
+				knownStorageDurationSum += cost.known.duration;
+				knownStorageSizeSum += cost.known.storageSize;
+			}
+		}
+
+		costs.push_back(cost);
+	}
+
+	const double durationPerByte = (knownDurationSum > 0.0 && knownByteSizeSum > 0.0)
+		? knownDurationSum / knownByteSizeSum
+		: 1.0;
+
+	// the size of the produced storage follows the included headers, so it predicts the duration
+	// better than the size of the source file
+	const double durationPerStorageByte = (knownStorageDurationSum > 0.0 &&
+										   knownStorageSizeSum > 0.0)
+		? knownStorageDurationSum / knownStorageSizeSum
+		: 0.0;
+
+	for (ExpectedCost& cost: costs)
+	{
+		if (cost.known.duration > 0)
+		{
+			cost.cost = cost.known.duration;
+		}
+		else if (cost.known.storageSize > 0 && durationPerStorageByte > 0.0)
+		{
+			cost.cost = cost.known.storageSize * durationPerStorageByte;
+		}
+		else
+		{
+			cost.cost = cost.byteSize * durationPerByte;
+		}
+	}
+
+	std::sort(costs.begin(), costs.end(), [](const ExpectedCost& p, const ExpectedCost& q) {
+		if (p.cost != q.cost)
+		{
+			return p.cost > q.cost;
+		}
+		return p.path.wstr() < q.path.wstr();
+	});
+
+	std::vector<FilePath> sortedFilePaths;
+	sortedFilePaths.reserve(costs.size());
+	for (const ExpectedCost& cost: costs)
+	{
+		sortedFilePaths.push_back(cost.path);
+	}
+	return sortedFilePaths;
+}
+
 std::vector<FilePath> utility::getTopLevelPaths(const std::vector<FilePath>& paths)
 {
 	return utility::getTopLevelPaths(utility::toSet(paths));
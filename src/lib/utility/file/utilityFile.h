@@ -1,6 +1,7 @@
 #ifndef UTILITY_FILE_H
 #define UTILITY_FILE_H
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -10,6 +11,18 @@ namespace utility
 {
 std::vector<FilePath> partitionFilePathsBySize(std::vector<FilePath> filePaths, int partitionCount = 0);
 
+// cost of indexing a translation unit in a previous run, zero where unknown
+struct IndexingCost
+{
+	size_t duration = 0;	   // in milliseconds
+	size_t storageSize = 0;	   // byte size of the produced intermediate storage
+};
+
+// sorts longest expected indexing duration first. Unknown durations are estimated from the
+// storage size of a previous run or else from the file size.
+std::vector<FilePath> orderFilePathsByExpectedDuration(
+	const std::vector<FilePath>& filePaths, const std::map<FilePath, IndexingCost>& knownCosts);
+
 std::vector<FilePath> getTopLevelPaths(const std::vector<FilePath>& paths);
 std::vector<FilePath> getTopLevelPaths(const std::set<FilePath>& paths);
 
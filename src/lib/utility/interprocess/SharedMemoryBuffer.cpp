@@ -0,0 +1,83 @@
+#include "SharedMemoryBuffer.h"
+
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include "SharedMemory.h"
+#include "logging.h"
+
+const char* SharedMemoryBuffer::s_memoryNamePrefix = "srctrlbuf_";
+
+void SharedMemoryBuffer::deleteSharedMemoryBuffer(const std::string& name)
+{
+	boost::interprocess::shared_memory_object::remove(
+		(s_memoryNamePrefix + SharedMemory::checkName(name)).c_str());
+}
+
+SharedMemoryBuffer::SharedMemoryBuffer(const std::string& name, size_t size, AccessMode mode)
+	: m_name(SharedMemory::checkName(name)), m_mode(mode)
+{
+	try
+	{
+		switch (mode)
+		{
+		case CREATE:
+		{
+			deleteSharedMemoryBuffer(m_name);
+
+			boost::interprocess::permissions permissions;
+			permissions.set_unrestricted();
+
+			boost::interprocess::shared_memory_object memory(
+				boost::interprocess::create_only,
+				getMemoryName().c_str(),
+				boost::interprocess::read_write,
+				permissions);
+			memory.truncate(static_cast<boost::interprocess::offset_t>(size));
+			m_region = boost::interprocess::mapped_region(memory, boost::interprocess::read_write);
+		}
+		break;
+
+		case OPEN_AND_DELETE:
+		{
+			boost::interprocess::shared_memory_object memory(
+				boost::interprocess::open_only,
+				getMemoryName().c_str(),
+				boost::interprocess::read_only);
+			m_region = boost::interprocess::mapped_region(memory, boost::interprocess::read_only);
+		}
+		break;
+		}
+	}
+	catch (boost::interprocess::interprocess_exception& e)
+	{
+		LOG_ERROR_STREAM(
+			<< "boost exception thrown at shared memory buffer creation - " << getMemoryName()
+			<< ": " << e.what());
+		throw e;
+	}
+}
+
+SharedMemoryBuffer::~SharedMemoryBuffer()
+{
+	if (m_mode == OPEN_AND_DELETE)
+	{
+		// unmapped first, so the memory can be removed on every platform
+		m_region = boost::interprocess::mapped_region();
+		deleteSharedMemoryBuffer(m_name);
+	}
+}
+
+char* SharedMemoryBuffer::getData() const
+{
+	return static_cast<char*>(m_region.get_address());
+}
+
+size_t SharedMemoryBuffer::getSize() const
+{
+	return m_region.get_size();
+}
+
+std::string SharedMemoryBuffer::getMemoryName() const
+{
+	return s_memoryNamePrefix + m_name;
+}
@@ -0,0 +1,39 @@
+#ifndef SHARED_MEMORY_BUFFER_H
+#define SHARED_MEMORY_BUFFER_H
+
+#include <string>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+// A named block of raw bytes in shared memory. Unlike SharedMemory it has neither an allocator nor
+// a mutex: the creating process fills it before passing on its name, the process opening it
+// afterwards is its only user and removes it again.
+class SharedMemoryBuffer
+{
+public:
+	enum AccessMode
+	{
+		CREATE,
+		OPEN_AND_DELETE
+	};
+
+	static void deleteSharedMemoryBuffer(const std::string& name);
+
+	// size is only used when creating the buffer
+	SharedMemoryBuffer(const std::string& name, size_t size, AccessMode mode);
+	~SharedMemoryBuffer();
+
+	char* getData() const;
+	size_t getSize() const;
+
+private:
+	static const char* s_memoryNamePrefix;
+
+	std::string getMemoryName() const;
+
+	std::string m_name;
+	AccessMode m_mode;
+	boost::interprocess::mapped_region m_region;
+};
+
+#endif	  // SHARED_MEMORY_BUFFER_H
@@ -0,0 +1,23 @@
+#ifndef MESSAGE_FULLTEXT_SEARCH_INTERRUPTED_H
+#define MESSAGE_FULLTEXT_SEARCH_INTERRUPTED_H
+
+#include "Message.h"
+#include "TabId.h"
+
+// stops a running fulltext search, not sent as task so it is handled while the search is running
+class MessageFullTextSearchInterrupted: public Message<MessageFullTextSearchInterrupted>
+{
+public:
+	static const std::string getStaticType()
+	{
+		return "MessageFullTextSearchInterrupted";
+	}
+
+	MessageFullTextSearchInterrupted()
+	{
+		setSendAsTask(false);
+		setSchedulerId(TabId::currentTab());
+	}
+};
+
+#endif	  // MESSAGE_FULLTEXT_SEARCH_INTERRUPTED_H
@@ -1,8 +1,10 @@
 #include "Blackboard.h"
 
-Blackboard::Blackboard() {}
+#include <chrono>
 
-Blackboard::Blackboard(std::shared_ptr<Blackboard> parent): m_parent(parent) {}
+Blackboard::Blackboard(): m_updateCount(0) {}
+
+Blackboard::Blackboard(std::shared_ptr<Blackboard> parent): m_parent(parent), m_updateCount(0) {}
 
 bool Blackboard::exists(const std::string& key)
 {
@@ -20,7 +22,30 @@ bool Blackboard::clear(const std::string& key)
 	if (it != m_items.end())
 	{
 		m_items.erase(it);
+		m_updateCount++;
+		m_updateCondition.notify_all();
 		return true;
 	}
 	return false;
 }
+
+size_t Blackboard::getUpdateCount()
+{
+	std::lock_guard<std::mutex> lock(m_itemMutex);
+	return m_updateCount;
+}
+
+void Blackboard::notifyUpdate()
+{
+	std::lock_guard<std::mutex> lock(m_itemMutex);
+	m_updateCount++;
+	m_updateCondition.notify_all();
+}
+
+bool Blackboard::waitForUpdate(size_t updateCount, size_t timeoutMS)
+{
+	std::unique_lock<std::mutex> lock(m_itemMutex);
+	return m_updateCondition.wait_for(lock, std::chrono::milliseconds(timeoutMS), [&]() {
+		return m_updateCount != updateCount;
+	});
+}
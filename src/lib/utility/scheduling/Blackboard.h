@@ -1,6 +1,7 @@
 #ifndef BLACKBOARD_H
 #define BLACKBOARD_H
 
+#include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
@@ -45,6 +46,16 @@ public:
 	bool exists(const std::string& key);
 	bool clear(const std::string& key);
 
+	// counts all changes of values on this blackboard and all calls to notifyUpdate
+	size_t getUpdateCount();
+
+	// wakes up waiting tasks without changing a value, e.g. when new work is available elsewhere
+	void notifyUpdate();
+
+	// blocks until the update count differs from the given one or the timeout expires, returns
+	// whether an update happened
+	bool waitForUpdate(size_t updateCount, size_t timeoutMS);
+
 private:
 	typedef std::map<std::string, std::shared_ptr<BlackboardItemBase>> ItemMap;
 
@@ -52,6 +63,9 @@ private:
 
 	ItemMap m_items;
 	std::mutex m_itemMutex;
+
+	size_t m_updateCount;
+	std::condition_variable m_updateCondition;
 };
 
 
@@ -61,6 +75,8 @@ void Blackboard::set(const std::string& key, const T& value)
 	std::lock_guard<std::mutex> lock(m_itemMutex);
 
 	m_items[key] = std::make_shared<BlackboardItem<T>>(value);
+	m_updateCount++;
+	m_updateCondition.notify_all();
 }
 
 template <typename T>
@@ -99,6 +115,8 @@ bool Blackboard::update(const std::string& key, std::function<T(const T&)> updat
 				it->second))
 		{
 			item->value = updater(item->value);
+			m_updateCount++;
+			m_updateCondition.notify_all();
 			return true;
 		}
 	}
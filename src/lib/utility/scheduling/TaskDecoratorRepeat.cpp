@@ -1,7 +1,6 @@
 #include "TaskDecoratorRepeat.h"
 
-#include <chrono>
-#include <thread>
+#include "Blackboard.h"
 
 TaskDecoratorRepeat::TaskDecoratorRepeat(ConditionType condition, TaskState exitState, size_t delayMS)
 	: m_condition(condition), m_exitState(exitState), m_delayMS(delayMS)
@@ -12,6 +11,8 @@ void TaskDecoratorRepeat::doEnter(std::shared_ptr<Blackboard> blackboard) {}
 
 Task::TaskState TaskDecoratorRepeat::doUpdate(std::shared_ptr<Blackboard> blackboard)
 {
+	const size_t updateCount = blackboard->getUpdateCount();
+
 	TaskState state = m_taskRunner->update(blackboard);
 
 	switch (m_condition)
@@ -29,7 +30,8 @@ Task::TaskState TaskDecoratorRepeat::doUpdate(std::shared_ptr<Blackboard> blackb
 		break;
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(m_delayMS));
+	// repeat right away if the child changed something, otherwise wait until another task does
+	blackboard->waitForUpdate(updateCount, m_delayMS);
 
 	return state;
 }
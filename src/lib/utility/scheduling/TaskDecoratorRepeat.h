@@ -14,6 +14,8 @@ public:
 		CONDITION_WHILE_SUCCESS
 	};
 
+	// delayMS is the maximum time to wait between repetitions, the child task is updated earlier
+	// when a value on the blackboard changes
 	TaskDecoratorRepeat(ConditionType condition, TaskState exitState, size_t delayMS);
 
 private:
@@ -0,0 +1,241 @@
+#include "ContentHash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "FilePath.h"
+
+namespace
+{
+const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+const size_t s_readChunkSize = 64 * 1024;
+
+inline uint64_t rotateLeft(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const char* data)
+{
+	uint64_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+inline uint32_t read32(const char* data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+inline uint64_t accumulate(uint64_t accumulator, uint64_t input)
+{
+	accumulator += input * PRIME64_2;
+	accumulator = rotateLeft(accumulator, 31);
+	return accumulator * PRIME64_1;
+}
+
+inline uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+{
+	accumulator ^= accumulate(0, value);
+	return accumulator * PRIME64_1 + PRIME64_4;
+}
+}	 // namespace
+
+std::string ContentHash::hashText(const std::string& text)
+{
+	ContentHash hash;
+	hash.update(text.data(), text.size());
+	return hash.finish();
+}
+
+std::string ContentHash::hashFile(const FilePath& filePath)
+{
+	std::ifstream stream(filePath.str(), std::ios::in | std::ios::binary);
+	if (!stream.is_open())
+	{
+		return "";
+	}
+
+	ContentHash hash;
+	std::vector<char> chunk(s_readChunkSize);
+	while (stream)
+	{
+		stream.read(chunk.data(), chunk.size());
+		hash.update(chunk.data(), static_cast<size_t>(stream.gcount()));
+	}
+
+	if (stream.bad())
+	{
+		return "";
+	}
+
+	return hash.finish();
+}
+
+ContentHash::ContentHash()
+	: m_totalSize(0), m_bufferSize(0), m_pendingCarriageReturn(false), m_lastChar(0)
+{
+	m_accumulators[0] = PRIME64_1 + PRIME64_2;
+	m_accumulators[1] = PRIME64_2;
+	m_accumulators[2] = 0;
+	m_accumulators[3] = 0 - PRIME64_1;
+}
+
+void ContentHash::update(const char* data, size_t size)
+{
+	// "\r\n" and single '\r' are hashed as '\n', matching the line splitting of TextAccess
+	const char* end = data + size;
+	while (data < end)
+	{
+		if (m_pendingCarriageReturn)
+		{
+			m_pendingCarriageReturn = false;
+			updateNormalized("\n", 1);
+			if (*data == '\n')
+			{
+				data++;
+				continue;
+			}
+		}
+
+		const char* carriageReturn = static_cast<const char*>(std::memchr(data, '\r', end - data));
+		const char* runEnd = carriageReturn ? carriageReturn : end;
+		updateNormalized(data, runEnd - data);
+
+		if (carriageReturn)
+		{
+			m_pendingCarriageReturn = true;
+			data = carriageReturn + 1;
+		}
+		else
+		{
+			data = end;
+		}
+	}
+}
+
+std::string ContentHash::finish()
+{
+	if (m_pendingCarriageReturn)
+	{
+		m_pendingCarriageReturn = false;
+		updateNormalized("\n", 1);
+	}
+
+	// TextAccess terminates the last line with a newline
+	if (m_totalSize > 0 && m_lastChar != '\n')
+	{
+		updateNormalized("\n", 1);
+	}
+
+	uint64_t hash;
+	if (m_totalSize >= 32)
+	{
+		hash = rotateLeft(m_accumulators[0], 1) + rotateLeft(m_accumulators[1], 7) +
+			rotateLeft(m_accumulators[2], 12) + rotateLeft(m_accumulators[3], 18);
+		for (uint64_t accumulator: m_accumulators)
+		{
+			hash = mergeRound(hash, accumulator);
+		}
+	}
+	else
+	{
+		hash = PRIME64_5;
+	}
+
+	hash += m_totalSize;
+
+	const char* data = m_buffer;
+	size_t remaining = m_bufferSize;
+	while (remaining >= 8)
+	{
+		hash ^= accumulate(0, read64(data));
+		hash = rotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+		data += 8;
+		remaining -= 8;
+	}
+	if (remaining >= 4)
+	{
+		hash ^= static_cast<uint64_t>(read32(data)) * PRIME64_1;
+		hash = rotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+		data += 4;
+		remaining -= 4;
+	}
+	while (remaining > 0)
+	{
+		hash ^= static_cast<uint64_t>(static_cast<unsigned char>(*data)) * PRIME64_5;
+		hash = rotateLeft(hash, 11) * PRIME64_1;
+		data++;
+		remaining--;
+	}
+
+	hash ^= hash >> 33;
+	hash *= PRIME64_2;
+	hash ^= hash >> 29;
+	hash *= PRIME64_3;
+	hash ^= hash >> 32;
+
+	std::stringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+	return ss.str();
+}
+
+void ContentHash::updateNormalized(const char* data, size_t size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+
+	m_totalSize += size;
+	m_lastChar = data[size - 1];
+
+	if (m_bufferSize > 0)
+	{
+		const size_t fill = std::min(size, sizeof(m_buffer) - m_bufferSize);
+		std::memcpy(m_buffer + m_bufferSize, data, fill);
+		m_bufferSize += fill;
+		data += fill;
+		size -= fill;
+
+		if (m_bufferSize < sizeof(m_buffer))
+		{
+			return;
+		}
+
+		consumeStripe(m_buffer);
+		m_bufferSize = 0;
+	}
+
+	while (size >= sizeof(m_buffer))
+	{
+		consumeStripe(data);
+		data += sizeof(m_buffer);
+		size -= sizeof(m_buffer);
+	}
+
+	if (size > 0)
+	{
+		std::memcpy(m_buffer, data, size);
+		m_bufferSize = size;
+	}
+}
+
+void ContentHash::consumeStripe(const char* data)
+{
+	m_accumulators[0] = accumulate(m_accumulators[0], read64(data));
+	m_accumulators[1] = accumulate(m_accumulators[1], read64(data + 8));
+	m_accumulators[2] = accumulate(m_accumulators[2], read64(data + 16));
+	m_accumulators[3] = accumulate(m_accumulators[3], read64(data + 24));
+}
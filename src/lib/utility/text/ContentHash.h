@@ -0,0 +1,39 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <cstdint>
+#include <string>
+
+class FilePath;
+
+// Streaming 64 bit content hash (xxHash64 layout) used for change detection of source files.
+// Line endings are normalized the same way TextAccess does, so hashing a file on disk yields the
+// same value as hashing the text that has been stored for it.
+class ContentHash
+{
+public:
+	static std::string hashText(const std::string& text);
+
+	// returns an empty string if the file cannot be read
+	static std::string hashFile(const FilePath& filePath);
+
+	ContentHash();
+
+	void update(const char* data, size_t size);
+	std::string finish();
+
+private:
+	void updateNormalized(const char* data, size_t size);
+	void consumeStripe(const char* data);
+
+	uint64_t m_accumulators[4];
+	uint64_t m_totalSize;
+
+	char m_buffer[32];
+	size_t m_bufferSize;
+
+	bool m_pendingCarriageReturn;
+	char m_lastChar;
+};
+
+#endif	  // CONTENT_HASH_H
@@ -0,0 +1,77 @@
+#include "LineOffsetTable.h"
+
+#include <algorithm>
+#include <cstring>
+
+size_t LineOffsetTable::getUtf8CharacterCount(const char* text, size_t size)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text);
+	size_t count = 0;
+	size_t i = 0;
+
+	// source code is mostly ASCII, so whole words without high bits are counted at once
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, bytes + i, sizeof(word));
+		if (word & 0x8080808080808080ull)
+		{
+			break;
+		}
+		count += sizeof(uint64_t);
+	}
+
+	for (; i < size; i++)
+	{
+		// continuation bytes do not start a character
+		if ((bytes[i] & 0xC0) != 0x80)
+		{
+			count++;
+			if (sizeof(wchar_t) == 2 && bytes[i] >= 0xF0)
+			{
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+LineOffsetTable::LineOffsetTable(const std::string& text)
+{
+	m_lineStarts.push_back(0);
+
+	const char* begin = text.data();
+	const char* end = begin + text.size();
+	for (const char* pos = begin;
+		 (pos = static_cast<const char*>(std::memchr(pos, '\n', end - pos))) != nullptr;)
+	{
+		pos++;
+		if (pos == end)
+		{
+			break;
+		}
+		m_lineStarts.push_back(static_cast<uint32_t>(pos - begin));
+	}
+}
+
+unsigned int LineOffsetTable::getLineCount() const
+{
+	return static_cast<unsigned int>(m_lineStarts.size());
+}
+
+unsigned int LineOffsetTable::getLineNumber(size_t pos) const
+{
+	// the first line start behind the position belongs to the next line
+	return static_cast<unsigned int>(
+		std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), pos) - m_lineStarts.begin());
+}
+
+size_t LineOffsetTable::getLineStart(unsigned int lineNumber) const
+{
+	if (lineNumber < 1 || lineNumber > m_lineStarts.size())
+	{
+		return 0;
+	}
+	return m_lineStarts[lineNumber - 1];
+}
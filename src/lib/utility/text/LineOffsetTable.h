@@ -0,0 +1,29 @@
+#ifndef LINE_OFFSET_TABLE_H
+#define LINE_OFFSET_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Byte offsets at which the lines of a text start. Like the lines of TextAccess every line ends
+// after a '\n', so byte positions in the text map to the same line numbers.
+class LineOffsetTable
+{
+public:
+	// number of characters the UTF-8 encoded bytes decode to, matching the length of the decoded
+	// std::wstring, which uses two characters for code points outside the BMP on Windows
+	static size_t getUtf8CharacterCount(const char* text, size_t size);
+
+	LineOffsetTable(const std::string& text);
+
+	unsigned int getLineCount() const;
+
+	// line numbers start at 1, positions behind the text map to the last line
+	unsigned int getLineNumber(size_t pos) const;
+	size_t getLineStart(unsigned int lineNumber) const;
+
+private:
+	std::vector<uint32_t> m_lineStarts;
+};
+
+#endif	  // LINE_OFFSET_TABLE_H
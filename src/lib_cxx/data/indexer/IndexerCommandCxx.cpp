@@ -3,6 +3,7 @@
 #include <QJsonArray>
 #include <QJsonObject>
 
+#include "ContentHash.h"
 #include "MessageStatus.h"
 #include "OrderedCache.h"
 #include "ResourcePaths.h"
@@ -158,6 +159,50 @@ size_t IndexerCommandCxx::getByteSize(size_t stringSize) const
 	return size;
 }
 
+std::string IndexerCommandCxx::getPreprocessorContextKey() const
+{
+	// only flags that influence preprocessing are part of the key, so that commands only differing
+	// in source and output file share the same context
+	static const std::vector<std::wstring> separateValueFlags = {
+		L"-D", L"-U", L"-I", L"-isystem", L"-iquote", L"-idirafter", L"-include", L"-imacros",
+		L"-include-pch", L"-isysroot", L"--sysroot", L"-x", L"-target", L"-F", L"/D", L"/U", L"/I",
+		L"/FI"};
+	// -O also sets __OPTIMIZE__ and -nostdinc changes the system include paths
+	static const std::vector<std::wstring> contextFlagPrefixes = {
+		L"-D", L"-U", L"-I", L"-isystem", L"-iquote", L"-idirafter", L"-include", L"-imacros",
+		L"-isysroot", L"--sysroot", L"-nostdinc", L"-O", L"-std", L"--std", L"-x", L"-f", L"-m",
+		L"-target", L"--target", L"-F", L"--driver-mode", L"/D", L"/U", L"/I", L"/FI", L"/O",
+		L"/std"};
+
+	std::string context = utility::encodeToUtf8(m_workingDirectory.wstr());
+	for (size_t i = 0; i < m_compilerFlags.size(); i++)
+	{
+		const std::wstring& flag = m_compilerFlags[i];
+
+		if (std::find(separateValueFlags.begin(), separateValueFlags.end(), flag) !=
+			separateValueFlags.end())
+		{
+			context += '\n' + utility::encodeToUtf8(flag);
+			if (i + 1 < m_compilerFlags.size())
+			{
+				context += ' ' + utility::encodeToUtf8(m_compilerFlags[++i]);
+			}
+			continue;
+		}
+
+		for (const std::wstring& prefix: contextFlagPrefixes)
+		{
+			if (utility::isPrefix(prefix, flag))
+			{
+				context += '\n' + utility::encodeToUtf8(flag);
+				break;
+			}
+		}
+	}
+
+	return ContentHash::hashText(context);
+}
+
 const std::set<FilePath>& IndexerCommandCxx::getIndexedPaths() const
 {
 	return m_indexedPaths;
@@ -8,13 +8,15 @@ void IndexerCxx::doIndex(
 	std::shared_ptr<ParserClientImpl> parserClient,
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo)
 {
-	CxxParser parser(
-		parserClient,
-		std::make_shared<FileRegister>(
-			indexerCommand->getSourceFilePath(),
-			indexerCommand->getIndexedPaths(),
-			indexerCommand->getExcludeFilters()),
-		m_indexerStateInfo);
+	std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(
+		indexerCommand->getSourceFilePath(),
+		indexerCommand->getIndexedPaths(),
+		indexerCommand->getExcludeFilters(),
+		indexerCommand->getAlreadyIndexedFilePaths());
+
+	CxxParser parser(parserClient, fileRegister, m_indexerStateInfo);
 
 	parser.buildIndex(indexerCommand);
+
+	indexerCommand->setShareableFilePaths(fileRegister->getShareableFilePaths());
 }
@@ -31,7 +31,7 @@ bool ASTAction::BeginSourceFileAction(clang::CompilerInstance& compiler)
 {
 	clang::Preprocessor& preprocessor = compiler.getPreprocessor();
 	preprocessor.addPPCallbacks(std::make_unique<PreprocessorCallbacks>(
-		compiler.getSourceManager(), m_client, m_canonicalFilePathCache));
+		preprocessor, m_client, m_canonicalFilePathCache));
 	preprocessor.addCommentHandler(&m_commentHandler);
 	return true;
 }
@@ -1,6 +1,7 @@
 #include "CxxAstVisitor.h"
 
 #include <clang/AST/ASTContext.h>
+#include <clang/AST/DeclTemplate.h>
 #include <clang/Lex/Preprocessor.h>
 
 #include "CanonicalFilePathCache.h"
@@ -171,6 +172,17 @@ bool CxxAstVisitor::TraverseDecl(clang::Decl* decl)
 			}
 
 			traverse = isLocatedInProjectFile(loc);
+
+			// implicit instantiations are recorded at the template, so other translation units that
+			// instantiate it with their own arguments must not skip that file
+			if (traverse && fileId.isValid() &&
+				(clang::isa<clang::TemplateDecl>(decl) ||
+				 clang::isa<clang::ClassTemplatePartialSpecializationDecl>(decl) ||
+				 clang::isa<clang::VarTemplatePartialSpecializationDecl>(decl)))
+			{
+				m_canonicalFilePathCache->getFileRegister()->addNonShareableFilePath(
+					m_canonicalFilePathCache->getCanonicalFilePath(fileId, sourceManager));
+			}
 		}
 	}
 
@@ -57,6 +57,6 @@ bool GeneratePCHAction::BeginSourceFileAction(clang::CompilerInstance& compiler)
 {
 	clang::Preprocessor& preprocessor = compiler.getPreprocessor();
 	preprocessor.addPPCallbacks(std::make_unique<PreprocessorCallbacks>(
-		compiler.getSourceManager(), m_client, m_canonicalFilePathCache));
+		preprocessor, m_client, m_canonicalFilePathCache));
 	return true;
 }
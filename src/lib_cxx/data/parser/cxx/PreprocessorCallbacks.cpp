@@ -1,10 +1,15 @@
 #include "PreprocessorCallbacks.h"
 
+#include <cctype>
+
 #include <clang/Basic/IdentifierTable.h>
 #include <clang/Driver/Util.h>
+#include <clang/Lex/HeaderSearch.h>
+#include <clang/Lex/Lexer.h>
 #include <clang/Lex/MacroArgs.h>
 
 #include "CanonicalFilePathCache.h"
+#include "FileRegister.h"
 #include "ParseLocation.h"
 #include "ParserClient.h"
 #include "utilityClang.h"
@@ -12,10 +17,11 @@
 #include "utilityString.h"
 
 PreprocessorCallbacks::PreprocessorCallbacks(
-	clang::SourceManager& sourceManager,
+	clang::Preprocessor& preprocessor,
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache)
-	: m_sourceManager(sourceManager)
+	: m_preprocessor(preprocessor)
+	, m_sourceManager(preprocessor.getSourceManager())
 	, m_client(client)
 	, m_canonicalFilePathCache(canonicalFilePathCache)
 {
@@ -28,6 +34,22 @@ void PreprocessorCallbacks::FileChanged(
 	clang::FileID prevID)
 {
 	const clang::FileID fileId = m_sourceManager.getFileID(location);
+
+	if (reason == EnterFile)
+	{
+		EnteredFile file;
+		file.fileId = fileId;
+		file.startLocation = m_sourceManager.getLocForStartOfFile(fileId);
+		m_enteredFiles.push_back(file);
+	}
+	else if (
+		reason == ExitFile && !m_enteredFiles.empty() && m_enteredFiles.back().fileId == prevID)
+	{
+		const EnteredFile file = m_enteredFiles.back();
+		m_enteredFiles.pop_back();
+		onFileExited(file);
+	}
+
 	const FilePath currentPath = m_canonicalFilePathCache->getCanonicalFilePath(
 		fileId, m_sourceManager);
 	m_currentPathIsProjectFile = false;
@@ -111,6 +133,7 @@ void PreprocessorCallbacks::MacroUndefined(
 	const clang::MacroDirective* macroUndefinition)
 {
 	onMacroUsage(macroNameToken);
+	onMacroDependency(macroNameToken, macroDefinition);
 }
 
 void PreprocessorCallbacks::Defined(
@@ -119,6 +142,7 @@ void PreprocessorCallbacks::Defined(
 	clang::SourceRange range)
 {
 	onMacroUsage(macroNameToken);
+	onMacroDependency(macroNameToken, macroDefinition);
 }
 
 void PreprocessorCallbacks::Ifdef(
@@ -127,6 +151,7 @@ void PreprocessorCallbacks::Ifdef(
 	const clang::MacroDefinition& macroDefinition)
 {
 	onMacroUsage(macroNameToken);
+	onMacroDependency(macroNameToken, macroDefinition);
 }
 void PreprocessorCallbacks::Ifndef(
 	clang::SourceLocation location,
@@ -134,6 +159,30 @@ void PreprocessorCallbacks::Ifndef(
 	const clang::MacroDefinition& macroDefinition)
 {
 	onMacroUsage(macroNameToken);
+	onMacroDependency(macroNameToken, macroDefinition);
+}
+
+void PreprocessorCallbacks::If(
+	clang::SourceLocation location,
+	clang::SourceRange conditionRange,
+	ConditionValueKind conditionValue)
+{
+	if (conditionValue != CVK_NotEvaluated)
+	{
+		onConditionDependency(conditionRange);
+	}
+}
+
+void PreprocessorCallbacks::Elif(
+	clang::SourceLocation location,
+	clang::SourceRange conditionRange,
+	ConditionValueKind conditionValue,
+	clang::SourceLocation ifLocation)
+{
+	if (conditionValue != CVK_NotEvaluated)
+	{
+		onConditionDependency(conditionRange);
+	}
 }
 
 void PreprocessorCallbacks::MacroExpands(
@@ -143,6 +192,7 @@ void PreprocessorCallbacks::MacroExpands(
 	const clang::MacroArgs* args)
 {
 	onMacroUsage(macroNameToken);
+	onMacroDependency(macroNameToken, macroDirective);
 }
 
 void PreprocessorCallbacks::onMacroUsage(const clang::Token& macroNameToken)
@@ -160,6 +210,138 @@ void PreprocessorCallbacks::onMacroUsage(const clang::Token& macroNameToken)
 	}
 }
 
+void PreprocessorCallbacks::onMacroDependency(
+	const clang::Token& macroNameToken, const clang::MacroDefinition& macroDefinition)
+{
+	if (m_enteredFiles.empty())
+	{
+		return;
+	}
+
+	const clang::MacroInfo* macroInfo = macroDefinition.getMacroInfo();
+	if (!macroInfo)
+	{
+		// the including file may define it, unless it turns out to be the include guard
+		m_enteredFiles.back().testedUndefinedMacros.insert(
+			macroNameToken.getIdentifierInfo()->getName().str());
+		return;
+	}
+
+	const clang::SourceLocation definitionLocation = macroInfo->getDefinitionLoc();
+	if (macroInfo->isBuiltinMacro() || definitionLocation.isInvalid() ||
+		m_sourceManager.isLoadedSourceLocation(definitionLocation) ||
+		m_sourceManager.isWrittenInBuiltinFile(definitionLocation) ||
+		m_sourceManager.isWrittenInCommandLineFile(definitionLocation))
+	{
+		// builtin, command line and precompiled macros are covered by the preprocessor context key
+		return;
+	}
+
+	// files are allocated in the order they are entered, so a definition located before the start
+	// of a file was made by the files that included it
+	for (EnteredFile& file: m_enteredFiles)
+	{
+		if (m_sourceManager.isBeforeInSLocAddrSpace(definitionLocation, file.startLocation))
+		{
+			file.usesOutsideMacros = true;
+		}
+	}
+}
+
+void PreprocessorCallbacks::onConditionDependency(clang::SourceRange conditionRange)
+{
+	if (m_enteredFiles.empty() || conditionRange.isInvalid())
+	{
+		return;
+	}
+
+	// undefined identifiers in #if conditions silently evaluate to 0 without any macro callback
+	const std::string condition = clang::Lexer::getSourceText(
+									  clang::CharSourceRange::getTokenRange(conditionRange),
+									  m_sourceManager,
+									  m_preprocessor.getLangOpts())
+									  .str();
+
+	auto isIdentifierChar = [](char c) {
+		return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+	};
+
+	size_t i = 0;
+	while (i < condition.size())
+	{
+		if (!isIdentifierChar(condition[i]))
+		{
+			i++;
+			continue;
+		}
+
+		const size_t start = i;
+		while (i < condition.size() && isIdentifierChar(condition[i]))
+		{
+			i++;
+		}
+
+		if (std::isdigit(static_cast<unsigned char>(condition[start])))
+		{
+			continue;
+		}
+
+		const std::string identifier = condition.substr(start, i - start);
+		if (utility::isPrefix<std::string>("__has_", identifier))
+		{
+			// skip the arguments of feature checks like __has_include(<file.h>)
+			i = condition.find(')', i);
+		}
+		else if (
+			identifier != "defined" && identifier != "true" && identifier != "false" &&
+			!m_preprocessor.isMacroDefined(identifier))
+		{
+			m_enteredFiles.back().testedUndefinedMacros.insert(identifier);
+		}
+	}
+}
+
+void PreprocessorCallbacks::onFileExited(const EnteredFile& file)
+{
+	std::set<std::string> testedUndefinedMacros = file.testedUndefinedMacros;
+	bool isGuarded = false;
+
+	const clang::FileEntry* fileEntry = m_sourceManager.getFileEntryForID(file.fileId);
+	if (fileEntry)
+	{
+		const clang::HeaderFileInfo* info =
+			m_preprocessor.getHeaderSearchInfo().getExistingFileInfo(fileEntry);
+		if (info)
+		{
+			isGuarded = info->isPragmaOnce || info->isImport || info->ControllingMacro ||
+				info->ControllingMacroID;
+
+			if (info->ControllingMacro)
+			{
+				testedUndefinedMacros.erase(info->ControllingMacro->getName().str());
+			}
+		}
+	}
+
+	// only guarded headers are skipped by the files that include them again later
+	if (isGuarded && !file.usesOutsideMacros && testedUndefinedMacros.empty() &&
+		file.fileId != m_sourceManager.getMainFileID())
+	{
+		const FilePath filePath = m_canonicalFilePathCache->getCanonicalFilePath(
+			file.fileId, m_sourceManager);
+		if (!filePath.empty())
+		{
+			m_canonicalFilePathCache->getFileRegister()->addShareableFilePath(filePath);
+		}
+	}
+
+	if (!m_enteredFiles.empty())
+	{
+		m_enteredFiles.back().testedUndefinedMacros.insert(
+			testedUndefinedMacros.begin(), testedUndefinedMacros.end());
+	}
+}
+
 ParseLocation PreprocessorCallbacks::getParseLocation(const clang::Token& macroNameTok) const
 {
 	const clang::SourceLocation& location = m_sourceManager.getSpellingLoc(macroNameTok.getLocation());
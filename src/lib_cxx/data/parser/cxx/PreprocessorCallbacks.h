@@ -3,10 +3,13 @@
 
 #include <memory>
 #include <set>
+#include <string>
+#include <vector>
 
 #include <clang/Basic/SourceManager.h>
 #include <clang/Lex/MacroInfo.h>
 #include <clang/Lex/PPCallbacks.h>
+#include <clang/Lex/Preprocessor.h>
 #include <clang/Lex/Token.h>
 #include <llvm/ADT/Optional.h>
 
@@ -22,7 +25,7 @@ class PreprocessorCallbacks: public clang::PPCallbacks
 {
 public:
 	explicit PreprocessorCallbacks(
-		clang::SourceManager& sourceManager,
+		clang::Preprocessor& preprocessor,
 		std::shared_ptr<ParserClient> client,
 		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache);
 
@@ -71,13 +74,27 @@ public:
 		const clang::MacroArgs* args) override;
 
 private:
+	// tracks whether a header expands the same way wherever it is included
+	struct EnteredFile
+	{
+		clang::FileID fileId;
+		clang::SourceLocation startLocation;
+		bool usesOutsideMacros = false;
+		std::set<std::string> testedUndefinedMacros;
+	};
+
 	void onMacroUsage(const clang::Token& macroNameToken);
+	void onMacroDependency(
+		const clang::Token& macroNameToken, const clang::MacroDefinition& macroDefinition);
+	void onConditionDependency(clang::SourceRange conditionRange);
+	void onFileExited(const EnteredFile& file);
 
 	ParseLocation getParseLocation(const clang::Token& macroNameToc) const;
 	ParseLocation getParseLocation(const clang::MacroInfo* macroNameToc) const;
 	ParseLocation getParseLocation(const clang::SourceRange& sourceRange) const;
 	bool isLocatedInProjectFile(const clang::SourceLocation loc);
 
+	clang::Preprocessor& m_preprocessor;
 	const clang::SourceManager& m_sourceManager;
 	std::shared_ptr<ParserClient> m_client;
 	std::shared_ptr<CanonicalFilePathCache> m_canonicalFilePathCache;
@@ -86,6 +103,7 @@ private:
 	bool m_currentPathIsProjectFile = false;
 
 	std::set<clang::FileID> m_fileWasRecorded;
+	std::vector<EnteredFile> m_enteredFiles;
 };
 
 #endif	  // PREPROCESSOR_CALLBACKS_H
@@ -4,6 +4,7 @@
 
 #include "MessageActivateFullTextSearch.h"
 #include "MessageActivateOverview.h"
+#include "MessageFullTextSearchInterrupted.h"
 #include "MessageSearch.h"
 #include "MessageSearchAutocomplete.h"
 #include "QtSearchBarButton.h"
@@ -111,10 +112,12 @@ void QtSearchBar::requestAutocomplete(const std::wstring& query, NodeTypeSet acc
 
 void QtSearchBar::requestSearch(const std::vector<SearchMatch>& matches, NodeTypeSet acceptedNodeTypes)
 {
+	MessageFullTextSearchInterrupted().dispatch();
 	MessageSearch(matches, acceptedNodeTypes).dispatch();
 }
 
 void QtSearchBar::requestFullTextSearch(const std::wstring& query, bool caseSensitive)
 {
+	MessageFullTextSearchInterrupted().dispatch();
 	MessageActivateFullTextSearch(query, caseSensitive).dispatch();
 }
@@ -191,7 +191,6 @@ void QtGraphicsView::setSceneRect(const QRectF& rect)
 {
 	QGraphicsView::setSceneRect(rect);
 	scene()->setSceneRect(rect);
-	m_imageCached = toQImage();
 	m_tabId = TabId::currentTab();
 }
 
@@ -692,7 +691,7 @@ QImage QtGraphicsView::toQImage()
 
 	QPainter painter(&image);
 	painter.setRenderHint(QPainter::Antialiasing);
-	scene()->render(&painter);
+	renderScene(&painter);
 
 	{
 		QFont font = painter.font();
@@ -722,6 +721,14 @@ QImage QtGraphicsView::toQImage()
 	return image;
 }
 
+void QtGraphicsView::renderScene(QPainter* painter)
+{
+	// lets the graph create all items that are left out while only a part of it is displayed
+	emit renderingStarted();
+	scene()->render(painter);
+	emit renderingFinished();
+}
+
 void QtGraphicsView::exportGraph()
 {
 	const QString exportNotice = QStringLiteral("Exported from Sourcetrail");
@@ -745,7 +752,7 @@ void QtGraphicsView::exportGraph()
 		svgGen.setDescription(QStringLiteral("Graph exported from Sourcetrail") + QChar(0x00AE));
 
 		QPainter painter(&svgGen);
-		scene()->render(&painter);
+		renderScene(&painter);
 
 		{
 			QFont font(QStringLiteral("Fira Sans, sans-serif"));
@@ -870,12 +877,15 @@ void QtGraphicsView::updateTransform()
 {
 	float zoomFactor = m_appZoomFactor * m_zoomFactor;
 	setTransform(QTransform(zoomFactor, 0, 0, zoomFactor, 0, 0));
+
+	emit zoomChanged();
 }
 
 void QtGraphicsView::handleMessage(MessageSaveAsImage* message)
 {
-	if ( (message->getSchedulerId() == getSchedulerId()) && !m_imageCached.isNull() )
+	if (message->getSchedulerId() == getSchedulerId())
 	{
-		m_imageCached.save(message->path);
+		const QString path = message->path;
+		m_onQtThread([this, path]() { toQImage().save(path); });
 	}
 }
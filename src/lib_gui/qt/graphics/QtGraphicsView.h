@@ -8,9 +8,11 @@
 #include "types.h"
 #include "MessageListener.h"
 #include "MessageSaveAsImage.h"
+#include "QtThreadedFunctor.h"
 
 
 class GraphFocusHandler;
+class QPainter;
 class QPushButton;
 class QTimer;
 class QtGraphEdge;
@@ -61,10 +63,14 @@ protected:
 signals:
 	void emptySpaceClicked();
 	void resized();
+	void zoomChanged();
 
 	void focusIn();
 	void focusOut();
 
+	void renderingStarted();
+	void renderingFinished();
+
 private slots:
 	void updateTimer();
 	void stopTimer();
@@ -99,6 +105,8 @@ private:
 	void setZoomFactor(float zoomFactor);
 	void updateTransform();
 
+	void renderScene(QPainter* painter);
+
 	void handleMessage(MessageSaveAsImage* message) override;
 
 	GraphFocusHandler* m_focusHandler;
@@ -154,8 +162,9 @@ private:
 	float m_zoomInButtonSpeed;
 	float m_zoomOutButtonSpeed;
 
-	QImage m_imageCached;
 	Id m_tabId;
+
+	QtThreadedLambdaFunctor m_onQtThread;
 };
 
 #endif	  // QT_GRAPHICS_VIEW_H
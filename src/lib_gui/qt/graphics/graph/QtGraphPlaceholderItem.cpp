@@ -0,0 +1,97 @@
+#include "QtGraphPlaceholderItem.h"
+
+#include <algorithm>
+
+#include <QPainter>
+#include <QPen>
+#include <QPolygonF>
+#include <QStyleOptionGraphicsItem>
+
+QtGraphPlaceholderItem::QtGraphPlaceholderItem()
+{
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+	setAcceptedMouseButtons(Qt::NoButton);
+}
+
+QtGraphPlaceholderItem::~QtGraphPlaceholderItem() {}
+
+void QtGraphPlaceholderItem::addBox(
+	const QRectF& rect, const QColor& fillColor, const QColor& borderColor)
+{
+	prepareGeometryChange();
+
+	m_boxes.push_back({rect, fillColor, borderColor});
+	m_boundingRect |= rect;
+}
+
+void QtGraphPlaceholderItem::addEdge(const QPolygonF& line, const QColor& color)
+{
+	prepareGeometryChange();
+
+	auto it = std::find_if(
+		m_edgePaths.begin(), m_edgePaths.end(), [&color](const std::pair<QColor, QPainterPath>& p) {
+			return p.first == color;
+		});
+
+	if (it == m_edgePaths.end())
+	{
+		m_edgePaths.emplace_back(color, QPainterPath());
+		it = m_edgePaths.end() - 1;
+	}
+
+	it->second.addPolygon(line);
+	m_boundingRect |= line.boundingRect();
+}
+
+QRectF QtGraphPlaceholderItem::boundingRect() const
+{
+	return m_boundingRect.adjusted(-1, -1, 1, 1);
+}
+
+QPainterPath QtGraphPlaceholderItem::shape() const
+{
+	// an empty shape keeps the item from being found under the mouse, so clicks reach the view
+	return QPainterPath();
+}
+
+void QtGraphPlaceholderItem::paint(
+	QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	painter->save();
+	painter->setRenderHint(QPainter::Antialiasing, false);
+
+	// cosmetic pens are one pixel wide at every zoom factor
+	QPen pen;
+	pen.setCosmetic(true);
+
+	painter->setBrush(Qt::NoBrush);
+	for (const std::pair<QColor, QPainterPath>& edgePath: m_edgePaths)
+	{
+		pen.setColor(edgePath.first);
+		painter->setPen(pen);
+		painter->drawPath(edgePath.second);
+	}
+
+	// only boxes within the exposed area are drawn and the painter only changes between colors
+	const Box* previousBox = nullptr;
+	for (const Box& box: m_boxes)
+	{
+		if (!box.rect.intersects(option->exposedRect))
+		{
+			continue;
+		}
+
+		if (!previousBox || previousBox->fillColor != box.fillColor ||
+			previousBox->borderColor != box.borderColor)
+		{
+			pen.setColor(box.borderColor);
+			painter->setPen(pen);
+			painter->setBrush(box.fillColor);
+		}
+
+		painter->drawRect(box.rect);
+		previousBox = &box;
+	}
+
+	painter->restore();
+}
@@ -0,0 +1,44 @@
+#ifndef QT_GRAPH_PLACEHOLDER_ITEM_H
+#define QT_GRAPH_PLACEHOLDER_ITEM_H
+
+#include <utility>
+#include <vector>
+
+#include <QColor>
+#include <QGraphicsItem>
+#include <QPainterPath>
+
+class QPolygonF;
+
+// Draws the nodes of a graph as boxes without text and merges all edges of the same color into one
+// path. Used instead of the full node and edge items when zoomed out on large graphs.
+class QtGraphPlaceholderItem: public QGraphicsItem
+{
+public:
+	QtGraphPlaceholderItem();
+	virtual ~QtGraphPlaceholderItem();
+
+	// boxes are drawn in the order they were added, so parents need to be added before children
+	void addBox(const QRectF& rect, const QColor& fillColor, const QColor& borderColor);
+	void addEdge(const QPolygonF& line, const QColor& color);
+
+	QRectF boundingRect() const override;
+	QPainterPath shape() const override;
+
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+private:
+	struct Box
+	{
+		QRectF rect;
+		QColor fillColor;
+		QColor borderColor;
+	};
+
+	std::vector<Box> m_boxes;
+	std::vector<std::pair<QColor, QPainterPath>> m_edgePaths;
+
+	QRectF m_boundingRect;
+};
+
+#endif	  // QT_GRAPH_PLACEHOLDER_ITEM_H
@@ -315,6 +315,17 @@ void QtProjectWizardContentPreferences::populate(QGridLayout* layout, int& row)
 		this,
 		&QtProjectWizardContentPreferences::indexerThreadsChanges);
 
+	// merge threads
+	m_mergeThreads = addComboBox(
+		QStringLiteral("Merge Threads"),
+		0,
+		24,
+		QStringLiteral("<p>Set the number of threads used to merge the indexing results of "
+					   "indexer threads in parallel.</p>"),
+		layout,
+		row);
+	m_mergeThreads->setItemText(0, QStringLiteral("default"));
+
 	// multi process indexing
 	m_multiProcessIndexing = addCheckBox(
 		QStringLiteral("Multi Process<br />C/C++ Indexing"),
@@ -527,6 +538,8 @@ void QtProjectWizardContentPreferences::load()
 	m_threads->setCurrentIndex(
 		appSettings->getIndexerThreadCount());	  // index and value are the same
 	indexerThreadsChanges(m_threads->currentIndex());
+	m_mergeThreads->setCurrentIndex(
+		appSettings->getStorageMergeThreadCount());	   // index and value are the same
 	m_multiProcessIndexing->setChecked(appSettings->getMultiProcessIndexingEnabled());
 
 	if (m_javaPath)
@@ -602,6 +615,8 @@ void QtProjectWizardContentPreferences::save()
 		appSettings->setPluginPort(pluginPort);
 
 	appSettings->setIndexerThreadCount(m_threads->currentIndex());	  // index and value are the same
+	appSettings->setStorageMergeThreadCount(
+		m_mergeThreads->currentIndex());	// index and value are the same
 	appSettings->setMultiProcessIndexingEnabled(m_multiProcessIndexing->isChecked());
 
 	if (m_javaPath)
@@ -131,6 +131,8 @@ private:
 	QComboBox* m_threads;
 	QLabel* m_threadsInfoLabel;
 
+	QComboBox* m_mergeThreads;
+
 	QCheckBox* m_multiProcessIndexing;
 
 	std::shared_ptr<CombinedPathDetector> m_javaPathDetector;
@@ -6,6 +6,7 @@
 #include <QLabel>
 #include <QMouseEvent>
 #include <QParallelAnimationGroup>
+#include <QPolygonF>
 #include <QPropertyAnimation>
 #include <QPushButton>
 #include <QScrollBar>
@@ -33,12 +34,168 @@
 #include "QtGraphNodeGroup.h"
 #include "QtGraphNodeQualifier.h"
 #include "QtGraphNodeText.h"
+#include "QtGraphPlaceholderItem.h"
 #include "QtGraphicsView.h"
 #include "QtSelfRefreshIconButton.h"
 #include "QtViewWidgetWrapper.h"
 #include "ResourcePaths.h"
 #include "utilityQt.h"
 
+namespace
+{
+// graphs with more top level nodes only create the items of nodes near the visible area
+const size_t s_lazyNodeCount = 200;
+
+// below this zoom factor large graphs are drawn with placeholders, because no text is readable
+const float s_levelOfDetailZoomFactor = 0.3f;
+
+bool containsTokenId(const DummyNode* node, Id tokenId)
+{
+	if (node->tokenId == tokenId)
+	{
+		return true;
+	}
+
+	for (const std::shared_ptr<DummyNode>& subNode: node->subNodes)
+	{
+		if (containsTokenId(subNode.get(), tokenId))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// copies a node and its sub nodes, so it can be created later while the controller changes the
+// original nodes
+std::shared_ptr<DummyNode> cloneDummyNodeRecursive(const DummyNode* node)
+{
+	std::shared_ptr<DummyNode> clone = std::make_shared<DummyNode>(*node);
+
+	// bundled nodes are only counted by the view
+	clone->bundledNodeCount = node->getBundledNodeCount();
+	clone->bundledNodes.clear();
+
+	for (std::shared_ptr<DummyNode>& subNode: clone->subNodes)
+	{
+		subNode = cloneDummyNodeRecursive(subNode.get());
+	}
+
+	return clone;
+}
+
+bool isAnyBundledEdgeHidden(const DummyEdge* edge, const std::set<Id>& visibleEdgeIds)
+{
+	for (Id edgeId: edge->data->getComponent<TokenComponentBundledEdges>()->getBundledEdgesIds())
+	{
+		if (visibleEdgeIds.find(edgeId) == visibleEdgeIds.end())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void addPlaceholderNodesRecursive(
+	QtGraphPlaceholderItem* item,
+	const DummyNode* node,
+	const QPointF& parentPosition,
+	std::map<Id, QRectF>* nodeRects)
+{
+	if (!node->visible)
+	{
+		return;
+	}
+
+	const QRectF rect(
+		parentPosition + QPointF(node->position.x, node->position.y),
+		QSizeF(node->size.x, node->size.y));
+
+	if (node->tokenId)
+	{
+		nodeRects->emplace(node->tokenId, rect);
+	}
+
+	GraphViewStyle::NodeStyle style;
+	if (node->isGraphNode())
+	{
+		style = GraphViewStyle::getStyleForNodeType(
+			node->data->getType(),
+			node->data->isExplicit(),
+			node->active,
+			false,
+			false,
+			node->childVisible,
+			node->getQualifierNode() != nullptr);
+	}
+	else if (node->isAccessNode())
+	{
+		style = GraphViewStyle::getStyleOfAccessNode();
+	}
+	else if (node->isBundleNode())
+	{
+		style = GraphViewStyle::getStyleOfBundleNode(false);
+	}
+	else if (node->isGroupNode())
+	{
+		style = GraphViewStyle::getStyleOfGroupNode(node->groupType, false);
+	}
+	else
+	{
+		return;
+	}
+
+	item->addBox(
+		rect,
+		QColor(style.color.fill.c_str()),
+		style.borderWidth > 0 ? QColor(style.color.border.c_str()) : QColor(Qt::transparent));
+
+	for (const std::shared_ptr<DummyNode>& subNode: node->subNodes)
+	{
+		addPlaceholderNodesRecursive(item, subNode.get(), rect.topLeft(), nodeRects);
+	}
+}
+
+bool addPlaceholderEdge(
+	QtGraphPlaceholderItem* item,
+	const DummyEdge* edge,
+	const std::map<Id, QRectF>& nodeRects,
+	Graph::TrailMode trailMode,
+	const QPointF& pathOffset)
+{
+	auto owner = nodeRects.find(edge->ownerId);
+	auto target = nodeRects.find(edge->targetId);
+
+	if (!edge->visible || owner == nodeRects.end() || target == nodeRects.end())
+	{
+		return false;
+	}
+
+	QPolygonF line;
+	line << owner->second.center();
+
+	if (trailMode != Graph::TRAIL_NONE)
+	{
+		for (const Vec4i& rect: edge->path)
+		{
+			line << QRectF(QPointF(rect.x(), rect.y()), QPointF(rect.z(), rect.w())).center() -
+					pathOffset;
+		}
+	}
+
+	line << target->second.center();
+
+	const Edge::EdgeType type = edge->data ? edge->data->getType() : Edge::EDGE_BUNDLED_EDGES;
+	const GraphViewStyle::EdgeStyle style = GraphViewStyle::getStyleForEdgeType(
+		type, edge->active, false, trailMode != Graph::TRAIL_NONE, false);
+
+	item->addEdge(line, QColor(style.color.c_str()));
+	return true;
+}
+}	 // namespace
+
 QtGraphView::QtGraphView(ViewLayout* viewLayout)
 	: GraphView(viewLayout)
 	, m_focusHandler(this)
@@ -67,6 +224,9 @@ QtGraphView::QtGraphView(ViewLayout* viewLayout)
 
 	connect(view, &QtGraphicsView::emptySpaceClicked, this, &QtGraphView::clickedInEmptySpace);
 	connect(view, &QtGraphicsView::resized, this, &QtGraphView::resized);
+	connect(view, &QtGraphicsView::zoomChanged, this, &QtGraphView::updateLevelOfDetail);
+	connect(view, &QtGraphicsView::renderingStarted, this, &QtGraphView::prepareRendering);
+	connect(view, &QtGraphicsView::renderingFinished, this, &QtGraphView::finishRendering);
 	connect(view, &QtGraphicsView::focusIn, [this]() { setNavigationFocus(true); });
 	connect(view, &QtGraphicsView::focusOut, [this]() { setNavigationFocus(false); });
 
@@ -259,6 +419,11 @@ void QtGraphView::findMatches(ScreenSearchSender* sender, const std::wstring& qu
 	m_onQtThread([sender, query, this]() {
 		m_matchedNodes.clear();
 
+		if (m_lazyItems.nodes.size())
+		{
+			createLazyItems(QRectF());
+		}
+
 		for (QtGraphNode* node: m_oldNodes)
 		{
 			node->matchNameRecursive(query, &m_matchedNodes);
@@ -339,6 +504,17 @@ void QtGraphView::rebuildGraph(
 
 		QGraphicsView* view = getView();
 
+		// the old placeholder stays visible until the new graph data is shown
+		const bool usedLevelOfDetail = m_placeholderItem != nullptr;
+		if (usedLevelOfDetail)
+		{
+			delete m_oldPlaceholderItem;
+			m_oldPlaceholderItem = m_placeholderItem;
+			m_placeholderItem = nullptr;
+		}
+
+		m_lazyItems = LazyItems();
+		const bool createLazily = nodes.size() > s_lazyNodeCount;
 
 		// create nodes
 		size_t activeNodeCount = 0;
@@ -349,12 +525,24 @@ void QtGraphView::rebuildGraph(
 
 		Id oldActiveTokenId = m_oldActiveNode ? m_oldActiveNode->getTokenId() : 0;
 		m_nodes.clear();
+		m_nodesByTokenId.clear();
 		m_activeNodes.clear();
 		m_oldActiveNode = nullptr;
 		m_virtualNodeRects.clear();
 
 		for (unsigned int i = 0; i < nodes.size(); i++)
 		{
+			// active and focused nodes are created right away
+			if (createLazily && !nodes[i]->hasActiveSubNode() &&
+				!(params.tokenIdToFocus && containsTokenId(nodes[i].get(), params.tokenIdToFocus)))
+			{
+				if (nodes[i]->visible)
+				{
+					m_lazyItems.nodes.push_back(cloneDummyNodeRecursive(nodes[i].get()));
+				}
+				continue;
+			}
+
 			QtGraphNode* node = createNodeRecursive(
 				view, nullptr, nodes[i].get(), activeNodeCount > 1, !params.disableInteraction);
 			if (node)
@@ -371,7 +559,13 @@ void QtGraphView::rebuildGraph(
 		Id newActiveTokenId = m_oldActiveNode ? m_oldActiveNode->getTokenId() : 0;
 
 		// move graph to center
-		QPointF center = itemsBoundingRect(m_nodes).center();
+		QRectF boundingRect = itemsBoundingRect(m_nodes);
+		for (const std::shared_ptr<DummyNode>& node: m_lazyItems.nodes)
+		{
+			boundingRect |= QRectF(node->position.x, node->position.y, node->size.x, node->size.y);
+		}
+
+		QPointF center = boundingRect.center();
 		const Vec2i o = GraphViewStyle::alignOnRaster(
 			Vec2i(static_cast<int>(center.x()), static_cast<int>(center.y())));
 		QPointF offset = QPointF(o.x, o.y);
@@ -388,25 +582,80 @@ void QtGraphView::rebuildGraph(
 		// create edges
 		Graph::TrailMode trailMode = m_graph ? m_graph->getTrailMode() : Graph::TRAIL_NONE;
 		std::set<Id> visibleEdgeIds;
-		for (const std::shared_ptr<DummyEdge>& edge: edges)
+		if (createLazily)
 		{
-			if (!edge->data || !edge->data->isType(Edge::EDGE_BUNDLED_EDGES))
+			m_placeholderItem = new QtGraphPlaceholderItem();
+
+			std::map<Id, QRectF> nodeRects;
+			for (const std::shared_ptr<DummyNode>& node: nodes)
 			{
-				createEdge(
-					view,
-					edge.get(),
-					&visibleEdgeIds,
-					trailMode,
-					offset,
-					params.bezierEdges,
-					!params.disableInteraction);
+				addPlaceholderNodesRecursive(m_placeholderItem, node.get(), -offset, &nodeRects);
 			}
+
+			// edges are created once both of their nodes exist
+			for (const std::shared_ptr<DummyEdge>& edge: edges)
+			{
+				if ((!edge->data || !edge->data->isType(Edge::EDGE_BUNDLED_EDGES)) &&
+					addPlaceholderEdge(m_placeholderItem, edge.get(), nodeRects, trailMode, offset))
+				{
+					if (edge->data)
+					{
+						visibleEdgeIds.insert(edge->data->getId());
+					}
+					m_lazyItems.edges.push_back(std::make_shared<DummyEdge>(*edge));
+				}
+			}
+			for (const std::shared_ptr<DummyEdge>& edge: edges)
+			{
+				if (edge->data && edge->data->isType(Edge::EDGE_BUNDLED_EDGES) &&
+					isAnyBundledEdgeHidden(edge.get(), visibleEdgeIds) &&
+					addPlaceholderEdge(
+						m_placeholderItem, edge.get(), nodeRects, Graph::TRAIL_NONE, QPointF()))
+				{
+					m_lazyItems.edges.push_back(std::make_shared<DummyEdge>(*edge));
+				}
+			}
+
+			m_placeholderItem->setVisible(false);
+			view->scene()->addItem(m_placeholderItem);
+
+			m_lazyItems.offset = offset;
+			m_lazyItems.trailMode = trailMode;
+			m_lazyItems.multipleActive = activeNodeCount > 1;
+			m_lazyItems.bezierEdges = params.bezierEdges;
+			m_lazyItems.interactive = !params.disableInteraction;
 		}
-		for (const std::shared_ptr<DummyEdge>& edge: edges)
+		else
 		{
-			if (edge->data && edge->data->isType(Edge::EDGE_BUNDLED_EDGES))
+			for (const std::shared_ptr<DummyEdge>& edge: edges)
 			{
-				createBundledEdgesEdge(view, edge.get(), &visibleEdgeIds, !params.disableInteraction);
+				if (!edge->data || !edge->data->isType(Edge::EDGE_BUNDLED_EDGES))
+				{
+					QtGraphEdge* qtEdge = createEdge(
+						view,
+						edge.get(),
+						&visibleEdgeIds,
+						trailMode,
+						offset,
+						params.bezierEdges,
+						!params.disableInteraction);
+					if (qtEdge)
+					{
+						m_edges.push_back(qtEdge);
+					}
+				}
+			}
+			for (const std::shared_ptr<DummyEdge>& edge: edges)
+			{
+				if (edge->data && edge->data->isType(Edge::EDGE_BUNDLED_EDGES))
+				{
+					QtGraphEdge* qtEdge = createBundledEdgesEdge(
+						view, edge.get(), &visibleEdgeIds, !params.disableInteraction);
+					if (qtEdge)
+					{
+						m_edges.push_back(qtEdge);
+					}
+				}
 			}
 		}
 
@@ -428,8 +677,9 @@ void QtGraphView::rebuildGraph(
 		m_scrollToTop = params.scrollToTop;
 		m_isIndexedList = params.isIndexedList;
 
-		if (params.animatedTransition && ApplicationSettings::getInstance()->getUseAnimations() &&
-			view->isVisible())
+		// transitions would animate all items of large graphs
+		if (params.animatedTransition && !createLazily && !usedLevelOfDetail &&
+			ApplicationSettings::getInstance()->getUseAnimations() && view->isVisible())
 		{
 			createTransition();
 		}
@@ -464,12 +714,17 @@ void QtGraphView::clear()
 		m_oldNodes.clear();
 		m_oldEdges.clear();
 
+		m_nodesByTokenId.clear();
+		m_lazyItems = LazyItems();
+
 		m_graph.reset();
 		m_oldGraph.reset();
 
 		m_matchedNodes.clear();
 
 		getView()->scene()->clear();
+		m_placeholderItem = nullptr;
+		m_oldPlaceholderItem = nullptr;
 	});
 }
 
@@ -744,6 +999,8 @@ void QtGraphView::scrolled(int)
 
 	MessageScrollGraph(view->horizontalScrollBar()->value(), view->verticalScrollBar()->value())
 		.dispatch();
+
+	updateLevelOfDetail();
 }
 
 void QtGraphView::resized()
@@ -754,6 +1011,54 @@ void QtGraphView::resized()
 	}
 
 	doResize();
+	updateLevelOfDetail();
+}
+
+void QtGraphView::updateLevelOfDetail()
+{
+	if (!m_placeholderItem || isTransitioning())
+	{
+		return;
+	}
+
+	QtGraphicsView* view = getView();
+	const bool showPlaceholders = view->getZoomFactor() < s_levelOfDetailZoomFactor;
+
+	setPlaceholdersVisible(showPlaceholders);
+
+	if (!showPlaceholders && (m_lazyItems.nodes.size() || m_lazyItems.edges.size()))
+	{
+		// also create the nodes around the visible area, so they are ready before scrolled to
+		const QRectF visibleRect = view->mapToScene(view->viewport()->rect()).boundingRect();
+		const qreal margin = std::max(visibleRect.width(), visibleRect.height()) / 2;
+		createLazyItems(visibleRect.adjusted(-margin, -margin, margin, margin));
+	}
+}
+
+void QtGraphView::prepareRendering()
+{
+	if (!m_placeholderItem)
+	{
+		return;
+	}
+
+	// exported images show the complete graph with all node names
+	setPlaceholdersVisible(false);
+
+	if (m_lazyItems.nodes.size() || m_lazyItems.edges.size())
+	{
+		createLazyItems(QRectF());
+	}
+}
+
+void QtGraphView::finishRendering()
+{
+	if (!m_placeholderItem)
+	{
+		return;
+	}
+
+	setPlaceholdersVisible(getView()->getZoomFactor() < s_levelOfDetailZoomFactor);
 }
 
 void QtGraphView::trailDepthChanged(int)
@@ -955,6 +1260,9 @@ void QtGraphView::switchToNewGraphData()
 		edge->deleteLater();
 	}
 
+	delete m_oldPlaceholderItem;
+	m_oldPlaceholderItem = nullptr;
+
 	m_oldNodes = m_nodes;
 	m_oldEdges = m_edges;
 
@@ -991,6 +1299,8 @@ void QtGraphView::switchToNewGraphData()
 		m_focusHandler.focusInitialNode();
 	}
 
+	updateLevelOfDetail();
+
 	// Repaint to make sure all artifacts are removed
 	view->update();
 
@@ -1113,6 +1423,11 @@ QtGraphNode* QtGraphView::createNodeRecursive(
 		m_activeNodes.push_back(newNode);
 	}
 
+	if (newNode->getTokenId())
+	{
+		m_nodesByTokenId.emplace(newNode->getTokenId(), newNode);
+	}
+
 	for (unsigned int i = 0; i < node->subNodes.size(); i++)
 	{
 		QtGraphNode* subNode = createNodeRecursive(
@@ -1142,11 +1457,14 @@ QtGraphEdge* QtGraphView::createEdge(
 		return nullptr;
 	}
 
-	QtGraphNode* owner = QtGraphNode::findNodeRecursive(m_nodes, edge->ownerId);
-	QtGraphNode* target = QtGraphNode::findNodeRecursive(m_nodes, edge->targetId);
+	auto ownerIt = m_nodesByTokenId.find(edge->ownerId);
+	auto targetIt = m_nodesByTokenId.find(edge->targetId);
 
-	if (owner != nullptr && target != nullptr)
+	if (ownerIt != m_nodesByTokenId.end() && targetIt != m_nodesByTokenId.end())
 	{
+		QtGraphNode* owner = ownerIt->second;
+		QtGraphNode* target = targetIt->second;
+
 		QtGraphEdge* qtEdge = new QtGraphEdge(
 			&m_focusHandler,
 			owner,
@@ -1195,8 +1513,6 @@ QtGraphEdge* QtGraphView::createEdge(
 			visibleEdgeIds->insert(edge->data->getId());
 		}
 
-		m_edges.push_back(qtEdge);
-
 		return qtEdge;
 	}
 
@@ -1211,24 +1527,97 @@ QtGraphEdge* QtGraphView::createBundledEdgesEdge(
 		return nullptr;
 	}
 
-	bool allVisible = true;
-	std::set<Id> bundledEdgesIds =
-		edge->data->getComponent<TokenComponentBundledEdges>()->getBundledEdgesIds();
-	for (Id edgeId: bundledEdgesIds)
+	if (!isAnyBundledEdgeHidden(edge, *visibleEdgeIds))
+	{
+		return nullptr;
+	}
+
+	return createEdge(view, edge, visibleEdgeIds, Graph::TRAIL_NONE, QPointF(), false, interactive);
+}
+
+void QtGraphView::createLazyItems(const QRectF& sceneRect)
+{
+	QGraphicsView* view = getView();
+	const bool visible = !m_placeholderItem || !m_placeholderItem->isVisible();
+
+	std::vector<std::shared_ptr<DummyNode>> remainingNodes;
+	for (const std::shared_ptr<DummyNode>& dummyNode: m_lazyItems.nodes)
 	{
-		if (visibleEdgeIds->find(edgeId) == visibleEdgeIds->end())
+		QRectF rect(
+			dummyNode->position.x, dummyNode->position.y, dummyNode->size.x, dummyNode->size.y);
+		rect.translate(-m_lazyItems.offset);
+
+		if (!sceneRect.isNull() && !sceneRect.intersects(rect))
+		{
+			remainingNodes.push_back(dummyNode);
+			continue;
+		}
+
+		QtGraphNode* node = createNodeRecursive(
+			view, nullptr, dummyNode.get(), m_lazyItems.multipleActive, m_lazyItems.interactive);
+		if (node)
 		{
-			allVisible = false;
-			break;
+			node->setPos(node->pos() - m_lazyItems.offset);
+			node->setVisible(visible);
+			m_oldNodes.push_back(node);
 		}
 	}
+	m_lazyItems.nodes.swap(remainingNodes);
 
-	if (allVisible)
+	// edges only need to be checked again after new nodes were created
+	if (m_nodesByTokenId.size() == m_lazyItems.checkedNodeCount)
 	{
-		return nullptr;
+		return;
 	}
+	m_lazyItems.checkedNodeCount = m_nodesByTokenId.size();
 
-	return createEdge(view, edge, visibleEdgeIds, Graph::TRAIL_NONE, QPointF(), false, interactive);
+	std::set<Id> visibleEdgeIds;
+	std::vector<std::shared_ptr<DummyEdge>> remainingEdges;
+	for (const std::shared_ptr<DummyEdge>& edge: m_lazyItems.edges)
+	{
+		if (m_nodesByTokenId.find(edge->ownerId) == m_nodesByTokenId.end() ||
+			m_nodesByTokenId.find(edge->targetId) == m_nodesByTokenId.end())
+		{
+			remainingEdges.push_back(edge);
+			continue;
+		}
+
+		const bool isBundledEdges = edge->data && edge->data->isType(Edge::EDGE_BUNDLED_EDGES);
+		QtGraphEdge* qtEdge = createEdge(
+			view,
+			edge.get(),
+			&visibleEdgeIds,
+			isBundledEdges ? Graph::TRAIL_NONE : m_lazyItems.trailMode,
+			isBundledEdges ? QPointF() : m_lazyItems.offset,
+			!isBundledEdges && m_lazyItems.bezierEdges,
+			m_lazyItems.interactive);
+		if (qtEdge)
+		{
+			qtEdge->setVisible(visible);
+			m_oldEdges.push_back(qtEdge);
+		}
+	}
+	m_lazyItems.edges.swap(remainingEdges);
+}
+
+void QtGraphView::setPlaceholdersVisible(bool visible)
+{
+	if (m_placeholderItem->isVisible() == visible)
+	{
+		return;
+	}
+
+	m_placeholderItem->setVisible(visible);
+
+	for (QtGraphNode* node: m_oldNodes)
+	{
+		node->setVisible(!visible);
+	}
+
+	for (QtGraphEdge* edge: m_oldEdges)
+	{
+		edge->setVisible(!visible);
+	}
 }
 
 QRectF QtGraphView::itemsBoundingRect(const std::list<QtGraphNode*>& items) const
@@ -1250,6 +1639,12 @@ QRectF QtGraphView::getSceneRect(const std::list<QtGraphNode*>& items) const
 		sceneRect |= rect;
 	}
 
+	// covers the nodes that were not created yet
+	if (m_placeholderItem)
+	{
+		sceneRect |= m_placeholderItem->boundingRect();
+	}
+
 	return sceneRect.adjusted(-75, -75, 75, 75).translated(m_sceneRectOffset);
 }
 
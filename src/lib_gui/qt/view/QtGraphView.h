@@ -1,6 +1,7 @@
 #ifndef QT_GRAPH_VIEW_H
 #define QT_GRAPH_VIEW_H
 
+#include <map>
 #include <set>
 
 #include <QGraphicsView>
@@ -24,6 +25,7 @@ class QSlider;
 class QtGraphEdge;
 class QtGraphicsView;
 class QtGraphNode;
+class QtGraphPlaceholderItem;
 class QtSelfRefreshIconButton;
 
 class QtGraphView
@@ -89,6 +91,10 @@ private slots:
 	void scrolled(int);
 	void resized();
 
+	void updateLevelOfDetail();
+	void prepareRendering();
+	void finishRendering();
+
 	void trailDepthChanged(int);
 	void trailDepthUpdated();
 
@@ -131,6 +137,11 @@ private:
 	QtGraphEdge* createBundledEdgesEdge(
 		QGraphicsView* view, const DummyEdge* edge, std::set<Id>* visibleEdgeIds, bool interactive);
 
+	// creates the deferred nodes within sceneRect, or all of them for a null rect, and the edges
+	// between existing nodes
+	void createLazyItems(const QRectF& sceneRect);
+	void setPlaceholdersVisible(bool visible);
+
 	QRectF itemsBoundingRect(const std::list<QtGraphNode*>& items) const;
 	QRectF getSceneRect(const std::list<QtGraphNode*>& items) const;
 
@@ -160,6 +171,9 @@ private:
 	std::list<QtGraphNode*> m_nodes;
 	std::list<QtGraphNode*> m_oldNodes;
 
+	// nodes of the newest graph, used to find the nodes of its edges
+	std::map<Id, QtGraphNode*> m_nodesByTokenId;
+
 	std::vector<QtGraphNode*> m_activeNodes;
 	QtGraphNode* m_oldActiveNode = nullptr;
 
@@ -190,6 +204,27 @@ private:
 
 	std::vector<QRectF> m_virtualNodeRects;
 
+	// Large graphs only create the items of nodes near the visible area and show placeholders
+	// instead of all items when zoomed out. The deferred nodes and edges are copies, because the
+	// controller keeps changing its own ones after the graph was passed to the view.
+	struct LazyItems
+	{
+		std::vector<std::shared_ptr<DummyNode>> nodes;
+		std::vector<std::shared_ptr<DummyEdge>> edges;
+
+		QPointF offset;
+		Graph::TrailMode trailMode = Graph::TRAIL_NONE;
+		bool multipleActive = false;
+		bool bezierEdges = false;
+		bool interactive = true;
+
+		size_t checkedNodeCount = 0;
+	};
+
+	LazyItems m_lazyItems;
+	QtGraphPlaceholderItem* m_placeholderItem = nullptr;
+	QtGraphPlaceholderItem* m_oldPlaceholderItem = nullptr;
+
 	// Name matches
 	std::vector<QtGraphNode*> m_matchedNodes;
 };
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+
+#include <algorithm>
+
+#include "AdjacencyIndex.h"
+#include "Edge.h"
+
+namespace
+{
+std::vector<Id> getEdgeIds(const std::vector<StorageEdge>& edges)
+{
+	std::vector<Id> ids;
+	for (const StorageEdge& edge: edges)
+	{
+		ids.push_back(edge.id);
+	}
+	return ids;
+}
+
+AdjacencyIndex getTestIndex()
+{
+	AdjacencyIndex index;
+	index.build({
+		StorageEdge(10, Edge::EDGE_CALL, 1, 2),
+		StorageEdge(11, Edge::EDGE_MEMBER, 1, 3),
+		StorageEdge(12, Edge::EDGE_CALL, 2, 3),
+		StorageEdge(13, Edge::EDGE_USAGE, 3, 1),
+		StorageEdge(14, Edge::EDGE_CALL, 3, 3),
+		StorageEdge(6, Edge::EDGE_INHERITANCE, 1, 5),
+	});
+	return index;
+}
+}	 // namespace
+
+TEST_CASE("adjacency index finds outgoing and incoming edges of nodes")
+{
+	const AdjacencyIndex index = getTestIndex();
+	REQUIRE(index.isBuilt());
+	REQUIRE(6 == index.getEdgeCount());
+
+	const std::vector<StorageEdge> outgoingEdges = index.getEdgesBySourceIds({1});
+	REQUIRE(std::vector<Id>({6, 10, 11}) == getEdgeIds(outgoingEdges));
+	REQUIRE(Edge::EDGE_INHERITANCE == outgoingEdges[0].type);
+	REQUIRE(1 == outgoingEdges[0].sourceNodeId);
+	REQUIRE(5 == outgoingEdges[0].targetNodeId);
+
+	const std::vector<StorageEdge> incomingEdges = index.getEdgesByTargetIds({3});
+	REQUIRE(std::vector<Id>({11, 12, 14}) == getEdgeIds(incomingEdges));
+	REQUIRE(2 == incomingEdges[1].sourceNodeId);
+	REQUIRE(3 == incomingEdges[1].targetNodeId);
+
+	REQUIRE(std::vector<Id>({12, 13, 14}) == getEdgeIds(index.getEdgesBySourceIds({3, 2, 3})));
+	REQUIRE(index.getEdgesBySourceIds({4, 5, 100}).empty());
+	REQUIRE(index.getEdgesByTargetIds({0}).empty());
+}
+
+TEST_CASE("adjacency index filters edges by type")
+{
+	const AdjacencyIndex index = getTestIndex();
+
+	REQUIRE(
+		std::vector<Id>({10}) == getEdgeIds(index.getEdgesBySourceIds({1}, Edge::EDGE_CALL)));
+	REQUIRE(
+		std::vector<Id>({6, 11}) ==
+		getEdgeIds(index.getEdgesBySourceIds({1}, Edge::EDGE_MEMBER | Edge::LAYOUT_VERTICAL)));
+	REQUIRE(index.getEdgesByTargetIds({1, 2, 3}, Edge::EDGE_OVERRIDE).empty());
+}
+
+TEST_CASE("adjacency index returns edges of node to itself once")
+{
+	const AdjacencyIndex index = getTestIndex();
+
+	std::vector<Id> edgeIds = getEdgeIds(index.getEdgesBySourceOrTargetId(3));
+	std::sort(edgeIds.begin(), edgeIds.end());
+	REQUIRE(std::vector<Id>({11, 12, 13, 14}) == edgeIds);
+}
+
+TEST_CASE("adjacency index finds edges of nodes with sparse ids")
+{
+	AdjacencyIndex index;
+	REQUIRE(index.build({
+		StorageEdge(3000000000, Edge::EDGE_CALL, 1000000, 2000000000),
+		StorageEdge(7, Edge::EDGE_USAGE, 2000000000, 1000000),
+	}));
+
+	REQUIRE(std::vector<Id>({3000000000}) == getEdgeIds(index.getEdgesBySourceIds({1000000})));
+	REQUIRE(std::vector<Id>({7}) == getEdgeIds(index.getEdgesByTargetIds({1000000})));
+	REQUIRE(index.getEdgesBySourceIds({1000001, 3000000000}).empty());
+}
+
+TEST_CASE("adjacency index is empty after clear")
+{
+	AdjacencyIndex index = getTestIndex();
+	index.clear();
+
+	REQUIRE_FALSE(index.isBuilt());
+	REQUIRE(0 == index.getEdgeCount());
+	REQUIRE(index.getEdgesBySourceIds({1}).empty());
+	REQUIRE(index.getEdgesBySourceOrTargetId(3).empty());
+}
@@ -0,0 +1,142 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <map>
+
+#include "BidirectionalTrailSearch.h"
+
+namespace
+{
+// edges are stored as edge id -> source and target node ids
+BidirectionalTrailSearch getSearch(
+	const std::map<Id, std::pair<Id, Id>>& edges,
+	const std::set<Id>& excludedNodeIds = {},
+	const std::set<Id>& hiddenNodeIds = {},
+	const std::set<Id>& hiddenEdgeIds = {})
+{
+	return BidirectionalTrailSearch(
+		[edges, hiddenEdgeIds](const std::vector<Id>& nodeIds, bool forward) {
+			std::vector<BidirectionalTrailSearch::Step> steps;
+			for (const auto& edge: edges)
+			{
+				const Id nodeId = forward ? edge.second.first : edge.second.second;
+				const Id otherNodeId = forward ? edge.second.second : edge.second.first;
+				if (std::find(nodeIds.begin(), nodeIds.end(), nodeId) != nodeIds.end())
+				{
+					steps.push_back(
+						{nodeId,
+						 edge.first,
+						 otherNodeId,
+						 hiddenEdgeIds.find(edge.first) == hiddenEdgeIds.end()});
+				}
+			}
+			return steps;
+		},
+		[excludedNodeIds](const std::vector<Id>& nodeIds) {
+			std::vector<Id> acceptedNodeIds;
+			for (Id nodeId: nodeIds)
+			{
+				if (excludedNodeIds.find(nodeId) == excludedNodeIds.end())
+				{
+					acceptedNodeIds.push_back(nodeId);
+				}
+			}
+			return acceptedNodeIds;
+		},
+		[hiddenNodeIds](const std::vector<Id>& nodeIds) {
+			std::vector<Id> shownNodeIds;
+			for (Id nodeId: nodeIds)
+			{
+				if (hiddenNodeIds.find(nodeId) == hiddenNodeIds.end())
+				{
+					shownNodeIds.push_back(nodeId);
+				}
+			}
+			return shownNodeIds;
+		});
+}
+
+std::map<Id, std::pair<Id, Id>> getTestEdges()
+{
+	// two shortest trails 1 -> 2 -> 4 -> 5 and 1 -> 3 -> 4 -> 5, a longer one over 6 and 7 and a
+	// branch from 2 to 8 and 9 that does not lead to 5
+	return {
+		{101, {1, 2}},
+		{102, {1, 3}},
+		{103, {2, 4}},
+		{104, {3, 4}},
+		{105, {4, 5}},
+		{106, {1, 6}},
+		{107, {6, 7}},
+		{108, {7, 4}},
+		{109, {2, 8}},
+		{110, {8, 9}},
+		{111, {5, 1}},
+	};
+}
+}	 // namespace
+
+TEST_CASE("bidirectional trail search finds all shortest trails")
+{
+	const BidirectionalTrailSearch::Result result = getSearch(getTestEdges()).search(1, 5, 0, 100);
+
+	REQUIRE(result.isFound);
+	REQUIRE_FALSE(result.isTruncated);
+	REQUIRE(std::set<Id>({1, 2, 3, 4, 5}) == result.nodeIds);
+	REQUIRE(std::set<Id>({101, 102, 103, 104, 105}) == result.edgeIds);
+}
+
+TEST_CASE("bidirectional trail search only passes accepted nodes")
+{
+	const BidirectionalTrailSearch::Result result =
+		getSearch(getTestEdges(), {2, 3}).search(1, 5, 0, 100);
+
+	REQUIRE(result.isFound);
+	REQUIRE(std::set<Id>({1, 4, 5, 6, 7}) == result.nodeIds);
+	REQUIRE(std::set<Id>({105, 106, 107, 108}) == result.edgeIds);
+}
+
+TEST_CASE("bidirectional trail search passes hidden nodes and edges without adding them")
+{
+	const BidirectionalTrailSearch::Result result =
+		getSearch(getTestEdges(), {}, {2}, {104}).search(1, 5, 0, 100);
+
+	REQUIRE(result.isFound);
+	REQUIRE(std::set<Id>({1, 3, 4, 5}) == result.nodeIds);
+	REQUIRE(std::set<Id>({102, 105}) == result.edgeIds);
+
+	// the ends of the trail are always shown
+	const BidirectionalTrailSearch::Result endsResult =
+		getSearch(getTestEdges(), {}, {1, 5}).search(1, 5, 0, 100);
+	REQUIRE(std::set<Id>({1, 2, 3, 4, 5}) == endsResult.nodeIds);
+	REQUIRE(std::set<Id>({101, 102, 103, 104, 105}) == endsResult.edgeIds);
+}
+
+TEST_CASE("bidirectional trail search respects maximum depth")
+{
+	REQUIRE(getSearch(getTestEdges()).search(1, 5, 3, 100).isFound);
+
+	const BidirectionalTrailSearch::Result result = getSearch(getTestEdges()).search(1, 5, 2, 100);
+	REQUIRE_FALSE(result.isFound);
+	REQUIRE_FALSE(result.isTruncated);
+	REQUIRE(result.nodeIds.empty());
+
+	REQUIRE_FALSE(getSearch(getTestEdges()).search(9, 1, 0, 100).isFound);
+	REQUIRE(std::set<Id>({3}) == getSearch(getTestEdges()).search(3, 3, 0, 100).nodeIds);
+}
+
+TEST_CASE("bidirectional trail search stops after visiting maximum node count")
+{
+	std::map<Id, std::pair<Id, Id>> edges;
+	for (Id i = 1; i < 100; i++)
+	{
+		edges.emplace(1000 + i, std::make_pair(i, i + 1));
+	}
+
+	const BidirectionalTrailSearch::Result result = getSearch(edges).search(1, 100, 0, 20);
+	REQUIRE_FALSE(result.isFound);
+	REQUIRE(result.isTruncated);
+	REQUIRE(21 == result.visitedNodeCount);
+
+	REQUIRE(getSearch(edges).search(1, 100, 0, 200).isFound);
+}
@@ -9,6 +9,7 @@
 #	include "utilityString.h"
 
 #	include "CxxParser.h"
+#	include "FileRegister.h"
 #	include "IndexerCommandCxx.h"
 #	include "IndexerStateInfo.h"
 #	include "ParserClientImpl.h"
@@ -3988,6 +3989,72 @@ TEST_CASE("cxx parser parses multiple files")
 	REQUIRE(testStorage->includes.size() == 1);
 }
 
+TEST_CASE("cxx parser only shares headers that expand the same way in every translation unit")
+{
+	const std::set<FilePath> indexedPaths = {FilePath(L"data/CxxParserTestSuite/shared/")};
+	const std::set<FilePathFilter> excludeFilters;
+	const std::set<FilePathFilter> includeFilters;
+	const FilePath workingDirectory(L".");
+	const FilePath firstFilePath(L"data/CxxParserTestSuite/shared/first.cpp");
+	const FilePath secondFilePath(L"data/CxxParserTestSuite/shared/second.cpp");
+
+	std::shared_ptr<IndexerCommandCxx> firstCommand = std::make_shared<IndexerCommandCxx>(
+		firstFilePath,
+		indexedPaths,
+		excludeFilters,
+		includeFilters,
+		workingDirectory,
+		std::vector<std::wstring> {L"-std=c++1z", firstFilePath.wstr()});
+
+	std::shared_ptr<IntermediateStorage> firstStorage = std::make_shared<IntermediateStorage>();
+	std::shared_ptr<FileRegister> firstFileRegister = std::make_shared<FileRegister>(
+		firstFilePath, indexedPaths, excludeFilters);
+	CxxParser firstParser(
+		std::make_shared<ParserClientImpl>(firstStorage.get()),
+		firstFileRegister,
+		std::make_shared<IndexerStateInfo>());
+	firstParser.buildIndex(firstCommand);
+
+	std::set<std::wstring> shareableFileNames;
+	for (const FilePath& filePath: firstFileRegister->getShareableFilePaths())
+	{
+		shareableFileNames.insert(filePath.fileName());
+	}
+
+	// configured.h depends on USE_WIDE_CHARS of first.cpp, unguarded.h has no include guard and
+	// templated.h may be instantiated differently by second.cpp
+	REQUIRE(shareableFileNames == std::set<std::wstring> {L"guarded.h"});
+	REQUIRE(utility::containsElement<std::wstring>(
+		TestStorage::create(firstStorage)->typedefs, L"Char <5:17 5:20>"));
+
+	std::shared_ptr<IndexerCommandCxx> secondCommand = std::make_shared<IndexerCommandCxx>(
+		secondFilePath,
+		indexedPaths,
+		excludeFilters,
+		includeFilters,
+		workingDirectory,
+		std::vector<std::wstring> {L"-std=c++1z", secondFilePath.wstr()});
+
+	std::shared_ptr<IntermediateStorage> secondStorage = std::make_shared<IntermediateStorage>();
+	CxxParser secondParser(
+		std::make_shared<ParserClientImpl>(secondStorage.get()),
+		std::make_shared<FileRegister>(
+			secondFilePath,
+			indexedPaths,
+			excludeFilters,
+			firstFileRegister->getShareableFilePaths()),
+		std::make_shared<IndexerStateInfo>());
+	secondParser.buildIndex(secondCommand);
+
+	// configured.h is recorded again and expands to the other typedef
+	std::shared_ptr<TestStorage> secondTestStorage = TestStorage::create(secondStorage);
+	REQUIRE(secondTestStorage->errors.size() == 0);
+	REQUIRE(utility::containsElement<std::wstring>(
+		secondTestStorage->typedefs, L"Char <7:14 7:17>"));
+	REQUIRE(!utility::containsElement<std::wstring>(
+		secondTestStorage->typedefs, L"Char <5:17 5:20>"));
+}
+
 
 TEST_CASE("cxx parser finds braces of class decl")
 {
@@ -7,6 +7,7 @@
 
 #include "FileSystem.h"
 #include "utility.h"
+#include "utilityFile.h"
 
 namespace
 {
@@ -144,3 +145,57 @@ TEST_CASE("find symlinked directories")
 	REQUIRE(dirs.size() == 2);
 #endif
 }
+
+TEST_CASE("order file paths by expected duration falls back to file size")
+{
+	const FilePath small(L"./data/FileSystemTestSuite/update.c");
+	const FilePath medium(L"./data/FileSystemTestSuite/main.cpp");
+	const FilePath large(L"./data/FileSystemTestSuite/tictactoe.h");
+
+	const std::vector<FilePath> orderedPaths = utility::orderFilePathsByExpectedDuration(
+		{small, large, medium}, {});
+
+	REQUIRE(orderedPaths.size() == 3);
+	REQUIRE(orderedPaths[0] == large);
+	REQUIRE(orderedPaths[1] == medium);
+	REQUIRE(orderedPaths[2] == small);
+}
+
+TEST_CASE("order file paths by expected duration prefers known durations")
+{
+	const FilePath small(L"./data/FileSystemTestSuite/update.c");
+	const FilePath medium(L"./data/FileSystemTestSuite/main.cpp");
+	const FilePath large(L"./data/FileSystemTestSuite/tictactoe.h");
+
+	std::map<FilePath, utility::IndexingCost> knownCosts;
+	knownCosts[small].duration = 500;
+	knownCosts[medium].duration = 10;
+
+	const std::vector<FilePath> orderedPaths = utility::orderFilePathsByExpectedDuration(
+		{small, large, medium}, knownCosts);
+
+	REQUIRE(orderedPaths.size() == 3);
+	REQUIRE(orderedPaths[0] == large);	  // estimated from the known duration per byte
+	REQUIRE(orderedPaths[1] == small);
+	REQUIRE(orderedPaths[2] == medium);
+}
+
+TEST_CASE("order file paths by expected duration estimates from known storage sizes")
+{
+	const FilePath small(L"./data/FileSystemTestSuite/update.c");
+	const FilePath medium(L"./data/FileSystemTestSuite/main.cpp");
+	const FilePath large(L"./data/FileSystemTestSuite/tictactoe.h");
+
+	std::map<FilePath, utility::IndexingCost> knownCosts;
+	knownCosts[medium].duration = 100;
+	knownCosts[medium].storageSize = 1000;
+	knownCosts[small].storageSize = 50000;	  // a small file producing a large storage
+
+	const std::vector<FilePath> orderedPaths = utility::orderFilePathsByExpectedDuration(
+		{small, large, medium}, knownCosts);
+
+	REQUIRE(orderedPaths.size() == 3);
+	REQUIRE(orderedPaths[0] == small);
+	REQUIRE(orderedPaths[1] == large);
+	REQUIRE(orderedPaths[2] == medium);
+}
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "FuzzyMatcher.h"
+#include "TestFuzzyMatcherKernels.h"
+
+namespace
+{
+std::vector<size_t> match(const std::wstring& text, const std::wstring& lowerQuery)
+{
+	std::vector<size_t> indices;
+	if (FuzzyMatcher::match(text.data(), text.size(), lowerQuery, 0, 0, &indices) !=
+		lowerQuery.size())
+	{
+		indices.clear();
+	}
+	return indices;
+}
+}	 // namespace
+
+TEST_CASE("fuzzy matcher finds characters case-insensitively with every kernel")
+{
+	const FuzzyMatcher::Kernel defaultKernel = FuzzyMatcher::getKernel();
+
+	// long enough for full blocks of every kernel followed by a remainder
+	const std::wstring text = L"namespace::SomeVeryLongClassName::getValueForKey_Xyz(int, float)";
+
+	for (FuzzyMatcher::Kernel kernel: getSupportedKernels())
+	{
+		FuzzyMatcher::setKernel(kernel);
+
+		REQUIRE(0 == FuzzyMatcher::find(text.data(), text.size(), L'n'));
+		REQUIRE(4 == FuzzyMatcher::find(text.data(), text.size(), L's'));
+		REQUIRE(49 == FuzzyMatcher::find(text.data(), text.size(), L'x'));
+		REQUIRE(text.find(L')') == FuzzyMatcher::find(text.data(), text.size(), L')'));
+		REQUIRE(text.size() == FuzzyMatcher::find(text.data(), text.size(), L'q'));
+		REQUIRE(2 == FuzzyMatcher::find(text.data(), 3, L'm'));
+		REQUIRE(3 == FuzzyMatcher::find(text.data(), 3, L'e'));
+	}
+
+	FuzzyMatcher::setKernel(defaultKernel);
+}
+
+TEST_CASE("fuzzy matcher matches subsequences greedily with every kernel")
+{
+	const FuzzyMatcher::Kernel defaultKernel = FuzzyMatcher::getKernel();
+
+	const std::wstring text = L"namespace::SomeVeryLongClassName::getValueForKey_Xyz(int, float)";
+
+	for (FuzzyMatcher::Kernel kernel: getSupportedKernels())
+	{
+		FuzzyMatcher::setKernel(kernel);
+
+		REQUIRE(std::vector<size_t>({4, 15, 19, 22}) == match(text, L"svlg"));
+		REQUIRE(std::vector<size_t>({49, 50, 51, 52}) == match(text, L"xyz("));
+		REQUIRE(match(text, L"xyzz").empty());
+
+		std::vector<size_t> indices = {1};
+		REQUIRE(3 == FuzzyMatcher::match(text.data() + 40, 10, L"vfk", 1, 40, &indices));
+		REQUIRE(std::vector<size_t>({1, 42, 45}) == indices);
+	}
+
+	FuzzyMatcher::setKernel(defaultKernel);
+}
+
+TEST_CASE("fuzzy matcher handles non-ASCII text with every kernel")
+{
+	const FuzzyMatcher::Kernel defaultKernel = FuzzyMatcher::getKernel();
+
+	const std::wstring text = L"Stra\u00dfenbahnHaltestelle::\u00e4nderung_\u00fcberall_Zielort";
+
+	for (FuzzyMatcher::Kernel kernel: getSupportedKernels())
+	{
+		FuzzyMatcher::setKernel(kernel);
+
+		REQUIRE(4 == FuzzyMatcher::find(text.data(), text.size(), L'\u00df'));
+		REQUIRE(text.find(L'\u00fc') == FuzzyMatcher::find(text.data(), text.size(), L'\u00fc'));
+		REQUIRE(text.find(L'Z') == FuzzyMatcher::find(text.data(), text.size(), L'z'));
+		REQUIRE(std::vector<size_t>({9, text.find(L'Z')}) == match(text, L"hz"));
+	}
+
+	FuzzyMatcher::setKernel(defaultKernel);
+}
@@ -110,3 +110,59 @@ TEST_CASE("HierarchyCache returns inheritance edges for diamond inheritance")
 	REQUIRE(utility::containsElement(inheritanceEdges, TestEdge(1, 3, {2}).toString()));
 	REQUIRE(utility::containsElement(inheritanceEdges, TestEdge(1, 4, {1, 2, 3, 4}).toString()));
 }
+
+TEST_CASE("HierarchyCache returns inheritance edge ids of the inheriting node")
+{
+	// edge ids differ from node ids and the bases have bases of their own
+	HierarchyCache cache;
+	cache.createInheritance(10, 1, 2);
+	cache.createInheritance(11, 1, 3);
+	cache.createInheritance(12, 2, 4);
+	cache.createInheritance(13, 3, 5);
+	std::vector<std::string> inheritanceEdges = getSerializedInheritanceEdges(
+		cache, 1, {2, 3, 4, 5});
+	REQUIRE(inheritanceEdges.size() == 4);
+	REQUIRE(utility::containsElement(inheritanceEdges, TestEdge(1, 2, {10}).toString()));
+	REQUIRE(utility::containsElement(inheritanceEdges, TestEdge(1, 3, {11}).toString()));
+	REQUIRE(utility::containsElement(inheritanceEdges, TestEdge(1, 4, {10, 12}).toString()));
+	REQUIRE(utility::containsElement(inheritanceEdges, TestEdge(1, 5, {11, 13}).toString()));
+}
+
+TEST_CASE("HierarchyCache removes and re-adds inheritance edges incrementally")
+{
+	HierarchyCache cache;
+	cache.createInheritance(1, 1, 2);
+	cache.createInheritance(2, 2, 3);
+
+	cache.removeInheritance(2, 2);
+	REQUIRE(getSerializedInheritanceEdges(cache, 1, {3}).size() == 0);
+
+	cache.addInheritance(5, 2, 3);
+	cache.addInheritance(5, 2, 3);
+	std::vector<std::string> inheritanceEdges = getSerializedInheritanceEdges(cache, 1, {3});
+	REQUIRE(inheritanceEdges.size() == 1);
+	REQUIRE(utility::containsElement(inheritanceEdges, TestEdge(1, 3, {1, 5}).toString()));
+}
+
+TEST_CASE("HierarchyCache moves members to new parent incrementally")
+{
+	HierarchyCache cache;
+	cache.createConnection(10, 1, 2, true, false, false);
+	cache.createConnection(11, 1, 3, true, false, false);
+	REQUIRE(cache.getFirstChildIdsCountForNodeId(1) == 2);
+
+	cache.removeConnection(11, 3);
+	REQUIRE(cache.getFirstChildIdsCountForNodeId(1) == 1);
+	REQUIRE(cache.getLastVisibleParentNodeId(3) == 3);
+
+	cache.addConnection(12, 4, 2);
+	cache.updateNodeFlags(4, false, false);
+	REQUIRE(!cache.nodeHasChildren(1));
+	REQUIRE(cache.nodeHasChildren(4));
+	REQUIRE(!cache.nodeIsVisible(4));
+	REQUIRE(cache.isChildOfVisibleNodeOrInvisible(4));
+
+	cache.updateNodeFlags(1, false, true);
+	REQUIRE(cache.nodeIsVisible(1));
+	REQUIRE(!cache.nodeIsImplicit(1));
+}
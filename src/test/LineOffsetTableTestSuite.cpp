@@ -0,0 +1,54 @@
+#include "catch.hpp"
+
+#include "LineOffsetTable.h"
+#include "TextAccess.h"
+
+TEST_CASE("line offset table maps positions to the lines of text access")
+{
+	const std::string text = "first line\n\nthird line\nlast line without newline";
+	const LineOffsetTable table(text);
+	const std::shared_ptr<TextAccess> textAccess = TextAccess::createFromString(text);
+
+	REQUIRE(textAccess->getLineCount() == table.getLineCount());
+
+	size_t lineStart = 0;
+	for (unsigned int lineNumber = 1; lineNumber <= textAccess->getLineCount(); lineNumber++)
+	{
+		const std::string line = textAccess->getLine(lineNumber);
+		REQUIRE(lineStart == table.getLineStart(lineNumber));
+		for (size_t pos = lineStart; pos < lineStart + line.size(); pos++)
+		{
+			REQUIRE(lineNumber == table.getLineNumber(pos));
+		}
+		lineStart += line.size();
+	}
+
+	REQUIRE(4 == table.getLineNumber(text.size() + 10));
+}
+
+TEST_CASE("line offset table does not start line after final newline")
+{
+	const LineOffsetTable table("a\nb\n");
+
+	REQUIRE(2 == table.getLineCount());
+	REQUIRE(1 == table.getLineNumber(1));
+	REQUIRE(2 == table.getLineNumber(2));
+	REQUIRE(2 == table.getLineNumber(3));
+}
+
+TEST_CASE("line offset table counts utf-8 encoded characters")
+{
+	// 'a', a two and a three byte character, a character outside the BMP and 20 ASCII characters
+	const std::string text = "a\xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80 and some ASCII text";
+
+	REQUIRE(0 == LineOffsetTable::getUtf8CharacterCount(text.data(), 0));
+	REQUIRE(1 == LineOffsetTable::getUtf8CharacterCount(text.data(), 1));
+	REQUIRE(2 == LineOffsetTable::getUtf8CharacterCount(text.data(), 3));
+	REQUIRE(3 == LineOffsetTable::getUtf8CharacterCount(text.data(), 6));
+	const size_t nonBmpLength = sizeof(wchar_t) == 2 ? 2 : 1;
+	REQUIRE(
+		3 + nonBmpLength + 20 == LineOffsetTable::getUtf8CharacterCount(text.data(), text.size()));
+
+	const std::string ascii = "namespace::SomeClass::someMethod()";
+	REQUIRE(ascii.size() == LineOffsetTable::getUtf8CharacterCount(ascii.data(), ascii.size()));
+}
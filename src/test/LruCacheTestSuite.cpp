@@ -0,0 +1,60 @@
+#include "catch.hpp"
+
+#include <string>
+
+#include "LruCache.h"
+
+TEST_CASE("lru cache returns stored values and counts hits and misses")
+{
+	LruCache<int, std::string> cache(2);
+	cache.setValue(1, "one");
+	cache.setValue(2, "two");
+
+	std::string value;
+	REQUIRE(cache.getValue(1, &value));
+	REQUIRE(value == "one");
+	REQUIRE(cache.getValue(2, &value));
+	REQUIRE(value == "two");
+	REQUIRE_FALSE(cache.getValue(3, &value));
+
+	REQUIRE(2 == cache.getSize());
+	REQUIRE(2 == cache.getHitCount());
+	REQUIRE(1 == cache.getMissCount());
+}
+
+TEST_CASE("lru cache drops least recently used value when full")
+{
+	LruCache<int, std::string> cache(2);
+	cache.setValue(1, "one");
+	cache.setValue(2, "two");
+
+	std::string value;
+	REQUIRE(cache.getValue(1, &value));
+
+	cache.setValue(3, "three");
+
+	REQUIRE(2 == cache.getSize());
+	REQUIRE(cache.getValue(1, &value));
+	REQUIRE_FALSE(cache.getValue(2, &value));
+	REQUIRE(cache.getValue(3, &value));
+	REQUIRE(value == "three");
+}
+
+TEST_CASE("lru cache replaces value of stored key")
+{
+	LruCache<int, std::string> cache(2);
+	cache.setValue(1, "one");
+	cache.setValue(2, "two");
+	cache.setValue(1, "uno");
+	cache.setValue(3, "three");
+
+	std::string value;
+	REQUIRE(cache.getValue(1, &value));
+	REQUIRE(value == "uno");
+	REQUIRE_FALSE(cache.getValue(2, &value));
+
+	cache.clear();
+	REQUIRE(0 == cache.getSize());
+	REQUIRE(0 == cache.getHitCount());
+	REQUIRE_FALSE(cache.getValue(1, &value));
+}
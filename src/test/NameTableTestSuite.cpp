@@ -0,0 +1,98 @@
+#include "catch.hpp"
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "NameHierarchy.h"
+#include "NameTable.h"
+#include "utilityString.h"
+
+namespace
+{
+std::vector<std::pair<Id, std::string>> getTestNames(size_t count)
+{
+	std::vector<std::pair<Id, std::string>> names;
+	for (size_t i = 0; i < count; i++)
+	{
+		NameHierarchy name(NAME_DELIMITER_CXX);
+		name.push(L"app");
+		name.push(L"Class" + std::to_wstring(i % 7));
+		name.push(NameElement(L"method" + std::to_wstring(i), L"void", L"() const"));
+
+		// leave gaps between the ids
+		names.emplace_back(i * 3 + 5, utility::encodeToUtf8(NameHierarchy::serialize(name)));
+	}
+	return names;
+}
+}	 // namespace
+
+TEST_CASE("name table finds saved names of all ids")
+{
+	const FilePath tablePath(L"data/NameTableTestSuite/names.idx");
+	FileSystem::createDirectory(tablePath.getParentDirectory());
+
+	const std::vector<std::pair<Id, std::string>> names = getTestNames(100);
+	REQUIRE(NameTable::save(names, tablePath, "revision"));
+
+	NameTable table;
+	REQUIRE(table.load(tablePath, "revision"));
+	REQUIRE(100 == table.getNameCount());
+
+	std::string buffer;
+	for (const std::pair<Id, std::string>& p: names)
+	{
+		REQUIRE(p.second == table.getSerializedName(p.first, &buffer));
+	}
+
+	REQUIRE(table.getSerializedName(0, &buffer).empty());
+	REQUIRE(table.getSerializedName(6, &buffer).empty());
+	REQUIRE(table.getSerializedName(1000, &buffer).empty());
+
+	table.clear();
+	FileSystem::remove(tablePath);
+	FileSystem::remove(tablePath.getParentDirectory());
+}
+
+TEST_CASE("name table keeps non-ascii names and deserializes them")
+{
+	const FilePath tablePath(L"data/NameTableTestSuite/names.idx");
+	FileSystem::createDirectory(tablePath.getParentDirectory());
+
+	NameHierarchy name(NAME_DELIMITER_JAVA);
+	name.push(L"pak\u00e9t");
+	name.push(NameElement(L"gr\u00fc\u00dfe", L"void", L"(int)"));
+
+	REQUIRE(NameTable::save(
+		{{1, utility::encodeToUtf8(NameHierarchy::serialize(name))}, {2, "::\tm"}},
+		tablePath,
+		"revision"));
+
+	NameTable table;
+	REQUIRE(table.load(tablePath, "revision"));
+
+	const NameHierarchy loadedName = NameHierarchy::deserialize(table.getSerializedName(1));
+	REQUIRE(
+		loadedName.getQualifiedNameWithSignature() == name.getQualifiedNameWithSignature());
+	REQUIRE(table.getSerializedName(2) == L"::\tm");
+
+	table.clear();
+	FileSystem::remove(tablePath);
+	FileSystem::remove(tablePath.getParentDirectory());
+}
+
+TEST_CASE("name table does not load table saved for other revision")
+{
+	const FilePath tablePath(L"data/NameTableTestSuite/names.idx");
+	FileSystem::createDirectory(tablePath.getParentDirectory());
+
+	REQUIRE(NameTable::save(getTestNames(3), tablePath, "revision"));
+
+	NameTable table;
+	REQUIRE_FALSE(table.load(tablePath, "other"));
+	REQUIRE_FALSE(table.isLoaded());
+	REQUIRE(table.getSerializedName(5).empty());
+
+	REQUIRE_FALSE(table.load(FilePath(L"data/NameTableTestSuite/missing.idx"), "revision"));
+
+	FileSystem::remove(tablePath);
+	FileSystem::remove(tablePath.getParentDirectory());
+}
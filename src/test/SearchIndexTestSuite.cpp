@@ -2,6 +2,7 @@
 
 #include "NameHierarchy.h"
 #include "SearchIndex.h"
+#include "TestSearchIndexElements.h"
 #include "utility.h"
 
 TEST_CASE("search index finds id of element added")
@@ -91,3 +92,150 @@ TEST_CASE("search index rates higher on consecutive letters")
 	REQUIRE(L"ocbcabc" == results[0].text);
 	REQUIRE(L"oaabbcc" == results[1].text);
 }
+
+TEST_CASE("search index finds elements inserted after setup")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo");
+	index.finishSetup();
+	index.insertNode(2, L"fobar");
+	index.insertNode(3, L"xyz");
+	std::vector<SearchResult> results = index.search(L"fbr", NodeTypeSet::all(), 0);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 2));
+
+	results = index.search(L"yz", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 3));
+}
+
+TEST_CASE("search index does not find removed elements")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo");
+	index.addNode(2, L"fob");
+	index.finishSetup();
+	index.removeNode(1);
+	index.insertNode(2, L"bar");
+	std::vector<SearchResult> results = index.search(L"fo", NodeTypeSet::all(), 0);
+
+	REQUIRE(0 == results.size());
+	REQUIRE(2 == index.getRemovedElementCount());
+
+	results = index.search(L"bar", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 2));
+}
+
+TEST_CASE("search index does not count elements inserted again under the same name as removed")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo");
+	index.addNode(2, L"fob");
+	index.finishSetup();
+	index.insertNode(1, L"foo");
+	index.insertNode(2, L"fob");
+
+	REQUIRE(0 == index.getRemovedElementCount());
+
+	std::vector<SearchResult> results = index.search(L"foo", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 1));
+}
+
+TEST_CASE("search index keeps remaining elements when compacted")
+{
+	SearchIndex index;
+	for (Id id = 1; id <= 4000; id++)
+	{
+		index.addNode(id, (id <= 2000 ? L"old" : L"new") + std::to_wstring(id));
+	}
+	index.finishSetup();
+	for (Id id = 1; id <= 2000; id++)
+	{
+		index.removeNode(id);
+	}
+	REQUIRE(index.needsCompaction());
+
+	std::shared_ptr<SearchIndex> compacted = index.createCompactedIndex();
+	REQUIRE(!compacted->needsCompaction());
+	REQUIRE(compacted->search(L"old", NodeTypeSet::all(), 0).size() == 0);
+
+	std::vector<SearchResult> results = compacted->search(L"new3999", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 3999));
+}
+
+TEST_CASE("search index built in parallel finds same results as sequentially built index")
+{
+	std::vector<SearchIndex::Element> elements = getTestSearchIndexElements(3000);
+	elements.emplace_back(elements.size() + 1, L"", NodeType(NODE_CLASS));
+
+	SearchIndex sequentialIndex;
+	for (const SearchIndex::Element& element: elements)
+	{
+		sequentialIndex.addNode(element.id, element.name, element.type);
+	}
+	sequentialIndex.finishSetup();
+
+	SearchIndex parallelIndex;
+	parallelIndex.build(elements, 4);
+
+	for (const std::wstring& query: {L"std", L"cls12", L"bmeth", L"method2999", L"qtc9"})
+	{
+		std::vector<SearchResult> sequentialResults =
+			sequentialIndex.search(query, NodeTypeSet::all(), 0);
+		std::vector<SearchResult> parallelResults = parallelIndex.search(query, NodeTypeSet::all(), 0);
+
+		REQUIRE(sequentialResults.size() == parallelResults.size());
+
+		std::set<std::wstring> sequentialTexts;
+		std::set<std::wstring> parallelTexts;
+		for (size_t i = 0; i < sequentialResults.size(); i++)
+		{
+			sequentialTexts.insert(sequentialResults[i].text);
+			parallelTexts.insert(parallelResults[i].text);
+		}
+		REQUIRE(sequentialTexts == parallelTexts);
+	}
+
+	parallelIndex.removeNode(1);
+	parallelIndex.insertNode(1, L"app::Renamed", NodeType(NODE_CLASS));
+	REQUIRE(parallelIndex.search(L"renamed", NodeTypeSet::all(), 0).size() == 1);
+
+	// the element without name is held by the root node
+	parallelIndex.insertNode(elements.back().id, L"app::Unnamed", NodeType(NODE_CLASS));
+	REQUIRE(parallelIndex.search(L"unnamed", NodeTypeSet::all(), 0).size() == 1);
+}
+
+TEST_CASE("search index refining cached queries finds same results as searching from scratch")
+{
+	SearchIndex index;
+	index.build(getTestSearchIndexElements(3000), 4);
+
+	SearchIndex::SearchCache cache;
+	for (const std::wstring& query:
+		 {L"c", L"cl", L"cls1", L"cls12", L"cls1", L"cls1m", L"Cls1Meth", L"x", L"xy"})
+	{
+		std::vector<SearchResult> freshResults = index.search(query, NodeTypeSet::all(), 20, 100);
+		std::vector<SearchResult> cachedResults =
+			index.search(query, NodeTypeSet::all(), 20, 100, &cache);
+
+		REQUIRE(freshResults.size() == cachedResults.size());
+		for (size_t i = 0; i < freshResults.size(); i++)
+		{
+			REQUIRE(freshResults[i].text == cachedResults[i].text);
+			REQUIRE(freshResults[i].indices == cachedResults[i].indices);
+			REQUIRE(freshResults[i].score == cachedResults[i].score);
+		}
+	}
+
+	const NodeTypeSet classTypes = NodeType(NODE_CLASS);
+	REQUIRE(
+		index.search(L"cls12", classTypes, 0).size() ==
+		index.search(L"cls12", classTypes, 0, 0, &cache).size());
+
+	cache.clear();
+	REQUIRE(index.search(L"method42", NodeTypeSet::all(), 1, 0, &cache).size() == 1);
+}
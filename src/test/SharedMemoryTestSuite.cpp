@@ -3,6 +3,10 @@
 #include <memory>
 #include <thread>
 
+#include "FlatIntermediateStorage.h"
+#include "IntermediateStorage.h"
+#include "InterprocessIndexingStatusManager.h"
+#include "InterprocessIntermediateStorageManager.h"
 #include "SharedMemory.h"
 
 TEST_CASE("shared memory")
@@ -96,3 +100,134 @@ TEST_CASE("shared memory")
 		}
 	}
 }
+
+TEST_CASE("indexing status manager shares indexed files per preprocessor context")
+{
+	InterprocessIndexingStatusManager owner("test_uuid", 0, true);
+	InterprocessIndexingStatusManager indexer("test_uuid", 1, false);
+
+	indexer.addIndexedFilePaths(
+		"context_a", {FilePath(L"/project/a.h"), FilePath(L"/project/include/b.h")});
+	indexer.addIndexedFilePaths("context_b", {FilePath(L"/project/c.h")});
+
+	const std::set<FilePath> filesA = owner.getIndexedFilePaths("context_a");
+	REQUIRE(filesA.size() == 2);
+	REQUIRE(filesA.find(FilePath(L"/project/a.h")) != filesA.end());
+	REQUIRE(filesA.find(FilePath(L"/project/include/b.h")) != filesA.end());
+
+	const std::set<FilePath> filesB = owner.getIndexedFilePaths("context_b");
+	REQUIRE(filesB.size() == 1);
+	REQUIRE(filesB.find(FilePath(L"/project/c.h")) != filesB.end());
+
+	REQUIRE(owner.getIndexedFilePaths("context").empty());
+	REQUIRE(owner.getIndexedFilePaths("").empty());
+}
+
+TEST_CASE("intermediate storage manager transfers storages between processes")
+{
+	InterprocessIntermediateStorageManager owner("test_uuid", 1, true);
+	InterprocessIntermediateStorageManager indexer("test_uuid", 1, false);
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	storage->setStorageNodes({StorageNode(1, 2, L"node\tname"), StorageNode(2, 3, L"")});
+	storage->setStorageFiles({StorageFile(3, L"/project/a.cpp", L"C++", "2020-01-01 12:00:00", true, false)});
+	storage->setStorageSymbols({StorageSymbol(1, 4)});
+	storage->setStorageEdges({StorageEdge(4, 8, 1, 2)});
+	storage->setStorageLocalSymbols({StorageLocalSymbol(5, L"local")});
+	storage->setStorageSourceLocations({StorageSourceLocation(6, 3, 1, 2, 3, 4, 1)});
+	storage->setStorageOccurrences({StorageOccurrence(1, 6), StorageOccurrence(2, 6)});
+	storage->setComponentAccesses({StorageComponentAccess(1, 2)});
+	storage->setErrors({StorageError(7, L"error", L"/project/a.cpp", true, false)});
+	storage->setNextId(8);
+
+	indexer.pushIntermediateStorage(storage);
+	indexer.pushIntermediateStorage(std::make_shared<IntermediateStorage>());
+	REQUIRE(owner.getIntermediateStorageCount() == 2);
+
+	std::shared_ptr<FlatIntermediateStorage> result = owner.popIntermediateStorage();
+	REQUIRE(result);
+	REQUIRE(owner.getIntermediateStorageCount() == 1);
+
+	REQUIRE(result->getStorageNodes().size() == 2);
+	REQUIRE(result->getStorageNodes()[0].id == 1);
+	REQUIRE(result->getStorageNodes()[0].type == 2);
+	REQUIRE(result->getStorageNodes()[0].serializedName == L"node\tname");
+	REQUIRE(result->getStorageNodes()[1].serializedName.empty());
+
+	REQUIRE(result->getStorageFiles().size() == 1);
+	REQUIRE(result->getStorageFiles()[0].filePath == L"/project/a.cpp");
+	REQUIRE(result->getStorageFiles()[0].languageIdentifier == L"C++");
+	REQUIRE(result->getStorageFiles()[0].modificationTime == "2020-01-01 12:00:00");
+	REQUIRE(result->getStorageFiles()[0].indexed);
+	REQUIRE(!result->getStorageFiles()[0].complete);
+
+	REQUIRE(result->getStorageSymbols().size() == 1);
+	REQUIRE(result->getStorageSymbols()[0].definitionKind == 4);
+
+	REQUIRE(result->getStorageEdges().size() == 1);
+	REQUIRE(result->getStorageEdges()[0].type == 8);
+	REQUIRE(result->getStorageEdges()[0].sourceNodeId == 1);
+	REQUIRE(result->getStorageEdges()[0].targetNodeId == 2);
+
+	REQUIRE(result->getStorageLocalSymbols().size() == 1);
+	REQUIRE(result->getStorageLocalSymbols().begin()->name == L"local");
+
+	REQUIRE(result->getStorageSourceLocations().size() == 1);
+	REQUIRE(result->getStorageSourceLocations().begin()->endCol == 4);
+
+	REQUIRE(result->getStorageOccurrences().size() == 2);
+	REQUIRE(result->getComponentAccesses().size() == 1);
+
+	REQUIRE(result->getErrors().size() == 1);
+	REQUIRE(result->getErrors()[0].message == L"error");
+	REQUIRE(result->getErrors()[0].fatal);
+	REQUIRE(!result->getErrors()[0].indexed);
+
+	REQUIRE(result->getNextId() == 8);
+
+	std::shared_ptr<FlatIntermediateStorage> empty = owner.popIntermediateStorage();
+	REQUIRE(empty);
+	REQUIRE(empty->getStorageNodes().empty());
+	REQUIRE(owner.getIntermediateStorageCount() == 0);
+	REQUIRE(!owner.popIntermediateStorage());
+}
+
+TEST_CASE("intermediate storage injects storage popped from shared memory")
+{
+	InterprocessIntermediateStorageManager owner("test_uuid", 2, true);
+	InterprocessIntermediateStorageManager indexer("test_uuid", 2, false);
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	storage->setStorageNodes(
+		{StorageNode(1, 2, L"a"), StorageNode(2, 2, L"b"), StorageNode(3, 3, L"/project/a.cpp")});
+	storage->setStorageFiles({StorageFile(3, L"/project/a.cpp", L"C++", "", true, true)});
+	storage->setStorageEdges({StorageEdge(4, 8, 1, 2)});
+	storage->setStorageSourceLocations({StorageSourceLocation(5, 3, 1, 2, 3, 4, 1)});
+	storage->setStorageOccurrences({StorageOccurrence(4, 5)});
+	indexer.pushIntermediateStorage(storage);
+
+	IntermediateStorage target;
+	const Id existingNodeId = target.addNode(StorageNodeData(2, L"b")).first;
+
+	std::shared_ptr<FlatIntermediateStorage> flatStorage = owner.popIntermediateStorage();
+	REQUIRE(flatStorage);
+	target.inject(*flatStorage);
+
+	REQUIRE(target.getStorageNodes().size() == 3);
+	REQUIRE(target.getStorageFiles().size() == 1);
+	REQUIRE(target.getStorageEdges().size() == 1);
+
+	const StorageEdge& edge = target.getStorageEdges()[0];
+	REQUIRE(edge.sourceNodeId != existingNodeId);
+	REQUIRE(edge.targetNodeId == existingNodeId);
+
+	REQUIRE(target.getStorageSourceLocations().size() == 1);
+	REQUIRE(
+		target.getStorageSourceLocations().begin()->fileNodeId == target.getStorageFiles()[0].id);
+
+	REQUIRE(target.getStorageOccurrences().size() == 1);
+	REQUIRE(target.getStorageOccurrences().begin()->elementId == edge.id);
+	REQUIRE(
+		target.getStorageOccurrences().begin()->sourceLocationId ==
+		target.getStorageSourceLocations().begin()->id);
+}
@@ -1,5 +1,8 @@
 #include "catch.hpp"
 
+#include <algorithm>
+
+#include "Edge.h"
 #include "FileSystem.h"
 #include "SqliteIndexStorage.h"
 
@@ -76,3 +79,148 @@ TEST_CASE("storage removes edge successfully")
 
 	REQUIRE(0 == edgeCount);
 }
+
+TEST_CASE("storage assigns consecutive element ids when adding in write mode")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<Id> nodeIds;
+	std::vector<Id> edgeIds;
+	int nodeCount = -1;
+	int edgeCount = -1;
+	size_t insertedRowCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage.beginTransaction();
+		Id errorId = storage.addError(StorageErrorData(L"error", L"a.cpp", false, true)).id;
+		nodeIds = storage.addNodes(
+			{StorageNode(0, 0, L"a"), StorageNode(0, 0, L"b"), StorageNode(0, 0, L"a")});
+		edgeIds = storage.addEdges(
+			{StorageEdge(0, 0, nodeIds[0], nodeIds[1]), StorageEdge(0, 0, nodeIds[1], nodeIds[0])});
+		storage.commitTransaction();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+		const std::vector<StorageError> errors = storage.getAll<StorageError>();
+		REQUIRE(errors.size() == 1);
+		REQUIRE(errors[0].id == errorId);
+		nodeCount = storage.getNodeCount();
+		edgeCount = storage.getEdgeCount();
+		insertedRowCount = storage.getInsertedRowCount();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(2 == nodeCount);
+	REQUIRE(2 == edgeCount);
+	REQUIRE(nodeIds.size() == 3);
+	REQUIRE(nodeIds[1] == nodeIds[0] + 1);
+	REQUIRE(nodeIds[2] == nodeIds[0]);
+	REQUIRE(edgeIds.size() == 2);
+	REQUIRE(edgeIds[0] == nodeIds[1] + 1);
+	REQUIRE(edgeIds[1] == edgeIds[0] + 1);
+	REQUIRE(errorId != nodeIds[0]);
+	REQUIRE(errorId != nodeIds[1]);
+	REQUIRE(errorId != edgeIds[0]);
+	REQUIRE(errorId != edgeIds[1]);
+	REQUIRE(insertedRowCount == 9);	   // elements, nodes and edges
+}
+
+TEST_CASE("storage records hierarchy changes after recording has been started")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	bool wasRecording = true;
+	std::vector<StorageHierarchyChange> changes;
+	Id memberEdgeId = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		wasRecording = storage.isRecordingHierarchyChanges();
+
+		const Id aId = storage.addNode(StorageNodeData(0, L"a"));
+		const Id bId = storage.addNode(StorageNodeData(0, L"b"));
+		storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), aId, bId));
+
+		storage.resetHierarchyChanges();
+
+		const Id cId = storage.addNode(StorageNodeData(0, L"c"));
+		memberEdgeId = storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), aId, cId));
+		storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_CALL), aId, cId));
+		storage.removeElement(bId);
+
+		changes = storage.getAll<StorageHierarchyChange>();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(!wasRecording);
+	REQUIRE(changes.size() == 3);
+	REQUIRE(changes[0].elementId == memberEdgeId);
+	REQUIRE(!changes[0].removed);
+	REQUIRE(changes[1].edgeType == Edge::typeToInt(Edge::EDGE_MEMBER));
+	REQUIRE(changes[1].removed);
+	REQUIRE(changes[2].edgeType == 0);
+	REQUIRE(changes[2].removed);
+}
+
+TEST_CASE("storage finds nodes by serialized names across several statements")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<Id> nodeIds;
+	std::vector<StorageNode> nodes;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		std::vector<std::wstring> serializedNames;
+		for (size_t i = 0; i < 1200; i++)
+		{
+			serializedNames.push_back(L"node_" + std::to_wstring(i));
+			nodeIds.push_back(storage.addNode(StorageNodeData(0, serializedNames.back())));
+		}
+		storage.commitTransaction();
+
+		serializedNames.push_back(L"missing");
+		nodes = storage.getNodesBySerializedNames(serializedNames);
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(nodes.size() == 1200);
+
+	std::sort(nodes.begin(), nodes.end(), [](const StorageNode& a, const StorageNode& b) {
+		return a.id < b.id;
+	});
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		REQUIRE(nodes[i].id == nodeIds[i]);
+		REQUIRE(nodes[i].serializedName == L"node_" + std::to_wstring(i));
+	}
+}
+
+TEST_CASE("storage finds node types by ids across several statements")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<Id> nodeIds;
+	std::vector<std::pair<Id, int>> nodeTypes;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		for (size_t i = 0; i < 1200; i++)
+		{
+			nodeIds.push_back(storage.addNode(
+				StorageNodeData(static_cast<int>(i % 3), L"node_" + std::to_wstring(i))));
+		}
+		storage.commitTransaction();
+
+		std::vector<Id> requestedIds(nodeIds.rbegin(), nodeIds.rend());
+		requestedIds.push_back(nodeIds.back() + 1000);
+		nodeTypes = storage.getNodeTypesByIds(requestedIds);
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(nodeTypes.size() == 1200);
+	for (size_t i = 0; i < nodeTypes.size(); i++)
+	{
+		REQUIRE(nodeTypes[i].first == nodeIds[i]);
+		REQUIRE(nodeTypes[i].second == static_cast<int>(i % 3));
+	}
+}
@@ -1,10 +1,18 @@
 #include "catch.hpp"
 
+#include <fstream>
+
+#include "utilityApp.h"
 #include "utilityString.h"
 
+#include "FileSystem.h"
+#include "FullTextSearchQuery.h"
 #include "IntermediateStorage.h"
 #include "ParseLocation.h"
 #include "PersistentStorage.h"
+#include "SourceLocation.h"
+#include "SourceLocationCollection.h"
+#include "TaskMergeStorages.h"
 
 namespace
 {
@@ -283,3 +291,93 @@ TEST_CASE("storage finds and removes depending file nodes")
 	// TS_ASSERT(!storage.getEdgeWithId(id4));
 	// TS_ASSERT(!storage.getEdgeWithId(id5));
 }
+
+TEST_CASE("storage merge combines storages in parallel and removes duplicates")
+{
+	std::vector<std::shared_ptr<IntermediateStorage>> storages;
+	for (size_t i = 0; i < 7; i++)
+	{
+		std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+		const Id sharedId = storage->addNode(StorageNodeData(1, L"shared")).first;
+		const Id ownId = storage->addNode(StorageNodeData(1, L"own" + std::to_wstring(i))).first;
+		storage->addEdge(StorageEdgeData(2, ownId, sharedId));
+		const Id fileId = storage->addNode(StorageNodeData(3, L"file.cpp")).first;
+		const Id locationId =
+			storage->addSourceLocation(StorageSourceLocationData(fileId, 1, 1, 1, 6, 1));
+		storage->addOccurrence(StorageOccurrence(sharedId, locationId));
+		storages.push_back(storage);
+	}
+
+	std::shared_ptr<IntermediateStorage> merged = TaskMergeStorages::mergeStorages(storages, 3);
+
+	REQUIRE(merged);
+	REQUIRE(merged->getStorageNodes().size() == 9);
+	REQUIRE(merged->getStorageEdges().size() == 7);
+	REQUIRE(merged->getStorageSourceLocations().size() == 1);
+	REQUIRE(merged->getStorageOccurrences().size() == 1);
+
+	REQUIRE(!TaskMergeStorages::mergeStorages({}, 3));
+}
+
+TEST_CASE("storage streams fulltext search hits of several batches with consecutive location ids")
+{
+	const FilePath directoryPath(L"data/StorageTestSuite/");
+	FileSystem::createDirectory(directoryPath);
+
+	std::set<Id> locationIds;
+	size_t batchCount = 0;
+	size_t reportedHitCount = 0;
+
+	// enough files for several batches of the search, independent of the thread count
+	const size_t fileCount = 40 * static_cast<size_t>(std::max(utility::getIdealThreadCount(), 1));
+	{
+		TestStorage storage;
+
+		std::shared_ptr<IntermediateStorage> intermediateStorage =
+			std::make_shared<IntermediateStorage>();
+		for (size_t i = 0; i < fileCount; i++)
+		{
+			const FilePath filePath = directoryPath.getConcatenated(
+				L"file_" + std::to_wstring(i) + L".cpp");
+			{
+				std::ofstream file;
+				file.open(filePath.str());
+				file << "int needle = 0;\n";
+				file.close();
+			}
+
+			const Id id = intermediateStorage
+							  ->addNode(StorageNodeData(
+								  nodeKindToInt(NODE_FILE),
+								  NameHierarchy::serialize(
+									  NameHierarchy(filePath.wstr(), NAME_DELIMITER_FILE))))
+							  .first;
+			intermediateStorage->addFile(
+				StorageFile(id, filePath.wstr(), L"cpp", "someTime", true, true));
+		}
+		storage.inject(intermediateStorage.get());
+
+		// counts the reported hits in the query it passes, like the code view does
+		FullTextSearchQuery query(L"needle", true);
+		storage.getFullTextSearchLocations(
+			query, [&](std::shared_ptr<SourceLocationCollection> collection) {
+				collection->forEachSourceLocation([&](SourceLocation* location) {
+					locationIds.insert(location->getLocationId());
+				});
+				query.reportedHitCount += collection->getSourceLocationCount();
+				batchCount++;
+			});
+		reportedHitCount = query.reportedHitCount;
+	}
+	FileSystem::remove(FilePath(L"data/fulltext.idx"));
+	for (size_t i = 0; i < fileCount; i++)
+	{
+		FileSystem::remove(directoryPath.getConcatenated(L"file_" + std::to_wstring(i) + L".cpp"));
+	}
+	FileSystem::remove(directoryPath);
+
+	REQUIRE(batchCount > 1);
+	REQUIRE(reportedHitCount == fileCount);
+	REQUIRE(locationIds.size() == fileCount);
+	REQUIRE(*locationIds.rbegin() - *locationIds.begin() == fileCount - 1);
+}
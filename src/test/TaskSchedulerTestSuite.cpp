@@ -5,9 +5,12 @@
 
 #include "Blackboard.h"
 #include "Task.h"
+#include "TaskDecoratorRepeat.h"
 #include "TaskGroupSelector.h"
 #include "TaskGroupSequence.h"
+#include "TaskReturnSuccessIf.h"
 #include "TaskScheduler.h"
+#include "TimeStamp.h"
 
 namespace
 {
@@ -281,3 +284,42 @@ TEST_CASE("task scheduling within task processing")
 	REQUIRE(5 == task->subTask->updateCallOrder);
 	REQUIRE(6 == task->subTask->exitCallOrder);
 }
+
+TEST_CASE("blackboard wait returns when values changed since update count was taken")
+{
+	Blackboard blackboard;
+	const size_t updateCount = blackboard.getUpdateCount();
+
+	REQUIRE(!blackboard.waitForUpdate(updateCount, 1));
+
+	blackboard.set<bool>("flag", true);
+	REQUIRE(blackboard.waitForUpdate(updateCount, 10000));
+	REQUIRE(!blackboard.waitForUpdate(blackboard.getUpdateCount(), 1));
+
+	blackboard.notifyUpdate();
+	REQUIRE(blackboard.getUpdateCount() == updateCount + 2);
+}
+
+TEST_CASE("repeat decorator wakes up when blackboard value changes")
+{
+	std::shared_ptr<Blackboard> blackboard = std::make_shared<Blackboard>();
+	blackboard->set<bool>("started", false);
+
+	std::shared_ptr<Task> task =
+		std::make_shared<TaskDecoratorRepeat>(
+			TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 10000)
+			->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
+				"started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false));
+
+	std::thread thread([blackboard]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		blackboard->set<bool>("started", true);
+	});
+
+	const TimeStamp start = TimeStamp::now();
+	while (task->update(blackboard) == Task::STATE_RUNNING)
+		;
+	thread.join();
+
+	REQUIRE(TimeStamp::now().deltaMS(start) < 5000);
+}
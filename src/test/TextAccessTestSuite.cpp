@@ -1,5 +1,6 @@
 #include "catch.hpp"
 
+#include "ContentHash.h"
 #include "TextAccess.h"
 
 namespace
@@ -148,3 +149,38 @@ TEST_CASE("textAccessFile get filePath")
 
 	REQUIRE(textAccess->getFilePath() == filePath);
 }
+
+TEST_CASE("content hash ignores line ending style")
+{
+	const std::string hash = ContentHash::hashText("first line\nsecond line\n");
+
+	REQUIRE(hash.size() == 16);
+	REQUIRE(ContentHash::hashText("first line\r\nsecond line\r\n") == hash);
+	REQUIRE(ContentHash::hashText("first line\rsecond line\r") == hash);
+	REQUIRE(ContentHash::hashText("first line\nsecond line") == hash);
+	REQUIRE(ContentHash::hashText("first line\nsecond line.\n") != hash);
+}
+
+TEST_CASE("content hash of file matches hash of its text access content")
+{
+	FilePath filePath(L"data/TextAccessTestSuite/text.txt");
+	std::shared_ptr<TextAccess> textAccess = TextAccess::createFromFile(filePath);
+
+	REQUIRE(ContentHash::hashFile(filePath) == ContentHash::hashText(textAccess->getText()));
+	REQUIRE(
+		ContentHash::hashText(getTestText()) ==
+		ContentHash::hashText(TextAccess::createFromString(getTestText())->getText()));
+}
+
+TEST_CASE("content hash of empty text is not empty")
+{
+	const std::string hash = ContentHash::hashText("");
+
+	REQUIRE(hash.size() == 16);
+	REQUIRE(hash != ContentHash::hashText("\n"));
+}
+
+TEST_CASE("content hash of missing file is empty")
+{
+	REQUIRE(ContentHash::hashFile(FilePath(L"data/TextAccessTestSuite/missing.txt")).empty());
+}
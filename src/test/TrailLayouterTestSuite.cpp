@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include "TestTrail.h"
+
+TEST_CASE("trail layouter places nodes in columns of their longest path from the root")
+{
+	TestTrail trail;
+	trail.addNode(1, true);
+	trail.addNode(2);
+	trail.addNode(3);
+	trail.addNode(4);
+	trail.addEdge(11, 1, 2);
+	trail.addEdge(12, 2, 3);
+	trail.addEdge(13, 1, 3);
+	trail.addEdge(14, 1, 4);
+
+	trail.layout();
+
+	REQUIRE(trail.getNode(1)->position.x < trail.getNode(2)->position.x);
+	REQUIRE(trail.getNode(2)->position.x < trail.getNode(3)->position.x);
+	REQUIRE(trail.getNode(2)->position.x == trail.getNode(4)->position.x);
+
+	// the edge skipping a column gets routed through a virtual node in between
+	REQUIRE(trail.getEdge(12)->path.empty());
+	REQUIRE(1 == trail.getEdge(13)->path.size());
+	REQUIRE(trail.getEdge(13)->path[0].x() == trail.getNode(2)->position.x);
+}
+
+TEST_CASE("trail layouter breaks cycles and hides unconnected nodes")
+{
+	TestTrail trail;
+	trail.addNode(1);
+	trail.addNode(2, true);
+	trail.addNode(3);
+	trail.addNode(4);
+	trail.addNode(5);
+	trail.addEdge(11, 2, 3);
+	trail.addEdge(12, 3, 1);
+	trail.addEdge(13, 1, 2);
+	trail.addEdge(14, 3, 4);
+
+	trail.layout(TrailLayouter::LAYOUT_TOP_BOTTOM);
+
+	REQUIRE(trail.getNode(2)->position.y < trail.getNode(3)->position.y);
+	REQUIRE(trail.getNode(3)->position.y < trail.getNode(1)->position.y);
+	REQUIRE(trail.getNode(3)->position.y < trail.getNode(4)->position.y);
+	REQUIRE(trail.getNode(1)->visible);
+	REQUIRE_FALSE(trail.getNode(5)->visible);
+}
+
+TEST_CASE("trail layouter orders nodes to avoid edge crossings")
+{
+	TestTrail trail;
+	trail.addNode(1, true);
+	for (Id id = 2; id <= 7; id++)
+	{
+		trail.addNode(id);
+	}
+	trail.addEdge(11, 1, 2);
+	trail.addEdge(12, 1, 3);
+	trail.addEdge(13, 1, 4);
+	trail.addEdge(14, 4, 5);
+	trail.addEdge(15, 3, 6);
+	trail.addEdge(16, 2, 7);
+
+	trail.layout();
+
+	const int y2 = trail.getNode(2)->position.y;
+	const int y3 = trail.getNode(3)->position.y;
+	const int y4 = trail.getNode(4)->position.y;
+	const int y5 = trail.getNode(5)->position.y;
+	const int y6 = trail.getNode(6)->position.y;
+	const int y7 = trail.getNode(7)->position.y;
+
+	REQUIRE((y2 < y3) == (y7 < y6));
+	REQUIRE((y3 < y4) == (y6 < y5));
+	REQUIRE((y2 < y4) == (y7 < y5));
+}
+
+TEST_CASE("trail layouter leaves nodes unchanged when cancelled")
+{
+	for (size_t checkCount: {1, 2, 3, 4})
+	{
+		TestTrail trail;
+		trail.addNode(1, true);
+		trail.addNode(2);
+		trail.addNode(3);
+		trail.addEdge(11, 1, 2);
+
+		size_t calls = 0;
+		trail.layout(TrailLayouter::LAYOUT_LEFT_RIGHT, [&calls, checkCount]() {
+			return ++calls >= checkCount;
+		});
+
+		REQUIRE(checkCount == calls);
+		REQUIRE(trail.getNode(1)->position == trail.getNode(2)->position);
+		REQUIRE(trail.getNode(3)->visible);
+	}
+}
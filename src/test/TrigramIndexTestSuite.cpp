@@ -0,0 +1,312 @@
+#include "catch.hpp"
+
+#include <map>
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "TrigramIndex.h"
+#include "utility.h"
+
+namespace
+{
+std::map<Id, std::string> getTestFiles()
+{
+	return {
+		{1, "class FooManagerImpl\n{\n\tvoid run();\n};\n"},
+		{2, "int managerCount = 0;\nint getManagerId();\n"},
+		{3, "void foo()\n{\n\tbar();\n}\n"}};
+}
+
+std::vector<FullTextSearchResult> search(
+	const TrigramIndex& index,
+	const std::map<Id, std::string>& files,
+	const std::string& term,
+	bool caseSensitive,
+	bool isRegex)
+{
+	return index.search(
+		term, caseSensitive, isRegex, [&files](Id fileId) { return files.at(fileId); }, 2);
+}
+
+void addFiles(TrigramIndex& index, const std::map<Id, std::string>& files)
+{
+	for (const auto& p: files)
+	{
+		index.addFile(p.first, p.second);
+	}
+	index.finishSetup();
+}
+}	 // namespace
+
+TEST_CASE("trigram index finds substrings inside identifiers")
+{
+	const std::map<Id, std::string> files = getTestFiles();
+	TrigramIndex index;
+	addFiles(index, files);
+
+	std::vector<FullTextSearchResult> results = search(index, files, "Manager", true, false);
+
+	REQUIRE(2 == results.size());
+	REQUIRE(1 == results[0].fileId);
+	REQUIRE(1 == results[0].positions.size());
+	REQUIRE(9 == results[0].positions[0]);
+	REQUIRE(7 == results[0].termLens[0]);
+	REQUIRE(2 == results[1].fileId);
+	REQUIRE(1 == results[1].positions.size());
+	REQUIRE(files.at(2).substr(results[1].positions[0], 7) == "Manager");
+}
+
+TEST_CASE("trigram index finds substrings case-insensitively")
+{
+	const std::map<Id, std::string> files = getTestFiles();
+	TrigramIndex index;
+	addFiles(index, files);
+
+	std::vector<FullTextSearchResult> results = search(index, files, "MANAGER", false, false);
+
+	REQUIRE(2 == results.size());
+	REQUIRE(1 == results[0].positions.size());
+	REQUIRE(2 == results[1].positions.size());
+	REQUIRE(search(index, files, "MANAGER", true, false).empty());
+}
+
+TEST_CASE("trigram index finds short terms without trigrams")
+{
+	const std::map<Id, std::string> files = getTestFiles();
+	TrigramIndex index;
+	addFiles(index, files);
+
+	std::vector<FullTextSearchResult> results = search(index, files, "()", true, false);
+
+	REQUIRE(3 == results.size());
+}
+
+TEST_CASE("trigram index candidates contain all trigrams of the term")
+{
+	const std::map<Id, std::string> files = getTestFiles();
+	TrigramIndex index;
+	addFiles(index, files);
+
+	REQUIRE(
+		std::vector<Id>({1, 2}) ==
+		index.getCandidateFileIds(TrigramIndex::getTermTrigrams("manager")));
+	REQUIRE(
+		std::vector<Id>({3}) == index.getCandidateFileIds(TrigramIndex::getTermTrigrams("bar()")));
+	REQUIRE(index.getCandidateFileIds(TrigramIndex::getTermTrigrams("xyz")).empty());
+	REQUIRE(3 == index.getCandidateFileIds({}).size());
+}
+
+TEST_CASE("trigram index adds files passed by reader on several threads")
+{
+	// larger than a batch, so the files are spread over several batches
+	std::map<Id, std::string> files = getTestFiles();
+	files.emplace(4, std::string(2 * 1024 * 1024, 'x') + "Manager");
+	files.emplace(5, "");
+	for (Id fileId = 6; fileId < 1000; fileId++)
+	{
+		files.emplace(fileId, "void function" + std::to_string(fileId) + "();");
+	}
+
+	TrigramIndex index;
+	size_t expectedByteCount = 0;
+	const size_t byteCount = index.addFiles(
+		[&](const std::function<void(Id, std::string&&)>& addFile) {
+			for (const auto& p: files)
+			{
+				expectedByteCount += p.second.size();
+				addFile(p.first, std::string(p.second));
+			}
+		},
+		3);
+	index.finishSetup();
+
+	REQUIRE(expectedByteCount == byteCount);
+	REQUIRE(files.size() - 1 == index.getFileCount());
+	REQUIRE(
+		std::vector<Id>({1, 2, 4}) ==
+		index.getCandidateFileIds(TrigramIndex::getTermTrigrams("manager")));
+	REQUIRE(
+		std::vector<Id>({999}) ==
+		index.getCandidateFileIds(TrigramIndex::getTermTrigrams("function999(")));
+}
+
+TEST_CASE("trigram index derives mandatory trigrams from regular expressions")
+{
+	REQUIRE(TrigramIndex::getTermTrigrams("Manager") == TrigramIndex::getRegexTrigrams("Manager"));
+	REQUIRE(
+		TrigramIndex::getTermTrigrams("getManager") ==
+		TrigramIndex::getRegexTrigrams("^\\s*getManager\\w*"));
+	REQUIRE(TrigramIndex::getTermTrigrams("abc") == TrigramIndex::getRegexTrigrams("abcd?"));
+	REQUIRE(TrigramIndex::getTermTrigrams("a.b") == TrigramIndex::getRegexTrigrams("a\\.b"));
+	REQUIRE(TrigramIndex::getRegexTrigrams("foo|bar").empty());
+	REQUIRE(TrigramIndex::getRegexTrigrams("(foo)+[bar]").empty());
+	REQUIRE(TrigramIndex::getRegexTrigrams("fo{2}").empty());
+}
+
+TEST_CASE("trigram index does not take operands of regular expression escapes as literals")
+{
+	REQUIRE(TrigramIndex::getTermTrigrams("bcd") == TrigramIndex::getRegexTrigrams("\\x41bcd"));
+	REQUIRE(TrigramIndex::getTermTrigrams("bcd") == TrigramIndex::getRegexTrigrams("\\u0041bcd"));
+	REQUIRE(TrigramIndex::getTermTrigrams("bcd") == TrigramIndex::getRegexTrigrams("\\cJbcd"));
+	REQUIRE(TrigramIndex::getTermTrigrams("abc") == TrigramIndex::getRegexTrigrams("(a)\\12abc"));
+	REQUIRE(TrigramIndex::getTermTrigrams("abc") == TrigramIndex::getRegexTrigrams("\\0abc"));
+	REQUIRE(TrigramIndex::getTermTrigrams("4243") == TrigramIndex::getRegexTrigrams("\\x414243"));
+	REQUIRE(TrigramIndex::getRegexTrigrams("\\x4bcd").empty());
+}
+
+TEST_CASE("trigram index finds regular expression matches with escaped characters")
+{
+	const std::map<Id, std::string> files = {{1, "int Abcd = 0;\n"}, {2, "int bcd = 0;\n"}};
+	TrigramIndex index;
+	addFiles(index, files);
+
+	std::vector<FullTextSearchResult> results = search(index, files, "\\x41bcd", true, true);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(1 == results[0].fileId);
+}
+
+TEST_CASE("trigram index finds regular expression matches per line")
+{
+	const std::map<Id, std::string> files = getTestFiles();
+	TrigramIndex index;
+	addFiles(index, files);
+
+	std::vector<FullTextSearchResult> results = search(index, files, "^int \\w+", true, true);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(2 == results[0].fileId);
+	REQUIRE(2 == results[0].positions.size());
+	REQUIRE(
+		files.at(2).substr(results[0].positions[0], results[0].termLens[0]) == "int managerCount");
+	REQUIRE(
+		files.at(2).substr(results[0].positions[1], results[0].termLens[1]) == "int getManagerId");
+
+	REQUIRE(2 == search(index, files, "MANAGER\\w*", false, true).size());
+	REQUIRE(search(index, files, "(unclosed", true, true).empty());
+}
+
+TEST_CASE("trigram index loads saved index only for matching fingerprint")
+{
+	const FilePath indexPath(L"data/TrigramIndexTestSuite/fulltext.idx");
+	FileSystem::createDirectory(indexPath.getParentDirectory());
+
+	const std::map<Id, std::string> files = getTestFiles();
+	{
+		TrigramIndex index;
+		addFiles(index, files);
+		REQUIRE(index.save(indexPath, "fingerprint"));
+	}
+
+	TrigramIndex index;
+	REQUIRE_FALSE(index.load(indexPath, "other"));
+	REQUIRE(0 == index.getFileCount());
+
+	REQUIRE(index.load(indexPath, "fingerprint"));
+	REQUIRE(3 == index.getFileCount());
+	REQUIRE(2 == search(index, files, "Manager", true, false).size());
+
+	FileSystem::remove(indexPath);
+	FileSystem::remove(indexPath.getParentDirectory());
+}
+
+TEST_CASE("trigram index update removes changed files and returns files to add")
+{
+	std::map<Id, std::string> files = getTestFiles();
+	TrigramIndex index;
+	REQUIRE(std::vector<Id>({1, 2, 3}) == index.update({{1, "a"}, {2, "a"}, {3, "a"}}, 2));
+	addFiles(index, files);
+
+	// file 2 changed, file 3 is gone and file 4 is new
+	files[2] = "int countManagers();\n";
+	files.erase(3);
+	files[4] = "void bar();\n";
+	const std::vector<Id> addedFileIds = index.update({{1, "a"}, {2, "b"}, {4, "a"}}, 2);
+	REQUIRE(std::vector<Id>({2, 4}) == addedFileIds);
+	REQUIRE(1 == index.getFileCount());
+
+	for (Id fileId: addedFileIds)
+	{
+		index.addFile(fileId, files.at(fileId));
+	}
+	index.finishSetup();
+
+	REQUIRE(3 == index.getFileCount());
+	REQUIRE(
+		std::vector<Id>({1, 2}) ==
+		index.getCandidateFileIds(TrigramIndex::getTermTrigrams("manager")));
+	REQUIRE(
+		std::vector<Id>({4}) ==
+		index.getCandidateFileIds(TrigramIndex::getTermTrigrams("bar()"), 2));
+	REQUIRE(index.getCandidateFileIds(TrigramIndex::getTermTrigrams("getManagerId")).empty());
+	REQUIRE(index.update({{1, "a"}, {2, "b"}, {4, "a"}}, 2).empty());
+}
+
+TEST_CASE("trigram index loads index saved for other fingerprint to update it")
+{
+	const FilePath indexPath(L"data/TrigramIndexTestSuite/fulltext.idx");
+	FileSystem::createDirectory(indexPath.getParentDirectory());
+
+	const std::map<Id, std::string> files = getTestFiles();
+	{
+		TrigramIndex index;
+		index.update({{1, "a"}, {2, "a"}, {3, "a"}}, 1);
+		addFiles(index, files);
+		REQUIRE(index.save(indexPath, "fingerprint"));
+	}
+
+	TrigramIndex index;
+	REQUIRE(index.load(indexPath));
+	REQUIRE(3 == index.getFileCount());
+	REQUIRE(std::vector<Id>({3}) == index.update({{1, "a"}, {2, "a"}, {3, "b"}}, 1));
+	REQUIRE(2 == index.getFileCount());
+
+	FileSystem::remove(indexPath);
+	FileSystem::remove(indexPath.getParentDirectory());
+}
+
+TEST_CASE("trigram index search continues after being stopped")
+{
+	const std::map<Id, std::string> files = getTestFiles();
+	TrigramIndex index;
+	addFiles(index, files);
+
+	std::vector<Id> fileIds;
+	const size_t nextCandidateIndex = index.search(
+		"()",
+		true,
+		false,
+		[&files](Id fileId) { return files.at(fileId); },
+		2,
+		0,
+		1,
+		[&fileIds](std::vector<FullTextSearchResult>&& results) {
+			for (const FullTextSearchResult& result: results)
+			{
+				fileIds.push_back(result.fileId);
+			}
+			return fileIds.size() < 2;
+		});
+
+	REQUIRE(2 == nextCandidateIndex);
+	REQUIRE(std::vector<Id>({1, 2}) == fileIds);
+
+	REQUIRE(
+		0 ==
+		index.search(
+			"()",
+			true,
+			false,
+			[&files](Id fileId) { return files.at(fileId); },
+			2,
+			nextCandidateIndex,
+			1,
+			[&fileIds](std::vector<FullTextSearchResult>&& results) {
+				for (const FullTextSearchResult& result: results)
+				{
+					fileIds.push_back(result.fileId);
+				}
+				return true;
+			}));
+	REQUIRE(std::vector<Id>({1, 2, 3}) == fileIds);
+}
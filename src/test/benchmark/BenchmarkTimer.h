@@ -0,0 +1,26 @@
+#ifndef BENCHMARK_TIMER_H
+#define BENCHMARK_TIMER_H
+
+#include <chrono>
+
+// measures the wall clock time since its creation
+class BenchmarkTimer
+{
+public:
+	BenchmarkTimer(): m_start(std::chrono::steady_clock::now()) {}
+
+	double getSeconds() const
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+	double getMilliSeconds() const
+	{
+		return getSeconds() * 1000;
+	}
+
+private:
+	const std::chrono::steady_clock::time_point m_start;
+};
+
+#endif	  // BENCHMARK_TIMER_H
@@ -0,0 +1,45 @@
+#include "catch.hpp"
+
+#include <iostream>
+
+#include "BenchmarkTimer.h"
+#include "FuzzyMatcher.h"
+#include "TestFuzzyMatcherKernels.h"
+
+TEST_CASE("fuzzy matcher benchmark")
+{
+	const FuzzyMatcher::Kernel defaultKernel = FuzzyMatcher::getKernel();
+
+	std::wstring text;
+	for (size_t i = 0; i < 1000; i++)
+	{
+		text += L"some_namespace::SomeClass" + std::to_wstring(i) + L"::someMethod";
+	}
+	const std::wstring query = L"qqq";
+
+	for (FuzzyMatcher::Kernel kernel: getSupportedKernels())
+	{
+		FuzzyMatcher::setKernel(kernel);
+
+		const size_t iterations = 1000;
+		size_t matchedCount = 0;
+		std::vector<size_t> indices;
+
+		const BenchmarkTimer timer;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			indices.clear();
+			matchedCount += FuzzyMatcher::match(text.data(), text.size(), query, 0, 0, &indices);
+		}
+		const double seconds = timer.getSeconds();
+
+		const char* kernelNames[] = {"scalar", "SSE2", "AVX2"};
+		std::cout << "FuzzyMatcher with " << kernelNames[kernel] << " kernel: "
+				  << static_cast<size_t>(iterations * text.size() / seconds / 1000000)
+				  << " M characters/s" << std::endl;
+
+		REQUIRE(0 == matchedCount);
+	}
+
+	FuzzyMatcher::setKernel(defaultKernel);
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include "BenchmarkTimer.h"
+#include "SearchIndex.h"
+#include "TestSearchIndexElements.h"
+
+// The benchmarks are built into their own executable, so counting the allocations here does not
+// change the allocator of the test executable.
+namespace
+{
+std::atomic<size_t> s_allocationCount(0);
+}	 // namespace
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	s_allocationCount++;
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+	if (void* p = operator new(size, std::nothrow))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+TEST_CASE("search index build benchmark")
+{
+	const size_t elementCount = 500000;
+	const std::vector<SearchIndex::Element> elements = getTestSearchIndexElements(elementCount);
+
+	for (size_t threadCount: {size_t(1), size_t(4), size_t(std::thread::hardware_concurrency())})
+	{
+		SearchIndex index;
+		const BenchmarkTimer timer;
+		index.build(elements, threadCount);
+		const double seconds = timer.getSeconds();
+
+		std::cout << "SearchIndex::build with " << threadCount
+				  << " threads: " << static_cast<size_t>(elementCount / seconds) << " nodes/s"
+				  << std::endl;
+
+		REQUIRE(index.search(L"method42", NodeTypeSet::all(), 1).size() == 1);
+	}
+}
+
+TEST_CASE("search index search benchmark")
+{
+	SearchIndex index;
+	index.build(getTestSearchIndexElements(500000), std::thread::hardware_concurrency());
+
+	for (const std::wstring& query: {L"m", L"me", L"cm4"})
+	{
+		// same limits as used for autocompletion
+		const size_t maxResultCount = static_cast<size_t>(std::pow(3, query.size() + 3));
+
+		const size_t allocationCount = s_allocationCount;
+		const BenchmarkTimer timer;
+		const std::vector<SearchResult> results = index.search(
+			query, NodeTypeSet::all(), maxResultCount, 100);
+		const double milliSeconds = timer.getMilliSeconds();
+
+		std::wcout << L"SearchIndex::search for \"" << query << L"\": " << milliSeconds << L" ms, "
+				   << (s_allocationCount - allocationCount) << L" allocations" << std::endl;
+
+		REQUIRE(results.size() == maxResultCount);
+	}
+}
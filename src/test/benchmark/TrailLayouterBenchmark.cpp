@@ -0,0 +1,24 @@
+#include "catch.hpp"
+
+#include <iostream>
+
+#include "BenchmarkTimer.h"
+#include "TestTrail.h"
+
+TEST_CASE("trail layouter benchmark")
+{
+	for (size_t nodeCount: {1000, 10000})
+	{
+		TestTrail trail;
+		addSyntheticTrail(&trail, nodeCount);
+
+		const BenchmarkTimer timer;
+		trail.layout();
+		const double milliSeconds = timer.getMilliSeconds();
+
+		std::cout << "TrailLayouter with " << nodeCount << " nodes: " << milliSeconds << " ms"
+				  << std::endl;
+
+		REQUIRE(trail.getNode(1)->visible);
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef TEST_FUZZY_MATCHER_KERNELS_H
+#define TEST_FUZZY_MATCHER_KERNELS_H
+
+#include <vector>
+
+#include "FuzzyMatcher.h"
+
+// kernels that can run on the current processor
+inline std::vector<FuzzyMatcher::Kernel> getSupportedKernels()
+{
+	std::vector<FuzzyMatcher::Kernel> kernels;
+	for (FuzzyMatcher::Kernel kernel:
+		 {FuzzyMatcher::KERNEL_SCALAR, FuzzyMatcher::KERNEL_SSE2, FuzzyMatcher::KERNEL_AVX2})
+	{
+		if (FuzzyMatcher::isKernelSupported(kernel))
+		{
+			kernels.push_back(kernel);
+		}
+	}
+	return kernels;
+}
+
+#endif	  // TEST_FUZZY_MATCHER_KERNELS_H
@@ -0,0 +1,26 @@
+#ifndef TEST_SEARCH_INDEX_ELEMENTS_H
+#define TEST_SEARCH_INDEX_ELEMENTS_H
+
+#include <string>
+#include <vector>
+
+#include "SearchIndex.h"
+
+// creates count methods spread over 5000 classes in a few namespaces
+inline std::vector<SearchIndex::Element> getTestSearchIndexElements(size_t count)
+{
+	const std::vector<std::wstring> namespaces = {L"std", L"boost", L"app", L"lib", L"detail", L"qt"};
+
+	std::vector<SearchIndex::Element> elements;
+	for (size_t i = 0; i < count; i++)
+	{
+		elements.emplace_back(
+			i + 1,
+			namespaces[i % namespaces.size()] + L"::Class" + std::to_wstring(i % 5000) +
+				L"::method" + std::to_wstring(i),
+			NodeType(NODE_METHOD));
+	}
+	return elements;
+}
+
+#endif	  // TEST_SEARCH_INDEX_ELEMENTS_H
@@ -0,0 +1,129 @@
+#ifndef TEST_TRAIL_H
+#define TEST_TRAIL_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "DummyEdge.h"
+#include "DummyNode.h"
+#include "Graph.h"
+#include "TrailLayouter.h"
+
+// dummy nodes and edges of a trail graph that get layouted by the TrailLayouter
+class TestTrail
+{
+public:
+	TestTrail(): m_graph(std::make_shared<Graph>()) {}
+
+	void addNode(Id id, bool active = false)
+	{
+		Node* node = m_graph->createNode(
+			id,
+			NodeType(NODE_FUNCTION),
+			NameHierarchy(L"function" + std::to_wstring(id), NAME_DELIMITER_CXX),
+			DEFINITION_EXPLICIT);
+
+		std::shared_ptr<DummyNode> dummyNode = std::make_shared<DummyNode>(DummyNode::DUMMY_DATA);
+		dummyNode->data = node;
+		dummyNode->tokenId = id;
+		dummyNode->name = node->getName();
+		dummyNode->visible = true;
+		dummyNode->active = active;
+		dummyNode->size = Vec2i(100, 30);
+
+		m_nodes.push_back(dummyNode);
+		m_topLevelAncestorIds.emplace(id, id);
+	}
+
+	void addEdge(Id id, Id originId, Id targetId)
+	{
+		Edge* edge = m_graph->createEdge(
+			id, Edge::EDGE_CALL, m_graph->getNodeById(originId), m_graph->getNodeById(targetId));
+
+		std::shared_ptr<DummyEdge> dummyEdge = std::make_shared<DummyEdge>(originId, targetId, edge);
+		dummyEdge->visible = true;
+		m_edges.push_back(dummyEdge);
+	}
+
+	void layout(
+		TrailLayouter::LayoutDirection direction = TrailLayouter::LAYOUT_LEFT_RIGHT,
+		std::function<bool()> isCancelled = std::function<bool()>())
+	{
+		TrailLayouter layouter(direction);
+		layouter.layoutGraph(m_nodes, m_edges, m_topLevelAncestorIds, isCancelled);
+	}
+
+	const DummyNode* getNode(Id id) const
+	{
+		for (const std::shared_ptr<DummyNode>& node: m_nodes)
+		{
+			if (node->tokenId == id)
+			{
+				return node.get();
+			}
+		}
+		return nullptr;
+	}
+
+	const DummyEdge* getEdge(Id id) const
+	{
+		for (const std::shared_ptr<DummyEdge>& edge: m_edges)
+		{
+			if (edge->data->getId() == id)
+			{
+				return edge.get();
+			}
+		}
+		return nullptr;
+	}
+
+	size_t getNodeCount() const
+	{
+		return m_nodes.size();
+	}
+
+private:
+	std::shared_ptr<Graph> m_graph;
+	std::vector<std::shared_ptr<DummyNode>> m_nodes;
+	std::vector<std::shared_ptr<DummyEdge>> m_edges;
+	std::map<Id, Id> m_topLevelAncestorIds;
+};
+
+// levels of nodes with calls to nodes of the next levels and a few calls back
+inline void addSyntheticTrail(TestTrail* trail, size_t nodeCount)
+{
+	const size_t levelSize = 40;
+	uint32_t random = 12345;
+	auto getRandom = [&random]() {
+		random = random * 1103515245 + 12345;
+		return static_cast<size_t>(random >> 8);
+	};
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		trail->addNode(i + 1, i == 0);
+	}
+
+	Id edgeId = nodeCount + 1;
+	for (size_t i = 1; i < nodeCount; i++)
+	{
+		const size_t level = (i - 1) / levelSize;
+		const size_t previousLevelStart = level ? (level - 1) * levelSize + 1 : 0;
+		const size_t previousLevelSize = level ? levelSize : 1;
+
+		// like in real trails most edges connect nodes of neighboring levels
+		const size_t nearbyStart = level > 1 ? (level - 2) * levelSize + 1 : 0;
+
+		trail->addEdge(edgeId++, previousLevelStart + getRandom() % previousLevelSize + 1, i + 1);
+		trail->addEdge(edgeId++, nearbyStart + getRandom() % (i - nearbyStart) + 1, i + 1);
+
+		if (getRandom() % 20 == 0)
+		{
+			trail->addEdge(edgeId++, i + 1, nearbyStart + getRandom() % (i - nearbyStart) + 1);
+		}
+	}
+}
+
+#endif	  // TEST_TRAIL_H